@@ -27,16 +27,6 @@ static inline uint64_t time_now(void)
 	return (uint64_t)(time.tv_sec * 1000 + time.tv_usec / 1000);
 }
 
-static inline uint16_t packet_length(struct packet_t * packet)
-{
-	return ((packet->length[0] << 8) | (packet->length[1] << 0));
-}
-
-static inline uint16_t packet_dsize(struct packet_t * packet)
-{
-	return packet_length(packet) - 5;
-}
-
 static inline uint32_t packet_crc(struct packet_t * packet)
 {
 	uint32_t crc = 0;
@@ -51,7 +41,7 @@ static inline uint32_t packet_crc(struct packet_t * packet)
 	return crc;
 }
 
-static void packet_put(struct interface_t * iface, struct packet_t * packet)
+void packet_put(struct interface_t * iface, struct packet_t * packet)
 {
 	uint16_t dsize = packet_dsize(packet);
 
@@ -108,7 +98,12 @@ static int packet_get_byte(struct packet_get_ctx_t * ctx, uint8_t c)
 	case PACKET_STATE_COMMAND:
 		ctx->state = PACKET_STATE_DATA;
 		length = (p[2] << 8) | (p[3] << 0);
-		if(ctx->index >= length)
+		if(length < 5)
+		{
+			ctx->index = 0;
+			ctx->state = PACKET_STATE_HEADER0;
+		}
+		else if(ctx->index >= length)
 			ctx->state = PACKET_STATE_CRC0;
 		break;
 
@@ -154,7 +149,7 @@ static int packet_get_byte(struct packet_get_ctx_t * ctx, uint8_t c)
 	return -1;
 }
 
-static int packet_get(struct interface_t * iface, struct packet_t * packet, int timeout)
+int packet_get(struct interface_t * iface, struct packet_t * packet, int timeout)
 {
 	struct packet_get_ctx_t ctx;
 	uint64_t time, end;
@@ -6,16 +6,29 @@
 #include <interface.h>
 
 #define PACKET_DATA_MAX		(1024)
+#define PACKET_LENGTH_MAX	(65535)
 
 struct packet_t {
 	uint8_t header[2];
 	uint8_t length[2];
 	uint8_t command;
-	uint8_t data[PACKET_DATA_MAX];
+	uint8_t data[PACKET_LENGTH_MAX - 5];
 	uint8_t crc[4];
 };
 
+static inline uint16_t packet_length(struct packet_t * packet)
+{
+	return ((packet->length[0] << 8) | (packet->length[1] << 0));
+}
+
+static inline uint16_t packet_dsize(struct packet_t * packet)
+{
+	return packet_length(packet) - 5;
+}
+
 void packet_init(struct packet_t * packet, uint8_t command, uint8_t * data, size_t size);
+void packet_put(struct interface_t * iface, struct packet_t * packet);
+int packet_get(struct interface_t * iface, struct packet_t * packet, int timeout);
 int packet_transfer(struct interface_t * iface, struct packet_t * request, struct packet_t * response, int timeout);
 
 #endif /* __PACKET_H__ */
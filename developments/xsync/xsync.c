@@ -3,7 +3,20 @@
 static void usage(void)
 {
 	printf("usage:\r\n");
-	printf("    xsync [-d device] [-b baud] <path>\r\n");
+	printf("    xsync [-d device] [-b baud] [-w window] [-s size] [-z] <path>\r\n");
+}
+
+static inline uint32_t xsync_get_be32(uint8_t * p)
+{
+	return (p[0] << 24) | (p[1] << 16) | (p[2] << 8) | (p[3] << 0);
+}
+
+static inline void xsync_put_be32(uint8_t * p, uint32_t v)
+{
+	p[0] = (v >> 24) & 0xff;
+	p[1] = (v >> 16) & 0xff;
+	p[2] = (v >>  8) & 0xff;
+	p[3] = (v >>  0) & 0xff;
 }
 
 static void xsync_show_progress(const char * filename, int percent)
@@ -27,7 +40,159 @@ static void xsync_show_progress(const char * filename, int percent)
 	fflush(stdout);
 }
 
-static void xsync_transfer_file(struct interface_t * iface, const char * filename)
+/*
+ * Ask for windowed transfer, the device answers with what it accepts. An
+ * older device answers XSYNC_COMMAND_UNKOWN, then stay with stop and wait.
+ */
+static int xsync_config(struct interface_t * iface, struct xsync_config_t * cfg)
+{
+	struct packet_t request, response;
+	uint8_t buf[8];
+	int result, retry;
+
+	buf[0] = XSYNC_VERSION;
+	buf[1] = cfg->flags;
+	buf[2] = cfg->window;
+	buf[3] = 0;
+	xsync_put_be32(&buf[4], cfg->chunk);
+	retry = 0;
+	packet_init(&request, XSYNC_COMMAND_CONFIG, buf, 8);
+	do {
+		result = packet_transfer(iface, &request, &response, 1000);
+	} while((result < 0) && (++retry < 3));
+	if((result < 0) || (response.command != XSYNC_COMMAND_CONFIG) || (packet_dsize(&response) < 8))
+		return -1;
+
+	cfg->flags &= response.data[1];
+	cfg->window = response.data[2];
+	cfg->chunk = xsync_get_be32(&response.data[4]);
+	if((cfg->window <= 0) || (cfg->window > XSYNC_WINDOW_MAX))
+		return -1;
+	if((cfg->chunk <= 0) || (cfg->chunk > XSYNC_CHUNK_MAX))
+		return -1;
+	return 0;
+}
+
+static int xsync_write_block(struct interface_t * iface, int fd, struct xsync_config_t * cfg, uint32_t seq, uint8_t * buf)
+{
+	struct packet_t request;
+	uint8_t * data = &buf[cfg->chunk];
+	int n, len = 0;
+
+	n = pread(fd, buf, cfg->chunk, (off_t)seq * cfg->chunk);
+	if(n <= 0)
+		return -1;
+
+	xsync_put_be32(&data[0], seq);
+	data[4] = 0;
+	if(cfg->flags & XSYNC_FLAG_LZ4)
+		len = LZ4_compress_default((const char *)buf, (char *)&data[5], n, n - 1);
+	if(len > 0)
+	{
+		data[4] = XSYNC_FLAG_LZ4;
+	}
+	else
+	{
+		memcpy(&data[5], buf, n);
+		len = n;
+	}
+	packet_init(&request, XSYNC_COMMAND_WRITE, data, len + 5);
+	packet_put(iface, &request);
+	return 0;
+}
+
+/*
+ * Keep up to window blocks in flight. Each ack tells the first block the
+ * device is missing and which later ones it holds, a hole behind a block
+ * that was sent after it can only be a lost packet, so that one is resent
+ * at once. On timeout every block not yet held is resent.
+ */
+static int xsync_transfer_window(struct interface_t * iface, int fd, const char * filename, int filesize, struct xsync_config_t * cfg)
+{
+	struct packet_t response;
+	uint32_t order[XSYNC_WINDOW_MAX];
+	uint8_t held[XSYNC_WINDOW_MAX];
+	uint32_t total = (filesize + cfg->chunk - 1) / cfg->chunk;
+	uint32_t base = 0, top = 0, count = 0;
+	uint32_t next, mask, latest, seq;
+	uint64_t done;
+	uint8_t * buf;
+	int retry = 0;
+	int i;
+
+	buf = malloc(cfg->chunk * 2 + 5);
+	if(!buf)
+		return -1;
+
+	while(base < total)
+	{
+		for(; (top < total) && (top < base + cfg->window); top++)
+		{
+			if(xsync_write_block(iface, fd, cfg, top, buf) < 0)
+			{
+				free(buf);
+				return -1;
+			}
+			order[top % cfg->window] = ++count;
+			held[top % cfg->window] = 0;
+		}
+
+		if((packet_get(iface, &response, cfg->timeout) < 0) || (response.command != XSYNC_COMMAND_WRITE) || (packet_dsize(&response) < 8))
+		{
+			if(++retry >= 3)
+			{
+				free(buf);
+				return -1;
+			}
+			for(seq = base; seq < top; seq++)
+			{
+				if(!held[seq % cfg->window])
+				{
+					xsync_write_block(iface, fd, cfg, seq, buf);
+					order[seq % cfg->window] = ++count;
+				}
+			}
+			continue;
+		}
+		retry = 0;
+
+		next = xsync_get_be32(&response.data[0]);
+		mask = xsync_get_be32(&response.data[4]);
+		if((next < base) || (next > top))
+			continue;
+		if(next > base)
+		{
+			base = next;
+			done = (uint64_t)base * cfg->chunk;
+			xsync_show_progress(filename, (done < filesize) ? done * 100 / filesize : 100);
+		}
+
+		latest = 0;
+		for(i = 0; i + 1 < cfg->window; i++)
+		{
+			seq = next + 1 + i;
+			if((mask & (1 << i)) && (seq < top))
+			{
+				held[seq % cfg->window] = 1;
+				if(order[seq % cfg->window] > latest)
+					latest = order[seq % cfg->window];
+			}
+		}
+		for(seq = base; seq < top; seq++)
+		{
+			if(!held[seq % cfg->window] && (order[seq % cfg->window] < latest))
+			{
+				xsync_write_block(iface, fd, cfg, seq, buf);
+				order[seq % cfg->window] = ++count;
+			}
+		}
+	}
+
+	free(buf);
+	return 0;
+}
+
+static void xsync_transfer_file(struct interface_t * iface, const char * filename, struct xsync_config_t * cfg)
 {
 	struct packet_t request, response;
 	char buf[PACKET_DATA_MAX];
@@ -95,17 +260,22 @@ static void xsync_transfer_file(struct interface_t * iface, const char * filenam
 	}
 
 	result = 0;
-	while(((n = read(fd, buf, sizeof(buf))) > 0) && !(result < 0))
+	if(cfg->window > 0)
+		result = xsync_transfer_window(iface, fd, filename, filesize, cfg);
+	else
 	{
-		retry = 0;
-		packet_init(&request, XSYNC_COMMAND_TRANSFER, (uint8_t *)buf, n);
-		do {
-			result = packet_transfer(iface, &request, &response, 1000);
-	    } while((result < 0) && (++retry < 3));
-		if(!(result < 0))
+		while(((n = read(fd, buf, sizeof(buf))) > 0) && !(result < 0))
 		{
-			len += n;
-			xsync_show_progress(filename, len * 100 / filesize);
+			retry = 0;
+			packet_init(&request, XSYNC_COMMAND_TRANSFER, (uint8_t *)buf, n);
+			do {
+				result = packet_transfer(iface, &request, &response, 1000);
+			} while((result < 0) && (++retry < 3));
+			if(!(result < 0))
+			{
+				len += n;
+				xsync_show_progress(filename, len * 100 / filesize);
+			}
 		}
 	}
 	if(result < 0)
@@ -137,6 +307,12 @@ int main(int argc, char * argv[])
 	char * path = ".";
 	char * device = "/dev/ttyUSB0";
 	int baud = 115200;
+	struct xsync_config_t cfg = {
+		.flags = 0,
+		.window = 8,
+		.chunk = 16384,
+		.timeout = 1000,
+	};
 	int result, retry;
 	int i;
 
@@ -152,6 +328,20 @@ int main(int argc, char * argv[])
 			baud = (int)strtoul(argv[i + 1], NULL, 0);
 			i++;
 		}
+		else if( !strcmp(argv[i], "-w") && (argc > i + 1) )
+		{
+			cfg.window = (int)strtoul(argv[i + 1], NULL, 0);
+			i++;
+		}
+		else if( !strcmp(argv[i], "-s") && (argc > i + 1) )
+		{
+			cfg.chunk = (int)strtoul(argv[i + 1], NULL, 0);
+			i++;
+		}
+		else if( !strcmp(argv[i], "-z") )
+		{
+			cfg.flags |= XSYNC_FLAG_LZ4;
+		}
 		else
 		{
 			path = argv[i];
@@ -177,7 +367,18 @@ int main(int argc, char * argv[])
 		return -1;
 	}
 
-	xsync_transfer_file(iface, path);
+	if(cfg.window > XSYNC_WINDOW_MAX)
+		cfg.window = XSYNC_WINDOW_MAX;
+	if((cfg.chunk <= 0) || (cfg.chunk > XSYNC_CHUNK_MAX))
+		cfg.chunk = XSYNC_CHUNK_MAX;
+	if((cfg.window > 0) && (xsync_config(iface, &cfg) < 0))
+		cfg.window = 0;
+	if(cfg.window > 0)
+		cfg.timeout = 1000 + (int)((uint64_t)(cfg.chunk + 16) * 2 * 10 * 1000 / baud);
+	if(cfg.timeout > XSYNC_TIMEOUT)
+		cfg.timeout = XSYNC_TIMEOUT;
+
+	xsync_transfer_file(iface, path, &cfg);
 	printf("\r\n");
 
 	retry = 0;
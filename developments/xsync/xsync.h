@@ -5,6 +5,13 @@
 #include <sha256.h>
 #include <interface.h>
 #include <packet.h>
+#include <lz4.h>
+
+#define XSYNC_VERSION		(1)
+#define XSYNC_WINDOW_MAX	(16)
+#define XSYNC_CHUNK_MAX		(32768)
+#define XSYNC_FLAG_LZ4		(1 << 0)
+#define XSYNC_TIMEOUT		(8000)
 
 enum xsync_command_t {
 	XSYNC_COMMAND_ALIVE		= 0x00,
@@ -12,7 +19,16 @@ enum xsync_command_t {
 	XSYNC_COMMAND_TRANSFER	= 0x02,
 	XSYNC_COMMAND_STOP		= 0x03,
 	XSYNC_COMMAND_SYSTEM	= 0x04,
+	XSYNC_COMMAND_CONFIG	= 0x05,
+	XSYNC_COMMAND_WRITE		= 0x06,
 	XSYNC_COMMAND_UNKOWN	= 0xff,
 };
 
+struct xsync_config_t {
+	int flags;
+	int window;
+	int chunk;
+	int timeout;
+};
+
 #endif /* __XSYNC_H__ */
@@ -0,0 +1,23 @@
+local M = Class(DisplayObject)
+
+function M:init(w, h)
+	self.super:init()
+
+	local assets = assets
+
+	self:addChild(DisplayShape.new(w, h)
+		:setSource(Pattern.texture(assets:loadTexture("graphics/cursor/bg.png")):setExtend(Pattern.EXTEND_REPEAT))
+		:paint())
+
+	local cursor = assets:loadDisplay("graphics/cursor/cursor.png")
+	self:addChild(cursor)
+
+	self:addEventListener(Event.MOUSE_DOWN, function(d, e) d:setPosition(e.x, e.y) end, cursor)
+		:addEventListener(Event.MOUSE_MOVE, function(d, e) d:setPosition(e.x, e.y) end, cursor)
+		:addEventListener(Event.MOUSE_UP, function(d, e) d:setPosition(e.x, e.y) end, cursor)
+		:addEventListener(Event.TOUCH_BEGIN, function(d, e) d:setPosition(e.x, e.y) end, cursor)
+		:addEventListener(Event.TOUCH_MOVE, function(d, e) d:setPosition(e.x, e.y) end, cursor)
+		:addEventListener(Event.TOUCH_END, function(d, e) d:setPosition(e.x, e.y) end, cursor)
+end
+
+return M
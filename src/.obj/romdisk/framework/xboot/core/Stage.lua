@@ -0,0 +1,73 @@
+local M = Class(DisplayObject)
+
+function M:init(fb)
+	self.display = Display.new(fb)
+	self.exiting = false
+	if not self.display then
+		self.super:init()
+	else
+		self.super:init(self.display:getSize())
+	end
+end
+
+function M:showfps(value)
+	self.display:showfps(value)
+	return self
+end
+
+function M:tiling(value, size)
+	self.display:tiling(value, size)
+	return self
+end
+
+function M:opaque(value)
+	self.display:opaque(value)
+	return self
+end
+
+function M:vsync(value)
+	self.display:vsync(value)
+	return self
+end
+
+function M:gc(budget, pause, stepmul)
+	self.display:gcBudget(budget, pause, stepmul)
+	return self
+end
+
+function M:exit()
+	self.exiting = true
+	return self
+end
+
+function M:loop()
+  local timermanager = timermanager
+	local Event = Event
+	local display = self.display
+	local stopwatch = Stopwatch.new()
+	local frame = Event.new(Event.ENTER_FRAME, {count = 0})
+
+	timermanager:addTimer(Timer.new(1 / 60, 0, function(t, i)
+		frame.time = frame.time + i.time * 1000000000
+		frame.count = i.count
+		frame.stop = nil
+		self:render(display, frame)
+		display:present()
+	end))
+
+	self:addEventListener(Event.KEY_DOWN, function(d, e)
+		if e.key == 10 then self:exit() end
+	end)
+
+	while not self.exiting do
+		Event.pumpAll(self.dispatch, self)
+
+		local elapsed = stopwatch:elapsed()
+		if elapsed ~= 0 then
+			stopwatch:reset()
+			timermanager:schedule(elapsed)
+		end
+	end
+end
+
+return M
@@ -0,0 +1,75 @@
+---
+-- The 'DisplayImageMask' class is used to display texture related objects that can
+-- be placed on the screen.
+--
+-- @module DisplayImageMask
+local M = Class(DisplayObject)
+
+---
+-- Creates a new object of display image.
+--
+-- @function [parent=#DisplayImageMask] new
+-- @param texture (Texture) The texture object
+-- @param pattern (Pattern) The pattern for mask.
+-- @return #DisplayImageMask
+function M:init(texture, pattern)
+	self.super:init()
+	self:setTexture(texture)
+	self:setPattern(pattern or Pattern.color(1, 1, 1, 0))
+end
+
+---
+-- Attach texture to display image.
+--
+-- @function [parent=#DisplayImageMask] setTexture
+-- @param self
+-- @param texture (Texture) The texture object
+function M:setTexture(texture)
+	if texture then
+		local w, h = texture:size()
+		self.texture = texture
+		if self.pattern then
+			self.object:setTextureMask(texture, self.pattern)
+		end
+		self:setSize(w, h)
+	end
+	return self
+end
+
+---
+-- Get texture of display image.
+--
+-- @function [parent=#DisplayImageMask] getTexture
+-- @param self
+-- @return The texture object of display image.
+function M:getTexture()
+	return self.texture
+end
+
+---
+-- Sets the display image's mask.
+-- 
+-- @function [parent=#DisplayText] setPattern
+-- @param self
+-- @param pattern (#Pattern) The new pattern for mask.
+function M:setPattern(pattern)
+	if pattern then
+		self.pattern = pattern
+		if self.texture then
+			self.object:setTextureMask(self.texture, pattern)
+		end
+	end
+	return self
+end
+
+---
+-- Gets the mask pattern.
+-- 
+-- @function [parent=#DisplayText] getPattern
+-- @param self
+-- @return pattern (#Pattern) The new pattern for mask.
+function M:getPattern()
+	return self.pattern
+end
+
+return M
@@ -0,0 +1,818 @@
+---
+-- The 'DisplayObject' class is the base class for all objects that can
+-- be placed on the screen.
+--
+-- @module DisplayObject
+local M = Class(EventDispatcher)
+
+local pointers = {
+	[Event.MOUSE_DOWN] = "begin",
+	[Event.MOUSE_MOVE] = "move",
+	[Event.MOUSE_UP] = "end",
+	[Event.TOUCH_BEGIN] = "begin",
+	[Event.TOUCH_MOVE] = "move",
+	[Event.TOUCH_END] = "end",
+}
+
+---
+-- Creates a new display object.
+--
+-- @function [parent=#DisplayObject] new
+-- @param width (number) The width of the display object in pixels.
+-- @param height (number) The height of the display object in pixels.
+-- @return #DisplayObject
+function M:init(width, height)
+	self.super:init()
+	self.parent = nil
+	self.children = {}
+	self.object = Object.new(self)
+	self.object:setSize(width or 0, height or 0)
+end
+
+---
+-- Determines whether the specified display object is contained in the subtree of
+-- this 'DisplayObject' instance.
+--
+-- @function [parent=#DisplayObject] contains
+-- @param self
+-- @param child (DisplayObject) The child object to test.
+-- @return 'true' if the child object is contained in the subtree of this 'DisplayObject'
+-- instance, otherwise 'false'.
+function M:contains(child)
+	for i, v in ipairs(self.children) do
+		if v == child then
+			return true
+		end
+	end
+
+	return false
+end
+
+---
+-- Returns the display object that contains this display object.
+-- 
+-- @function [parent=#DisplayObject] getParent
+-- @param self
+-- @return The parent display object.
+function M:getParent()
+	return self.parent
+end
+
+---
+-- Adds a display object as a child to this display object. The child
+-- is added as a last child of this 'DisplayObject' instance.
+--
+-- Display object can have only one parent. Therefore if you add a child
+-- object that already has a different display object as a parent, the
+-- display object is removed from the child list of the other display
+-- object and then added to this display object.
+--
+-- @function [parent=#DisplayObject] addChild
+-- @param self
+-- @param child (DisplayObject) The child display object to add.
+-- @return A value of 'true' or 'false'.
+function M:addChild(child)
+	if child == nil or self == child then
+		return false
+	end
+
+	if child.parent == self then
+		return false
+	end
+
+	child:removeSelf()
+	table.insert(self.children, child)
+	child.parent = self
+	child.object:setDrawHook(child.__draw ~= M.__draw)
+	self.object:addChild(child.object)
+
+	return true
+end
+
+---
+-- Removes the specified child 'DisplayObject' instance from the child list
+-- of this 'DisplayObject' instance.
+--
+-- @function [parent=#DisplayObject] removeChild
+-- @param self
+-- @param child (DisplayObject) The child display object to remove.
+-- @return A value of 'true' or 'false'.
+function M:removeChild(child)
+	if child == nil or self == child then
+		return false
+	end
+
+	local index = 0
+
+	for i, v in ipairs(self.children) do
+		if v == child then
+			index = i
+			break
+		end
+	end
+
+	if index <= 0 then
+		return false
+	end
+
+	table.remove(self.children, index)
+	child.parent = nil
+	self.object:removeChild(child.object)
+
+	return true
+end
+
+---
+-- If the display object has a parent, removes the display object from the
+-- child list of its parent display object.
+--
+-- @function [parent=#DisplayObject] removeSelf
+-- @param self
+-- @return A value of 'true' or 'false'.
+function M:removeSelf()
+	local parent = self.parent
+
+	if parent == nil then
+		return false
+	end
+
+	return parent:removeChild(self)
+end
+
+---
+-- Moves the display object to the visual front of its parent.
+--
+-- @function [parent=#DisplayObject] toFront
+-- @param self
+-- @return A value of 'true' or 'false'.
+function M:toFront()
+	local parent = self.parent
+
+	if parent == nil then
+		return false
+	end
+
+	if not parent:removeChild(self) then
+		return false
+	end
+
+	table.insert(parent.children, self)
+	self.parent = parent
+	parent.object:addChild(self.object)
+
+	return true
+end
+
+---
+-- Moves the display object to the visual back of its parent.
+--
+-- @function [parent=#DisplayObject] toBack
+-- @param self
+-- @return A value of 'true' or 'false'.
+function M:toBack()
+	local parent = self.parent
+
+	if parent == nil then
+		return false
+	end
+
+	if not parent:removeChild(self) then
+		return false
+	end
+
+	table.insert(parent.children, 1, self)
+	self.parent = parent
+	parent.object:addChild(self.object, true)
+
+	return true
+end
+
+---
+-- Sets the width and height of the display object in pixels. (Inner, No transform matrix)
+--
+-- @function [parent=#DisplayObject] setSize
+-- @param self
+-- @param width (number) The width of the display object.
+-- @param height (number) The height of the display object.
+function M:setSize(width, height)
+	self.object:setSize(width, height)
+	return self
+end
+
+---
+-- Returns the width and height of the display object in pixels. (Inner, No transform matrix)
+--
+-- @function [parent=#DisplayObject] getSize
+-- @param self
+-- @return The width and height of the display object.
+function M:getSize()
+	return self.object:getSize()
+end
+
+---
+-- Sets the x coordinates of the display object.
+--
+-- @function [parent=#DisplayObject] setX
+-- @param self
+-- @param x (number) The new x coordinate of the display object.
+function M:setX(x)
+	self.object:setX(x)
+	return self
+end
+
+---
+-- Returns the x coordinate of the display object.
+--
+-- @function [parent=#DisplayObject] getX
+-- @param self
+-- @return The x coordinate of the display object.
+function M:getX()
+	return self.object:getX()
+end
+
+---
+-- Sets the y coordinates of the display object.
+--
+-- @function [parent=#DisplayObject] setY
+-- @param self
+-- @param y (number) The new y coordinate of the display object.
+function M:setY(y)
+	self.object:setY(y)
+	return self
+end
+
+---
+-- Returns the y coordinate of the display object.
+--
+-- @function [parent=#DisplayObject] getY
+-- @param self
+-- @return The y coordinate of the display object.
+function M:getY()
+	return self.object:getY()
+end
+
+---
+-- Sets the x and y coordinates of the display object.
+--
+-- @function [parent=#DisplayObject] setPosition
+-- @param self
+-- @param x (number) The new x coordinate of the display object.
+-- @param y (number) The new y coordinate of the display object.
+function M:setPosition(x, y)
+	self.object:setPosition(x, y)
+	return self
+end
+
+---
+-- Returns the x and y coordinates of the display object.
+--
+-- @function [parent=#DisplayObject] getPosition
+-- @param self
+-- @return The x and y coordinates of the display object.
+function M:getPosition()
+	return self.object:getPosition()
+end
+
+---
+-- Sets the rotation of the display object in degrees.
+--
+-- @function [parent=#DisplayObject] setRotation
+-- @param self
+-- @param rotation (number) rotation of the display object
+function M:setRotation(rotation)
+	self.object:setRotation(rotation)
+	return self
+end
+
+---
+-- Returns the rotation of the display object in degrees.
+--
+-- @function [parent=#DisplayObject] getRotation
+-- @param self
+-- @return Rotation of the display object.
+function M:getRotation()
+	return self.object:getRotation()
+end
+
+---
+-- Sets the horizontal scale of the display object.
+--
+-- @function [parent=#DisplayObject] setScaleX
+-- @param self
+-- @param x (number) horizontal scale of the display object
+function M:setScaleX(x)
+	self.object:setScaleX(x)
+	return self
+end
+
+---
+-- Returns the horizontal scale of the display object.
+--
+-- @function [parent=#DisplayObject] getScaleX
+-- @param self
+-- @return The horizontal scale (percentage) of the display object.
+function M:getScaleX()
+	return self.object:getScaleX()
+end
+
+---
+-- Sets the vertical scale of the display object.
+--
+-- @function [parent=#DisplayObject] setScaleY
+-- @param self
+-- @param y (number) vertical scale of the display object
+function M:setScaleY(y)
+	self.object:setScaleY(y)
+	return self
+end
+
+---
+-- Returns the vertical scale of the display object.
+--
+-- @function [parent=#DisplayObject] getScaleY
+-- @param self
+-- @return The vertical scale of the display object.
+function M:getScaleY()
+	return self.object:getScaleY()
+end
+
+---
+-- Sets the horizontal and vertical scales of the display object.
+--
+-- @function [parent=#DisplayObject] setScale
+-- @param self
+-- @param x (number) horizontal scale (percentage) of the display object
+-- @param y (number) vertical scale (percentage) of the display object
+function M:setScale(x, y)
+	self.object:setScale(x, y or x)
+	return self
+end
+
+---
+-- Returns the horizontal and vertical scales of the display object.
+--
+-- @function [parent=#DisplayObject] getScale
+-- @param self
+-- @return The horizontal and vertical scales of the display object
+function M:getScale()
+	return self.object:getScale()
+end
+
+---
+-- Sets the anchor point of the display object in percentage.
+--
+-- @function [parent=#DisplayObject] setAnchor
+-- @param self
+-- @param x (number) The horizontal percentage of anchor point.
+-- @param y (number) The vertical percentage of anchor point.
+function M:setAnchor(x, y)
+	self.object:setAnchor(x, y or x)
+	return self
+end
+
+---
+-- Returns the anchor point of the display object in percentage.
+--
+-- @function [parent=#DisplayObject] getAnchor
+-- @param self
+-- @return The anchor point of the display object in percentage.
+function M:getAnchor()
+	return self.object:getAnchor()
+end
+
+---
+-- Sets the alpha transparency of this display object. 0 means fully transparent and 1 means fully opaque.
+--
+-- @function [parent=#DisplayObject] setAlpha
+-- @param self
+-- @param alpha (number) The new alpha transparency of the display object
+function M:setAlpha(alpha)
+	self.object:setAlpha(alpha)
+	return self
+end
+
+---
+-- Returns the alpha transparency of this display object.
+--
+-- @function [parent=#DisplayObject] getAlpha
+-- @param self
+-- @return The alpha of the display object
+function M:getAlpha()
+	return self.object:getAlpha()
+end
+
+---
+-- Sets the alignment of this display object.
+--
+-- @function [parent=#DisplayObject] setAlignment
+-- @param self
+-- @param align the alignment of display object
+function M:setAlignment(align)
+	self.object:setAlignment(align)
+	return self
+end
+
+---
+-- Returns the alignment of this display object.
+--
+-- @function [parent=#DisplayObject] getAlignment
+-- @param self
+-- @return the alignment of display object
+function M:getAlignment()
+	return self.object:getAlignment()
+end
+
+---
+-- Sets whether or not the display object is visible. Display objects that are not visible are also taken
+-- into consideration while calculating bounds.
+--
+-- @function [parent=#DisplayObject] setVisible
+-- @param self
+-- @param visible (bool) whether or not the display object is visible
+function M:setVisible(visible)
+	self.object:setVisible(visible)
+	return self
+end
+
+---
+-- Returns whether or not the display object is visible.
+--
+-- @function [parent=#DisplayObject] getVisible
+-- @param self
+-- @return A value of 'true' if display object is visible; 'false' otherwise.
+function M:getVisible()
+	return self.object:getVisible()
+end
+
+---
+-- Sets whether or not the display object is touchable.
+--
+-- @function [parent=#DisplayObject] setTouchable
+-- @param self
+-- @param touchable (bool) whether or not the display object is touchable
+function M:setTouchable(touchable)
+	self.object:setTouchable(touchable)
+	return self
+end
+
+---
+-- Returns whether or not the display object is touchable.
+--
+-- @function [parent=#DisplayObject] getTouchable
+-- @param self
+-- @return A value of 'true' if display object is touchable; 'false' otherwise.
+function M:getTouchable()
+	return self.object:getTouchable()
+end
+---
+-- Update cache matrix that represents the transformation from the local coordinate system to another.
+--
+-- @function [parent=#DisplayObject] updateTransformMatrix
+-- @param self
+-- @param target (optional) The destination space of the transformation, nil for the screen space.
+function M:updateTransformMatrix(target)
+	local o = self.parent
+
+	self.object:initTransormMatrix()
+	while(o and o ~= target) do
+		self.object:upateTransformMatrix(o.object)
+		o = o.parent
+	end
+	return self
+end
+
+---
+-- Return a matrix that represents the transformation from the local coordinate system to another.
+--
+-- @function [parent=#DisplayObject] getTransformMatrix
+-- @param self
+-- @param target (optional) The destination space of the transformation, nil for the screen space.
+-- @return The transformation matrix of the display object to another
+function M:getTransformMatrix(target)
+	self:updateTransformMatrix(target)
+	return self.object:getTransformMatrix()
+end
+
+---
+-- Converts the x,y coordinates from the global to the display object's (local) coordinates.
+--
+-- @function [parent=#DisplayObject] globalToLocal
+-- @param self
+-- @param x (number) x coordinate of the global coordinate.
+-- @param y (number) y coordinate of the global coordinate.
+-- @param target (optional) The destination space of the transformation, nil for the screen space.
+-- @return x coordinate relative to the display object.
+-- @return y coordinate relative to the display object.
+function M:globalToLocal(x, y, target)
+	self:updateTransformMatrix(target)
+	return self.object:globalToLocal(x, y)
+end
+
+---
+-- Converts the x,y coordinates from the display object's (local) coordinates to the global coordinates.
+--
+-- @function [parent=#DisplayObject] localToGlobal
+-- @param self
+-- @param x (number) x coordinate of the local coordinate.
+-- @param y (number) y coordinate of the local coordinate.
+-- @param target (optional) The destination space of the transformation, nil for the screen space.
+-- @return x coordinate relative to the display area.
+-- @return y coordinate relative to the display area.
+function M:localToGlobal(x, y, target)
+	self:updateTransformMatrix(target)
+	return self.object:localToGlobal(x, y)
+end
+
+---
+-- Checks whether the given coordinates (in global coordinate system) is in bounds of the display object.
+--
+-- @function [parent=#DisplayObject] hitTestPoint
+-- @param self
+-- @param x (number)
+-- @param y (number)
+-- @param target (DisplayObject) The display object that defines the other coordinate system to transform
+-- @return 'true' if the given global coordinates are in bounds of the display object, 'false' otherwise.
+function M:hitTestPoint(x, y, target)
+	if self:getVisible() and self:getTouchable() then
+		self:updateTransformMatrix(target)
+		return self.object:hitTestPoint(x, y)
+	else
+		return false
+	end
+end
+
+---
+-- Returns a area (as x, y, w and h) that encloses the display object as
+-- it appears in another display object’s coordinate system.
+--
+-- @function [parent=#DisplayObject] getBounds
+-- @param self
+-- @param target (DisplayObject) The display object that defines the other coordinate system to transform
+-- @return area has 4 values as x, y, w and h of bounds
+function M:getBounds(target)
+	self:updateTransformMatrix(target)
+	return self.object:bounds()
+end
+
+---
+-- Perform a custom animation of a set of display object properties. Any running
+-- or queued animation is stopped first. Animations are advanced natively in one
+-- pass before each frame is rendered, and 'Event.ANIMATE_COMPLETE' is dispatched
+-- when one has finished.
+--
+-- @function [parent=#DisplayObject] animate
+-- @param self
+-- @param properties (table) The properties values that the animation will move toward. ['x' 'y' 'rotation' 'scalex' 'scaley' 'alpha'], any other key animates a numeric field of the display object.
+-- @param duration (number) Determining how long the animation will run in seconds.
+-- @param easing (#Easing) The string indicating which easing function to use for transition.
+-- The following easing functions can be used:
+-- "linear"
+-- "inSine"		"outSine"		"inOutSine"
+-- "inQuad"		"outQuad"		"inOutQuad"
+-- "inCubic"	"outCubic"		"inOutCubic"
+-- "inQuart"	"outQuart"		"inOutQuart"
+-- "inQuint"	"outQuint"		"inOutQuint"
+-- "inExpo"		"outExpo"		"inOutExpo"
+-- "inCirc"		"outCirc"		"inOutCirc"
+-- "inBack"		"outBack"		"inOutBack"
+-- "inElastic"	"outElastic"	"inOutElastic"
+-- "inBounce"	"outBounce"		"inOutBounce"
+-- @param callback (optional) The function called with the display object when the animation has finished.
+function M:animate(properties, duration, easing, callback)
+	if self.object:stopAnimate() then
+		self:dispatchEvent(Event.new(Event.ANIMATE_COMPLETE))
+	end
+
+	if not properties or type(properties) ~= "table" or not next(properties) then
+		return self
+	end
+
+	if duration and duration <= 0 then
+		return self
+	end
+
+	return self:queueAnimate(properties, duration, easing, callback)
+end
+
+---
+-- Queue a custom animation after the running and queued animations of display
+-- object, starting at once if there is none. The properties start from the values
+-- they have when the animation starts. An empty set of properties simply waits
+-- for the duration, which can be used to delay or to synchronize a sequence.
+--
+-- @function [parent=#DisplayObject] queueAnimate
+-- @param self
+-- @param properties (table) The properties values that the animation will move toward.
+-- @param duration (number) Determining how long the animation will run in seconds.
+-- @param easing (#Easing) The string indicating which easing function to use for transition.
+-- @param callback (optional) The function called with the display object when the animation has finished.
+function M:queueAnimate(properties, duration, easing, callback)
+	self.object:animate(properties or {}, duration or 1, easing, function(d)
+		d:dispatchEvent(Event.new(Event.ANIMATE_COMPLETE))
+		if callback then
+			callback(d)
+		end
+	end)
+	return self
+end
+
+---
+-- Stop the running animation of display object and discard the queued ones,
+-- leaving the properties at their current values.
+--
+-- @function [parent=#DisplayObject] stopAnimate
+-- @param self
+function M:stopAnimate()
+	self.object:stopAnimate()
+	return self
+end
+
+---
+-- Tests whether display object has a running animation.
+--
+-- @function [parent=#DisplayObject] isAnimating
+-- @param self
+-- @return 'true' if display object is animating, 'false' otherwise.
+function M:isAnimating()
+	return self.object:isAnimating()
+end
+
+---
+-- Layout display object and it's children to the screen.
+--
+-- @function [parent=#DisplayObject] layout
+-- @param self
+function M:layout()
+	local x1, y1, x2, y2
+	for i, v in ipairs(self.children) do
+		if v:getVisible() then
+			x1, y1, x2, y2 = self.object:layout(v.object, x1, y1, x2, y2)
+			v:layout()
+		end
+	end
+end
+
+---
+-- Marks the display object as changed, so the bitmap caches of the object and
+-- all of its ancestors are rebuilt on the next render. Subclasses call it
+-- whenever their drawn content changes without a change of size.
+--
+-- @function [parent=#DisplayObject] invalidate
+-- @param self
+function M:invalidate()
+	self.object:invalidate()
+	return self
+end
+
+---
+-- Sets whether or not the display object and it's children are cached as a bitmap.
+-- A cached subtree is rasterised once into an offscreen surface and then composited
+-- with the object's transform and alpha, until one of it's descendants changes.
+-- The alpha of the object applies to the whole cached subtree.
+--
+-- @function [parent=#DisplayObject] setCacheAsBitmap
+-- @param self
+-- @param cache (bool) whether or not the display object is cached as a bitmap
+function M:setCacheAsBitmap(cache)
+	self.object:setCache(cache)
+	return self
+end
+
+---
+-- Returns whether or not the display object is cached as a bitmap.
+--
+-- @function [parent=#DisplayObject] getCacheAsBitmap
+-- @param self
+-- @return A value of 'true' if display object is cached as a bitmap; 'false' otherwise.
+function M:getCacheAsBitmap()
+	return self.object:getCache()
+end
+
+---
+-- Adds a listener function for the specified event type. Display objects
+-- listening for 'Event.ENTER_FRAME' are flagged on the native object, so the
+-- renderer only visits those when dispatching the frame event.
+--
+-- @function [parent=#DisplayObject] addEventListener
+-- @param self
+-- @param type (string) The type of event.
+-- @param listener (function) The listener function that processes the event.
+-- @param data (optional) An optional data parameter that is passed as a first argument to the listener function.
+-- @param capture (optional) Whether the listener handles pointer events in the capturing phase instead of the bubbling phase.
+function M:addEventListener(type, listener, data, capture)
+	EventDispatcher.addEventListener(self, type, listener, data, capture)
+	if type == Event.ENTER_FRAME then
+		local els = self.eventListenersMap[type]
+		self.object:setEnterFrame(els and #els > 0)
+	end
+	return self
+end
+
+---
+-- Removes a listener function for the specified event type.
+--
+-- @function [parent=#DisplayObject] removeEventListener
+-- @param self
+-- @param type (string) The type of event.
+-- @param listener (function) The listener function that processes the event.
+-- @param data (optional) An optional data parameter that is passed as a first argument to the listener function.
+function M:removeEventListener(type, listener, data)
+	EventDispatcher.removeEventListener(self, type, listener, data)
+	if type == Event.ENTER_FRAME then
+		local els = self.eventListenersMap[type]
+		self.object:setEnterFrame(els and #els > 0)
+	end
+	return self
+end
+
+---
+-- Draw display object to the screen. Subclasses which register their content
+-- with the native object, like shapes, texts and images, need not override it.
+--
+-- @function [parent=#DisplayObject] __draw
+-- @param self
+-- @param display (Display) The context of the screen.
+function M:__draw(display)
+	display:drawObject(self.object)
+end
+
+---
+-- Render display object and it's children to the screen. The 'Event.ENTER_FRAME'
+-- event is dispatched to the listening display objects, then the whole tree is
+-- drawn by the native scene graph.
+--
+-- @function [parent=#DisplayObject] render
+-- @param self
+-- @param display (Display) The context of the screen.
+-- @param event (Event) The 'Event' object to be dispatched.
+function M:render(display, event)
+	if event and event.type ~= Event.ENTER_FRAME then
+		self:dispatch(event)
+		event = nil
+	end
+	self.object:setDrawHook(self.__draw ~= M.__draw)
+	display:render(self.object, event)
+end
+
+---
+-- Dispatches an event to display object and it's children.
+--
+-- Pointer events are routed to the topmost touchable display object under the
+-- point, travelling from this display object down to the target in the capturing
+-- phase and back up in the bubbling phase. A pressed pointer keeps the route it
+-- was pressed on until released. Other events are broadcast to the whole tree.
+--
+-- @function [parent=#DisplayObject] dispatch
+-- @param self
+-- @param event (Event) The 'Event' object to be dispatched.
+function M:dispatch(event)
+	local pointer = pointers[event.type]
+
+	if pointer and event.x and event.y then
+		local id = event.id or -1
+		local captures = self.__captures
+		if not captures then
+			captures = {}
+			self.__captures = captures
+		end
+
+		local path = captures[id]
+		if pointer == "begin" or not path then
+			local o = self.object:pick(event.x, event.y) or self
+			path = {}
+			while o and o ~= self do
+				table.insert(path, o)
+				o = o.parent
+			end
+			table.insert(path, self)
+		end
+		if pointer == "begin" then
+			captures[id] = path
+		elseif pointer == "end" then
+			captures[id] = nil
+		end
+
+		event.target = path[1]
+		event.phase = Event.CAPTURING_PHASE
+		for i = #path, 2, -1 do
+			path[i]:dispatchEvent(event)
+		end
+		event.phase = Event.AT_TARGET
+		path[1]:dispatchEvent(event)
+		event.phase = Event.BUBBLING_PHASE
+		for i = 2, #path do
+			path[i]:dispatchEvent(event)
+		end
+		return
+	end
+
+	local children = self.children
+
+	for i = #children, 1, -1 do
+		children[i]:dispatch(event)
+	end
+
+	self:dispatchEvent(event)
+end
+
+return M
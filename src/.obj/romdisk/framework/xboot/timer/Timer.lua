@@ -0,0 +1,61 @@
+---
+-- The 'Timer' class is used to execute a code at specified intervals.
+-- 
+-- @module Timer
+local M = Class()
+
+---
+-- Creates a new 'Timer' object with the specified delay and iteration.
+-- 
+-- @function [parent=#Timer] new
+-- @param delay (number) The delay in seconds
+-- @param iteration (number) The number of times listener is to be invoked. pass 0 if you want it to loop forever.
+-- @param listener (function) The listener to invoke after the delay, with the timer and a table of the elapsed "time" and the "count" of calls. The table is reused between calls.
+-- @param catchup (optional) What to do with the periods missed when the timer is scheduled late.
+-- "skip" fires once and keeps the timer's phase, which is the default.
+-- "burst" fires once for every missed period.
+-- "delay" fires once and restarts the period from then.
+-- @return New 'Timer' object.
+function M:init(delay, iteration, listener, catchup)
+	self.delay = delay or 1
+	self.iteration = iteration or 1
+	self.listener = listener
+	self.catchup = catchup or "skip"
+	self.running = true
+end
+
+---
+-- Returns the current running status of timer.
+-- 
+-- @function [parent=#Timer] isRunning
+-- @param self
+-- @return 'true' if the timer is running, 'false' otherwise.
+function M:isRunning()
+	return self.running
+end
+
+---
+-- Resumes the timer that was paused.
+--
+-- @function [parent=#Timer] resume
+-- @param self
+function M:resume()
+	self.running = true
+	if self.__wheel then
+		self.__wheel:resume(self)
+	end
+end
+
+---
+-- Pauses the timer that was running.
+--
+-- @function [parent=#Timer] pause
+-- @param self
+function M:pause()
+	self.running = false
+	if self.__wheel then
+		self.__wheel:pause(self)
+	end
+end
+
+return M
@@ -0,0 +1,77 @@
+---
+-- The 'TimerManager' class is used to manager timer.
+-- 
+-- @module TimerManager
+local M = Class()
+
+---
+-- Creates a new 'TimerManager' object. Timers are kept in a native timer wheel,
+-- so registering, removing and looking up a timer cost the same however many
+-- timers are registered, and scheduling only visits the timers that expire.
+-- 
+-- @function [parent=#TimerManager] new
+-- @return New 'TimerManager' object.
+function M:init()
+	self.wheel = TimerWheel.new()
+end
+
+---
+-- Checks if the 'TimerManager' object has a timer.
+-- 
+-- @function [parent=#TimerManager] hasTimer
+-- @param self
+-- @param timer (Timer) The timer was registered.
+-- @return A value of 'true' if a timer is registered; 'false' otherwise.
+function M:hasTimer(timer)
+	if not timer then
+		return false
+	end
+
+	return self.wheel:has(timer)
+end
+
+--- 
+-- Registers a timer
+-- 
+-- @function [parent=#TimerManager] addTimer
+-- @param self
+-- @param timer (Timer) The timer will be registered.
+-- @return A value of 'true' or 'false'.
+function M:addTimer(timer)
+	if not timer or not self.wheel:add(timer) then
+		return false
+	end
+
+	timer.__wheel = self.wheel
+	return true
+end
+
+---
+-- Removes a timer from the 'TimerManager'. A timer may remove itself or any
+-- other timer from within it's listener.
+-- 
+-- @function [parent=#TimerManager] removeTimer
+-- @param self
+-- @param timer (Timer) The timer will be removed.
+-- @return A value of 'true' or 'false'.
+function M:removeTimer(timer)
+	if not timer or not self.wheel:remove(timer) then
+		return false
+	end
+
+	timer:pause()
+	timer.__wheel = nil
+	return true
+end
+
+---
+-- Schedule timers according to time interval.
+-- 
+-- @function [parent=#TimerManager] schedule
+-- @param self
+-- @param dt (number) The time delta in seconds.
+function M:schedule(dt)
+	self.wheel:schedule(dt)
+end
+
+return M
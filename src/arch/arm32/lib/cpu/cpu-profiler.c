@@ -2,29 +2,103 @@
  * cpu-profiler.c
  */
 
+#include <xboot.h>
 #include <pmu.h>
 
+/*
+ * Generic profiler event to armv7 pmu event and counter mapping, the cycle
+ * counter is dedicated, others are allocated in order of importance, so that
+ * cores with only four event counters still provide the common events.
+ */
+static const struct {
+	int event;
+	int counter;
+} pmu_map[PROFILER_EVENT_MAX] = {
+	{ CYCLE,				-1 },
+	{ INSTRUCTION,			 0 },
+	{ L1DCACHE_ACCESS,		 3 },
+	{ L1DCACHE_MISS,		 1 },
+	{ PREDICTABLE_BRANCH,	 4 },
+	{ MISPREDICTED_BRANCH,	 2 },
+};
+static uint32_t pmu_last[PROFILER_EVENT_MAX];
+static uint64_t pmu_high[PROFILER_EVENT_MAX];
+
+static inline int pmu_index(int event)
+{
+	if((event & PROFILER_EVENT_ALL) == 0)
+		return -1;
+	return __builtin_ctz(event);
+}
+
 void cpu_profiler_start(int event, int data)
 {
-	pmn_config(data, event);
-	pmn_enable(data);
+	int i = pmu_index(event);
+
+	if(i < 0)
+		return;
+	pmu_enable();
+	pmu_user_enable();
+	if(pmu_map[i].counter < 0)
+	{
+		ccnt_divider(0);
+		ccnt_enable();
+	}
+	else if(pmu_map[i].counter < pmn_number())
+	{
+		pmn_config(pmu_map[i].counter, pmu_map[i].event);
+		pmn_enable(pmu_map[i].counter);
+	}
 }
 
 void cpu_profiler_stop(int event, int data)
 {
-	pmn_disable(data);
+	int i = pmu_index(event);
+
+	if(i < 0)
+		return;
+	if(pmu_map[i].counter < 0)
+		ccnt_disable();
+	else if(pmu_map[i].counter < pmn_number())
+		pmn_disable(pmu_map[i].counter);
 }
 
 uint64_t cpu_profiler_read(int event, int data)
 {
-	return pmn_read(data);
+	int i = pmu_index(event);
+	uint32_t value;
+
+	if(i < 0)
+		return 0;
+	if(pmu_map[i].counter < 0)
+		value = ccnt_read();
+	else if(pmu_map[i].counter < pmn_number())
+		value = pmn_read(pmu_map[i].counter);
+	else
+		return 0;
+
+	/*
+	 * Extend the 32-bits hardware counter to 64-bits, the counter must be
+	 * read at least once per wrap period.
+	 */
+	if(value < pmu_last[i])
+		pmu_high[i] += 0x100000000ULL;
+	pmu_last[i] = value;
+	return pmu_high[i] | value;
 }
 
 void cpu_profiler_reset(void)
 {
+	int i;
+
 	pmu_enable();
 	pmu_user_enable();
 	pmn_reset();
 	ccnt_reset();
 	ccnt_divider(0);
+	for(i = 0; i < PROFILER_EVENT_MAX; i++)
+	{
+		pmu_last[i] = 0;
+		pmu_high[i] = 0;
+	}
 }
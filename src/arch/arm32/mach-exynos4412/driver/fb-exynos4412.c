@@ -639,6 +639,8 @@ static struct device_t * fb_exynos4412_probe(struct driver_t * drv, struct dtnod
 	fb->create = fb_create;
 	fb->destroy = fb_destroy;
 	fb->present = fb_present;
+	fb->flip = NULL;
+	fb->vsync = NULL;
 	fb->priv = pdat;
 	fb_exynos4412_init(pdat);
 
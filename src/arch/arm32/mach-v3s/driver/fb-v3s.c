@@ -54,6 +54,9 @@ struct fb_v3s_pdata_t
 	int bytes_per_pixel;
 	int index;
 	void * vram[2];
+	u64_t vcount;
+	u64_t vperiod;
+	ktime_t vstamp;
 
 	struct {
 		int pixel_clock_hz;
@@ -281,14 +284,14 @@ static struct render_t * fb_create(struct framebuffer_t * fb)
 	size_t pixlen;
 
 	pixlen = pdat->width * pdat->height * pdat->bytes_per_pixel;
-	pixels = memalign(4, pixlen);
+	pixels = dma_alloc_noncoherent(pixlen);
 	if(!pixels)
 		return NULL;
 
 	render = malloc(sizeof(struct render_t));
 	if(!render)
 	{
-		free(pixels);
+		dma_free_noncoherent(pixels);
 		return NULL;
 	}
 
@@ -307,7 +310,7 @@ static void fb_destroy(struct framebuffer_t * fb, struct render_t * render)
 {
 	if(render)
 	{
-		free(render->pixels);
+		dma_free_noncoherent(render->pixels);
 		free(render);
 	}
 }
@@ -326,6 +329,39 @@ static void fb_present(struct framebuffer_t * fb, struct render_t * render, stru
 	}
 }
 
+static void fb_flip(struct framebuffer_t * fb, struct render_t * render)
+{
+	struct fb_v3s_pdata_t * pdat = (struct fb_v3s_pdata_t *)fb->priv;
+
+	if(render && render->pixels)
+	{
+		dma_cache_sync(render->pixels, render->pixlen, DMA_TO_DEVICE);
+		v3s_de_set_address(pdat, render->pixels);
+		v3s_de_enable(pdat);
+	}
+}
+
+static u64_t fb_vsync(struct framebuffer_t * fb)
+{
+	struct fb_v3s_pdata_t * pdat = (struct fb_v3s_pdata_t *)fb->priv;
+	struct v3s_tcon_reg_t * tcon = (struct v3s_tcon_reg_t *)pdat->virttcon;
+	ktime_t timeout = ktime_add_ms(ktime_get(), 50);
+	ktime_t now;
+	u64_t n;
+
+	write32((virtual_addr_t)&tcon->int0, read32((virtual_addr_t)&tcon->int0) & ~(1 << 15));
+	while(!(read32((virtual_addr_t)&tcon->int0) & (1 << 15)))
+	{
+		if(ktime_after(ktime_get(), timeout))
+			break;
+	}
+	now = ktime_get();
+	n = (ktime_to_ns(ktime_sub(now, pdat->vstamp)) + pdat->vperiod / 2) / pdat->vperiod;
+	pdat->vcount += (n > 0) ? n : 1;
+	pdat->vstamp = now;
+	return pdat->vcount;
+}
+
 static struct device_t * fb_v3s_probe(struct driver_t * drv, struct dtnode_t * n)
 {
 	struct fb_v3s_pdata_t * pdat;
@@ -376,6 +412,11 @@ static struct device_t * fb_v3s_probe(struct driver_t * drv, struct dtnode_t * n
 	pdat->timing.v_sync_active = dt_read_bool(n, "vsync-active", 0);
 	pdat->timing.den_active = dt_read_bool(n, "den-active", 0);
 	pdat->timing.clk_active = dt_read_bool(n, "clk-active", 0);
+	pdat->vcount = 0;
+	pdat->vperiod = (u64_t)(pdat->width + pdat->timing.h_front_porch + pdat->timing.h_back_porch + pdat->timing.h_sync_len)
+		* (pdat->height + pdat->timing.v_front_porch + pdat->timing.v_back_porch + pdat->timing.v_sync_len)
+		* 1000000000ULL / pdat->timing.pixel_clock_hz;
+	pdat->vstamp = ktime_get();
 	pdat->backlight = search_led(dt_read_string(n, "backlight", NULL));
 
 	fb->name = alloc_device_name(dt_read_name(n), -1);
@@ -389,6 +430,8 @@ static struct device_t * fb_v3s_probe(struct driver_t * drv, struct dtnode_t * n
 	fb->create = fb_create;
 	fb->destroy = fb_destroy;
 	fb->present = fb_present;
+	fb->flip = fb_flip;
+	fb->vsync = fb_vsync;
 	fb->priv = pdat;
 
 	clk_enable(pdat->clkde);
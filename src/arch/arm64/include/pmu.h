@@ -0,0 +1,169 @@
+#ifndef __ARM64_PMU_H__
+#define __ARM64_PMU_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <types.h>
+#include <stdint.h>
+#include <arm64.h>
+
+enum {
+	SW_INCR						= 0x00,
+	L1I_CACHE_REFILL			= 0x01,
+	L1I_TLB_REFILL				= 0x02,
+	L1D_CACHE_REFILL			= 0x03,
+	L1D_CACHE					= 0x04,
+	L1D_TLB_REFILL				= 0x05,
+	LD_RETIRED					= 0x06,
+	ST_RETIRED					= 0x07,
+	INST_RETIRED				= 0x08,
+	EXC_TAKEN					= 0x09,
+	EXC_RETURN					= 0x0A,
+	CID_WRITE_RETIRED			= 0x0B,
+	PC_WRITE_RETIRED			= 0x0C,
+	BR_IMMED_RETIRED			= 0x0D,
+	BR_RETURN_RETIRED			= 0x0E,
+	UNALIGNED_LDST_RETIRED		= 0x0F,
+	BR_MIS_PRED					= 0x10,
+	CPU_CYCLES					= 0x11,
+	BR_PRED						= 0x12,
+	MEM_ACCESS					= 0x13,
+	L1I_CACHE					= 0x14,
+	L1D_CACHE_WB				= 0x15,
+	L2D_CACHE					= 0x16,
+	L2D_CACHE_REFILL			= 0x17,
+	L2D_CACHE_WB				= 0x18,
+	BUS_ACCESS					= 0x19,
+	MEMORY_ERROR				= 0x1A,
+	INST_SPEC					= 0x1B,
+	TTBR_WRITE_RETIRED			= 0x1C,
+	BUS_CYCLES					= 0x1D,
+	CHAIN						= 0x1E,
+	L1D_CACHE_ALLOCATE			= 0x1F,
+	L2D_CACHE_ALLOCATE			= 0x20,
+	BR_RETIRED					= 0x21,
+	BR_MIS_PRED_RETIRED			= 0x22,
+	STALL_FRONTEND				= 0x23,
+	STALL_BACKEND				= 0x24,
+	L1D_TLB						= 0x25,
+	L1I_TLB						= 0x26,
+};
+
+static inline void pmu_enable(void)
+{
+	uint64_t value = arm64_read_sysreg(pmcr_el0);
+	value |= (1 << 0);
+	arm64_write_sysreg(pmcr_el0, value);
+}
+
+static inline void pmu_disable(void)
+{
+	uint64_t value = arm64_read_sysreg(pmcr_el0);
+	value &= ~(1 << 0);
+	arm64_write_sysreg(pmcr_el0, value);
+}
+
+static inline void pmu_user_enable(void)
+{
+	uint64_t value = arm64_read_sysreg(pmuserenr_el0);
+	value |= (1 << 0);
+	arm64_write_sysreg(pmuserenr_el0, value);
+}
+
+static inline void pmu_user_disable(void)
+{
+	uint64_t value = arm64_read_sysreg(pmuserenr_el0);
+	value &= ~(1 << 0);
+	arm64_write_sysreg(pmuserenr_el0, value);
+}
+
+static inline void pmn_reset(void)
+{
+	uint64_t value = arm64_read_sysreg(pmcr_el0);
+	value |= (1 << 1);
+	arm64_write_sysreg(pmcr_el0, value);
+}
+
+static inline void pmn_enable(int counter)
+{
+	uint64_t value = 0x1 << counter;
+	arm64_write_sysreg(pmcntenset_el0, value);
+}
+
+static inline void pmn_disable(int counter)
+{
+	uint64_t value = 0x1 << counter;
+	arm64_write_sysreg(pmcntenclr_el0, value);
+}
+
+static inline uint32_t pmn_number(void)
+{
+	uint64_t value = arm64_read_sysreg(pmcr_el0);
+	return (value >> 11) & 0x1f;
+}
+
+static inline void pmn_config(uint32_t counter, uint32_t event)
+{
+	uint64_t value = event & 0xffff;
+	arm64_write_sysreg(pmselr_el0, (uint64_t)(counter & 0x1f));
+	arm64_write_sysreg(pmxevtyper_el0, value);
+}
+
+static inline uint32_t pmn_read(uint32_t counter)
+{
+	arm64_write_sysreg(pmselr_el0, (uint64_t)(counter & 0x1f));
+	return (uint32_t)arm64_read_sysreg(pmxevcntr_el0);
+}
+
+static inline void ccnt_reset(void)
+{
+	uint64_t value = arm64_read_sysreg(pmcr_el0);
+	value |= (1 << 2);
+	arm64_write_sysreg(pmcr_el0, value);
+}
+
+static inline void ccnt_enable(void)
+{
+	uint64_t value = (1ULL << 31);
+	arm64_write_sysreg(pmccfiltr_el0, (uint64_t)0);
+	arm64_write_sysreg(pmcntenset_el0, value);
+}
+
+static inline void ccnt_disable(void)
+{
+	uint64_t value = (1ULL << 31);
+	arm64_write_sysreg(pmcntenclr_el0, value);
+}
+
+static inline void ccnt_long(int enable)
+{
+	uint64_t value = arm64_read_sysreg(pmcr_el0);
+	if(enable)
+		value |= (1 << 6);
+	else
+		value &= ~(1 << 6);
+	arm64_write_sysreg(pmcr_el0, value);
+}
+
+static inline uint64_t ccnt_read(void)
+{
+	return arm64_read_sysreg(pmccntr_el0);
+}
+
+static inline uint32_t overflow_read(void)
+{
+	return (uint32_t)arm64_read_sysreg(pmovsclr_el0);
+}
+
+static inline void overflow_write(uint32_t value)
+{
+	arm64_write_sysreg(pmovsclr_el0, (uint64_t)value);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ARM64_PMU_H__ */
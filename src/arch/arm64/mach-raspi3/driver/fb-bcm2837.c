@@ -138,6 +138,8 @@ static struct device_t * fb_bcm2837_probe(struct driver_t * drv, struct dtnode_t
 	fb->create = fb_create;
 	fb->destroy = fb_destroy;
 	fb->present = fb_present;
+	fb->flip = NULL;
+	fb->vsync = NULL;
 	fb->priv = pdat;
 
 	if(!register_framebuffer(&dev, fb))
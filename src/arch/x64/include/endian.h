@@ -9,7 +9,7 @@ extern "C" {
 #define BIG_ENDIAN		(0x4321)
 
 #if ( !defined(__LITTLE_ENDIAN) && !defined(__BIG_ENDIAN) )
-#define __BIG_ENDIAN
+#define __LITTLE_ENDIAN
 #endif
 
 #if defined(__LITTLE_ENDIAN)
@@ -0,0 +1,140 @@
+/*
+ * aes128.c
+ *
+ * Aes128 block encryption and decryption by the aes-ni instructions, four
+ * independent blocks are interleaved to hide the latency of aesenc and
+ * aesdec. Selected at run time when cpuid reports them, otherwise the
+ * table driven code is used. The decryption keys are the encryption ones
+ * in reverse through aesimc, made on each call as the context only keeps
+ * the expanded encryption key.
+ */
+
+#include <stdint.h>
+#include <cpuid.h>
+#include <aes128.h>
+
+typedef long long v2di __attribute__((vector_size(16)));
+typedef long long v2du __attribute__((vector_size(16), aligned(1), may_alias));
+
+#define load(p)				(*(const v2du *)(p))
+#define store(p, x)			(*(v2du *)(p) = (x))
+
+extern void __aes128_encrypt_blocks(struct aes128_ctx_t * ctx, const uint8_t * in, uint8_t * out, size_t blks);
+extern void __aes128_decrypt_blocks(struct aes128_ctx_t * ctx, const uint8_t * in, uint8_t * out, size_t blks);
+
+static int aes128_ni = -1;
+
+static inline int aes128_ni_check(void)
+{
+	unsigned int a, b, c, d;
+
+	if(aes128_ni < 0)
+		aes128_ni = (__get_cpuid(1, &a, &b, &c, &d) && (c & bit_AES)) ? 1 : 0;
+	return aes128_ni;
+}
+
+static __attribute__((target("aes"))) void aes128_ni_crypt(const v2di * k, int enc, const uint8_t * in, uint8_t * out, size_t blks)
+{
+	v2di x0, x1, x2, x3;
+	int i;
+
+	while(blks >= 4)
+	{
+		x0 = load(in + 0) ^ k[0];
+		x1 = load(in + 16) ^ k[0];
+		x2 = load(in + 32) ^ k[0];
+		x3 = load(in + 48) ^ k[0];
+		if(enc)
+		{
+			for(i = 1; i < 10; i++)
+			{
+				x0 = __builtin_ia32_aesenc128(x0, k[i]);
+				x1 = __builtin_ia32_aesenc128(x1, k[i]);
+				x2 = __builtin_ia32_aesenc128(x2, k[i]);
+				x3 = __builtin_ia32_aesenc128(x3, k[i]);
+			}
+			x0 = __builtin_ia32_aesenclast128(x0, k[10]);
+			x1 = __builtin_ia32_aesenclast128(x1, k[10]);
+			x2 = __builtin_ia32_aesenclast128(x2, k[10]);
+			x3 = __builtin_ia32_aesenclast128(x3, k[10]);
+		}
+		else
+		{
+			for(i = 1; i < 10; i++)
+			{
+				x0 = __builtin_ia32_aesdec128(x0, k[i]);
+				x1 = __builtin_ia32_aesdec128(x1, k[i]);
+				x2 = __builtin_ia32_aesdec128(x2, k[i]);
+				x3 = __builtin_ia32_aesdec128(x3, k[i]);
+			}
+			x0 = __builtin_ia32_aesdeclast128(x0, k[10]);
+			x1 = __builtin_ia32_aesdeclast128(x1, k[10]);
+			x2 = __builtin_ia32_aesdeclast128(x2, k[10]);
+			x3 = __builtin_ia32_aesdeclast128(x3, k[10]);
+		}
+		store(out + 0, x0);
+		store(out + 16, x1);
+		store(out + 32, x2);
+		store(out + 48, x3);
+		in += 64;
+		out += 64;
+		blks -= 4;
+	}
+	while(blks--)
+	{
+		x0 = load(in) ^ k[0];
+		if(enc)
+		{
+			for(i = 1; i < 10; i++)
+				x0 = __builtin_ia32_aesenc128(x0, k[i]);
+			x0 = __builtin_ia32_aesenclast128(x0, k[10]);
+		}
+		else
+		{
+			for(i = 1; i < 10; i++)
+				x0 = __builtin_ia32_aesdec128(x0, k[i]);
+			x0 = __builtin_ia32_aesdeclast128(x0, k[10]);
+		}
+		store(out, x0);
+		in += 16;
+		out += 16;
+	}
+}
+
+static __attribute__((target("aes"))) void aes128_ni_decrypt(struct aes128_ctx_t * ctx, const uint8_t * in, uint8_t * out, size_t blks)
+{
+	v2di k[11];
+	int i;
+
+	k[0] = load(&ctx->xkey[160]);
+	for(i = 1; i < 10; i++)
+		k[i] = __builtin_ia32_aesimc128(load(&ctx->xkey[(10 - i) * 16]));
+	k[10] = load(&ctx->xkey[0]);
+	aes128_ni_crypt(k, 0, in, out, blks);
+}
+
+static void aes128_ni_encrypt(struct aes128_ctx_t * ctx, const uint8_t * in, uint8_t * out, size_t blks)
+{
+	v2di k[11];
+	int i;
+
+	for(i = 0; i < 11; i++)
+		k[i] = load(&ctx->xkey[i * 16]);
+	aes128_ni_crypt(k, 1, in, out, blks);
+}
+
+void aes128_encrypt_blocks(struct aes128_ctx_t * ctx, const uint8_t * in, uint8_t * out, size_t blks)
+{
+	if(aes128_ni_check())
+		aes128_ni_encrypt(ctx, in, out, blks);
+	else
+		__aes128_encrypt_blocks(ctx, in, out, blks);
+}
+
+void aes128_decrypt_blocks(struct aes128_ctx_t * ctx, const uint8_t * in, uint8_t * out, size_t blks)
+{
+	if(aes128_ni_check())
+		aes128_ni_decrypt(ctx, in, out, blks);
+	else
+		__aes128_decrypt_blocks(ctx, in, out, blks);
+}
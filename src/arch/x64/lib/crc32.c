@@ -0,0 +1,98 @@
+/*
+ * crc32.c
+ *
+ * Crc32 by carry-less multiplication, folding 64 bytes per step with the
+ * pclmulqdq instruction. Selected at run time when the cpu has pclmulqdq,
+ * otherwise the slice by 8 tables are used. The constants are
+ * the bit reflected ones for the 0xedb88320 polynomial from the intel paper
+ * "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ".
+ */
+
+#include <stdint.h>
+#include <cpuid.h>
+#include <crc32.h>
+
+/*
+ * The intrinsic headers pull in the host stdlib, so use the builtins directly
+ */
+typedef long long v2di __attribute__((vector_size(16)));
+typedef int v4si __attribute__((vector_size(16)));
+typedef long long v2du __attribute__((vector_size(16), aligned(1), may_alias));
+
+#define clmul(a, b, i)	__builtin_ia32_pclmulqdq128((a), (b), (i))
+#define load(p)			(*(const v2du *)(p))
+
+extern uint32_t __crc32_sum(uint32_t crc, const uint8_t * buf, int len);
+
+static const v2di k1k2 = { 0x0154442bd4, 0x01c6e41596 };
+static const v2di k3k4 = { 0x01751997d0, 0x00ccaa009e };
+static const v2di k5k0 = { 0x0163cd6124, 0x0000000000 };
+static const v2di poly = { 0x01db710641, 0x01f7011641 };
+static const v2di mask = { 0x00ffffffff, 0x00ffffffff };
+
+static int crc32_pclmul = -1;
+
+/*
+ * Fold a multiple of 16 bytes, at least 64, with the crc not inverted.
+ */
+static __attribute__((target("pclmul"))) uint32_t crc32_fold(uint32_t crc, const uint8_t * buf, int len)
+{
+	v2di x1, x2, x3, x4;
+
+	x1 = load(buf + 0x00) ^ (v2di){ crc, 0 };
+	x2 = load(buf + 0x10);
+	x3 = load(buf + 0x20);
+	x4 = load(buf + 0x30);
+	buf += 64;
+	len -= 64;
+
+	while(len >= 64)
+	{
+		x1 = clmul(x1, k1k2, 0x00) ^ clmul(x1, k1k2, 0x11) ^ load(buf + 0x00);
+		x2 = clmul(x2, k1k2, 0x00) ^ clmul(x2, k1k2, 0x11) ^ load(buf + 0x10);
+		x3 = clmul(x3, k1k2, 0x00) ^ clmul(x3, k1k2, 0x11) ^ load(buf + 0x20);
+		x4 = clmul(x4, k1k2, 0x00) ^ clmul(x4, k1k2, 0x11) ^ load(buf + 0x30);
+		buf += 64;
+		len -= 64;
+	}
+
+	/*
+	 * Fold the four lanes into one, then the remaining 16 bytes blocks
+	 */
+	x1 = clmul(x1, k3k4, 0x00) ^ clmul(x1, k3k4, 0x11) ^ x2;
+	x1 = clmul(x1, k3k4, 0x00) ^ clmul(x1, k3k4, 0x11) ^ x3;
+	x1 = clmul(x1, k3k4, 0x00) ^ clmul(x1, k3k4, 0x11) ^ x4;
+	while(len >= 16)
+	{
+		x1 = clmul(x1, k3k4, 0x00) ^ clmul(x1, k3k4, 0x11) ^ load(buf);
+		buf += 16;
+		len -= 16;
+	}
+
+	/*
+	 * Fold 128 bits to 64 bits, then barrett reduce to 32 bits
+	 */
+	x1 = clmul(x1, k3k4, 0x10) ^ (v2di){ x1[1], 0 };
+	x2 = (v2di)__builtin_shuffle((v4si)x1, (v4si){ 0 }, (v4si){ 1, 2, 3, 4 });
+	x1 = clmul(x1 & mask, k5k0, 0x00) ^ x2;
+	x2 = clmul(x1 & mask, poly, 0x10) & mask;
+	x1 = clmul(x2, poly, 0x00) ^ x1;
+	return ((v4si)x1)[1];
+}
+
+uint32_t crc32_sum(uint32_t crc, const uint8_t * buf, int len)
+{
+	unsigned int a, b, c, d;
+	int n;
+
+	if(crc32_pclmul < 0)
+		crc32_pclmul = (__get_cpuid(1, &a, &b, &c, &d) && (c & bit_PCLMUL)) ? 1 : 0;
+	if(crc32_pclmul && (len >= 64))
+	{
+		n = len & ~15;
+		crc = ~crc32_fold(~crc, buf, n);
+		buf += n;
+		len -= n;
+	}
+	return __crc32_sum(crc, buf, len);
+}
@@ -0,0 +1,103 @@
+/*
+ * sha1.c
+ *
+ * Sha1 block transform by the sha extensions, four rounds per sha1rnds4
+ * with the message schedule from sha1msg1, sha1msg2 and sha1nexte.
+ * Selected at run time when cpuid reports them, otherwise the portable
+ * transform is used.
+ */
+
+#include <stdint.h>
+#include <cpuid.h>
+#include <sha1.h>
+
+typedef int v4si __attribute__((vector_size(16)));
+typedef unsigned int v4ui __attribute__((vector_size(16)));
+typedef char v16qi __attribute__((vector_size(16)));
+typedef int v4su __attribute__((vector_size(16), aligned(1), may_alias));
+
+#define add(a, b)			((v4si)((v4ui)(a) + (v4ui)(b)))
+#define load(p)				(*(const v4su *)(p))
+#define bswap(x)			((v4si)__builtin_shuffle((v16qi)(x), (v16qi){ 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 }))
+
+extern void __sha1_blocks(uint32_t * state, const uint8_t * data, size_t blocks);
+
+static int sha1_ni = -1;
+
+/*
+ * Four rounds on the message words in w, e is the running e for these
+ * rounds and f receives abcd for the next ones. The schedule is updated
+ * four groups ahead, the conditions are constant, so they fold away.
+ */
+#define ROUND4(i, w, prev, prev2, next, e, f) \
+	do { \
+		e = ((i) == 0) ? add(e, w) : __builtin_ia32_sha1nexte(e, w); \
+		f = abcd; \
+		if(((i) >= 3) && ((i) <= 18)) \
+			next = __builtin_ia32_sha1msg2(next, w); \
+		abcd = __builtin_ia32_sha1rnds4(abcd, e, (i) / 5); \
+		if(((i) >= 1) && ((i) <= 16)) \
+			prev = __builtin_ia32_sha1msg1(prev, w); \
+		if(((i) >= 2) && ((i) <= 17)) \
+			prev2 ^= w; \
+	} while(0)
+
+static __attribute__((target("sha"))) void sha1_ni_blocks(uint32_t * state, const uint8_t * data, size_t blocks)
+{
+	v4si abcd, e0, e1, abcd_save, e0_save;
+	v4si w0, w1, w2, w3;
+
+	abcd = load(&state[0]);
+	abcd = __builtin_shuffle(abcd, (v4si){ 3, 2, 1, 0 });
+	e0 = (v4si){ 0, 0, 0, (int)state[4] };
+
+	while(blocks--)
+	{
+		abcd_save = abcd;
+		e0_save = e0;
+		w0 = bswap(load(data + 0));
+		w1 = bswap(load(data + 16));
+		w2 = bswap(load(data + 32));
+		w3 = bswap(load(data + 48));
+
+		ROUND4( 0, w0, w3, w2, w1, e0, e1);
+		ROUND4( 1, w1, w0, w3, w2, e1, e0);
+		ROUND4( 2, w2, w1, w0, w3, e0, e1);
+		ROUND4( 3, w3, w2, w1, w0, e1, e0);
+		ROUND4( 4, w0, w3, w2, w1, e0, e1);
+		ROUND4( 5, w1, w0, w3, w2, e1, e0);
+		ROUND4( 6, w2, w1, w0, w3, e0, e1);
+		ROUND4( 7, w3, w2, w1, w0, e1, e0);
+		ROUND4( 8, w0, w3, w2, w1, e0, e1);
+		ROUND4( 9, w1, w0, w3, w2, e1, e0);
+		ROUND4(10, w2, w1, w0, w3, e0, e1);
+		ROUND4(11, w3, w2, w1, w0, e1, e0);
+		ROUND4(12, w0, w3, w2, w1, e0, e1);
+		ROUND4(13, w1, w0, w3, w2, e1, e0);
+		ROUND4(14, w2, w1, w0, w3, e0, e1);
+		ROUND4(15, w3, w2, w1, w0, e1, e0);
+		ROUND4(16, w0, w3, w2, w1, e0, e1);
+		ROUND4(17, w1, w0, w3, w2, e1, e0);
+		ROUND4(18, w2, w1, w0, w3, e0, e1);
+		ROUND4(19, w3, w2, w1, w0, e1, e0);
+
+		e0 = __builtin_ia32_sha1nexte(e0, e0_save);
+		abcd = add(abcd, abcd_save);
+		data += 64;
+	}
+
+	*(v4su *)&state[0] = __builtin_shuffle(abcd, (v4si){ 3, 2, 1, 0 });
+	state[4] = e0[3];
+}
+
+void sha1_blocks(uint32_t * state, const uint8_t * data, size_t blocks)
+{
+	unsigned int a, b, c, d;
+
+	if(sha1_ni < 0)
+		sha1_ni = (__get_cpuid_count(7, 0, &a, &b, &c, &d) && (b & bit_SHA)) ? 1 : 0;
+	if(sha1_ni)
+		sha1_ni_blocks(state, data, blocks);
+	else
+		__sha1_blocks(state, data, blocks);
+}
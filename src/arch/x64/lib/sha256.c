@@ -0,0 +1,117 @@
+/*
+ * sha256.c
+ *
+ * Sha256 block transform by the sha extensions, four rounds per pair of
+ * sha256rnds2 with the message schedule from sha256msg1 and sha256msg2.
+ * Selected at run time when cpuid reports them, otherwise the portable
+ * transform is used. The state is kept as abef and cdgh while hashing.
+ */
+
+#include <stdint.h>
+#include <cpuid.h>
+#include <sha256.h>
+
+typedef int v4si __attribute__((vector_size(16)));
+typedef unsigned int v4ui __attribute__((vector_size(16)));
+typedef char v16qi __attribute__((vector_size(16)));
+typedef int v4su __attribute__((vector_size(16), aligned(1), may_alias));
+
+#define add(a, b)			((v4si)((v4ui)(a) + (v4ui)(b)))
+#define load(p)				(*(const v4su *)(p))
+#define bswap(x)			((v4si)__builtin_shuffle((v16qi)(x), (v16qi){ 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 }))
+
+extern void __sha256_blocks(uint32_t * state, const uint8_t * data, size_t blocks);
+
+static const uint32_t K[64] __attribute__((aligned(16))) =
+{
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static int sha256_ni = -1;
+
+/*
+ * Four rounds on the message words in w, updating the schedule four
+ * groups ahead. The conditions are constant, so they fold away.
+ */
+#define ROUND4(i, w, prev, next) \
+	do { \
+		m = add(w, *(const v4si *)&K[(i) * 4]); \
+		s1 = __builtin_ia32_sha256rnds2(s1, s0, m); \
+		if(((i) >= 3) && ((i) < 15)) \
+			next = __builtin_ia32_sha256msg2(add(next, __builtin_shuffle(prev, w, (v4si){ 1, 2, 3, 4 })), w); \
+		s0 = __builtin_ia32_sha256rnds2(s0, s1, __builtin_shuffle(m, (v4si){ 2, 3, 0, 1 })); \
+		if(((i) >= 1) && ((i) < 13)) \
+			prev = __builtin_ia32_sha256msg1(prev, w); \
+	} while(0)
+
+static __attribute__((target("sha"))) void sha256_ni_blocks(uint32_t * state, const uint8_t * data, size_t blocks)
+{
+	v4si s0, s1, t, m, abef, cdgh;
+	v4si w0, w1, w2, w3;
+
+	t = load(&state[0]);
+	s1 = load(&state[4]);
+	s0 = __builtin_shuffle(t, s1, (v4si){ 5, 4, 1, 0 });
+	s1 = __builtin_shuffle(t, s1, (v4si){ 7, 6, 3, 2 });
+
+	while(blocks--)
+	{
+		abef = s0;
+		cdgh = s1;
+		w0 = bswap(load(data + 0));
+		w1 = bswap(load(data + 16));
+		w2 = bswap(load(data + 32));
+		w3 = bswap(load(data + 48));
+
+		ROUND4( 0, w0, w3, w1);
+		ROUND4( 1, w1, w0, w2);
+		ROUND4( 2, w2, w1, w3);
+		ROUND4( 3, w3, w2, w0);
+		ROUND4( 4, w0, w3, w1);
+		ROUND4( 5, w1, w0, w2);
+		ROUND4( 6, w2, w1, w3);
+		ROUND4( 7, w3, w2, w0);
+		ROUND4( 8, w0, w3, w1);
+		ROUND4( 9, w1, w0, w2);
+		ROUND4(10, w2, w1, w3);
+		ROUND4(11, w3, w2, w0);
+		ROUND4(12, w0, w3, w1);
+		ROUND4(13, w1, w0, w2);
+		ROUND4(14, w2, w1, w3);
+		ROUND4(15, w3, w2, w0);
+
+		s0 = add(s0, abef);
+		s1 = add(s1, cdgh);
+		data += 64;
+	}
+
+	*(v4su *)&state[0] = __builtin_shuffle(s0, s1, (v4si){ 3, 2, 7, 6 });
+	*(v4su *)&state[4] = __builtin_shuffle(s0, s1, (v4si){ 1, 0, 5, 4 });
+}
+
+void sha256_blocks(uint32_t * state, const uint8_t * data, size_t blocks)
+{
+	unsigned int a, b, c, d;
+
+	if(sha256_ni < 0)
+		sha256_ni = (__get_cpuid_count(7, 0, &a, &b, &c, &d) && (b & bit_SHA)) ? 1 : 0;
+	if(sha256_ni)
+		sha256_ni_blocks(state, data, blocks);
+	else
+		__sha256_blocks(state, data, blocks);
+}
@@ -0,0 +1,37 @@
+/*
+ * cpu-profiler.c
+ */
+
+#include <xboot.h>
+#include <sandbox.h>
+
+/*
+ * The sandbox counters are backed by the host perf_event_open, with the
+ * generic profiler event bit mapped to perf hardware event index.
+ */
+static inline int perf_index(int event)
+{
+	if((event & PROFILER_EVENT_ALL) == 0)
+		return -1;
+	return __builtin_ctz(event);
+}
+
+void cpu_profiler_start(int event, int data)
+{
+	sandbox_perf_start(perf_index(event));
+}
+
+void cpu_profiler_stop(int event, int data)
+{
+	sandbox_perf_stop(perf_index(event));
+}
+
+uint64_t cpu_profiler_read(int event, int data)
+{
+	return sandbox_perf_read(perf_index(event));
+}
+
+void cpu_profiler_reset(void)
+{
+	sandbox_perf_reset();
+}
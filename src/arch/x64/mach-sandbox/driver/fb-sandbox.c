@@ -106,6 +106,12 @@ static void fb_present(struct framebuffer_t * fb, struct render_t * render, stru
 	sandbox_sdl_fb_surface_present(pdat->priv, render->priv);
 }
 
+static void fb_flip(struct framebuffer_t * fb, struct render_t * render)
+{
+	struct fb_sandbox_pdata_t * pdat = (struct fb_sandbox_pdata_t *)fb->priv;
+	sandbox_sdl_fb_surface_present(pdat->priv, render->priv);
+}
+
 static struct device_t * fb_sandbox_probe(struct driver_t * drv, struct dtnode_t * n)
 {
 	struct fb_sandbox_pdata_t * pdat;
@@ -146,6 +152,8 @@ static struct device_t * fb_sandbox_probe(struct driver_t * drv, struct dtnode_t
 	fb->create = fb_create;
 	fb->destroy = fb_destroy;
 	fb->present = fb_present;
+	fb->flip = fb_flip;
+	fb->vsync = NULL;
 	fb->priv = pdat;
 
 	if(!register_framebuffer(&dev, fb))
@@ -0,0 +1,202 @@
+/*
+ * driver/nor-sandbox.c
+ *
+ * Copyright(c) 2007-2018 Jianjun Jiang <8192542@qq.com>
+ * Official site: http://xboot.org
+ * Mobile phone: +86-18665388956
+ * QQ: 8192542
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <xboot.h>
+#include <block/ftl.h>
+#include <sandbox.h>
+
+/*
+ * Nor flash simulated by an image file on the host, erasing sets the bits
+ * of a whole erase block and programming can only clear them.
+ */
+struct nor_sandbox_pdata_t {
+	int fd;
+	u8_t * mem;
+	struct ftl_flash_t flash;
+};
+
+static bool_t nor_sandbox_sync(struct nor_sandbox_pdata_t * pdat, u64_t addr, u32_t count)
+{
+	sandbox_file_seek(pdat->fd, addr);
+	return (sandbox_file_write(pdat->fd, pdat->mem + addr, count) == count) ? TRUE : FALSE;
+}
+
+static bool_t nor_sandbox_read(struct ftl_flash_t * flash, u64_t addr, u8_t * buf, u32_t count)
+{
+	struct nor_sandbox_pdata_t * pdat = (struct nor_sandbox_pdata_t *)flash->priv;
+
+	if(addr + count > flash->capacity)
+		return FALSE;
+	memcpy(buf, pdat->mem + addr, count);
+	return TRUE;
+}
+
+static bool_t nor_sandbox_program(struct ftl_flash_t * flash, u64_t addr, u8_t * buf, u32_t count)
+{
+	struct nor_sandbox_pdata_t * pdat = (struct nor_sandbox_pdata_t *)flash->priv;
+	u32_t i;
+
+	if(addr + count > flash->capacity)
+		return FALSE;
+	for(i = 0; i < count; i++)
+		pdat->mem[addr + i] &= buf[i];
+	return nor_sandbox_sync(pdat, addr, count);
+}
+
+static bool_t nor_sandbox_erase(struct ftl_flash_t * flash, u64_t addr)
+{
+	struct nor_sandbox_pdata_t * pdat = (struct nor_sandbox_pdata_t *)flash->priv;
+
+	addr &= ~((u64_t)flash->erasesz - 1);
+	if(addr + flash->erasesz > flash->capacity)
+		return FALSE;
+	memset(pdat->mem + addr, 0xff, flash->erasesz);
+	return nor_sandbox_sync(pdat, addr, flash->erasesz);
+}
+
+static struct device_t * nor_sandbox_probe(struct driver_t * drv, struct dtnode_t * n)
+{
+	struct nor_sandbox_pdata_t * pdat;
+	struct block_t * blk;
+	struct device_t * dev;
+	char * path = dt_read_string(n, "path", "nor.img");
+	u64_t size = dt_read_long(n, "size", 4 * 1024 * 1024);
+	u32_t erasesz = dt_read_int(n, "erase-size", 4096);
+	u64_t len;
+	int fd;
+
+	if((erasesz == 0) || (erasesz & (erasesz - 1)) || (size < erasesz))
+		return NULL;
+	size &= ~((u64_t)erasesz - 1);
+
+	fd = sandbox_file_open(path, "r+");
+	if(fd <= 0)
+		fd = sandbox_file_open(path, "w+");
+	if(fd <= 0)
+		return NULL;
+
+	pdat = malloc(sizeof(struct nor_sandbox_pdata_t));
+	if(!pdat)
+	{
+		sandbox_file_close(fd);
+		return NULL;
+	}
+
+	pdat->mem = malloc(size);
+	if(!pdat->mem)
+	{
+		sandbox_file_close(fd);
+		free(pdat);
+		return NULL;
+	}
+	memset(pdat->mem, 0xff, size);
+	len = sandbox_file_length(fd);
+	if(len > size)
+		len = size;
+	sandbox_file_seek(fd, 0);
+	if(len > 0)
+		sandbox_file_read(fd, pdat->mem, len);
+
+	pdat->fd = fd;
+	pdat->flash.erasesz = erasesz;
+	pdat->flash.capacity = size;
+	pdat->flash.read = nor_sandbox_read;
+	pdat->flash.program = nor_sandbox_program;
+	pdat->flash.erase = nor_sandbox_erase;
+	pdat->flash.priv = pdat;
+	if(len < size)
+		nor_sandbox_sync(pdat, len, size - len);
+
+	blk = ftl_alloc(&pdat->flash);
+	if(!blk)
+	{
+		sandbox_file_close(fd);
+		free(pdat->mem);
+		free(pdat);
+		return NULL;
+	}
+	blk->name = alloc_device_name(dt_read_name(n), dt_read_id(n));
+
+	if(!register_block(&dev, blk))
+	{
+		sandbox_file_close(fd);
+		free_device_name(blk->name);
+		ftl_free(blk);
+		free(pdat->mem);
+		free(pdat);
+		return NULL;
+	}
+	dev->driver = drv;
+
+	return dev;
+}
+
+static void nor_sandbox_remove(struct device_t * dev)
+{
+	struct block_t * blk = (struct block_t *)dev->priv;
+	struct nor_sandbox_pdata_t * pdat;
+
+	if(blk && unregister_block(blk))
+	{
+		pdat = (struct nor_sandbox_pdata_t *)ftl_flash(blk)->priv;
+		sandbox_file_close(pdat->fd);
+		free_device_name(blk->name);
+		ftl_free(blk);
+		free(pdat->mem);
+		free(pdat);
+	}
+}
+
+static void nor_sandbox_suspend(struct device_t * dev)
+{
+}
+
+static void nor_sandbox_resume(struct device_t * dev)
+{
+}
+
+static struct driver_t nor_sandbox = {
+	.name		= "nor-sandbox",
+	.probe		= nor_sandbox_probe,
+	.remove		= nor_sandbox_remove,
+	.suspend	= nor_sandbox_suspend,
+	.resume		= nor_sandbox_resume,
+};
+
+static __init void nor_sandbox_driver_init(void)
+{
+	register_driver(&nor_sandbox);
+}
+
+static __exit void nor_sandbox_driver_exit(void)
+{
+	unregister_driver(&nor_sandbox);
+}
+
+driver_initcall(nor_sandbox_driver_init);
+driver_exitcall(nor_sandbox_driver_exit);
@@ -0,0 +1,494 @@
+/*
+ * driver/spi-sandbox.c
+ *
+ * Copyright(c) 2007-2018 Jianjun Jiang <8192542@qq.com>
+ * Official site: http://xboot.org
+ * Mobile phone: +86-18665388956
+ * QQ: 8192542
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <xboot.h>
+#include <spi/spi.h>
+#include <sandbox.h>
+
+/*
+ * Spi bus with a simulated quad spi nor flash on chip select 0, backed by
+ * an image file on the host. The flash answers sfdp, and every phase of a
+ * command is checked against the lanes it must be sent on, so a read on
+ * the wrong lanes or a quad read without the quad enable bit returns junk
+ * like the real part would.
+ */
+struct spi_sandbox_pdata_t {
+	int fd;
+	u8_t * mem;
+	u32_t size;
+	u8_t sfdp[128];
+	u8_t sr1;
+	u8_t sr2;
+	int wel;
+	int addr4;
+	int selected;
+
+	u8_t cmd;
+	int phase;
+	int hlen;
+	int alen;
+	int htype;
+	int dtype;
+	u8_t h[8];
+	int hn;
+	int dn;
+	u32_t addr;
+	int bad;
+	u32_t lo;
+	u32_t hi;
+};
+
+static void spi_sandbox_sfdp_put(struct spi_sandbox_pdata_t * pdat, int off, u32_t v)
+{
+	pdat->sfdp[off + 0] = (v >> 0) & 0xff;
+	pdat->sfdp[off + 1] = (v >> 8) & 0xff;
+	pdat->sfdp[off + 2] = (v >> 16) & 0xff;
+	pdat->sfdp[off + 3] = (v >> 24) & 0xff;
+}
+
+static void spi_sandbox_sfdp_init(struct spi_sandbox_pdata_t * pdat)
+{
+	memset(pdat->sfdp, 0xff, sizeof(pdat->sfdp));
+	/* Sfdp header and the basic flash parameter header, jesd216b */
+	memcpy(&pdat->sfdp[0], "SFDP", 4);
+	pdat->sfdp[4] = 6;
+	pdat->sfdp[5] = 1;
+	pdat->sfdp[6] = 0;
+	pdat->sfdp[7] = 0xff;
+	pdat->sfdp[8] = 0x00;
+	pdat->sfdp[9] = 6;
+	pdat->sfdp[10] = 1;
+	pdat->sfdp[11] = 16;
+	spi_sandbox_sfdp_put(pdat, 12, 0xff000030);
+	memset(&pdat->sfdp[0x30], 0, 64);
+	/* 4k erase 20h, 1-1-2, 1-2-2, 1-4-4 and 1-1-4 fast reads */
+	spi_sandbox_sfdp_put(pdat, 0x30, (1 << 22) | (1 << 21) | (1 << 20) | (1 << 16) | (0x20 << 8) | (1 << 2) | (1 << 0));
+	spi_sandbox_sfdp_put(pdat, 0x34, pdat->size * 8 - 1);
+	/* 1-4-4 ebh with 2 mode and 4 dummy clocks, 1-1-4 6bh with 8 dummy clocks */
+	spi_sandbox_sfdp_put(pdat, 0x38, (0x6b << 24) | (0 << 21) | (8 << 16) | (0xeb << 8) | (2 << 5) | (4 << 0));
+	/* 1-1-2 3bh with 8 dummy clocks, 1-2-2 bbh with 4 mode clocks */
+	spi_sandbox_sfdp_put(pdat, 0x3c, (0xbb << 24) | (4 << 21) | (0 << 16) | (0x3b << 8) | (0 << 5) | (8 << 0));
+	/* 4k, 32k and 64k erase */
+	spi_sandbox_sfdp_put(pdat, 0x4c, (0x52 << 24) | (15 << 16) | (0x20 << 8) | (12 << 0));
+	spi_sandbox_sfdp_put(pdat, 0x50, (0xd8 << 8) | (16 << 0));
+	/* 256 bytes page */
+	spi_sandbox_sfdp_put(pdat, 0x58, (8 << 4));
+	/* Quad enable is bit 1 of status register 2, read with 35h and written with 01h */
+	spi_sandbox_sfdp_put(pdat, 0x68, (5 << 20));
+}
+
+static void spi_sandbox_sync(struct spi_sandbox_pdata_t * pdat)
+{
+	if(pdat->lo < pdat->hi)
+	{
+		sandbox_file_seek(pdat->fd, pdat->lo);
+		sandbox_file_write(pdat->fd, pdat->mem + pdat->lo, pdat->hi - pdat->lo);
+	}
+	pdat->lo = 0xffffffff;
+	pdat->hi = 0;
+}
+
+static void spi_sandbox_dirty(struct spi_sandbox_pdata_t * pdat, u32_t addr, u32_t len)
+{
+	if(addr < pdat->lo)
+		pdat->lo = addr;
+	if(addr + len > pdat->hi)
+		pdat->hi = addr + len;
+}
+
+static void spi_sandbox_command(struct spi_sandbox_pdata_t * pdat, u8_t cmd)
+{
+	int alen = pdat->addr4 ? 4 : 3;
+	int qe = (pdat->sr2 & 0x02) ? 1 : 0;
+
+	pdat->cmd = cmd;
+	pdat->alen = 0;
+	pdat->hlen = 0;
+	pdat->htype = SPI_TYPE_SINGLE;
+	pdat->dtype = SPI_TYPE_SINGLE;
+	switch(cmd)
+	{
+	case 0x03:
+	case 0x02:
+	case 0x20:
+	case 0x52:
+	case 0xd8:
+		pdat->alen = alen;
+		pdat->hlen = alen;
+		break;
+	case 0x0b:
+		pdat->alen = alen;
+		pdat->hlen = alen + 1;
+		break;
+	case 0x5a:
+		pdat->alen = 3;
+		pdat->hlen = 4;
+		break;
+	case 0x3b:
+		pdat->alen = alen;
+		pdat->hlen = alen + 1;
+		pdat->dtype = SPI_TYPE_DUAL;
+		break;
+	case 0xbb:
+		pdat->alen = alen;
+		pdat->hlen = alen + 1;
+		pdat->htype = SPI_TYPE_DUAL;
+		pdat->dtype = SPI_TYPE_DUAL;
+		break;
+	case 0x6b:
+		pdat->alen = alen;
+		pdat->hlen = alen + 1;
+		pdat->dtype = SPI_TYPE_QUAD;
+		pdat->bad |= !qe;
+		break;
+	case 0xeb:
+		pdat->alen = alen;
+		pdat->hlen = alen + 3;
+		pdat->htype = SPI_TYPE_QUAD;
+		pdat->dtype = SPI_TYPE_QUAD;
+		pdat->bad |= !qe;
+		break;
+	default:
+		break;
+	}
+}
+
+static void spi_sandbox_feed(struct spi_sandbox_pdata_t * pdat, u8_t c, int type)
+{
+	int i;
+
+	if(pdat->phase == 0)
+	{
+		pdat->bad |= (type != SPI_TYPE_SINGLE);
+		spi_sandbox_command(pdat, c);
+		pdat->phase = 1;
+	}
+	else if(pdat->hn < pdat->hlen)
+	{
+		pdat->bad |= (type != pdat->htype);
+		pdat->h[pdat->hn++] = c;
+		if(pdat->hn == pdat->alen)
+		{
+			for(i = 0, pdat->addr = 0; i < pdat->alen; i++)
+				pdat->addr = (pdat->addr << 8) | pdat->h[i];
+		}
+	}
+	else
+	{
+		pdat->bad |= (type != pdat->dtype);
+		switch(pdat->cmd)
+		{
+		case 0x01:
+			if(pdat->wel && (pdat->dn == 0))
+				pdat->sr1 = c & 0xfc;
+			else if(pdat->wel && (pdat->dn == 1))
+				pdat->sr2 = c;
+			break;
+		case 0x31:
+			if(pdat->wel && (pdat->dn == 0))
+				pdat->sr2 = c;
+			break;
+		case 0x02:
+			if(pdat->wel && !pdat->bad)
+			{
+				i = (pdat->addr & ~0xff) | ((pdat->addr + pdat->dn) & 0xff);
+				if(i < pdat->size)
+				{
+					pdat->mem[i] &= c;
+					spi_sandbox_dirty(pdat, i, 1);
+				}
+			}
+			break;
+		default:
+			break;
+		}
+		pdat->dn++;
+	}
+}
+
+static u8_t spi_sandbox_out(struct spi_sandbox_pdata_t * pdat, int type)
+{
+	u32_t addr;
+	u8_t c = 0xff;
+
+	if((pdat->phase == 0) || (pdat->hn < pdat->hlen) || (type != pdat->dtype))
+		pdat->bad = 1;
+	if(pdat->bad)
+		return 0xa5;
+	switch(pdat->cmd)
+	{
+	case 0x05:
+		c = pdat->sr1 | (pdat->wel ? 0x02 : 0x00);
+		break;
+	case 0x35:
+		c = pdat->sr2;
+		break;
+	case 0x9f:
+		c = (pdat->dn == 0) ? 0xef : ((pdat->dn == 1) ? 0x40 : 0x17);
+		break;
+	case 0x5a:
+		addr = pdat->addr + pdat->dn;
+		c = (addr < sizeof(pdat->sfdp)) ? pdat->sfdp[addr] : 0xff;
+		break;
+	case 0x03:
+	case 0x0b:
+	case 0x3b:
+	case 0xbb:
+	case 0x6b:
+	case 0xeb:
+		addr = (pdat->addr + pdat->dn) % pdat->size;
+		c = pdat->mem[addr];
+		break;
+	default:
+		break;
+	}
+	pdat->dn++;
+	return c;
+}
+
+static void spi_sandbox_finish(struct spi_sandbox_pdata_t * pdat)
+{
+	u32_t sz = 0, addr;
+
+	if(pdat->phase == 0)
+		return;
+	switch(pdat->cmd)
+	{
+	case 0x06:
+		pdat->wel = 1;
+		return;
+	case 0x04:
+		pdat->wel = 0;
+		return;
+	case 0xb7:
+		pdat->addr4 = 1;
+		return;
+	case 0xe9:
+		pdat->addr4 = 0;
+		return;
+	case 0x99:
+		pdat->addr4 = 0;
+		pdat->wel = 0;
+		return;
+	case 0x20:
+		sz = 4096;
+		break;
+	case 0x52:
+		sz = 32768;
+		break;
+	case 0xd8:
+		sz = 65536;
+		break;
+	case 0x01:
+	case 0x31:
+	case 0x02:
+		pdat->wel = 0;
+		spi_sandbox_sync(pdat);
+		return;
+	default:
+		return;
+	}
+	if(pdat->wel && !pdat->bad && (pdat->hn == pdat->hlen))
+	{
+		addr = pdat->addr & ~(sz - 1);
+		if(addr + sz <= pdat->size)
+		{
+			memset(pdat->mem + addr, 0xff, sz);
+			spi_sandbox_dirty(pdat, addr, sz);
+			spi_sandbox_sync(pdat);
+		}
+	}
+	pdat->wel = 0;
+}
+
+static int spi_sandbox_transfer(struct spi_t * spi, struct spi_msg_t * msg)
+{
+	struct spi_sandbox_pdata_t * pdat = (struct spi_sandbox_pdata_t *)spi->priv;
+	u8_t * tx = msg->txbuf;
+	u8_t * rx = msg->rxbuf;
+	int i;
+
+	if(!pdat->selected)
+		return msg->len;
+	for(i = 0; i < msg->len; i++)
+	{
+		if(tx)
+			spi_sandbox_feed(pdat, tx[i], msg->type);
+		else if(rx)
+			rx[i] = spi_sandbox_out(pdat, msg->type);
+	}
+	return msg->len;
+}
+
+static void spi_sandbox_select(struct spi_t * spi, int cs)
+{
+	struct spi_sandbox_pdata_t * pdat = (struct spi_sandbox_pdata_t *)spi->priv;
+
+	if(cs == 0)
+	{
+		pdat->selected = 1;
+		pdat->phase = 0;
+		pdat->hn = 0;
+		pdat->dn = 0;
+		pdat->bad = 0;
+	}
+}
+
+static void spi_sandbox_deselect(struct spi_t * spi, int cs)
+{
+	struct spi_sandbox_pdata_t * pdat = (struct spi_sandbox_pdata_t *)spi->priv;
+
+	if((cs == 0) && pdat->selected)
+	{
+		spi_sandbox_finish(pdat);
+		pdat->selected = 0;
+	}
+}
+
+static struct device_t * spi_sandbox_probe(struct driver_t * drv, struct dtnode_t * n)
+{
+	struct spi_sandbox_pdata_t * pdat;
+	struct spi_t * spi;
+	struct device_t * dev;
+	char * path = dt_read_string(n, "path", "spinor.img");
+	u32_t size = dt_read_int(n, "size", 8 * 1024 * 1024);
+	u64_t len;
+	int fd;
+
+	if((size < 65536) || (size > 16 * 1024 * 1024) || (size & (size - 1)))
+		return NULL;
+
+	fd = sandbox_file_open(path, "r+");
+	if(fd <= 0)
+		fd = sandbox_file_open(path, "w+");
+	if(fd <= 0)
+		return NULL;
+
+	pdat = malloc(sizeof(struct spi_sandbox_pdata_t));
+	if(!pdat)
+	{
+		sandbox_file_close(fd);
+		return NULL;
+	}
+	memset(pdat, 0, sizeof(struct spi_sandbox_pdata_t));
+
+	pdat->mem = malloc(size);
+	if(!pdat->mem)
+	{
+		sandbox_file_close(fd);
+		free(pdat);
+		return NULL;
+	}
+
+	spi = malloc(sizeof(struct spi_t));
+	if(!spi)
+	{
+		sandbox_file_close(fd);
+		free(pdat->mem);
+		free(pdat);
+		return NULL;
+	}
+
+	memset(pdat->mem, 0xff, size);
+	len = sandbox_file_length(fd);
+	if(len > size)
+		len = size;
+	sandbox_file_seek(fd, 0);
+	if(len > 0)
+		sandbox_file_read(fd, pdat->mem, len);
+	pdat->fd = fd;
+	pdat->size = size;
+	pdat->lo = len;
+	pdat->hi = size;
+	spi_sandbox_sync(pdat);
+	spi_sandbox_sfdp_init(pdat);
+
+	spi->name = alloc_device_name(dt_read_name(n), dt_read_id(n));
+	spi->type = SPI_TYPE_SINGLE | SPI_TYPE_DUAL | SPI_TYPE_QUAD;
+	spi->transfer = spi_sandbox_transfer;
+	spi->select = spi_sandbox_select;
+	spi->deselect = spi_sandbox_deselect;
+	spi->priv = pdat;
+
+	if(!register_spi(&dev, spi))
+	{
+		sandbox_file_close(fd);
+		free(pdat->mem);
+		free_device_name(spi->name);
+		free(spi->priv);
+		free(spi);
+		return NULL;
+	}
+	dev->driver = drv;
+
+	return dev;
+}
+
+static void spi_sandbox_remove(struct device_t * dev)
+{
+	struct spi_t * spi = (struct spi_t *)dev->priv;
+	struct spi_sandbox_pdata_t * pdat = (struct spi_sandbox_pdata_t *)spi->priv;
+
+	if(spi && unregister_spi(spi))
+	{
+		sandbox_file_close(pdat->fd);
+		free(pdat->mem);
+		free_device_name(spi->name);
+		free(spi->priv);
+		free(spi);
+	}
+}
+
+static void spi_sandbox_suspend(struct device_t * dev)
+{
+}
+
+static void spi_sandbox_resume(struct device_t * dev)
+{
+}
+
+static struct driver_t spi_sandbox = {
+	.name		= "spi-sandbox",
+	.probe		= spi_sandbox_probe,
+	.remove		= spi_sandbox_remove,
+	.suspend	= spi_sandbox_suspend,
+	.resume		= spi_sandbox_resume,
+};
+
+static __init void spi_sandbox_driver_init(void)
+{
+	register_driver(&spi_sandbox);
+}
+
+static __exit void spi_sandbox_driver_exit(void)
+{
+	unregister_driver(&spi_sandbox);
+}
+
+driver_initcall(spi_sandbox_driver_init);
+driver_exitcall(spi_sandbox_driver_exit);
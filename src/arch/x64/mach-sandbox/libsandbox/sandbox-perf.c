@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <sandbox.h>
+
+static const uint64_t perf_config[] = {
+	PERF_COUNT_HW_CPU_CYCLES,
+	PERF_COUNT_HW_INSTRUCTIONS,
+	PERF_COUNT_HW_CACHE_REFERENCES,
+	PERF_COUNT_HW_CACHE_MISSES,
+	PERF_COUNT_HW_BRANCH_INSTRUCTIONS,
+	PERF_COUNT_HW_BRANCH_MISSES,
+};
+static int perf_fd[sizeof(perf_config) / sizeof(perf_config[0])] = { -1, -1, -1, -1, -1, -1 };
+
+static inline int perf_valid(int event)
+{
+	return ((event >= 0) && (event < sizeof(perf_config) / sizeof(perf_config[0]))) ? 1 : 0;
+}
+
+void sandbox_perf_start(int event)
+{
+	struct perf_event_attr attr;
+
+	if(!perf_valid(event) || (perf_fd[event] >= 0))
+		return;
+	memset(&attr, 0, sizeof(struct perf_event_attr));
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.size = sizeof(struct perf_event_attr);
+	attr.config = perf_config[event];
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	perf_fd[event] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+	if(perf_fd[event] < 0)
+		return;
+	ioctl(perf_fd[event], PERF_EVENT_IOC_RESET, 0);
+	ioctl(perf_fd[event], PERF_EVENT_IOC_ENABLE, 0);
+}
+
+void sandbox_perf_stop(int event)
+{
+	if(!perf_valid(event) || (perf_fd[event] < 0))
+		return;
+	ioctl(perf_fd[event], PERF_EVENT_IOC_DISABLE, 0);
+	close(perf_fd[event]);
+	perf_fd[event] = -1;
+}
+
+uint64_t sandbox_perf_read(int event)
+{
+	uint64_t value;
+
+	if(!perf_valid(event) || (perf_fd[event] < 0))
+		return 0;
+	if(read(perf_fd[event], &value, sizeof(uint64_t)) != sizeof(uint64_t))
+		return 0;
+	return value;
+}
+
+void sandbox_perf_reset(void)
+{
+	int i;
+
+	for(i = 0; i < sizeof(perf_config) / sizeof(perf_config[0]); i++)
+	{
+		if(perf_fd[i] >= 0)
+			ioctl(perf_fd[i], PERF_EVENT_IOC_RESET, 0);
+	}
+}
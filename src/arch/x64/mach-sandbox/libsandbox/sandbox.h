@@ -115,6 +115,14 @@ void sandbox_sdl_timer_set_next(int delay, void (*cb)(void *), void * data);
 uint64_t sandbox_get_time_counter(void);
 uint64_t sandbox_get_time_frequency(void);
 
+/*
+ * Perf interface
+ */
+void sandbox_perf_start(int event);
+void sandbox_perf_stop(int event);
+uint64_t sandbox_perf_read(int event);
+void sandbox_perf_reset(void);
+
 /*
  * Sysfs interface
  */
@@ -0,0 +1,537 @@
+/*
+ * driver/block/ftl.c
+ *
+ * Copyright(c) 2007-2018 Jianjun Jiang <8192542@qq.com>
+ * Official site: http://xboot.org
+ * Mobile phone: +86-18665388956
+ * QQ: 8192542
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <xboot.h>
+#include <block/ftl.h>
+
+/*
+ * Log structured flash translation layer for nor flash.
+ *
+ * Every erase block starts with a header, then a tag per slot, then the
+ * slots of 512 bytes sector data. Sectors are never rewritten in place,
+ * each write goes to the next free slot of the head block, so a write only
+ * programs flash and never erases it. The data is programmed before its
+ * tag, and every word of the header and the tags is paired with its
+ * complement, so a program or erase cut by a power loss can never look
+ * valid and the previous copy of the sector stays the current one.
+ *
+ * At mount the used blocks are replayed in the order they were opened to
+ * rebuild the sector map. Blocks are reclaimed by a garbage collector which
+ * picks the block with the fewest valid sectors, and the coldest block is
+ * moved when the erase counts drift too far apart.
+ */
+#define FTL_MAGIC				(0x304c5446)
+#define FTL_SECTOR_SIZE			(512)
+#define FTL_NONE				(0xffffffff)
+#define FTL_WEAR_THRESHOLD		(64)
+
+struct ftl_header_t {
+	u32_t magic;
+	u32_t ec;
+	u32_t nec;
+	u32_t seq;
+	u32_t nseq;
+	u32_t reserved[3];
+} __attribute__ ((packed));
+
+struct ftl_tag_t {
+	u32_t lsn;
+	u32_t nlsn;
+} __attribute__ ((packed));
+
+enum {
+	FTL_BLOCK_BLANK		= 0,
+	FTL_BLOCK_FREE		= 1,
+	FTL_BLOCK_USED		= 2,
+	FTL_BLOCK_DIRTY		= 3,
+};
+
+struct ftl_t {
+	struct ftl_flash_t * flash;
+	u32_t nblocks;
+	u32_t slots;
+	u32_t nsectors;
+	u32_t * map;
+	u32_t * ec;
+	u16_t * valid;
+	u8_t * state;
+	u32_t seq;
+	u32_t head;
+	u32_t next;
+	u32_t nfree;
+	u8_t buf[FTL_SECTOR_SIZE];
+};
+
+struct ftl_order_t {
+	u32_t seq;
+	u32_t block;
+};
+
+static inline u64_t ftl_block_addr(struct ftl_t * ftl, u32_t b)
+{
+	return (u64_t)b * ftl->flash->erasesz;
+}
+
+static inline u64_t ftl_tag_addr(struct ftl_t * ftl, u32_t phys)
+{
+	return ftl_block_addr(ftl, phys / ftl->slots) + sizeof(struct ftl_header_t) + (phys % ftl->slots) * sizeof(struct ftl_tag_t);
+}
+
+static inline u64_t ftl_data_addr(struct ftl_t * ftl, u32_t phys)
+{
+	return ftl_block_addr(ftl, phys / ftl->slots) + sizeof(struct ftl_header_t) + ftl->slots * sizeof(struct ftl_tag_t) + (phys % ftl->slots) * FTL_SECTOR_SIZE;
+}
+
+static bool_t ftl_read_tag(struct ftl_t * ftl, u32_t phys, u32_t * lsn)
+{
+	struct ftl_tag_t tag;
+
+	if(!ftl->flash->read(ftl->flash, ftl_tag_addr(ftl, phys), (u8_t *)&tag, sizeof(struct ftl_tag_t)))
+		return FALSE;
+	tag.lsn = le32_to_cpu(tag.lsn);
+	tag.nlsn = le32_to_cpu(tag.nlsn);
+	if(((tag.lsn ^ tag.nlsn) != 0xffffffff) || (tag.lsn >= ftl->nsectors))
+		return FALSE;
+	*lsn = tag.lsn;
+	return TRUE;
+}
+
+static bool_t ftl_format(struct ftl_t * ftl, u32_t b)
+{
+	u32_t h[3];
+
+	h[0] = cpu_to_le32(FTL_MAGIC);
+	h[1] = cpu_to_le32(ftl->ec[b]);
+	h[2] = cpu_to_le32(~ftl->ec[b]);
+	return ftl->flash->program(ftl->flash, ftl_block_addr(ftl, b), (u8_t *)h, sizeof(h));
+}
+
+static bool_t ftl_erase(struct ftl_t * ftl, u32_t b)
+{
+	if((ftl->state[b] == FTL_BLOCK_FREE) || (ftl->state[b] == FTL_BLOCK_BLANK))
+		ftl->nfree--;
+	ftl->state[b] = FTL_BLOCK_DIRTY;
+	ftl->valid[b] = 0;
+	if(!ftl->flash->erase(ftl->flash, ftl_block_addr(ftl, b)))
+		return FALSE;
+	ftl->ec[b]++;
+	if(!ftl_format(ftl, b))
+		return FALSE;
+	ftl->state[b] = FTL_BLOCK_FREE;
+	ftl->nfree++;
+	return TRUE;
+}
+
+static bool_t ftl_erased(struct ftl_t * ftl, u64_t addr, u32_t len)
+{
+	u32_t n, i;
+
+	while(len > 0)
+	{
+		n = (len < FTL_SECTOR_SIZE) ? len : FTL_SECTOR_SIZE;
+		if(!ftl->flash->read(ftl->flash, addr, ftl->buf, n))
+			return FALSE;
+		for(i = 0; i < n; i++)
+		{
+			if(ftl->buf[i] != 0xff)
+				return FALSE;
+		}
+		addr += n;
+		len -= n;
+	}
+	return TRUE;
+}
+
+/*
+ * Open the free block with the lowest erase count as the new head.
+ */
+static bool_t ftl_open(struct ftl_t * ftl)
+{
+	u32_t b, best = FTL_NONE;
+	u32_t s[2];
+
+	for(b = 0; b < ftl->nblocks; b++)
+	{
+		if((ftl->state[b] == FTL_BLOCK_FREE) || (ftl->state[b] == FTL_BLOCK_BLANK))
+		{
+			if((best == FTL_NONE) || (ftl->ec[b] < ftl->ec[best]))
+				best = b;
+		}
+	}
+	if(best == FTL_NONE)
+		return FALSE;
+
+	if(ftl->state[best] == FTL_BLOCK_BLANK)
+	{
+		if(ftl_erased(ftl, ftl_block_addr(ftl, best), ftl->flash->erasesz))
+		{
+			if(!ftl_format(ftl, best))
+				return FALSE;
+			ftl->state[best] = FTL_BLOCK_FREE;
+		}
+		else if(!ftl_erase(ftl, best))
+		{
+			return FALSE;
+		}
+	}
+
+	s[0] = cpu_to_le32(ftl->seq);
+	s[1] = cpu_to_le32(~ftl->seq);
+	ftl->state[best] = FTL_BLOCK_USED;
+	ftl->nfree--;
+	if(!ftl->flash->program(ftl->flash, ftl_block_addr(ftl, best) + offsetof(struct ftl_header_t, seq), (u8_t *)s, sizeof(s)))
+		return FALSE;
+	ftl->seq++;
+	ftl->head = best;
+	ftl->next = 0;
+	return TRUE;
+}
+
+static bool_t ftl_append(struct ftl_t * ftl, u32_t lsn, u8_t * buf)
+{
+	struct ftl_tag_t tag;
+	u32_t phys, old;
+
+	if((ftl->head == FTL_NONE) || (ftl->next >= ftl->slots))
+	{
+		ftl->head = FTL_NONE;
+		if(!ftl_open(ftl))
+			return FALSE;
+	}
+	phys = ftl->head * ftl->slots + ftl->next++;
+
+	tag.lsn = cpu_to_le32(lsn);
+	tag.nlsn = cpu_to_le32(~lsn);
+	if(!ftl->flash->program(ftl->flash, ftl_data_addr(ftl, phys), buf, FTL_SECTOR_SIZE))
+		return FALSE;
+	if(!ftl->flash->program(ftl->flash, ftl_tag_addr(ftl, phys), (u8_t *)&tag, sizeof(struct ftl_tag_t)))
+		return FALSE;
+
+	old = ftl->map[lsn];
+	if(old != FTL_NONE)
+		ftl->valid[old / ftl->slots]--;
+	ftl->map[lsn] = phys;
+	ftl->valid[ftl->head]++;
+	return TRUE;
+}
+
+/*
+ * Copy the valid sectors of a block to the head and erase it.
+ */
+static bool_t ftl_relocate(struct ftl_t * ftl, u32_t b)
+{
+	u32_t phys, lsn, i;
+
+	for(i = 0; (i < ftl->slots) && (ftl->valid[b] > 0); i++)
+	{
+		phys = b * ftl->slots + i;
+		if(!ftl_read_tag(ftl, phys, &lsn) || (ftl->map[lsn] != phys))
+			continue;
+		if(!ftl->flash->read(ftl->flash, ftl_data_addr(ftl, phys), ftl->buf, FTL_SECTOR_SIZE))
+			return FALSE;
+		if(!ftl_append(ftl, lsn, ftl->buf))
+			return FALSE;
+	}
+	return ftl_erase(ftl, b);
+}
+
+static bool_t ftl_gc(struct ftl_t * ftl)
+{
+	u32_t b, victim, cold, maxec;
+
+	while(ftl->nfree < 2)
+	{
+		victim = FTL_NONE;
+		for(b = 0; b < ftl->nblocks; b++)
+		{
+			if(((ftl->state[b] != FTL_BLOCK_USED) || (b == ftl->head)) && (ftl->state[b] != FTL_BLOCK_DIRTY))
+				continue;
+			if((victim == FTL_NONE) || (ftl->valid[b] < ftl->valid[victim]) || ((ftl->valid[b] == ftl->valid[victim]) && (ftl->ec[b] < ftl->ec[victim])))
+				victim = b;
+		}
+		if((victim == FTL_NONE) || (ftl->valid[victim] >= ftl->slots))
+			return FALSE;
+		if(!ftl_relocate(ftl, victim))
+			return FALSE;
+	}
+
+	cold = FTL_NONE;
+	maxec = 0;
+	for(b = 0; b < ftl->nblocks; b++)
+	{
+		if(ftl->ec[b] > maxec)
+			maxec = ftl->ec[b];
+		if((ftl->state[b] == FTL_BLOCK_USED) && (b != ftl->head) && ((cold == FTL_NONE) || (ftl->ec[b] < ftl->ec[cold])))
+			cold = b;
+	}
+	if((cold != FTL_NONE) && (maxec - ftl->ec[cold] > FTL_WEAR_THRESHOLD))
+		return ftl_relocate(ftl, cold);
+	return TRUE;
+}
+
+static bool_t ftl_write_sector(struct ftl_t * ftl, u32_t lsn, u8_t * buf)
+{
+	if(ftl->map[lsn] != FTL_NONE)
+	{
+		if(ftl->flash->read(ftl->flash, ftl_data_addr(ftl, ftl->map[lsn]), ftl->buf, FTL_SECTOR_SIZE) && (memcmp(ftl->buf, buf, FTL_SECTOR_SIZE) == 0))
+			return TRUE;
+	}
+	if(ftl->nfree < 2)
+	{
+		if(!ftl_gc(ftl))
+			return FALSE;
+	}
+	return ftl_append(ftl, lsn, buf);
+}
+
+static int ftl_order_cmp(const void * a, const void * b)
+{
+	u32_t sa = ((struct ftl_order_t *)a)->seq;
+	u32_t sb = ((struct ftl_order_t *)b)->seq;
+
+	return (sa < sb) ? -1 : ((sa > sb) ? 1 : 0);
+}
+
+static bool_t ftl_mount(struct ftl_t * ftl)
+{
+	struct ftl_header_t h;
+	struct ftl_order_t * order;
+	u64_t sum = 0;
+	u32_t b, i, n = 0, known = 0, phys, lsn;
+
+	order = malloc(sizeof(struct ftl_order_t) * ftl->nblocks);
+	if(!order)
+		return FALSE;
+
+	for(b = 0; b < ftl->nblocks; b++)
+	{
+		if(!ftl->flash->read(ftl->flash, ftl_block_addr(ftl, b), (u8_t *)&h, sizeof(struct ftl_header_t)))
+		{
+			free(order);
+			return FALSE;
+		}
+		h.magic = le32_to_cpu(h.magic);
+		h.ec = le32_to_cpu(h.ec);
+		h.nec = le32_to_cpu(h.nec);
+		h.seq = le32_to_cpu(h.seq);
+		h.nseq = le32_to_cpu(h.nseq);
+		ftl->ec[b] = FTL_NONE;
+		if((h.magic == 0xffffffff) && (h.ec == 0xffffffff) && (h.nec == 0xffffffff) && (h.seq == 0xffffffff) && (h.nseq == 0xffffffff))
+		{
+			ftl->state[b] = FTL_BLOCK_BLANK;
+		}
+		else if((h.magic == FTL_MAGIC) && ((h.ec ^ h.nec) == 0xffffffff))
+		{
+			ftl->ec[b] = h.ec;
+			sum += h.ec;
+			known++;
+			if((h.seq == 0xffffffff) && (h.nseq == 0xffffffff))
+			{
+				ftl->state[b] = FTL_BLOCK_FREE;
+			}
+			else if((h.seq ^ h.nseq) == 0xffffffff)
+			{
+				ftl->state[b] = FTL_BLOCK_USED;
+				order[n].seq = h.seq;
+				order[n].block = b;
+				n++;
+				if(h.seq >= ftl->seq)
+					ftl->seq = h.seq + 1;
+			}
+			else
+			{
+				ftl->state[b] = FTL_BLOCK_DIRTY;
+			}
+		}
+		else
+		{
+			ftl->state[b] = FTL_BLOCK_DIRTY;
+		}
+	}
+
+	for(b = 0; b < ftl->nblocks; b++)
+	{
+		if(ftl->ec[b] == FTL_NONE)
+			ftl->ec[b] = known ? (u32_t)(sum / known) : 0;
+		if((ftl->state[b] == FTL_BLOCK_FREE) || (ftl->state[b] == FTL_BLOCK_BLANK))
+			ftl->nfree++;
+	}
+
+	qsort(order, n, sizeof(struct ftl_order_t), ftl_order_cmp);
+	for(i = 0; i < n; i++)
+	{
+		for(phys = order[i].block * ftl->slots; phys < (order[i].block + 1) * ftl->slots; phys++)
+		{
+			if(ftl_read_tag(ftl, phys, &lsn))
+				ftl->map[lsn] = phys;
+		}
+	}
+
+	/*
+	 * Keep appending to the newest block after the last slot touched, a slot
+	 * cut by a power loss is skipped rather than programmed twice
+	 */
+	if(n > 0)
+	{
+		b = order[n - 1].block;
+		for(i = ftl->slots; i > 0; i--)
+		{
+			phys = b * ftl->slots + i - 1;
+			if(!ftl_erased(ftl, ftl_tag_addr(ftl, phys), sizeof(struct ftl_tag_t)) || !ftl_erased(ftl, ftl_data_addr(ftl, phys), FTL_SECTOR_SIZE))
+				break;
+		}
+		ftl->head = b;
+		ftl->next = i;
+	}
+	free(order);
+
+	for(lsn = 0; lsn < ftl->nsectors; lsn++)
+	{
+		if(ftl->map[lsn] != FTL_NONE)
+			ftl->valid[ftl->map[lsn] / ftl->slots]++;
+	}
+	return TRUE;
+}
+
+static u64_t ftl_block_read(struct block_t * blk, u8_t * buf, u64_t blkno, u64_t blkcnt)
+{
+	struct ftl_t * ftl = (struct ftl_t *)(blk->priv);
+	u64_t cnt = block_available_count(blk, blkno, blkcnt);
+	u64_t i;
+
+	for(i = 0; i < cnt; i++, buf += FTL_SECTOR_SIZE)
+	{
+		if(ftl->map[blkno + i] == FTL_NONE)
+			memset(buf, 0, FTL_SECTOR_SIZE);
+		else if(!ftl->flash->read(ftl->flash, ftl_data_addr(ftl, ftl->map[blkno + i]), buf, FTL_SECTOR_SIZE))
+			break;
+	}
+	return i;
+}
+
+static u64_t ftl_block_write(struct block_t * blk, u8_t * buf, u64_t blkno, u64_t blkcnt)
+{
+	struct ftl_t * ftl = (struct ftl_t *)(blk->priv);
+	u64_t cnt = block_available_count(blk, blkno, blkcnt);
+	u64_t i;
+
+	for(i = 0; i < cnt; i++, buf += FTL_SECTOR_SIZE)
+	{
+		if(!ftl_write_sector(ftl, blkno + i, buf))
+			break;
+	}
+	return i;
+}
+
+static void ftl_block_sync(struct block_t * blk)
+{
+}
+
+struct block_t * ftl_alloc(struct ftl_flash_t * flash)
+{
+	struct block_t * blk;
+	struct ftl_t * ftl;
+	u32_t nblocks, slots, reserve;
+
+	if(!flash || !flash->read || !flash->program || !flash->erase || (flash->erasesz == 0))
+		return NULL;
+
+	nblocks = flash->capacity / flash->erasesz;
+	slots = (flash->erasesz - sizeof(struct ftl_header_t)) / (FTL_SECTOR_SIZE + sizeof(struct ftl_tag_t));
+	reserve = 3 + nblocks / 32;
+	if((slots == 0) || (slots > 0xffff) || (nblocks <= reserve))
+		return NULL;
+
+	ftl = malloc(sizeof(struct ftl_t));
+	if(!ftl)
+		return NULL;
+
+	blk = malloc(sizeof(struct block_t));
+	if(!blk)
+	{
+		free(ftl);
+		return NULL;
+	}
+
+	ftl->flash = flash;
+	ftl->nblocks = nblocks;
+	ftl->slots = slots;
+	ftl->nsectors = (nblocks - reserve) * slots;
+	ftl->map = malloc(sizeof(u32_t) * ftl->nsectors);
+	ftl->ec = malloc(sizeof(u32_t) * nblocks);
+	ftl->valid = calloc(nblocks, sizeof(u16_t));
+	ftl->state = malloc(nblocks);
+	ftl->seq = 0;
+	ftl->head = FTL_NONE;
+	ftl->next = 0;
+	ftl->nfree = 0;
+	if(ftl->map)
+		memset(ftl->map, 0xff, sizeof(u32_t) * ftl->nsectors);
+
+	if(!ftl->map || !ftl->ec || !ftl->valid || !ftl->state || !ftl_mount(ftl))
+	{
+		free(ftl->map);
+		free(ftl->ec);
+		free(ftl->valid);
+		free(ftl->state);
+		free(ftl);
+		free(blk);
+		return NULL;
+	}
+
+	blk->name = NULL;
+	blk->blksz = FTL_SECTOR_SIZE;
+	blk->blkcnt = ftl->nsectors;
+	blk->read = ftl_block_read;
+	blk->write = ftl_block_write;
+	blk->sync = ftl_block_sync;
+	blk->priv = ftl;
+
+	return blk;
+}
+
+void ftl_free(struct block_t * blk)
+{
+	struct ftl_t * ftl;
+
+	if(blk)
+	{
+		ftl = (struct ftl_t *)(blk->priv);
+		free(ftl->map);
+		free(ftl->ec);
+		free(ftl->valid);
+		free(ftl->state);
+		free(ftl);
+		free(blk);
+	}
+}
+
+struct ftl_flash_t * ftl_flash(struct block_t * blk)
+{
+	return blk ? ((struct ftl_t *)(blk->priv))->flash : NULL;
+}
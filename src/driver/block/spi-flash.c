@@ -29,12 +29,15 @@
 #include <xboot.h>
 #include <spi/spi.h>
 #include <block/block.h>
+#include <block/ftl.h>
 
 enum {
 	OPCODE_SFDP			= 0x5a,
 	OPCODE_RDID			= 0x9f,
 	OPCODE_WRSR			= 0x01,
 	OPCODE_RDSR			= 0x05,
+	OPCODE_RDSR2		= 0x35,
+	OPCODE_WRSR2		= 0x31,
 	OPCODE_WREN			= 0x06,
 	OPCODE_READ			= 0x03,
 	OPCODE_PROG			= 0x02,
@@ -90,11 +93,16 @@ struct spi_flash_info_t {
 	u8_t opcode_erase_32k;
 	u8_t opcode_erase_64k;
 	u8_t opcode_erase_256k;
+	u8_t read_type;
+	u8_t read_address_type;
+	u8_t read_dummy;
+	u8_t quad_enable;
 };
 
 struct spi_flash_pdata_t {
 	struct spi_device_t * dev;
 	struct spi_flash_info_t info;
+	struct ftl_flash_t flash;
 };
 
 static bool_t spi_flash_read_sfdp(struct spi_device_t * dev, struct sfdp_t * sfdp)
@@ -117,7 +125,7 @@ static bool_t spi_flash_read_sfdp(struct spi_device_t * dev, struct sfdp_t * sfd
 	if((sfdp->h.sign[0] != 'S') || (sfdp->h.sign[1] != 'F') || (sfdp->h.sign[2] != 'D') || (sfdp->h.sign[3] != 'P'))
 		return FALSE;
 
-	sfdp->h.nph = sfdp->h.nph > SFDP_MAX_NPH ? sfdp->h.nph + 1 : SFDP_MAX_NPH;
+	sfdp->h.nph = (sfdp->h.nph + 1 < SFDP_MAX_NPH) ? sfdp->h.nph + 1 : SFDP_MAX_NPH;
 	for(i = 0; i < sfdp->h.nph; i++)
 	{
 		addr = i * sizeof(struct sfdp_parameter_header_t) + sizeof(struct sfdp_header_t);
@@ -174,15 +182,33 @@ static bool_t spi_flash_read_id(struct spi_device_t * dev, u32_t * id)
 }
 
 static const struct spi_flash_info_t spi_flash_infos[] = {
-	{ "w25x40", 0xef3013, 512 * 1024, 4096, 1, 256, 3, OPCODE_READ, OPCODE_PROG, OPCODE_WREN, OPCODE_E4K, 0, OPCODE_E64K, 0 },
+	{ "w25x40", 0xef3013, 512 * 1024, 4096, 1, 256, 3, OPCODE_READ, OPCODE_PROG, OPCODE_WREN, OPCODE_E4K, 0, OPCODE_E64K, 0, SPI_TYPE_SINGLE, SPI_TYPE_SINGLE, 0, 0 },
 };
 
-static bool_t spi_flash_detect(struct spi_device_t * dev, struct spi_flash_info_t * info)
+/*
+ * Take a fast read from its sfdp dword half, with the address and the mode
+ * bits sent on the address lanes and followed by the dummy clocks.
+ */
+static bool_t spi_flash_fast_read(struct spi_flash_info_t * info, u32_t v, int atype, int dtype)
+{
+	int lanes = (atype == SPI_TYPE_QUAD) ? 4 : ((atype == SPI_TYPE_DUAL) ? 2 : 1);
+	int clocks = ((v >> 0) & 0x1f) + ((v >> 5) & 0x7);
+
+	if((((v >> 8) & 0xff) == 0) || ((clocks * lanes) % 8 != 0) || (clocks * lanes / 8 > 8))
+		return FALSE;
+	info->opcode_read = (v >> 8) & 0xff;
+	info->read_type = dtype;
+	info->read_address_type = atype;
+	info->read_dummy = clocks * lanes / 8;
+	return TRUE;
+}
+
+static bool_t spi_flash_detect(struct spi_device_t * dev, int type, struct spi_flash_info_t * info)
 {
 	const struct spi_flash_info_t * t;
 	struct sfdp_t sfdp;
-	u32_t v, id;
-	int i;
+	u32_t v, d3, d4, id;
+	int i, qer;
 
 	if(spi_flash_read_sfdp(dev, &sfdp))
 	{
@@ -295,6 +321,11 @@ static bool_t spi_flash_detect(struct spi_device_t * dev, struct spi_flash_info_
 		info->opcode_write_enable = OPCODE_WREN;
 		info->read_granularity = 1;
 		info->opcode_read = OPCODE_READ;
+		info->read_type = SPI_TYPE_SINGLE;
+		info->read_address_type = SPI_TYPE_SINGLE;
+		info->read_dummy = 0;
+		info->quad_enable = 0;
+		qer = -1;
 		if((sfdp.bt.major == 1) && (sfdp.bt.minor < 5))
 		{
 			/* Basic flash parameter table 1th dword */
@@ -309,6 +340,28 @@ static bool_t spi_flash_detect(struct spi_device_t * dev, struct spi_flash_info_
 			/* Basic flash parameter table 11th dword */
 			v = (sfdp.bt.table[43] << 24) | (sfdp.bt.table[42] << 16) | (sfdp.bt.table[41] << 8) | (sfdp.bt.table[40] << 0);
 			info->write_granularity = 1 << ((v >> 4) & 0xf);
+			/* Basic flash parameter table 15th dword, quad enable requirements */
+			v = (sfdp.bt.table[59] << 24) | (sfdp.bt.table[58] << 16) | (sfdp.bt.table[57] << 8) | (sfdp.bt.table[56] << 0);
+			qer = (v >> 20) & 0x7;
+		}
+		/* Basic flash parameter table 1th, 3th and 4th dword, the fast reads */
+		v = (sfdp.bt.table[3] << 24) | (sfdp.bt.table[2] << 16) | (sfdp.bt.table[1] << 8) | (sfdp.bt.table[0] << 0);
+		d3 = (sfdp.bt.table[11] << 24) | (sfdp.bt.table[10] << 16) | (sfdp.bt.table[9] << 8) | (sfdp.bt.table[8] << 0);
+		d4 = (sfdp.bt.table[15] << 24) | (sfdp.bt.table[14] << 16) | (sfdp.bt.table[13] << 8) | (sfdp.bt.table[12] << 0);
+		if((type & SPI_TYPE_QUAD) && (qer >= 0) && (qer != 3) && (qer <= 6))
+		{
+			if(((v >> 21) & 0x1) && spi_flash_fast_read(info, d3 >> 0, SPI_TYPE_QUAD, SPI_TYPE_QUAD))
+				info->quad_enable = qer;
+			else if(((v >> 22) & 0x1) && spi_flash_fast_read(info, d3 >> 16, SPI_TYPE_SINGLE, SPI_TYPE_QUAD))
+				info->quad_enable = qer;
+		}
+		if((type & SPI_TYPE_DUAL) && (info->read_type == SPI_TYPE_SINGLE))
+		{
+			if(!(((v >> 20) & 0x1) && spi_flash_fast_read(info, d4 >> 16, SPI_TYPE_DUAL, SPI_TYPE_DUAL)))
+			{
+				if((v >> 16) & 0x1)
+					spi_flash_fast_read(info, d4 >> 0, SPI_TYPE_SINGLE, SPI_TYPE_DUAL);
+			}
 		}
 		info->opcode_write = OPCODE_PROG;
 		return TRUE;
@@ -350,6 +403,17 @@ static inline void spi_flash_write_status_register(struct spi_flash_pdata_t * pd
 	spi_device_deselect(pdat->dev);
 }
 
+static inline u8_t spi_flash_read_status_register2(struct spi_flash_pdata_t * pdat)
+{
+	u8_t tx = OPCODE_RDSR2;
+	u8_t rx = 0;
+
+	spi_device_select(pdat->dev);
+	spi_device_write_then_read(pdat->dev, &tx, 1, &rx, 1);
+	spi_device_deselect(pdat->dev);
+	return rx;
+}
+
 static inline void spi_flash_write_enable(struct spi_flash_pdata_t * pdat)
 {
 	spi_device_select(pdat->dev);
@@ -386,36 +450,63 @@ static inline void spi_flash_wait_for_busy(struct spi_flash_pdata_t * pdat)
 	while((spi_flash_read_status_register(pdat) & 0x1) == 0x1);
 }
 
+static inline int spi_flash_transfer(struct spi_flash_pdata_t * pdat, int type, void * txbuf, void * rxbuf, int len)
+{
+	struct spi_msg_t msg;
+
+	msg.txbuf = txbuf;
+	msg.rxbuf = rxbuf;
+	msg.len = len;
+	msg.type = type;
+	msg.mode = pdat->dev->mode;
+	msg.bits = pdat->dev->bits;
+	msg.speed = pdat->dev->speed;
+	return spi_transfer(pdat->dev->spi, &msg);
+}
+
 static void spi_flash_read_bytes(struct spi_flash_pdata_t * pdat, u32_t addr, u8_t * buf, u32_t count)
 {
-	u8_t tx[5];
+	u8_t tx[16];
+	int n = 0;
 
+	tx[n++] = pdat->info.opcode_read;
 	switch(pdat->info.address_length)
 	{
 	case 3:
-		tx[0] = pdat->info.opcode_read;
-		tx[1] = (u8_t)(addr >> 16);
-		tx[2] = (u8_t)(addr >> 8);
-		tx[3] = (u8_t)(addr >> 0);
-		spi_device_select(pdat->dev);
-		spi_device_write_then_read(pdat->dev, tx, 4, buf, count);
-		spi_device_deselect(pdat->dev);
+		tx[n++] = (u8_t)(addr >> 16);
+		tx[n++] = (u8_t)(addr >> 8);
+		tx[n++] = (u8_t)(addr >> 0);
 		break;
 
 	case 4:
-		tx[0] = pdat->info.opcode_read;
-		tx[1] = (u8_t)(addr >> 24);
-		tx[2] = (u8_t)(addr >> 16);
-		tx[3] = (u8_t)(addr >> 8);
-		tx[4] = (u8_t)(addr >> 0);
-		spi_device_select(pdat->dev);
-		spi_device_write_then_read(pdat->dev, tx, 5, buf, count);
-		spi_device_deselect(pdat->dev);
+		tx[n++] = (u8_t)(addr >> 24);
+		tx[n++] = (u8_t)(addr >> 16);
+		tx[n++] = (u8_t)(addr >> 8);
+		tx[n++] = (u8_t)(addr >> 0);
 		break;
 
 	default:
-		break;
+		return;
+	}
+	memset(&tx[n], 0xff, pdat->info.read_dummy);
+	n += pdat->info.read_dummy;
+
+	/*
+	 * The opcode always goes out on one lane, the address, mode bits and
+	 * dummy clocks on the address lanes, then the data on the data lanes
+	 */
+	spi_device_select(pdat->dev);
+	if(pdat->info.read_address_type == SPI_TYPE_SINGLE)
+	{
+		spi_flash_transfer(pdat, SPI_TYPE_SINGLE, tx, NULL, n);
+	}
+	else
+	{
+		spi_flash_transfer(pdat, SPI_TYPE_SINGLE, tx, NULL, 1);
+		spi_flash_transfer(pdat, pdat->info.read_address_type, &tx[1], NULL, n - 1);
 	}
+	spi_flash_transfer(pdat, pdat->info.read_type, NULL, buf, count);
+	spi_device_deselect(pdat->dev);
 }
 
 static void spi_flash_write_bytes(struct spi_flash_pdata_t * pdat, u32_t addr, u8_t * buf, u32_t count)
@@ -580,6 +671,50 @@ static void spi_flash_sector_erase_256k(struct spi_flash_pdata_t * pdat, u32_t a
 	}
 }
 
+/*
+ * Set the quad enable bit the way the sfdp 15th dword asks for, without it
+ * the io2 and io3 pins stay write protect and hold.
+ */
+static void spi_flash_quad_enable(struct spi_flash_pdata_t * pdat)
+{
+	u8_t tx[3];
+	int n;
+
+	switch(pdat->info.quad_enable)
+	{
+	case 1:
+		tx[0] = OPCODE_WRSR;
+		tx[1] = spi_flash_read_status_register(pdat);
+		tx[2] = 0x02;
+		n = 3;
+		break;
+	case 2:
+		tx[0] = OPCODE_WRSR;
+		tx[1] = spi_flash_read_status_register(pdat) | 0x40;
+		n = 2;
+		break;
+	case 4:
+	case 5:
+		tx[0] = OPCODE_WRSR;
+		tx[1] = spi_flash_read_status_register(pdat);
+		tx[2] = spi_flash_read_status_register2(pdat) | 0x02;
+		n = 3;
+		break;
+	case 6:
+		tx[0] = OPCODE_WRSR2;
+		tx[1] = spi_flash_read_status_register2(pdat) | 0x02;
+		n = 2;
+		break;
+	default:
+		return;
+	}
+	spi_flash_write_enable(pdat);
+	spi_device_select(pdat->dev);
+	spi_device_write_then_read(pdat->dev, tx, n, 0, 0);
+	spi_device_deselect(pdat->dev);
+	spi_flash_wait_for_busy(pdat);
+}
+
 static void spi_flash_init(struct spi_flash_pdata_t * pdat)
 {
 	spi_flash_chip_reset(pdat);
@@ -587,6 +722,8 @@ static void spi_flash_init(struct spi_flash_pdata_t * pdat)
 	spi_flash_write_enable(pdat);
 	spi_flash_write_status_register(pdat, 0);
 	spi_flash_wait_for_busy(pdat);
+	if(pdat->info.read_type == SPI_TYPE_QUAD)
+		spi_flash_quad_enable(pdat);
 	if(pdat->info.address_length == 4)
 	{
 		spi_flash_write_enable(pdat);
@@ -693,6 +830,75 @@ static void spi_flash_sync(struct block_t * blk)
 {
 }
 
+static bool_t spi_flash_ftl_read(struct ftl_flash_t * flash, u64_t addr, u8_t * buf, u32_t count)
+{
+	struct spi_flash_pdata_t * pdat = (struct spi_flash_pdata_t *)flash->priv;
+	u32_t len;
+
+	while(count > 0)
+	{
+		if(pdat->info.read_granularity == 1)
+			len = count;
+		else
+			len = (count < pdat->info.read_granularity) ? count : pdat->info.read_granularity;
+		spi_flash_wait_for_busy(pdat);
+		spi_flash_read_bytes(pdat, addr, buf, len);
+		addr += len;
+		buf += len;
+		count -= len;
+	}
+	return TRUE;
+}
+
+static bool_t spi_flash_ftl_program(struct ftl_flash_t * flash, u64_t addr, u8_t * buf, u32_t count)
+{
+	struct spi_flash_pdata_t * pdat = (struct spi_flash_pdata_t *)flash->priv;
+	u32_t page = (pdat->info.write_granularity == 1) ? 256 : pdat->info.write_granularity;
+	u32_t len;
+
+	spi_flash_wait_for_busy(pdat);
+	while(count > 0)
+	{
+		len = page - (addr % page);
+		if(len > count)
+			len = count;
+		spi_flash_write_enable(pdat);
+		spi_flash_write_bytes(pdat, addr, buf, len);
+		spi_flash_wait_for_busy(pdat);
+		addr += len;
+		buf += len;
+		count -= len;
+	}
+	return TRUE;
+}
+
+static bool_t spi_flash_ftl_erase(struct ftl_flash_t * flash, u64_t addr)
+{
+	struct spi_flash_pdata_t * pdat = (struct spi_flash_pdata_t *)flash->priv;
+
+	spi_flash_wait_for_busy(pdat);
+	spi_flash_write_enable(pdat);
+	switch(pdat->info.blksz)
+	{
+	case 4096:
+		spi_flash_sector_erase_4k(pdat, addr);
+		break;
+	case 32768:
+		spi_flash_sector_erase_32k(pdat, addr);
+		break;
+	case 65536:
+		spi_flash_sector_erase_64k(pdat, addr);
+		break;
+	case 262144:
+		spi_flash_sector_erase_256k(pdat, addr);
+		break;
+	default:
+		return FALSE;
+	}
+	spi_flash_wait_for_busy(pdat);
+	return TRUE;
+}
+
 static struct device_t * spi_flash_probe(struct driver_t * drv, struct dtnode_t * n)
 {
 	struct spi_flash_pdata_t * pdat;
@@ -700,12 +906,20 @@ static struct device_t * spi_flash_probe(struct driver_t * drv, struct dtnode_t
 	struct device_t * dev;
 	struct spi_device_t * spidev;
 	struct spi_flash_info_t info;
+	int type;
 
 	spidev = spi_device_alloc(dt_read_string(n, "spi-bus", NULL), dt_read_int(n, "chip-select", 0), dt_read_int(n, "type", 0), dt_read_int(n, "mode", 0), 8, dt_read_int(n, "speed", 0));
 	if(!spidev)
 		return NULL;
 
-	if(!spi_flash_detect(spidev, &info))
+	/*
+	 * The type is how many lanes are wired, commands are always sent on
+	 * one lane and only the fast read uses the wider ones
+	 */
+	type = spidev->spi->type & ((spidev->type << 1) - 1);
+	spidev->type = SPI_TYPE_SINGLE;
+
+	if(!spi_flash_detect(spidev, type, &info))
 	{
 		spi_device_free(spidev);
 		return NULL;
@@ -718,33 +932,58 @@ static struct device_t * spi_flash_probe(struct driver_t * drv, struct dtnode_t
 		return NULL;
 	}
 
-	blk = malloc(sizeof(struct block_t));
-	if(!blk)
-	{
-		spi_device_free(spidev);
-		free(pdat);
-		return NULL;
-	}
-
 	pdat->dev = spidev;
 	memcpy(&pdat->info, &info, sizeof(struct spi_flash_info_t));
+	pdat->flash.erasesz = pdat->info.blksz;
+	pdat->flash.capacity = pdat->info.capacity;
+	pdat->flash.read = spi_flash_ftl_read;
+	pdat->flash.program = spi_flash_ftl_program;
+	pdat->flash.erase = spi_flash_ftl_erase;
+	pdat->flash.priv = pdat;
+	spi_flash_init(pdat);
 
+	/*
+	 * With the ftl, writes are remapped into a wear levelled log instead
+	 * of erasing the covering sector in place
+	 */
+	if(dt_read_bool(n, "ftl", 0))
+	{
+		blk = ftl_alloc(&pdat->flash);
+		if(!blk)
+		{
+			spi_device_free(spidev);
+			free(pdat);
+			return NULL;
+		}
+	}
+	else
+	{
+		blk = malloc(sizeof(struct block_t));
+		if(!blk)
+		{
+			spi_device_free(spidev);
+			free(pdat);
+			return NULL;
+		}
+		blk->blksz = pdat->info.blksz;
+		blk->blkcnt = pdat->info.capacity / pdat->info.blksz;
+		blk->read = spi_flash_read;
+		blk->write = spi_flash_write;
+		blk->sync = spi_flash_sync;
+		blk->priv = pdat;
+	}
 	blk->name = alloc_device_name(dt_read_name(n), dt_read_id(n));
-	blk->blksz = pdat->info.blksz;
-	blk->blkcnt = pdat->info.capacity / pdat->info.blksz;
-	blk->read = spi_flash_read;
-	blk->write = spi_flash_write;
-	blk->sync = spi_flash_sync;
-	blk->priv = pdat;
-	spi_flash_init(pdat);
 
 	if(!register_block(&dev, blk))
 	{
 		spi_device_free(pdat->dev);
 
 		free_device_name(blk->name);
-		free(blk->priv);
-		free(blk);
+		if(blk->read == spi_flash_read)
+			free(blk);
+		else
+			ftl_free(blk);
+		free(pdat);
 		return NULL;
 	}
 	dev->driver = drv;
@@ -755,15 +994,22 @@ static struct device_t * spi_flash_probe(struct driver_t * drv, struct dtnode_t
 static void spi_flash_remove(struct device_t * dev)
 {
 	struct block_t * blk = (struct block_t *)dev->priv;
-	struct spi_flash_pdata_t * pdat = (struct spi_flash_pdata_t *)blk->priv;
+	struct spi_flash_pdata_t * pdat;
 
 	if(blk && unregister_block(blk))
 	{
+		if(blk->read == spi_flash_read)
+			pdat = (struct spi_flash_pdata_t *)blk->priv;
+		else
+			pdat = (struct spi_flash_pdata_t *)ftl_flash(blk)->priv;
 		spi_device_free(pdat->dev);
 
 		free_device_name(blk->name);
-		free(blk->priv);
-		free(blk);
+		if(blk->read == spi_flash_read)
+			free(blk);
+		else
+			ftl_free(blk);
+		free(pdat);
 	}
 }
 
@@ -231,6 +231,41 @@ void framebuffer_present_render(struct framebuffer_t * fb, struct render_t * ren
 		fb->present(fb, render, rect, nrect);
 }
 
+bool_t framebuffer_can_flip(struct framebuffer_t * fb)
+{
+	if(fb && fb->flip)
+		return TRUE;
+	return FALSE;
+}
+
+void framebuffer_flip_render(struct framebuffer_t * fb, struct render_t * render)
+{
+	if(fb)
+	{
+		if(fb->flip)
+			fb->flip(fb, render);
+		else if(fb->present)
+			fb->present(fb, render, NULL, 0);
+	}
+}
+
+/*
+ * Without a vertical blanking source, wait for the next tick of a nominal 60Hz
+ * refresh. The wait yields, so other tasks keep running until the deadline.
+ */
+u64_t framebuffer_wait_vsync(struct framebuffer_t * fb)
+{
+	u64_t period = 1000000000ULL / 60;
+	u64_t count;
+
+	if(fb && fb->vsync)
+		return fb->vsync(fb);
+	count = ktime_to_ns(ktime_get()) / period + 1;
+	while(ktime_to_ns(ktime_get()) < count * period)
+		task_yield();
+	return count;
+}
+
 void framebuffer_set_backlight(struct framebuffer_t * fb, int brightness)
 {
 	if(fb && fb->setbl)
@@ -233,13 +233,14 @@ char * kvdb_get(struct kvdb_t * db, const char * key, const char * def)
 	return (char *)def;
 }
 
-void kvdb_from_string(struct kvdb_t * db, char * str)
+bool_t kvdb_from_string(struct kvdb_t * db, char * str)
 {
 	char * p = str;
 	char * r, * k, * v;
+	bool_t ret = TRUE;
 
 	if(!db || !p)
-		return;
+		return FALSE;
 
 	while((r = strsep(&p, ",;\r\n")) != NULL)
 	{
@@ -250,9 +251,14 @@ void kvdb_from_string(struct kvdb_t * db, char * str)
 			k = (k && strcmp(k, "") != 0) ? k : NULL;
 			v = (v && strcmp(v, "") != 0) ? v : NULL;
 			if(k && v)
+			{
 				kvdb_set(db, k, v);
+				if(!kvdb_get(db, k, NULL))
+					ret = FALSE;
+			}
 		}
 	}
+	return ret;
 }
 
 char * kvdb_to_string(struct kvdb_t * db)
@@ -290,3 +296,16 @@ int kvdb_summary(struct kvdb_t * db, void * buf)
 	}
 	return len;
 }
+
+void kvdb_foreach(struct kvdb_t * db, void (*cb)(const char * key, const char * value, void * data), void * data)
+{
+	struct record_t * pos, * n;
+
+	if(!db || !cb)
+		return;
+
+	list_for_each_entry_safe(pos, n, &db->list, head)
+	{
+		cb(pos->key, pos->value, data);
+	}
+}
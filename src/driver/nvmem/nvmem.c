@@ -61,56 +61,314 @@ struct nvmem_t * search_first_nvmem(void)
 	return (struct nvmem_t *)dev->priv;
 }
 
-static bool_t nvmem_init_kvdb(struct nvmem_t * m)
+/*
+ * The store is an append only journal. Two header slots at the start take
+ * turns naming the current generation, and the rest is split in two halves,
+ * the generation's parity picks the half holding its log. Every record is
+ *
+ *   crc32 (4) | key length (2) | value length (2) | key | value
+ *
+ * with the crc covering the generation too, so stale records left behind by
+ * an older generation or a torn write end the log on load. A set appends
+ * one record, and when the half is full the whole database is written to
+ * the other half before the next header slot switches to it.
+ */
+#define NVMEM_JOURNAL_MAGIC		(0x4a4d564e)
+#define NVMEM_JOURNAL_HEADER	(12)
+#define NVMEM_JOURNAL_RECORD	(8)
+#define NVMEM_JOURNAL_DELETE	(0xffff)
+
+static inline void nvmem_put32(uint8_t * p, uint32_t v)
 {
-	uint32_t c, crc = 0;
-	char h[8];
-	char * s;
-	int l, size;
+	p[0] = (v >>  0) & 0xff;
+	p[1] = (v >>  8) & 0xff;
+	p[2] = (v >> 16) & 0xff;
+	p[3] = (v >> 24) & 0xff;
+}
 
-	if(!m)
-		return FALSE;
-	m->db = NULL;
+static inline uint32_t nvmem_get32(uint8_t * p)
+{
+	return ((uint32_t)p[3] << 24) | (p[2] << 16) | (p[1] << 8) | (p[0] << 0);
+}
 
-	size = nvmem_capacity(m);
-	if(size < (8 + 1))
+static inline int nvmem_half_size(struct nvmem_t * m)
+{
+	return (nvmem_capacity(m) - NVMEM_JOURNAL_HEADER * 2) / 2;
+}
+
+static inline int nvmem_half_offset(struct nvmem_t * m, uint32_t gen)
+{
+	return NVMEM_JOURNAL_HEADER * 2 + (gen & 0x1) * nvmem_half_size(m);
+}
+
+static int nvmem_encode(uint8_t * p, uint32_t gen, const char * key, const char * value)
+{
+	uint32_t crc = 0;
+	uint8_t g[4];
+	int lk = strlen(key);
+	int lv = value ? strlen(value) : 0;
+
+	if((lk == 0) || (lk >= NVMEM_JOURNAL_DELETE) || (lv >= NVMEM_JOURNAL_DELETE))
+		return 0;
+	if(p)
+	{
+		p[4] = (lk >> 0) & 0xff;
+		p[5] = (lk >> 8) & 0xff;
+		p[6] = value ? ((lv >> 0) & 0xff) : 0xff;
+		p[7] = value ? ((lv >> 8) & 0xff) : 0xff;
+		memcpy(&p[8], key, lk);
+		if(value)
+			memcpy(&p[8 + lk], value, lv);
+		nvmem_put32(g, gen);
+		crc = crc32_sum(crc, g, 4);
+		crc = crc32_sum(crc, &p[4], 4 + lk + lv);
+		nvmem_put32(p, crc);
+	}
+	return NVMEM_JOURNAL_RECORD + lk + lv;
+}
+
+struct nvmem_snapshot_t {
+	uint8_t * buf;
+	uint32_t gen;
+	int len;
+	int size;
+};
+
+static void nvmem_snapshot_record(const char * key, const char * value, void * data)
+{
+	struct nvmem_snapshot_t * ss = (struct nvmem_snapshot_t *)data;
+	int l = nvmem_encode(NULL, ss->gen, key, value);
+
+	if(ss->buf && (l > 0) && (ss->len + l <= ss->size))
+		nvmem_encode(ss->buf + ss->len, ss->gen, key, value);
+	ss->len += l;
+}
+
+static int nvmem_snapshot_length(struct nvmem_t * m)
+{
+	struct nvmem_snapshot_t ss;
+
+	ss.buf = NULL;
+	ss.gen = 0;
+	ss.len = 0;
+	ss.size = 0;
+	kvdb_foreach(m->db, nvmem_snapshot_record, &ss);
+	return ss.len;
+}
+
+/*
+ * Write the whole database as the next generation and read it back before
+ * the header names it. Until the header is written the current generation
+ * stays intact, whatever was cut short. Generation zero is the old store in
+ * [0, tail), which the new half must not reach into.
+ */
+static bool_t nvmem_compact(struct nvmem_t * m)
+{
+	struct nvmem_snapshot_t ss;
+	uint8_t h[NVMEM_JOURNAL_HEADER];
+	uint32_t gen = m->gen + 1;
+	int off = nvmem_half_offset(m, gen);
+
+	if((m->gen == 0) && (off < m->tail))
 		return FALSE;
+	ss.size = nvmem_half_size(m);
+	ss.buf = malloc(ss.size * 2);
+	ss.gen = gen;
+	ss.len = 0;
+	if(!ss.buf)
+		return FALSE;
+	kvdb_foreach(m->db, nvmem_snapshot_record, &ss);
+	if((ss.len > ss.size) || ((ss.len > 0) && ((nvmem_write(m, ss.buf, off, ss.len) != ss.len)
+		|| (nvmem_read(m, ss.buf + ss.size, off, ss.len) != ss.len) || (memcmp(ss.buf, ss.buf + ss.size, ss.len) != 0))))
+	{
+		free(ss.buf);
+		return FALSE;
+	}
+	free(ss.buf);
 
-	if(nvmem_read(m, h, 0, 8) != 8)
+	nvmem_put32(&h[0], NVMEM_JOURNAL_MAGIC);
+	nvmem_put32(&h[4], gen);
+	nvmem_put32(&h[8], crc32_sum(0, h, 8));
+	if(nvmem_write(m, h, (gen & 0x1) * NVMEM_JOURNAL_HEADER, NVMEM_JOURNAL_HEADER) != NVMEM_JOURNAL_HEADER)
 		return FALSE;
-	c = (h[3] << 24) | (h[2] << 16) | (h[1] << 8) | (h[0] << 0);
-	l = (h[7] << 24) | (h[6] << 16) | (h[5] << 8) | (h[4] << 0);
+	m->gen = gen;
+	m->tail = off + ss.len;
+	m->dirty = 0;
+	return TRUE;
+}
 
-	m->db = kvdb_alloc(size);
-	if(m->db)
+static bool_t nvmem_append(struct nvmem_t * m, const char * key, const char * value)
+{
+	uint8_t * p;
+	int l = nvmem_encode(NULL, m->gen, key, value);
+
+	if((l > 0) && (m->gen != 0) && (m->tail + l <= nvmem_half_offset(m, m->gen) + nvmem_half_size(m)))
 	{
-		if((l > 0) && (l + 8 < size))
+		p = malloc(l);
+		if(p)
 		{
-			s = malloc(l);
-			if(!s)
+			nvmem_encode(p, m->gen, key, value);
+			if(nvmem_write(m, p, m->tail, l) == l)
 			{
-				kvdb_free(m->db);
-				return FALSE;
+				m->tail += l;
+				free(p);
+				return TRUE;
 			}
-			if(nvmem_read(m, s, 8, l) != l)
-			{
-				kvdb_free(m->db);
-				free(s);
-				return FALSE;
-			}
-			crc = crc32_sum(crc, (const uint8_t *)(&h[4]), 4);
-			crc = crc32_sum(crc, (const uint8_t *)s, l);
-			if(crc == c)
-				kvdb_from_string(m->db, s);
-			else
-				nvmem_sync(m);
+			free(p);
+		}
+	}
+	return nvmem_compact(m);
+}
+
+static bool_t nvmem_load_header(struct nvmem_t * m, int slot, uint32_t * gen)
+{
+	uint8_t h[NVMEM_JOURNAL_HEADER];
+
+	if(nvmem_read(m, h, slot * NVMEM_JOURNAL_HEADER, NVMEM_JOURNAL_HEADER) != NVMEM_JOURNAL_HEADER)
+		return FALSE;
+	if((nvmem_get32(&h[0]) != NVMEM_JOURNAL_MAGIC) || (nvmem_get32(&h[8]) != crc32_sum(0, h, 8)))
+		return FALSE;
+	*gen = nvmem_get32(&h[4]);
+	return ((*gen & 0x1) == slot) ? TRUE : FALSE;
+}
+
+static void nvmem_load_journal(struct nvmem_t * m)
+{
+	uint8_t r[NVMEM_JOURNAL_RECORD], g[4];
+	uint32_t crc;
+	int off = nvmem_half_offset(m, m->gen);
+	int end = off + nvmem_half_size(m);
+	int lk, lv, l;
+	char * s;
+
+	nvmem_put32(g, m->gen);
+	while(off + NVMEM_JOURNAL_RECORD <= end)
+	{
+		if(nvmem_read(m, r, off, NVMEM_JOURNAL_RECORD) != NVMEM_JOURNAL_RECORD)
+			break;
+		lk = (r[5] << 8) | (r[4] << 0);
+		lv = (r[7] << 8) | (r[6] << 0);
+		l = lk + ((lv == NVMEM_JOURNAL_DELETE) ? 0 : lv);
+		if((lk == 0) || (lk == NVMEM_JOURNAL_DELETE) || (off + NVMEM_JOURNAL_RECORD + l > end))
+			break;
+		s = malloc(l + 2);
+		if(!s)
+			break;
+		if(nvmem_read(m, s, off + NVMEM_JOURNAL_RECORD, l) != l)
+		{
 			free(s);
+			break;
+		}
+		crc = crc32_sum(0, g, 4);
+		crc = crc32_sum(crc, &r[4], 4);
+		crc = crc32_sum(crc, (const uint8_t *)s, l);
+		if(crc != nvmem_get32(&r[0]))
+		{
+			free(s);
+			break;
+		}
+		memmove(&s[lk + 1], &s[lk], l - lk);
+		s[lk] = 0;
+		s[l + 1] = 0;
+		kvdb_set(m->db, s, (lv == NVMEM_JOURNAL_DELETE) ? NULL : &s[lk + 1]);
+		free(s);
+		off += NVMEM_JOURNAL_RECORD + l;
+	}
+	m->tail = off;
+}
+
+/*
+ * The store used to be one crc'ed string at offset zero, keep what it held.
+ * Returns false only when there is no such store. Its bytes are then kept
+ * as generation zero up to tail, or all of the region when it could not be
+ * read back in full.
+ */
+static bool_t nvmem_load_legacy(struct nvmem_t * m)
+{
+	uint32_t c, crc = 0;
+	uint8_t h[8];
+	char * s;
+	int l, size = nvmem_capacity(m);
+	bool_t ret = TRUE;
+
+	m->tail = size;
+	if(nvmem_read(m, h, 0, 8) != 8)
+		return TRUE;
+	c = nvmem_get32(&h[0]);
+	l = nvmem_get32(&h[4]);
+	if((l <= 0) || (l + 8 >= size))
+		return FALSE;
+	s = malloc(l);
+	if(!s)
+		return TRUE;
+	if(nvmem_read(m, s, 8, l) == l)
+	{
+		crc = crc32_sum(crc, &h[4], 4);
+		crc = crc32_sum(crc, (const uint8_t *)s, l);
+		if((crc == c) && (s[l - 1] == 0))
+		{
+			if(kvdb_from_string(m->db, s))
+				m->tail = 8 + l;
 		}
 		else
+			ret = FALSE;
+	}
+	free(s);
+	return ret;
+}
+
+static bool_t nvmem_init_kvdb(struct nvmem_t * m)
+{
+	uint32_t g0, g1;
+	bool_t v0, v1;
+	int size;
+
+	if(!m)
+		return FALSE;
+	m->db = NULL;
+	m->gen = 0;
+	m->tail = 0;
+	m->dirty = 0;
+
+	size = nvmem_capacity(m);
+	if(size < NVMEM_JOURNAL_HEADER * 2 + (NVMEM_JOURNAL_RECORD + 2) * 2)
+		return FALSE;
+
+	m->db = kvdb_alloc(size);
+	if(!m->db)
+		return FALSE;
+
+	v0 = nvmem_load_header(m, 0, &g0);
+	v1 = nvmem_load_header(m, 1, &g1);
+	if(v0 || v1)
+	{
+		m->gen = (v0 && (!v1 || (g0 > g1))) ? g0 : g1;
+		nvmem_load_journal(m);
+	}
+	else if(nvmem_load_legacy(m))
+	{
+		/*
+		 * The first compaction writes the other half clear of the old store,
+		 * so only the header slot lands on it. Keep the old store as it is
+		 * when its keys do not fit in a half.
+		 */
+		if(!nvmem_compact(m))
 		{
-			nvmem_sync(m);
+			m->dirty = 1;
+			LOG("Keep the old store of nvmem '%s' as it is, it could not be moved to the journal", m->name);
 		}
 	}
+	else
+	{
+		/*
+		 * No store at all, or a first compaction cut while writing its header,
+		 * which leaves a read back copy of the old store as generation one.
+		 */
+		m->gen = 1;
+		nvmem_load_journal(m);
+		if(!nvmem_compact(m))
+			m->dirty = 1;
+	}
 	return TRUE;
 }
 
@@ -223,8 +481,25 @@ int nvmem_write(struct nvmem_t * m, void * buf, int offset, int count)
 
 void nvmem_set(struct nvmem_t * m, const char * key, const char * value)
 {
-	if(m && m->db)
+	char * old;
+
+	if(m && m->db && key)
+	{
+		old = kvdb_get(m->db, key, NULL);
+		if((!old && !value) || (old && value && (strcmp(old, value) == 0)))
+			return;
+		old = old ? strdup(old) : NULL;
 		kvdb_set(m->db, key, value);
+		if((value && !kvdb_get(m->db, key, NULL)) || (nvmem_snapshot_length(m) > nvmem_half_size(m)))
+		{
+			kvdb_set(m->db, key, old);
+			free(old);
+			return;
+		}
+		free(old);
+		if(!nvmem_append(m, key, value))
+			m->dirty = 1;
+	}
 }
 
 char * nvmem_get(struct nvmem_t * m, const char * key, const char * def)
@@ -237,35 +512,17 @@ char * nvmem_get(struct nvmem_t * m, const char * key, const char * def)
 void nvmem_clear(struct nvmem_t * m)
 {
 	if(m && m->db)
-		return kvdb_clear(m->db);
+	{
+		kvdb_clear(m->db);
+		if(m->gen == 0)
+			m->tail = 0;
+		if(!nvmem_compact(m))
+			m->dirty = 1;
+	}
 }
 
 void nvmem_sync(struct nvmem_t * m)
 {
-	uint32_t c = 0;
-	char h[8];
-	char * s;
-	int l;
-
-	if(m && m->db)
-	{
-		s = kvdb_to_string(m->db);
-		if(s)
-		{
-			l = strlen(s) + 1;
-			h[4] = (l >>  0) & 0xff;
-			h[5] = (l >>  8) & 0xff;
-			h[6] = (l >> 16) & 0xff;
-			h[7] = (l >> 24) & 0xff;
-			c = crc32_sum(c, (const uint8_t *)(&h[4]), 4);
-			c = crc32_sum(c, (const uint8_t *)s, l);
-			h[0] = (c >>  0) & 0xff;
-			h[1] = (c >>  8) & 0xff;
-			h[2] = (c >> 16) & 0xff;
-			h[3] = (c >> 24) & 0xff;
-			nvmem_write(m, h, 0, 8);
-			nvmem_write(m, s, 8, l);
-			free(s);
-		}
-	}
+	if(m && m->db && m->dirty)
+		nvmem_compact(m);
 }
@@ -10,7 +10,16 @@
 # define WORDS_BIGENDIAN		(1)
 #endif
 
-#define CAIRO_NO_MUTEX			(1)
+#if defined(CONFIG_MAX_SMP_CPUS) && (CONFIG_MAX_SMP_CPUS > 1)
+# define CAIRO_HAS_XBOOT_MUTEX	(1)
+# define HAVE_GCC_LEGACY_ATOMICS	(1)
+# define SIZEOF_INT				(__SIZEOF_INT__)
+# define SIZEOF_LONG			(__SIZEOF_LONG__)
+# define SIZEOF_LONG_LONG		(__SIZEOF_LONG_LONG__)
+# define SIZEOF_VOID_P			(__SIZEOF_POINTER__)
+#else
+# define CAIRO_NO_MUTEX			(1)
+#endif
 #define HAVE_UINT64_T			(1)
 #define HAVE_STDINT_H			(1)
 
@@ -175,6 +175,20 @@
 # define CAIRO_RECURSIVE_MUTEX_IMPL_INIT(mutex)
 # define CAIRO_RECURSIVE_MUTEX_IMPL_NIL_INITIALIZER 0
 
+#elif CAIRO_HAS_XBOOT_MUTEX /***********************************************/
+
+/* xboot tasks are cooperative and never preempted while inside cairo, so
+ * the short critical sections only have to exclude the other cpus. */
+
+  typedef spinlock_t cairo_mutex_impl_t;
+
+# define CAIRO_MUTEX_IMPL_XBOOT 1
+# define CAIRO_MUTEX_IMPL_LOCK(mutex) spin_lock (&(mutex))
+# define CAIRO_MUTEX_IMPL_UNLOCK(mutex) spin_unlock (&(mutex))
+# define CAIRO_MUTEX_IMPL_INIT(mutex) spin_lock_init (&(mutex))
+# define CAIRO_MUTEX_IMPL_INITIALIZE() CAIRO_MUTEX_IMPL_NOOP
+# define CAIRO_MUTEX_IMPL_NIL_INITIALIZER SPIN_LOCK_INIT()
+
 #elif defined(_WIN32) /******************************************************/
 
 #define WIN32_LEAN_AND_MEAN
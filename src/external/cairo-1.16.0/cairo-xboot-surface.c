@@ -135,3 +135,11 @@ void cairo_xboot_surface_present(cairo_surface_t * surface, struct dirty_rect_t
 	if(cxs)
 		cxs->fb->present(cxs->fb, cxs->render, rect, nrect);
 }
+
+void cairo_xboot_surface_flip(cairo_surface_t * surface)
+{
+	struct cairo_xboot_surface_t * cxs = (struct cairo_xboot_surface_t *)cairo_surface_get_user_data(surface, NULL);
+
+	if(cxs)
+		framebuffer_flip_render(cxs->fb, cxs->render);
+}
@@ -30,6 +30,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <float.h>
 #include <assert.h>
 #include <string.h>
 
@@ -101,6 +103,80 @@ static int strtod_buffer_size(const char *s)
     return p - s;
 }
 
+/* Powers of ten which are exactly representable as a double */
+static const double exact_pow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+    1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+    1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* Parse a plain decimal number without strtod() when the result is
+ * guaranteed to be correctly rounded: the significand fits in 53 bits
+ * and the power of ten is exact, so a single multiply or divide rounds
+ * once (Clinger's fast path). Returns 0 if strtod() must be used. */
+static int fast_strtod(const char *nptr, char **endptr, double *value)
+{
+#if defined(FLT_EVAL_METHOD) && (FLT_EVAL_METHOD == 0)
+    const char *p = nptr;
+    uint64_t mantissa = 0;
+    int digits = 0, exponent = 0, exp = 0;
+    int negative = 0, exp_negative = 0;
+    double d;
+
+    if (*p == '-') {
+        negative = 1;
+        p++;
+    }
+    if (*p < '0' || *p > '9')
+        return 0;
+    while (*p >= '0' && *p <= '9') {
+        if (digits++ >= 19)
+            return 0;
+        mantissa = mantissa * 10 + (*p++ - '0');
+    }
+    if (*p == 'x' || *p == 'X')
+        return 0;
+    if (*p == '.') {
+        p++;
+        if (*p < '0' || *p > '9')
+            return 0;
+        while (*p >= '0' && *p <= '9') {
+            if (digits++ >= 19)
+                return 0;
+            mantissa = mantissa * 10 + (*p++ - '0');
+            exponent--;
+        }
+    }
+    if (*p == 'e' || *p == 'E') {
+        p++;
+        if (*p == '-' || *p == '+')
+            exp_negative = (*p++ == '-');
+        if (*p < '0' || *p > '9')
+            return 0;
+        while (*p >= '0' && *p <= '9') {
+            if (exp > 1000)
+                return 0;
+            exp = exp * 10 + (*p++ - '0');
+        }
+        exponent += exp_negative ? -exp : exp;
+    }
+    if (mantissa > ((uint64_t)1 << 53) || exponent < -22 || exponent > 22)
+        return 0;
+
+    d = (double)mantissa;
+    if (exponent < 0)
+        d /= exact_pow10[-exponent];
+    else
+        d *= exact_pow10[exponent];
+    *value = negative ? -d : d;
+    *endptr = (char *)p;
+
+    return 1;
+#else
+    return 0;
+#endif
+}
+
 /* Similar to strtod(), but must be passed the current locale's decimal point
  * character. Guaranteed to be called at the start of any valid number in a string */
 double fpconv_strtod(const char *nptr, char **endptr)
@@ -110,6 +186,10 @@ double fpconv_strtod(const char *nptr, char **endptr)
     int buflen;
     double value;
 
+    /* Most numbers in JSON documents are short plain decimals */
+    if (fast_strtod(nptr, endptr, &value))
+        return value;
+
     /* System strtod() is fine when decimal point is '.' */
     if (locale_decimal_point == '.')
         return strtod(nptr, endptr);
@@ -170,6 +250,38 @@ static void set_number_format(char *fmt, int precision)
     fmt[i] = 0;
 }
 
+/* Format an integral value which has at most precision digits. "%.14g"
+ * prints these exactly, so no snprintf() is needed. Returns 0 if the
+ * value can't be handled. */
+static int integer_g_fmt(char *str, double num, int precision)
+{
+    char buf[24];
+    char *b = buf + sizeof(buf);
+    uint64_t n;
+    int len;
+
+    if (!(num > -exact_pow10[precision] && num < exact_pow10[precision]))
+        return 0;
+    if (num == 0 && 1 / num < 0)
+        return 0;       /* -0 */
+    n = (uint64_t)(num < 0 ? -num : num);
+    if ((double)n != (num < 0 ? -num : num))
+        return 0;
+
+    do {
+        *--b = '0' + n % 10;
+        n /= 10;
+    } while (n);
+    if (num < 0)
+        *--b = '-';
+
+    len = buf + sizeof(buf) - b;
+    memcpy(str, b, len);
+    str[len] = 0;
+
+    return len;
+}
+
 /* Assumes there is always at least 32 characters available in the target buffer */
 int fpconv_g_fmt(char *str, double num, int precision)
 {
@@ -178,6 +290,11 @@ int fpconv_g_fmt(char *str, double num, int precision)
     int len;
     char *b;
 
+    /* Integers are the most common numbers and need no formatting */
+    len = integer_g_fmt(str, num, precision);
+    if (len)
+        return len;
+
     set_number_format(fmt, precision);
 
     /* Pass through when decimal point character is dot. */
@@ -37,6 +37,7 @@
  */
 
 #include <assert.h>
+#include <stdint.h>
 #include <string.h>
 #include <math.h>
 #include <limits.h>
@@ -119,9 +120,10 @@ typedef struct {
     json_token_type_t ch2token[256];
     char escape2char[256];  /* Decoding */
 
-    /* encode_buf is only allocated and used when
+    /* encode_buf and decode_buf are only allocated and used when
      * encode_keep_buffer is set */
     strbuf_t encode_buf;
+    strbuf_t decode_buf;
 
     int encode_sparse_convert;
     int encode_sparse_ratio;
@@ -138,9 +140,12 @@ typedef struct {
 typedef struct {
     const char *data;
     const char *ptr;
+    const char *end;
     strbuf_t *tmp;    /* Temporary storage for strings */
     json_config_t *cfg;
     int current_depth;
+    int target;       /* Stack index of the table to decode into */
+    int target_used;  /* Set once the target has been emptied for use */
 } json_parse_t;
 
 typedef struct {
@@ -193,6 +198,106 @@ static const char *char2escape[256] = {
     NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
 };
 
+/* ===== WORD SCANNING =====
+ *
+ * Strings are scanned a machine word at a time. Each helper sets the
+ * top bit of the bytes it is looking for, so a word can be rejected
+ * with a single test before falling back to a byte loop. */
+
+typedef unsigned long json_word_t;
+
+#define JSON_WORD_ONES      ((json_word_t)-1 / 0xff)
+#define JSON_WORD_HIGHS     (JSON_WORD_ONES * 0x80)
+#define JSON_WORD_REP(c)    (JSON_WORD_ONES * (unsigned char)(c))
+#define JSON_WORD_ALIGNED(p) (((uintptr_t)(p) & (sizeof(json_word_t) - 1)) == 0)
+
+/* Non zero if any byte is less than n, n <= 128 */
+static inline json_word_t json_word_less(json_word_t x, unsigned char n)
+{
+    return (x - JSON_WORD_REP(n)) & ~x & JSON_WORD_HIGHS;
+}
+
+/* Non zero if any byte equals c */
+static inline json_word_t json_word_equal(json_word_t x, unsigned char c)
+{
+    return json_word_less(x ^ JSON_WORD_REP(c), 1);
+}
+
+/* Exact per byte flags of the bytes which are not zero */
+static inline json_word_t json_word_nonzero(json_word_t x)
+{
+    return (((x & ~JSON_WORD_HIGHS) + ~JSON_WORD_HIGHS) | x) & JSON_WORD_HIGHS;
+}
+
+/* Length of the leading run of characters which need no escaping */
+static size_t json_scan_plain(const char *str, size_t len)
+{
+    const char *p = str;
+    const char *end = str + len;
+    json_word_t x;
+
+    while (p < end && !JSON_WORD_ALIGNED(p)) {
+        if (char2escape[(unsigned char)*p])
+            return p - str;
+        p++;
+    }
+    while (p + sizeof(json_word_t) <= end) {
+        memcpy(&x, p, sizeof(x));
+        if (json_word_less(x, 0x20) | json_word_equal(x, '"') |
+            json_word_equal(x, '\\') | json_word_equal(x, '/') |
+            json_word_equal(x, 0x7f))
+            break;
+        p += sizeof(json_word_t);
+    }
+    while (p < end && !char2escape[(unsigned char)*p])
+        p++;
+
+    return p - str;
+}
+
+/* Returns the first quote, backslash or NULL at or after p */
+static const char *json_scan_string(const char *p, const char *end)
+{
+    json_word_t x;
+
+    while (p < end && !JSON_WORD_ALIGNED(p)) {
+        if (*p == '"' || *p == '\\' || !*p)
+            return p;
+        p++;
+    }
+    while (p + sizeof(json_word_t) <= end) {
+        memcpy(&x, p, sizeof(x));
+        if (json_word_less(x, 1) | json_word_equal(x, '"') |
+            json_word_equal(x, '\\'))
+            break;
+        p += sizeof(json_word_t);
+    }
+    while (*p != '"' && *p != '\\' && *p)
+        p++;
+
+    return p;
+}
+
+/* Skips aligned words made up of JSON whitespace only */
+static const char *json_skip_whitespace(const char *p, const char *end)
+{
+    json_word_t x;
+
+    if (!JSON_WORD_ALIGNED(p))
+        return p;
+    while (p + sizeof(json_word_t) <= end) {
+        memcpy(&x, p, sizeof(x));
+        if (json_word_nonzero(x ^ JSON_WORD_REP(' ')) &
+            json_word_nonzero(x ^ JSON_WORD_REP('\t')) &
+            json_word_nonzero(x ^ JSON_WORD_REP('\n')) &
+            json_word_nonzero(x ^ JSON_WORD_REP('\r')))
+            break;
+        p += sizeof(json_word_t);
+    }
+
+    return p;
+}
+
 /* ===== CONFIGURATION ===== */
 
 static json_config_t *json_fetch_config(lua_State *l)
@@ -316,12 +421,15 @@ static int json_cfg_encode_keep_buffer(lua_State *l)
 
     json_enum_option(l, 1, &cfg->encode_keep_buffer, NULL, 1);
 
-    /* Init / free the buffer if the setting has changed */
+    /* Init / free the buffers if the setting has changed */
     if (old_value ^ cfg->encode_keep_buffer) {
-        if (cfg->encode_keep_buffer)
+        if (cfg->encode_keep_buffer) {
             strbuf_init(&cfg->encode_buf, 0);
-        else
+            strbuf_init(&cfg->decode_buf, 0);
+        } else {
             strbuf_free(&cfg->encode_buf);
+            strbuf_free(&cfg->decode_buf);
+        }
     }
 
     return 1;
@@ -367,8 +475,10 @@ static int json_destroy_config(lua_State *l)
     json_config_t *cfg;
 
     cfg = (json_config_t *)lua_touserdata(l, 1);
-    if (cfg)
+    if (cfg) {
         strbuf_free(&cfg->encode_buf);
+        strbuf_free(&cfg->decode_buf);
+    }
     cfg = NULL;
 
     return 0;
@@ -399,6 +509,7 @@ static void json_create_config(lua_State *l)
 
 #if DEFAULT_ENCODE_KEEP_BUFFER > 0
     strbuf_init(&cfg->encode_buf, 0);
+    strbuf_init(&cfg->decode_buf, 0);
 #endif
 
     /* Decoding init */
@@ -469,6 +580,7 @@ static void json_append_string(lua_State *l, strbuf_t *json, int lindex)
     const char *escstr;
     const char *str;
     size_t len;
+    size_t run;
     size_t i;
 
     str = lua_tolstring(l, lindex, &len);
@@ -481,6 +593,13 @@ static void json_append_string(lua_State *l, strbuf_t *json, int lindex)
 
     strbuf_append_char_unsafe(json, '\"');
     for (i = 0; i < len; i++) {
+        /* Copy the run of characters which need no escaping */
+        run = json_scan_plain(str + i, len - i);
+        strbuf_append_mem_unsafe(json, str + i, run);
+        i += run;
+        if (i >= len)
+            break;
+
         escstr = char2escape[(unsigned char)str[i]];
         if (escstr)
             strbuf_append_string(json, escstr);
@@ -897,6 +1016,7 @@ static void json_set_token_error(json_token_t *token, json_parse_t *json,
 static void json_next_string_token(json_parse_t *json, json_token_t *token)
 {
     char *escape2char = json->cfg->escape2char;
+    const char *run;
     char ch;
 
     /* Caller must ensure a string is next */
@@ -940,11 +1060,19 @@ static void json_next_string_token(json_parse_t *json, json_token_t *token)
 
             /* Skip '\' */
             json->ptr++;
+
+            /* Append translated single character
+             * Unicode escapes are handled above */
+            strbuf_append_char_unsafe(json->tmp, ch);
+            json->ptr++;
+            continue;
         }
-        /* Append normal character or translated single character
-         * Unicode escapes are handled above */
-        strbuf_append_char_unsafe(json->tmp, ch);
-        json->ptr++;
+
+        /* Append the run of normal characters up to the next quote,
+         * escape or end of string */
+        run = json_scan_string(json->ptr, json->end);
+        strbuf_append_mem_unsafe(json->tmp, json->ptr, run - json->ptr);
+        json->ptr = run;
     }
     json->ptr++;    /* Eat final quote (") */
 
@@ -1034,7 +1162,7 @@ static void json_next_token(json_parse_t *json, json_token_t *token)
         token->type = ch2token[ch];
         if (token->type != T_WHITESPACE)
             break;
-        json->ptr++;
+        json->ptr = json_skip_whitespace(json->ptr + 1, json->end);
     }
 
     /* Store location of new token. Required when throwing errors
@@ -1108,12 +1236,37 @@ static void json_next_token(json_parse_t *json, json_token_t *token)
  * json->tmp struct.
  * json and token should exist on the stack somewhere.
  * luaL_error() will long_jmp and release the stack */
+/* Remove every key from the table at the absolute index idx */
+static void json_clear_table(lua_State *l, int idx)
+{
+    lua_pushnil(l);
+    while (lua_next(l, idx) != 0) {
+        lua_pop(l, 1);
+        lua_pushvalue(l, -1);
+        lua_pushnil(l);
+        lua_rawset(l, idx);
+    }
+}
+
+/* Release the decode state before raising an error. A target table that
+ * was partially filled is left empty rather than half decoded. */
+static void json_decode_abort(lua_State *l, json_parse_t *json)
+{
+    if (!json->cfg->encode_keep_buffer)
+        strbuf_free(json->tmp);
+
+    if (json->target_used) {
+        lua_settop(l, json->target);
+        json_clear_table(l, json->target);
+    }
+}
+
 static void json_throw_parse_error(lua_State *l, json_parse_t *json,
                                    const char *exp, json_token_t *token)
 {
     const char *found;
 
-    strbuf_free(json->tmp);
+    json_decode_abort(l, json);
 
     if (token->type == T_ERROR)
         found = token->value.string;
@@ -1130,6 +1283,25 @@ static inline void json_decode_ascend(json_parse_t *json)
     json->current_depth--;
 }
 
+/* Pushes the table to decode the next object or array into. The caller
+ * supplied table is emptied and reused for the outermost one, which keeps
+ * its allocated array and hash parts instead of creating garbage.
+ *
+ * This is destructive: the previous contents are gone as soon as decoding
+ * reaches the outermost object or array, and if the document turns out to
+ * be invalid the table is left empty. */
+static void json_decode_table(lua_State *l, json_parse_t *json)
+{
+    if (!json->target || json->target_used) {
+        lua_newtable(l);
+        return;
+    }
+
+    json->target_used = 1;
+    json_clear_table(l, json->target);
+    lua_pushvalue(l, json->target);
+}
+
 static void json_decode_descend(lua_State *l, json_parse_t *json, int slots)
 {
     json->current_depth++;
@@ -1139,7 +1311,7 @@ static void json_decode_descend(lua_State *l, json_parse_t *json, int slots)
         return;
     }
 
-    strbuf_free(json->tmp);
+    json_decode_abort(l, json);
     luaL_error(l, "Found too many nested data structures (%d) at character %d",
         json->current_depth, json->ptr - json->data);
 }
@@ -1152,7 +1324,7 @@ static void json_parse_object_context(lua_State *l, json_parse_t *json)
      * .., table, key, value */
     json_decode_descend(l, json, 3);
 
-    lua_newtable(l);
+    json_decode_table(l, json);
 
     json_next_token(json, &token);
 
@@ -1204,7 +1376,7 @@ static void json_parse_array_context(lua_State *l, json_parse_t *json)
      * .., table, value */
     json_decode_descend(l, json, 2);
 
-    lua_newtable(l);
+    json_decode_table(l, json);
 
     json_next_token(json, &token);
 
@@ -1268,12 +1440,22 @@ static int json_decode(lua_State *l)
     json_token_t token;
     size_t json_len;
 
-    luaL_argcheck(l, lua_gettop(l) == 1, 1, "expected 1 argument");
+    luaL_argcheck(l, lua_gettop(l) == 1 || lua_gettop(l) == 2, 1,
+                  "expected 1 or 2 arguments");
 
     json.cfg = json_fetch_config(l);
     json.data = luaL_checklstring(l, 1, &json_len);
     json.current_depth = 0;
     json.ptr = json.data;
+    json.end = json.data + json_len;
+    json.target = 0;
+    json.target_used = 0;
+
+    /* Optional table to decode the outermost object or array into */
+    if (!lua_isnoneornil(l, 2)) {
+        luaL_checktype(l, 2, LUA_TTABLE);
+        json.target = 2;
+    }
 
     /* Detect Unicode other than UTF-8 (see RFC 4627, Sec 3)
      *
@@ -1286,7 +1468,13 @@ static int json_decode(lua_State *l)
     /* Ensure the temporary buffer can hold the entire string.
      * This means we no longer need to do length checks since the decoded
      * string must be smaller than the entire json string */
-    json.tmp = strbuf_new(json_len);
+    if (!json.cfg->encode_keep_buffer) {
+        json.tmp = strbuf_new(json_len);
+    } else {
+        json.tmp = &json.cfg->decode_buf;
+        strbuf_reset(json.tmp);
+        strbuf_ensure_empty_length(json.tmp, json_len);
+    }
 
     json_next_token(&json, &token);
     json_process_value(l, &json, &token);
@@ -1297,7 +1485,8 @@ static int json_decode(lua_State *l)
     if (token.type != T_END)
         json_throw_parse_error(l, &json, "the end", &token);
 
-    strbuf_free(json.tmp);
+    if (!json.cfg->encode_keep_buffer)
+        strbuf_free(json.tmp);
 
     return 1;
 }
@@ -1332,12 +1521,13 @@ static int json_protect_conversion(lua_State *l)
     int err;
 
     /* Deliberately throw an error for invalid arguments */
-    luaL_argcheck(l, lua_gettop(l) == 1, 1, "expected 1 argument");
+    luaL_argcheck(l, lua_gettop(l) == 1 || lua_gettop(l) == 2, 1,
+                  "expected 1 or 2 arguments");
 
     /* pcall() the function stored as upvalue(1) */
     lua_pushvalue(l, lua_upvalueindex(1));
     lua_insert(l, 1);
-    err = lua_pcall(l, 1, 1, 0);
+    err = lua_pcall(l, lua_gettop(l) - 1, 1, 0);
     if (!err)
         return 1;
 
@@ -104,7 +104,14 @@
     ((type *)(((uint8_t *)data) - offsetof (type, member)))
 
 /* TLS */
-#if defined(PIXMAN_NO_TLS)
+#if defined(PIXMAN_PER_CPU_TLS)
+
+#   define PIXMAN_DEFINE_THREAD_LOCAL(type, name)			\
+    static type name[CONFIG_MAX_SMP_CPUS]
+#   define PIXMAN_GET_THREAD_LOCAL(name)				\
+    (&name[smp_processor_id ()])
+
+#elif defined(PIXMAN_NO_TLS)
 
 #   define PIXMAN_DEFINE_THREAD_LOCAL(type, name)			\
     static type name
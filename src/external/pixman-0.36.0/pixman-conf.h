@@ -29,7 +29,7 @@
 
 #ifdef __ARM64__
 # undef USE_ARM_SIMD
-# undef USE_ARM_NEON
+# define USE_ARM_NEON
 #endif
 
 #ifdef __X64__
@@ -38,7 +38,11 @@
 # define USE_SSSE3
 #endif
 
+#if defined(CONFIG_MAX_SMP_CPUS) && (CONFIG_MAX_SMP_CPUS > 1)
+#define PIXMAN_PER_CPU_TLS		(1)
+#else
 #define PIXMAN_NO_TLS 			(1)
+#endif
 #define HAVE_BUILTIN_CLZ		(1)
 
 #endif /* __PIXMAN_CONF_H__ */
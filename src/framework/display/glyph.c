@@ -0,0 +1,495 @@
+/*
+ * framework/display/glyph.c
+ *
+ * Copyright(c) 2007-2018 Jianjun Jiang <8192542@qq.com>
+ * Official site: http://xboot.org
+ * Mobile phone: +86-18665388956
+ * QQ: 8192542
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <xboot.h>
+#include <framework/display/glyph.h>
+
+/*
+ * Glyph cache. Every glyph is filled once per (size, subpixel phase) into
+ * an A8 atlas using the same outline path that cairo_text_path produces.
+ * Strings are then assembled from the atlas into an A8 run mask which is
+ * kept in a small LRU, so an unchanged string costs one masked blit.
+ * Only axis aligned transforms are handled; anything else returns NULL
+ * and the caller falls back to filling the outline.
+ */
+#define GLYPH_ATLAS_SIZE		(512)
+#define GLYPH_HASH_SIZE			(256)
+#define GLYPH_SUBPIXEL			(4)
+#define GLYPH_MAX_PIXEL_SIZE	(256)
+#define GLYPH_MAX_SIZES			(8)
+#define GLYPH_MAX_RUNS			(256)
+#define GLYPH_MAX_RUN_BYTES		(SZ_2M)
+
+struct glyph_size_t {
+	struct list_head entry;
+	int xx, yy;
+	cairo_scaled_font_t * sfont;
+};
+
+struct glyph_t {
+	struct hlist_node node;
+	unsigned long index;
+	int xx, yy;
+	int phase;
+	int x, y, w, h;
+	int left, top;
+};
+
+struct glyph_run_t {
+	struct hlist_node node;
+	struct list_head entry;
+	unsigned int hash;
+	int xx, yy;
+	int phase;
+	char * text;
+	cairo_surface_t * mask;
+	int left, top;
+	size_t bytes;
+};
+
+struct glyph_cache_t {
+	cairo_font_face_t * face;
+	cairo_font_options_t * options;
+	cairo_surface_t * atlas;
+	cairo_t * cr;
+	int shelf_x, shelf_y, shelf_h;
+	unsigned int generation;
+
+	struct hlist_head glyphs[GLYPH_HASH_SIZE];
+	struct hlist_head runs[GLYPH_HASH_SIZE];
+	struct list_head sizes;
+	struct list_head lru;
+	int nsize;
+	int nrun;
+	size_t bytes;
+};
+
+static inline unsigned int glyph_hash(unsigned long index, int xx, int yy, int phase)
+{
+	return (unsigned int)(index * 131 + xx * 31 + yy * 7 + phase) % GLYPH_HASH_SIZE;
+}
+
+static unsigned int glyph_run_hash(const char * text, int xx, int yy, int phase)
+{
+	unsigned char * p = (unsigned char *)text;
+	unsigned int seed = 131;
+	unsigned int hash = (xx * 31 + yy) * 7 + phase;
+
+	while(*p)
+	{
+		hash = hash * seed + (*p++);
+	}
+	return hash;
+}
+
+static void glyph_cache_reset(struct glyph_cache_t * c)
+{
+	struct glyph_t * pos;
+	struct hlist_node * n;
+	int i;
+
+	for(i = 0; i < GLYPH_HASH_SIZE; i++)
+	{
+		hlist_for_each_entry_safe(pos, n, &c->glyphs[i], node)
+		{
+			hlist_del(&pos->node);
+			free(pos);
+		}
+	}
+	cairo_save(c->cr);
+	cairo_set_operator(c->cr, CAIRO_OPERATOR_CLEAR);
+	cairo_paint(c->cr);
+	cairo_restore(c->cr);
+	c->shelf_x = 0;
+	c->shelf_y = 0;
+	c->shelf_h = 0;
+	c->generation++;
+}
+
+static void glyph_run_destroy(struct glyph_cache_t * c, struct glyph_run_t * run)
+{
+	hlist_del(&run->node);
+	list_del(&run->entry);
+	c->nrun--;
+	c->bytes -= run->bytes;
+	cairo_surface_destroy(run->mask);
+	free(run->text);
+	free(run);
+}
+
+static struct glyph_size_t * glyph_cache_size(struct glyph_cache_t * c, int xx, int yy)
+{
+	struct glyph_size_t * pos, * n;
+	cairo_matrix_t fm, ctm;
+
+	list_for_each_entry_safe(pos, n, &c->sizes, entry)
+	{
+		if((pos->xx == xx) && (pos->yy == yy))
+		{
+			list_move(&pos->entry, &c->sizes);
+			return pos;
+		}
+	}
+
+	pos = malloc(sizeof(struct glyph_size_t));
+	if(!pos)
+		return NULL;
+	cairo_matrix_init_scale(&fm, xx / 64.0, yy / 64.0);
+	cairo_matrix_init_identity(&ctm);
+	pos->sfont = cairo_scaled_font_create(c->face, &fm, &ctm, c->options);
+	if(cairo_scaled_font_status(pos->sfont) != CAIRO_STATUS_SUCCESS)
+	{
+		cairo_scaled_font_destroy(pos->sfont);
+		free(pos);
+		return NULL;
+	}
+	pos->xx = xx;
+	pos->yy = yy;
+	list_add(&pos->entry, &c->sizes);
+	if(++c->nsize > GLYPH_MAX_SIZES)
+	{
+		n = list_last_entry(&c->sizes, struct glyph_size_t, entry);
+		list_del(&n->entry);
+		cairo_scaled_font_destroy(n->sfont);
+		free(n);
+		c->nsize--;
+	}
+	return pos;
+}
+
+static struct glyph_t * glyph_cache_glyph(struct glyph_cache_t * c, struct glyph_size_t * size, unsigned long index, int phase)
+{
+	struct hlist_head * head = &c->glyphs[glyph_hash(index, size->xx, size->yy, phase)];
+	struct glyph_t * pos;
+	struct hlist_node * n;
+	cairo_glyph_t glyph;
+	double x1, y1, x2, y2;
+
+	hlist_for_each_entry_safe(pos, n, head, node)
+	{
+		if((pos->index == index) && (pos->phase == phase) && (pos->xx == size->xx) && (pos->yy == size->yy))
+			return pos;
+	}
+
+	pos = malloc(sizeof(struct glyph_t));
+	if(!pos)
+		return NULL;
+	pos->index = index;
+	pos->xx = size->xx;
+	pos->yy = size->yy;
+	pos->phase = phase;
+
+	glyph.index = index;
+	glyph.x = (double)phase / GLYPH_SUBPIXEL;
+	glyph.y = 0;
+	cairo_set_scaled_font(c->cr, size->sfont);
+	cairo_new_path(c->cr);
+	cairo_glyph_path(c->cr, &glyph, 1);
+	cairo_fill_extents(c->cr, &x1, &y1, &x2, &y2);
+	cairo_new_path(c->cr);
+	if((x2 > x1) && (y2 > y1))
+	{
+		pos->left = floor(x1);
+		pos->top = floor(y1);
+		pos->w = (int)ceil(x2) - pos->left;
+		pos->h = (int)ceil(y2) - pos->top;
+		if((pos->w + 1 > GLYPH_ATLAS_SIZE) || (pos->h + 1 > GLYPH_ATLAS_SIZE))
+		{
+			free(pos);
+			return NULL;
+		}
+		if(c->shelf_x + pos->w + 1 > GLYPH_ATLAS_SIZE)
+		{
+			c->shelf_x = 0;
+			c->shelf_y += c->shelf_h;
+			c->shelf_h = 0;
+		}
+		if(c->shelf_y + pos->h + 1 > GLYPH_ATLAS_SIZE)
+			glyph_cache_reset(c);
+		pos->x = c->shelf_x;
+		pos->y = c->shelf_y;
+		c->shelf_x += pos->w + 1;
+		if(c->shelf_h < pos->h + 1)
+			c->shelf_h = pos->h + 1;
+
+		cairo_save(c->cr);
+		cairo_rectangle(c->cr, pos->x, pos->y, pos->w, pos->h);
+		cairo_clip(c->cr);
+		cairo_translate(c->cr, pos->x - pos->left, pos->y - pos->top);
+		cairo_glyph_path(c->cr, &glyph, 1);
+		cairo_fill(c->cr);
+		cairo_restore(c->cr);
+	}
+	else
+	{
+		pos->left = 0;
+		pos->top = 0;
+		pos->x = 0;
+		pos->y = 0;
+		pos->w = 0;
+		pos->h = 0;
+	}
+	hlist_add_head(&pos->node, head);
+
+	return pos;
+}
+
+static struct glyph_run_t * glyph_run_build(struct glyph_cache_t * c, const char * text, int xx, int yy, int phase)
+{
+	struct glyph_size_t * size;
+	struct glyph_run_t * run;
+	struct glyph_t ** gs;
+	cairo_glyph_t * glyphs = NULL;
+	cairo_t * cr;
+	int * gx, * gy;
+	int x1, y1, x2, y2;
+	int num = 0, retry = 0;
+	int x, p, i;
+	unsigned int generation;
+
+	size = glyph_cache_size(c, xx, yy);
+	if(!size)
+		return NULL;
+	if(cairo_scaled_font_text_to_glyphs(size->sfont, (double)phase / GLYPH_SUBPIXEL, 0, text, -1, &glyphs, &num, NULL, NULL, NULL) != CAIRO_STATUS_SUCCESS)
+		return NULL;
+
+	gs = malloc(num * (sizeof(struct glyph_t *) + sizeof(int) * 2) + 1);
+	if(!gs)
+	{
+		cairo_glyph_free(glyphs);
+		return NULL;
+	}
+	gx = (int *)(gs + num);
+	gy = gx + num;
+
+again:
+	generation = c->generation;
+	for(i = 0; i < num; i++)
+	{
+		x = floor(glyphs[i].x);
+		p = floor((glyphs[i].x - x) * GLYPH_SUBPIXEL + 0.5);
+		if(p >= GLYPH_SUBPIXEL)
+		{
+			x++;
+			p = 0;
+		}
+		gx[i] = x;
+		gy[i] = floor(glyphs[i].y + 0.5);
+		gs[i] = glyph_cache_glyph(c, size, glyphs[i].index, p);
+		if(!gs[i])
+			break;
+		if(c->generation != generation)
+		{
+			/* The atlas was recycled under us, start over once */
+			if(retry++)
+				break;
+			goto again;
+		}
+	}
+	cairo_glyph_free(glyphs);
+	if(i < num)
+	{
+		free(gs);
+		return NULL;
+	}
+
+	x1 = y1 = INT_MAX;
+	x2 = y2 = INT_MIN;
+	for(i = 0; i < num; i++)
+	{
+		if(gs[i]->w > 0)
+		{
+			if(gx[i] + gs[i]->left < x1)
+				x1 = gx[i] + gs[i]->left;
+			if(gy[i] + gs[i]->top < y1)
+				y1 = gy[i] + gs[i]->top;
+			if(gx[i] + gs[i]->left + gs[i]->w > x2)
+				x2 = gx[i] + gs[i]->left + gs[i]->w;
+			if(gy[i] + gs[i]->top + gs[i]->h > y2)
+				y2 = gy[i] + gs[i]->top + gs[i]->h;
+		}
+	}
+	if(x2 <= x1 || y2 <= y1)
+	{
+		x1 = y1 = 0;
+		x2 = y2 = 1;
+	}
+
+	run = malloc(sizeof(struct glyph_run_t));
+	if(!run)
+	{
+		free(gs);
+		return NULL;
+	}
+	run->mask = cairo_image_surface_create(CAIRO_FORMAT_A8, x2 - x1, y2 - y1);
+	cr = cairo_create(run->mask);
+	for(i = 0; i < num; i++)
+	{
+		if(gs[i]->w > 0)
+		{
+			x = gx[i] + gs[i]->left - x1;
+			p = gy[i] + gs[i]->top - y1;
+			cairo_set_source_surface(cr, c->atlas, x - gs[i]->x, p - gs[i]->y);
+			cairo_rectangle(cr, x, p, gs[i]->w, gs[i]->h);
+			cairo_fill(cr);
+		}
+	}
+	cairo_destroy(cr);
+	cairo_surface_flush(run->mask);
+	free(gs);
+
+	run->text = strdup(text);
+	run->xx = xx;
+	run->yy = yy;
+	run->phase = phase;
+	run->left = x1;
+	run->top = y1;
+	run->bytes = cairo_image_surface_get_stride(run->mask) * (y2 - y1);
+	return run;
+}
+
+struct glyph_cache_t * glyph_cache_alloc(cairo_font_face_t * face)
+{
+	struct glyph_cache_t * c;
+	int i;
+
+	if(!face)
+		return NULL;
+
+	c = malloc(sizeof(struct glyph_cache_t));
+	if(!c)
+		return NULL;
+
+	c->atlas = cairo_image_surface_create(CAIRO_FORMAT_A8, GLYPH_ATLAS_SIZE, GLYPH_ATLAS_SIZE);
+	if(cairo_surface_status(c->atlas) != CAIRO_STATUS_SUCCESS)
+	{
+		cairo_surface_destroy(c->atlas);
+		free(c);
+		return NULL;
+	}
+	c->cr = cairo_create(c->atlas);
+	c->options = cairo_font_options_create();
+	cairo_surface_get_font_options(c->atlas, c->options);
+	c->face = cairo_font_face_reference(face);
+	c->shelf_x = 0;
+	c->shelf_y = 0;
+	c->shelf_h = 0;
+	c->generation = 0;
+	for(i = 0; i < GLYPH_HASH_SIZE; i++)
+	{
+		init_hlist_head(&c->glyphs[i]);
+		init_hlist_head(&c->runs[i]);
+	}
+	init_list_head(&c->sizes);
+	init_list_head(&c->lru);
+	c->nsize = 0;
+	c->nrun = 0;
+	c->bytes = 0;
+
+	return c;
+}
+
+void glyph_cache_free(struct glyph_cache_t * c)
+{
+	struct glyph_size_t * pos, * n;
+	struct glyph_run_t * rpos, * rn;
+
+	if(c)
+	{
+		glyph_cache_reset(c);
+		list_for_each_entry_safe(rpos, rn, &c->lru, entry)
+		{
+			glyph_run_destroy(c, rpos);
+		}
+		list_for_each_entry_safe(pos, n, &c->sizes, entry)
+		{
+			list_del(&pos->entry);
+			cairo_scaled_font_destroy(pos->sfont);
+			free(pos);
+		}
+		cairo_destroy(c->cr);
+		cairo_surface_destroy(c->atlas);
+		cairo_font_options_destroy(c->options);
+		cairo_font_face_destroy(c->face);
+		free(c);
+	}
+}
+
+cairo_surface_t * glyph_cache_lookup(struct glyph_cache_t * c, const char * text, cairo_matrix_t * m, int * x, int * y)
+{
+	struct glyph_run_t * run, * last;
+	struct hlist_node * n;
+	unsigned int hash;
+	int xx, yy, phase;
+	double ox, oy;
+
+	if(!c || !text || (m->xy != 0) || (m->yx != 0))
+		return NULL;
+	if(!(m->xx > 0) || !(m->yy > 0) || (m->xx > GLYPH_MAX_PIXEL_SIZE) || (m->yy > GLYPH_MAX_PIXEL_SIZE))
+		return NULL;
+
+	xx = floor(m->xx * 64 + 0.5);
+	yy = floor(m->yy * 64 + 0.5);
+	ox = floor(m->x0);
+	oy = floor(m->y0 + 0.5);
+	phase = floor((m->x0 - ox) * GLYPH_SUBPIXEL + 0.5);
+	if(phase >= GLYPH_SUBPIXEL)
+	{
+		ox += 1;
+		phase = 0;
+	}
+
+	hash = glyph_run_hash(text, xx, yy, phase);
+	hlist_for_each_entry_safe(run, n, &c->runs[hash % GLYPH_HASH_SIZE], node)
+	{
+		if((run->hash == hash) && (run->xx == xx) && (run->yy == yy) && (run->phase == phase) && (strcmp(run->text, text) == 0))
+		{
+			list_move(&run->entry, &c->lru);
+			*x = ox + run->left;
+			*y = oy + run->top;
+			return run->mask;
+		}
+	}
+
+	run = glyph_run_build(c, text, xx, yy, phase);
+	if(!run)
+		return NULL;
+	run->hash = hash;
+	hlist_add_head(&run->node, &c->runs[hash % GLYPH_HASH_SIZE]);
+	list_add(&run->entry, &c->lru);
+	c->nrun++;
+	c->bytes += run->bytes;
+	while((c->nrun > 1) && ((c->nrun > GLYPH_MAX_RUNS) || (c->bytes > GLYPH_MAX_RUN_BYTES)))
+	{
+		last = list_last_entry(&c->lru, struct glyph_run_t, entry);
+		glyph_run_destroy(c, last);
+	}
+	*x = ox + run->left;
+	*y = oy + run->top;
+	return run->mask;
+}
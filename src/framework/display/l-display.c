@@ -27,16 +27,48 @@
  */
 
 #include <cairo.h>
+#include <cairoint.h>
 #include <cairo-xboot.h>
 #include <framework/display/l-display.h>
+#include <framework/display/tiler.h>
+#include <framework/display/glyph.h>
 
 extern cairo_scaled_font_t * luaL_checkudata_scaled_font(lua_State * L, int ud, const char * tname);
+extern struct glyph_cache_t * luaL_checkudata_glyph_cache(lua_State * L, int ud, const char * tname);
+
+#define DISPLAY_CACHE_DEPTH		(8)
+#define DISPLAY_CACHE_SIZE		(2048)
+#define DISPLAY_PAGE_MAX		(2)
 
 struct ldisplay_t {
 	struct framebuffer_t * fb;
 	cairo_surface_t * alone;
 	cairo_surface_t * cs;
 	cairo_t * cr;
+	struct tiler_t * tiler;
+
+	struct {
+		cairo_surface_t * cs;
+		cairo_t * cr;
+		struct tiler_t * tiler;
+	} page[DISPLAY_PAGE_MAX];
+	int npage;
+	int index;
+	int opaque;
+
+	struct {
+		cairo_t * cr;
+		struct tiler_t * tiler;
+		cairo_matrix_t redirect;
+	} stack[DISPLAY_CACHE_DEPTH];
+	int depth;
+
+	int vsync;
+	u64_t vcount;
+	u64_t missed;
+
+	s64_t gcbudget;
+	s64_t gctime;
 
 	int showfps;
 	double fps;
@@ -49,13 +81,35 @@ static int l_display_new(lua_State * L)
 	const char * name = luaL_optstring(L, 1, NULL);
 	struct ldisplay_t * display;
 	struct framebuffer_t * fb = name ? search_framebuffer(name) : search_first_framebuffer();
+	int i;
 	if(!fb)
 		return 0;
 	display = lua_newuserdata(L, sizeof(struct ldisplay_t));
 	display->fb = fb;
 	display->alone = cairo_xboot_surface_create(display->fb, display->fb->alone);
-	display->cs = cairo_xboot_surface_create(display->fb, NULL);
-	display->cr = cairo_create(display->cs);
+	display->npage = framebuffer_can_flip(display->fb) ? DISPLAY_PAGE_MAX : 1;
+	for(i = 0; i < display->npage; i++)
+	{
+		display->page[i].cs = cairo_xboot_surface_create(display->fb, NULL);
+		display->page[i].cr = cairo_create(display->page[i].cs);
+		display->page[i].tiler = NULL;
+		cairo_save(display->page[i].cr);
+		cairo_set_source_rgb(display->page[i].cr, 1, 1, 1);
+		cairo_set_operator(display->page[i].cr, CAIRO_OPERATOR_SOURCE);
+		cairo_paint(display->page[i].cr);
+		cairo_restore(display->page[i].cr);
+	}
+	display->index = 0;
+	display->opaque = 0;
+	display->cs = display->page[0].cs;
+	display->cr = display->page[0].cr;
+	display->tiler = NULL;
+	display->depth = 0;
+	display->vsync = 0;
+	display->vcount = 0;
+	display->missed = 0;
+	display->gcbudget = 0;
+	display->gctime = 0;
 	display->showfps = 0;
 	display->fps = 60;
 	display->frame = 0;
@@ -69,13 +123,43 @@ static const luaL_Reg l_display[] = {
 	{NULL,	NULL}
 };
 
+/*
+ * While a subtree is rendered into its bitmap cache every draw is redirected
+ * from screen space into the pixel space of that cache.
+ */
+static inline cairo_matrix_t * display_matrix(struct ldisplay_t * display, cairo_matrix_t * m, cairo_matrix_t * t)
+{
+	if(display->depth <= 0)
+		return m;
+	cairo_matrix_multiply(t, m, &display->stack[display->depth - 1].redirect);
+	return t;
+}
+
+static void display_cache_pop(struct ldisplay_t * display)
+{
+	if(display->depth > 0)
+	{
+		cairo_destroy(display->cr);
+		display->depth--;
+		display->cr = display->stack[display->depth].cr;
+		display->tiler = display->stack[display->depth].tiler;
+	}
+}
+
 static int m_display_gc(lua_State * L)
 {
 	struct ldisplay_t * display = luaL_checkudata(L, 1, MT_DISPLAY);
+	int i;
+	while(display->depth > 0)
+		display_cache_pop(display);
 	cairo_xboot_surface_present(display->alone, NULL, 0);
 	cairo_surface_destroy(display->alone);
-	cairo_destroy(display->cr);
-	cairo_surface_destroy(display->cs);
+	for(i = 0; i < display->npage; i++)
+	{
+		tiler_free(display->page[i].tiler);
+		cairo_destroy(display->page[i].cr);
+		cairo_surface_destroy(display->page[i].cs);
+	}
 	return 0;
 }
 
@@ -118,79 +202,130 @@ static int m_display_set_backlight(lua_State * L)
 	return 0;
 }
 
-static int m_display_draw_shape(lua_State * L)
+static void display_draw_shape(struct ldisplay_t * display, struct lobject_t * object, cairo_t ** shape)
 {
-	struct ldisplay_t * display = luaL_checkudata(L, 1, MT_DISPLAY);
-	struct lobject_t * object = luaL_checkudata(L, 2, MT_OBJECT);
-	cairo_t ** shape = luaL_checkudata(L, 3, MT_SHAPE);
 	cairo_t * cr = display->cr;
+	cairo_matrix_t m;
+	if(display->tiler)
+	{
+		tiler_paint(display->tiler, &object->__transform_matrix, cairo_get_target(*shape), CAIRO_FILTER_GOOD, object->alpha);
+		return;
+	}
 	cairo_save(cr);
-	cairo_set_matrix(cr, &object->__transform_matrix);
+	cairo_set_matrix(cr, display_matrix(display, &object->__transform_matrix, &m));
 	cairo_surface_t * surface = cairo_surface_reference(cairo_get_target(*shape));
 	cairo_set_source_surface(cr, surface, 0, 0);
 	cairo_surface_destroy(surface);
 	cairo_paint_with_alpha(cr, object->alpha);
 	cairo_restore(cr);
-	return 0;
 }
 
-static int m_display_draw_text(lua_State * L)
+static void display_draw_text(struct ldisplay_t * display, cairo_scaled_font_t * sfont, struct glyph_cache_t * glyph, const char * text, struct lpattern_t * pattern, cairo_matrix_t * matrix)
 {
-	struct ldisplay_t * display = luaL_checkudata(L, 1, MT_DISPLAY);
-	cairo_scaled_font_t * sfont = luaL_checkudata_scaled_font(L, 2, MT_FONT);
-	const char * text = luaL_optstring(L, 3, NULL);
-	struct lpattern_t * pattern = luaL_checkudata(L, 4, MT_PATTERN);
-	cairo_matrix_t * matrix = luaL_checkudata(L, 5, MT_MATRIX);
 	cairo_t * cr = display->cr;
+	cairo_surface_t * mask;
+	cairo_matrix_t m;
+	int x, y;
+	matrix = display_matrix(display, matrix, &m);
+	mask = glyph_cache_lookup(glyph, text, matrix, &x, &y);
+	if(mask)
+	{
+		if(display->tiler)
+		{
+			tiler_mask_surface(display->tiler, pattern->pattern, mask, x, y);
+			return;
+		}
+		cairo_save(cr);
+		cairo_set_source(cr, pattern->pattern);
+		cairo_mask_surface(cr, mask, x, y);
+		cairo_restore(cr);
+		return;
+	}
 	cairo_save(cr);
 	cairo_set_scaled_font(cr, sfont);
 	cairo_set_font_matrix(cr, matrix);
 	cairo_text_path(cr, text);
+	if(display->tiler)
+	{
+		double x1, y1, x2, y2;
+		cairo_fill_extents(cr, &x1, &y1, &x2, &y2);
+		tiler_fill(display->tiler, cairo_copy_path(cr), pattern->pattern, x1, y1, x2, y2);
+		cairo_new_path(cr);
+		cairo_restore(cr);
+		return;
+	}
 	cairo_set_source(cr, pattern->pattern);
 	cairo_fill(cr);
 	cairo_restore(cr);
-	return 0;
 }
 
-static int m_display_draw_texture(lua_State * L)
+static void display_draw_texture(struct ldisplay_t * display, struct lobject_t * object, struct ltexture_t * texture)
 {
-	struct ldisplay_t * display = luaL_checkudata(L, 1, MT_DISPLAY);
-	struct lobject_t * object = luaL_checkudata(L, 2, MT_OBJECT);
-	struct ltexture_t * texture = luaL_checkudata(L, 3, MT_TEXTURE);
 	cairo_t * cr = display->cr;
+	cairo_matrix_t m;
+	if(display->tiler)
+	{
+		tiler_paint(display->tiler, &object->__transform_matrix, texture->surface, CAIRO_FILTER_FAST, object->alpha);
+		return;
+	}
 	cairo_save(cr);
-	cairo_set_matrix(cr, &object->__transform_matrix);
+	cairo_set_matrix(cr, display_matrix(display, &object->__transform_matrix, &m));
 	cairo_set_source_surface(cr, texture->surface, 0, 0);
 	cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_FAST);
 	cairo_paint_with_alpha(cr, object->alpha);
 	cairo_restore(cr);
-	return 0;
 }
 
-static int m_display_draw_texture_mask(lua_State * L)
+static void display_draw_texture_mask(struct ldisplay_t * display, struct lobject_t * object, struct ltexture_t * texture, struct lpattern_t * pattern)
 {
-	struct ldisplay_t * display = luaL_checkudata(L, 1, MT_DISPLAY);
-	struct lobject_t * object = luaL_checkudata(L, 2, MT_OBJECT);
-	struct ltexture_t * texture = luaL_checkudata(L, 3, MT_TEXTURE);
-	struct lpattern_t * pattern = luaL_checkudata(L, 4, MT_PATTERN);
 	cairo_t * cr = display->cr;
+	cairo_matrix_t m;
+	if(display->tiler)
+	{
+		tiler_mask(display->tiler, &object->__transform_matrix, texture->surface, pattern->pattern);
+		return;
+	}
 	cairo_save(cr);
-	cairo_set_matrix(cr, &object->__transform_matrix);
+	cairo_set_matrix(cr, display_matrix(display, &object->__transform_matrix, &m));
 	cairo_set_source_surface(cr, texture->surface, 0, 0);
 	cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_FAST);
 	cairo_mask(cr, pattern->pattern);
 	cairo_restore(cr);
-	return 0;
 }
 
-static int m_display_draw_ninepatch(lua_State * L)
+static void tiler_ninepatch_piece(struct tiler_t * tiler, struct lobject_t * object, cairo_surface_t * cs, double tx, double ty, double sx, double sy)
+{
+	cairo_matrix_t m = object->__transform_matrix;
+
+	if(cs)
+	{
+		cairo_matrix_translate(&m, tx, ty);
+		cairo_matrix_scale(&m, sx, sy);
+		tiler_paint(tiler, &m, cs, CAIRO_FILTER_FAST, object->alpha);
+	}
+}
+
+static void display_draw_ninepatch(struct ldisplay_t * display, struct lobject_t * object, struct lninepatch_t * ninepatch)
 {
-	struct ldisplay_t * display = luaL_checkudata(L, 1, MT_DISPLAY);
-	struct lobject_t * object = luaL_checkudata(L, 2, MT_OBJECT);
-	struct lninepatch_t * ninepatch = luaL_checkudata(L, 3, MT_NINEPATCH);
 	cairo_t * cr = display->cr;
+	cairo_matrix_t m;
+	if(display->tiler)
+	{
+		double r = ninepatch->__w - ninepatch->right;
+		double b = ninepatch->__h - ninepatch->bottom;
+		tiler_ninepatch_piece(display->tiler, object, ninepatch->lt, 0, 0, 1, 1);
+		tiler_ninepatch_piece(display->tiler, object, ninepatch->mt, ninepatch->left, 0, ninepatch->__sx, 1);
+		tiler_ninepatch_piece(display->tiler, object, ninepatch->rt, r, 0, 1, 1);
+		tiler_ninepatch_piece(display->tiler, object, ninepatch->lm, 0, ninepatch->top, 1, ninepatch->__sy);
+		tiler_ninepatch_piece(display->tiler, object, ninepatch->mm, ninepatch->left, ninepatch->top, ninepatch->__sx, ninepatch->__sy);
+		tiler_ninepatch_piece(display->tiler, object, ninepatch->rm, r, ninepatch->top, 1, ninepatch->__sy);
+		tiler_ninepatch_piece(display->tiler, object, ninepatch->lb, 0, b, 1, 1);
+		tiler_ninepatch_piece(display->tiler, object, ninepatch->mb, ninepatch->left, b, ninepatch->__sx, 1);
+		tiler_ninepatch_piece(display->tiler, object, ninepatch->rb, r, b, 1, 1);
+		return;
+	}
 	cairo_save(cr);
-	cairo_set_matrix(cr, &object->__transform_matrix);
+	cairo_set_matrix(cr, display_matrix(display, &object->__transform_matrix, &m));
 	if(ninepatch->lt)
 	{
 		cairo_save(cr);
@@ -278,6 +413,292 @@ static int m_display_draw_ninepatch(lua_State * L)
 		cairo_restore(cr);
 	}
 	cairo_restore(cr);
+}
+
+static int display_cache_push(struct ldisplay_t * display, struct lobject_t * object, double x, double y, double w, double h)
+{
+	cairo_matrix_t * t = &object->__transform_matrix;
+	cairo_matrix_t inv, m;
+	cairo_t * cr;
+	int pw, ph;
+
+	if(display->depth >= DISPLAY_CACHE_DEPTH)
+		return 0;
+	pw = ceil(w * sqrt(t->xx * t->xx + t->yx * t->yx));
+	ph = ceil(h * sqrt(t->xy * t->xy + t->yy * t->yy));
+	inv = *t;
+	if((pw <= 0) || (ph <= 0) || (pw > DISPLAY_CACHE_SIZE) || (ph > DISPLAY_CACHE_SIZE) || (cairo_matrix_invert(&inv) != CAIRO_STATUS_SUCCESS))
+		return 0;
+	if(object->__cache && ((cairo_image_surface_get_width(object->__cache) != pw) || (cairo_image_surface_get_height(object->__cache) != ph)))
+	{
+		cairo_surface_destroy(object->__cache);
+		object->__cache = NULL;
+	}
+	if(!object->__cache)
+	{
+		object->__cache = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, pw, ph);
+		if(cairo_surface_status(object->__cache) != CAIRO_STATUS_SUCCESS)
+		{
+			cairo_surface_destroy(object->__cache);
+			object->__cache = NULL;
+			return 0;
+		}
+	}
+	cairo_matrix_init_translate(&object->__cache_matrix, x, y);
+	cairo_matrix_scale(&object->__cache_matrix, w / pw, h / ph);
+	cairo_matrix_init_scale(&m, pw / w, ph / h);
+	cairo_matrix_translate(&m, -x, -y);
+
+	cr = cairo_create(object->__cache);
+	cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+	cairo_paint(cr);
+	cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+
+	display->stack[display->depth].cr = display->cr;
+	display->stack[display->depth].tiler = display->tiler;
+	cairo_matrix_multiply(&display->stack[display->depth].redirect, &inv, &m);
+	display->depth++;
+	display->cr = cr;
+	display->tiler = NULL;
+	return 1;
+}
+
+static void display_draw_cache(struct ldisplay_t * display, struct lobject_t * object)
+{
+	cairo_t * cr = display->cr;
+	cairo_matrix_t m, t;
+	cairo_matrix_multiply(&m, &object->__cache_matrix, &object->__transform_matrix);
+	if(display->tiler)
+	{
+		tiler_paint(display->tiler, &m, object->__cache, CAIRO_FILTER_GOOD, object->alpha);
+		return;
+	}
+	cairo_save(cr);
+	cairo_set_matrix(cr, display_matrix(display, &m, &t));
+	cairo_set_source_surface(cr, object->__cache, 0, 0);
+	cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_GOOD);
+	cairo_paint_with_alpha(cr, object->alpha);
+	cairo_restore(cr);
+}
+
+static void display_draw_object(struct ldisplay_t * display, struct lobject_t * object)
+{
+	switch(object->__drawable)
+	{
+	case DRAWABLE_SHAPE:
+		display_draw_shape(display, object, object->__shape);
+		break;
+	case DRAWABLE_TEXT:
+		display_draw_text(display, object->__sfont, object->__glyph, object->__text, object->__pattern, &object->__transform_matrix);
+		break;
+	case DRAWABLE_TEXTURE:
+		display_draw_texture(display, object, object->__texture);
+		break;
+	case DRAWABLE_TEXTURE_MASK:
+		display_draw_texture_mask(display, object, object->__texture, object->__pattern);
+		break;
+	case DRAWABLE_NINEPATCH:
+		display_draw_ninepatch(display, object, object->__ninepatch);
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+ * Draw the content of a node, calling back into lua only when the display
+ * object overrides '__draw'. The display is always at stack index 1.
+ */
+static void display_draw_node(lua_State * L, struct ldisplay_t * display, struct lobject_t * object)
+{
+	if(!object->visible)
+		return;
+	if(object->__draw_hook)
+	{
+		if(lobject_push_owner(L, object))
+		{
+			lua_getfield(L, -1, "__draw");
+			lua_insert(L, -2);
+			lua_pushvalue(L, 1);
+			lua_call(L, 2, 0);
+		}
+	}
+	else if(object->alpha > 0)
+	{
+		display_draw_object(display, object);
+	}
+}
+
+/*
+ * Whether the subtree of an object may touch the screen, only checked while
+ * drawing to the screen itself, a cache holds the whole subtree anyway.
+ */
+static int display_in_view(struct ldisplay_t * display, struct lobject_t * object)
+{
+	double x1, y1, x2, y2;
+
+	if(display->depth > 0)
+		return 1;
+	if(!lobject_get_extents(object, &x1, &y1, &x2, &y2))
+		return 1;
+	_cairo_matrix_transform_bounding_box(&object->__transform_matrix, &x1, &y1, &x2, &y2, NULL);
+	if((x2 < -1) || (y2 < -1) || (x1 > framebuffer_get_width(display->fb) + 1) || (y1 > framebuffer_get_height(display->fb) + 1))
+		return 0;
+	return 1;
+}
+
+static void display_render_object(lua_State * L, struct ldisplay_t * display, struct lobject_t * object, cairo_matrix_t * m);
+
+static int display_render_cache(lua_State * L, struct ldisplay_t * display, struct lobject_t * object)
+{
+	struct lobject_t * pos, * n;
+	double x1, y1, x2, y2;
+	double alpha;
+
+	if(object->__cache_dirty || !object->__cache)
+	{
+		lobject_get_extents(object, &x1, &y1, &x2, &y2);
+		x1 = floor(x1) - 1;
+		y1 = floor(y1) - 1;
+		x2 = ceil(x2) + 1;
+		y2 = ceil(y2) + 1;
+		if(!display_cache_push(display, object, x1, y1, x2 - x1, y2 - y1))
+			return 0;
+		alpha = object->alpha;
+		object->alpha = 1;
+		display_draw_node(L, display, object);
+		list_for_each_entry_safe(pos, n, &object->children, entry)
+		{
+			display_render_object(L, display, pos, &object->__transform_matrix);
+		}
+		object->alpha = alpha;
+		display_cache_pop(display);
+		object->__cache_dirty = 0;
+	}
+	display_draw_cache(display, object);
+	return 1;
+}
+
+static void display_render_object(lua_State * L, struct ldisplay_t * display, struct lobject_t * object, cairo_matrix_t * m)
+{
+	struct lobject_t * pos, * n;
+
+	cairo_matrix_multiply(&object->__transform_matrix, lobject_get_matrix(object), m);
+	if(!display_in_view(display, object))
+		return;
+	if(object->__cache_enable)
+	{
+		if(object->alpha <= 0)
+			return;
+		if(display_render_cache(L, display, object))
+			return;
+	}
+	display_draw_node(L, display, object);
+	list_for_each_entry_safe(pos, n, &object->children, entry)
+	{
+		display_render_object(L, display, pos, &object->__transform_matrix);
+	}
+}
+
+static void display_collect(lua_State * L, struct lobject_t * object, int idx, int * n)
+{
+	struct lobject_t * pos;
+
+	if(object->__enter_frame && lobject_push_owner(L, object))
+		lua_rawseti(L, idx, ++(*n));
+	list_for_each_entry(pos, &object->children, entry)
+	{
+		display_collect(L, pos, idx, n);
+	}
+}
+
+static int m_display_render(lua_State * L)
+{
+	struct ldisplay_t * display = luaL_checkudata(L, 1, MT_DISPLAY);
+	struct lobject_t * object = luaL_checkudata(L, 2, MT_OBJECT);
+	struct lobject_t * pos;
+	cairo_matrix_t m;
+	int i, n = 0;
+
+	while(display->depth > 0)
+		display_cache_pop(display);
+	lobject_animate(L);
+	if(!lua_isnoneornil(L, 3))
+	{
+		lua_settop(L, 3);
+		lua_newtable(L);
+		display_collect(L, object, 4, &n);
+		for(i = 1; i <= n; i++)
+		{
+			lua_rawgeti(L, 4, i);
+			lua_getfield(L, -1, "dispatchEvent");
+			lua_insert(L, -2);
+			lua_pushvalue(L, 3);
+			lua_call(L, 2, 0);
+		}
+		lua_pop(L, 1);
+	}
+	cairo_matrix_init_identity(&m);
+	for(pos = object->parent; pos; pos = pos->parent)
+		cairo_matrix_multiply(&m, &m, lobject_get_matrix(pos));
+	display_render_object(L, display, object, &m);
+	return 0;
+}
+
+static int m_display_draw_object(lua_State * L)
+{
+	struct ldisplay_t * display = luaL_checkudata(L, 1, MT_DISPLAY);
+	struct lobject_t * object = luaL_checkudata(L, 2, MT_OBJECT);
+	display_draw_object(display, object);
+	return 0;
+}
+
+static int m_display_draw_shape(lua_State * L)
+{
+	struct ldisplay_t * display = luaL_checkudata(L, 1, MT_DISPLAY);
+	struct lobject_t * object = luaL_checkudata(L, 2, MT_OBJECT);
+	cairo_t ** shape = luaL_checkudata(L, 3, MT_SHAPE);
+	display_draw_shape(display, object, shape);
+	return 0;
+}
+
+static int m_display_draw_text(lua_State * L)
+{
+	struct ldisplay_t * display = luaL_checkudata(L, 1, MT_DISPLAY);
+	cairo_scaled_font_t * sfont = luaL_checkudata_scaled_font(L, 2, MT_FONT);
+	struct glyph_cache_t * glyph = luaL_checkudata_glyph_cache(L, 2, MT_FONT);
+	const char * text = luaL_optstring(L, 3, NULL);
+	struct lpattern_t * pattern = luaL_checkudata(L, 4, MT_PATTERN);
+	cairo_matrix_t * matrix = luaL_checkudata(L, 5, MT_MATRIX);
+	display_draw_text(display, sfont, glyph, text, pattern, matrix);
+	return 0;
+}
+
+static int m_display_draw_texture(lua_State * L)
+{
+	struct ldisplay_t * display = luaL_checkudata(L, 1, MT_DISPLAY);
+	struct lobject_t * object = luaL_checkudata(L, 2, MT_OBJECT);
+	struct ltexture_t * texture = luaL_checkudata(L, 3, MT_TEXTURE);
+	display_draw_texture(display, object, texture);
+	return 0;
+}
+
+static int m_display_draw_texture_mask(lua_State * L)
+{
+	struct ldisplay_t * display = luaL_checkudata(L, 1, MT_DISPLAY);
+	struct lobject_t * object = luaL_checkudata(L, 2, MT_OBJECT);
+	struct ltexture_t * texture = luaL_checkudata(L, 3, MT_TEXTURE);
+	struct lpattern_t * pattern = luaL_checkudata(L, 4, MT_PATTERN);
+	display_draw_texture_mask(display, object, texture, pattern);
+	return 0;
+}
+
+static int m_display_draw_ninepatch(lua_State * L)
+{
+	struct ldisplay_t * display = luaL_checkudata(L, 1, MT_DISPLAY);
+	struct lobject_t * object = luaL_checkudata(L, 2, MT_OBJECT);
+	struct lninepatch_t * ninepatch = luaL_checkudata(L, 3, MT_NINEPATCH);
+	display_draw_ninepatch(display, object, ninepatch);
 	return 0;
 }
 
@@ -291,13 +712,126 @@ static int m_display_showfps(lua_State * L)
 	return 0;
 }
 
+static int m_display_tiling(lua_State * L)
+{
+	struct ldisplay_t * display = luaL_checkudata(L, 1, MT_DISPLAY);
+	int flag = lua_toboolean(L, 2) ? 1 : 0;
+	int size = luaL_optinteger(L, 3, 128);
+	int i;
+	for(i = 0; i < display->npage; i++)
+	{
+		if(display->page[i].tiler)
+		{
+			tiler_free(display->page[i].tiler);
+			display->page[i].tiler = NULL;
+			cairo_save(display->page[i].cr);
+			cairo_set_source_rgb(display->page[i].cr, 1, 1, 1);
+			cairo_set_operator(display->page[i].cr, CAIRO_OPERATOR_SOURCE);
+			cairo_paint(display->page[i].cr);
+			cairo_restore(display->page[i].cr);
+		}
+		if(flag)
+		{
+			display->page[i].tiler = tiler_alloc(display->page[i].cs, size);
+			tiler_opaque(display->page[i].tiler, display->opaque);
+		}
+	}
+	display->tiler = display->page[display->index].tiler;
+	lua_pushboolean(L, display->tiler ? 1 : 0);
+	return 1;
+}
+
+static int m_display_opaque(lua_State * L)
+{
+	struct ldisplay_t * display = luaL_checkudata(L, 1, MT_DISPLAY);
+	int i;
+	display->opaque = lua_toboolean(L, 2) ? 1 : 0;
+	for(i = 0; i < display->npage; i++)
+		tiler_opaque(display->page[i].tiler, display->opaque);
+	return 0;
+}
+
+static int m_display_vsync(lua_State * L)
+{
+	struct ldisplay_t * display = luaL_checkudata(L, 1, MT_DISPLAY);
+	int flag = lua_toboolean(L, 2) ? 1 : 0;
+	if(flag && !display->vsync)
+	{
+		display->vcount = 0;
+		display->missed = 0;
+	}
+	display->vsync = flag;
+	return 0;
+}
+
+static int m_display_get_missed_frames(lua_State * L)
+{
+	struct ldisplay_t * display = luaL_checkudata(L, 1, MT_DISPLAY);
+	lua_pushinteger(L, display->missed);
+	return 1;
+}
+
+static int m_display_gc_budget(lua_State * L)
+{
+	struct ldisplay_t * display = luaL_checkudata(L, 1, MT_DISPLAY);
+	double budget = luaL_optnumber(L, 2, 0);
+	display->gcbudget = (budget > 0) ? (s64_t)(budget * 1000) : 0;
+	display->gctime = 0;
+	if(!lua_isnoneornil(L, 3))
+		lua_gc(L, LUA_GCSETPAUSE, luaL_checkinteger(L, 3));
+	if(!lua_isnoneornil(L, 4))
+		lua_gc(L, LUA_GCSETSTEPMUL, luaL_checkinteger(L, 4));
+	return 0;
+}
+
+static int m_display_get_gc_time(lua_State * L)
+{
+	struct ldisplay_t * display = luaL_checkudata(L, 1, MT_DISPLAY);
+	lua_pushnumber(L, (double)display->gctime / (double)1000000000.0);
+	return 1;
+}
+
+/*
+ * Spend the idle time after a frame has been presented on incremental steps of
+ * the garbage collector, bounded by the budget, so the collector runs ahead of
+ * the allocations and seldom has to take a long step in the middle of a frame.
+ * Stepping stops early once a cycle completes, as the next one has nothing to do
+ * until the frames have allocated again.
+ */
+static void display_gc_step(lua_State * L, struct ldisplay_t * display)
+{
+	ktime_t start = ktime_get();
+	s64_t elapsed;
+
+	do {
+		if(lua_gc(L, LUA_GCSTEP, 0))
+			break;
+		elapsed = ktime_to_ns(ktime_sub(ktime_get(), start));
+	} while(elapsed < display->gcbudget);
+	display->gctime = ktime_to_ns(ktime_sub(ktime_get(), start));
+}
+
+/*
+ * Wait for the vertical blanking, every vertical blanking passed without a
+ * new frame since the previous one counts as a missed frame.
+ */
+static void display_wait_vsync(struct ldisplay_t * display)
+{
+	u64_t count = framebuffer_wait_vsync(display->fb);
+	if((display->vcount > 0) && (count > display->vcount + 1))
+		display->missed += count - display->vcount - 1;
+	display->vcount = count;
+}
+
 static int m_display_present(lua_State * L)
 {
 	struct ldisplay_t * display = luaL_checkudata(L, 1, MT_DISPLAY);
 	cairo_t * cr = display->cr;
+	if(display->tiler)
+		tiler_flush(display->tiler);
 	if(display->showfps)
 	{
-		char buf[32];
+		char buf[64];
 		ktime_t now = ktime_get();
 		s64_t delta = ktime_ms_delta(now, display->stamp);
 		if(delta > 0)
@@ -308,16 +842,37 @@ static int m_display_present(lua_State * L)
 		cairo_set_font_size(cr, 24);
 		cairo_set_source_rgb(cr, 0.4, 0.4, 0.4);
 		cairo_move_to(cr, 0, 24);
-		snprintf(buf, sizeof(buf), "%.2f %d", display->fps, display->frame);
+		if(display->gcbudget > 0)
+			snprintf(buf, sizeof(buf), "%.2f %d gc %.2fms", display->fps, display->frame, (double)display->gctime / (double)1000000.0);
+		else
+			snprintf(buf, sizeof(buf), "%.2f %d", display->fps, display->frame);
 		cairo_show_text(cr, buf);
 		cairo_restore(cr);
 	}
-	cairo_xboot_surface_present(display->cs, NULL, 0);
-	cairo_save(cr);
-	cairo_set_source_rgb(cr, 1, 1, 1);
-	cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
-	cairo_paint(cr);
-	cairo_restore(cr);
+	if(display->vsync)
+		display_wait_vsync(display);
+	if(display->npage > 1)
+	{
+		cairo_xboot_surface_flip(display->cs);
+		display->index = (display->index + 1) % display->npage;
+		display->cs = display->page[display->index].cs;
+		display->cr = cr = display->page[display->index].cr;
+		display->tiler = display->page[display->index].tiler;
+	}
+	else
+	{
+		cairo_xboot_surface_present(display->cs, NULL, 0);
+	}
+	if(!display->tiler && !display->opaque)
+	{
+		cairo_save(cr);
+		cairo_set_source_rgb(cr, 1, 1, 1);
+		cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+		cairo_paint(cr);
+		cairo_restore(cr);
+	}
+	if(display->gcbudget > 0)
+		display_gc_step(L, display);
 	return 0;
 }
 
@@ -333,7 +888,15 @@ static const luaL_Reg m_display[] = {
 	{"drawTexture",			m_display_draw_texture},
 	{"drawTextureMask",		m_display_draw_texture_mask},
 	{"drawNinepatch",		m_display_draw_ninepatch},
+	{"drawObject",			m_display_draw_object},
+	{"render",				m_display_render},
 	{"showfps",				m_display_showfps},
+	{"tiling",				m_display_tiling},
+	{"opaque",				m_display_opaque},
+	{"vsync",				m_display_vsync},
+	{"getMissedFrames",		m_display_get_missed_frames},
+	{"gcBudget",			m_display_gc_budget},
+	{"getGcTime",			m_display_get_gc_time},
 	{"present",				m_display_present},
 	{NULL,					NULL}
 };
@@ -35,118 +35,427 @@
  * b = begin value
  * c = change value (ending - beginning)
  * d = duration (total time)
- * func = easing function will be invoked in 'easing' method
+ * func = easing function will be invoked in 'easing' method, also looked up
+ *        by name for the native tweens of display objects
  */
 struct leasing_t {
 	double b;
 	double c;
 	double d;
-	int (*func)(lua_State *L);
+	leasing_func_t func;
 };
 
-static int m_linear(lua_State * L);
-static int m_in_sine(lua_State * L);
-static int m_out_sine(lua_State * L);
-static int m_in_out_sine(lua_State * L);
-static int m_in_quad(lua_State * L);
-static int m_out_quad(lua_State * L);
-static int m_in_out_quad(lua_State * L);
-static int m_in_cubic(lua_State * L);
-static int m_out_cubic(lua_State * L);
-static int m_in_out_cubic(lua_State * L);
-static int m_in_quart(lua_State * L);
-static int m_out_quart(lua_State * L);
-static int m_in_out_quart(lua_State * L);
-static int m_in_quint(lua_State * L);
-static int m_out_quint(lua_State * L);
-static int m_in_out_quint(lua_State * L);
-static int m_in_expo(lua_State * L);
-static int m_out_expo(lua_State * L);
-static int m_in_out_expo(lua_State * L);
-static int m_in_circ(lua_State * L);
-static int m_out_circ(lua_State * L);
-static int m_in_out_circ(lua_State * L);
-static int m_in_back(lua_State * L);
-static int m_out_back(lua_State * L);
-static int m_in_out_back(lua_State * L);
-static int m_in_elastic(lua_State * L);
-static int m_out_elastic(lua_State * L);
-static int m_in_out_elastic(lua_State * L);
-static int m_in_bounce(lua_State * L);
-static int m_out_bounce(lua_State * L);
-static int m_in_out_bounce(lua_State * L);
+static double __linear(double t, double b, double c, double d)
+{
+	return c * t / d + b;
+}
+
+static double __in_sine(double t, double b, double c, double d)
+{
+	return -c * cos(t / d * M_PI_2) + c + b;
+}
+
+static double __out_sine(double t, double b, double c, double d)
+{
+	return c * sin(t / d * M_PI_2) + b;
+}
+
+static double __in_out_sine(double t, double b, double c, double d)
+{
+	return -c / 2 * (cos(M_PI * t / d) - 1) + b;
+}
+
+static double __in_quad(double t, double b, double c, double d)
+{
+	double r;
+	t = t / d;
+	r = c * pow(t, 2) + b;
+	return r;
+}
+
+static double __out_quad(double t, double b, double c, double d)
+{
+	double r;
+	t = t / d;
+	r = -c * t * (t - 2) + b;
+	return r;
+}
+
+static double __in_out_quad(double t, double b, double c, double d)
+{
+	double r;
+	t = t / d * 2;
+	if(t < 1)
+		r =  c / 2 * pow(t, 2) + b;
+	else
+		r = -c / 2 * ((t - 1) * (t - 3) - 1) + b;
+	return r;
+}
+
+static double __in_cubic(double t, double b, double c, double d)
+{
+	double r;
+	t = t / d;
+	r = c * pow(t, 3) + b;
+	return r;
+}
+
+static double __out_cubic(double t, double b, double c, double d)
+{
+	double r;
+	t = t / d - 1;
+	r = c * (pow(t, 3) + 1) + b;
+	return r;
+}
+
+static double __in_out_cubic(double t, double b, double c, double d)
+{
+	double r;
+	t = t / d * 2;
+	if(t < 1)
+		r =  c / 2 * pow(t, 3) + b;
+	else
+	{
+		t = t - 2;
+		r = c / 2 * (pow(t, 3) + 2) + b;
+	}
+	return r;
+}
+
+static double __in_quart(double t, double b, double c, double d)
+{
+	double r;
+	t = t / d;
+	r = c * pow(t, 4) + b;
+	return r;
+}
+
+static double __out_quart(double t, double b, double c, double d)
+{
+	double r;
+	t = t / d - 1;
+	r = -c * (pow(t, 4) - 1) + b;
+	return r;
+}
+
+static double __in_out_quart(double t, double b, double c, double d)
+{
+	double r;
+	t = t / d * 2;
+	if(t < 1)
+		r =  c / 2 * pow(t, 4) + b;
+	else
+	{
+		t = t - 2;
+		r = -c / 2 * (pow(t, 4) - 2) + b;
+	}
+	return r;
+}
+
+static double __in_quint(double t, double b, double c, double d)
+{
+	double r;
+	t = t / d;
+	r = c * pow(t, 5) + b;
+	return r;
+}
+
+static double __out_quint(double t, double b, double c, double d)
+{
+	double r;
+	t = t / d - 1;
+	r = c * (pow(t, 5) + 1) + b;
+	return r;
+}
+
+static double __in_out_quint(double t, double b, double c, double d)
+{
+	double r;
+	t = t / d * 2;
+	if(t < 1)
+		r = c / 2 * pow(t, 5) + b;
+	else
+	{
+		t = t - 2;
+		r = c / 2 * (pow(t, 5) + 2) + b;
+	}
+	return r;
+}
+
+static double __in_expo(double t, double b, double c, double d)
+{
+	double r;
+	if(t == 0)
+		r = b;
+	else
+		r = c * pow(2, 10 * (t / d - 1)) + b - c * 0.001;
+	return r;
+}
+
+static double __out_expo(double t, double b, double c, double d)
+{
+	double r;
+	if(t == d)
+		r = b + c;
+	else
+		r = c * 1.001 * (-pow(2, -10 * t / d) + 1) + b;
+	return r;
+}
+
+static double __in_out_expo(double t, double b, double c, double d)
+{
+	double r;
+	if(t == 0)
+		r = b;
+	else if(t == d)
+		r = b + c;
+	else
+	{
+		t = t / d * 2;
+		if(t < 1)
+			r = c / 2 * pow(2, 10 * (t - 1)) + b - c * 0.0005;
+		else
+		{
+			t = t - 1;
+			r = c / 2 * 1.0005 * (-pow(2, -10 * t) + 2) + b;
+		}
+	}
+	return r;
+}
+
+static double __in_circ(double t, double b, double c, double d)
+{
+	double r;
+	t = t / d;
+	r = -c * (sqrt(1 - pow(t, 2)) - 1) + b;
+	return r;
+}
+
+static double __out_circ(double t, double b, double c, double d)
+{
+	double r;
+	t = t / d - 1;
+	r = c * sqrt(1 - pow(t, 2)) + b;
+	return r;
+}
+
+static double __in_out_circ(double t, double b, double c, double d)
+{
+	double r;
+	t = t / d * 2;
+	if(t < 1)
+		r = -c / 2 * (sqrt(1 - t * t) - 1) + b;
+	else
+	{
+		t = t - 2;
+		r = c / 2 * (sqrt(1 - t * t) + 1) + b;
+	}
+	return r;
+}
+
+static double __in_back(double t, double b, double c, double d)
+{
+	double s = 1.70158;
+	double r;
+	t = t / d;
+	r = c * t * t * ((s + 1) * t - s) + b;
+	return r;
+}
+
+static double __out_back(double t, double b, double c, double d)
+{
+	double s = 1.70158;
+	double r;
+	t = t / d - 1;
+	r = c * (t * t * ((s + 1) * t + s) + 1) + b;
+	return r;
+}
+
+static double __in_out_back(double t, double b, double c, double d)
+{
+	double s = 1.70158;
+	double r;
+	s = s * 1.525;
+	t = t / d * 2;
+	if(t < 1)
+		r = c / 2 * (t * t * ((s + 1) * t - s)) + b;
+	else
+	{
+		t = t - 2;
+		r = c / 2 * (t * t * ((s + 1) * t + s) + 2) + b;
+	}
+	return r;
+}
+
+static double __in_elastic(double t, double b, double c, double d)
+{
+	double r;
+	if(t == 0)
+		r = b;
+	else
+	{
+		t = t / d;
+		if(t == 1)
+			r = b + c;
+		else
+		{
+			double p = d * 0.3;
+			double s = p / 4;
+			double a = c;
+			t = t - 1;
+			r = -(a * pow(2, 10 * t) * sin((t * d - s) * (2 * M_PI) / p)) + b;
+		}
+	}
+	return r;
+}
+
+static double __out_elastic(double t, double b, double c, double d)
+{
+	double r;
+	if(t == 0)
+		r = b;
+	else
+	{
+		t = t / d;
+		if(t == 1)
+			r = b + c;
+		else
+		{
+			double p = d * 0.3;
+			double s = p / 4;
+			double a = c;
+			r = a * pow(2, -10 * t) * sin((t * d - s) * (2 * M_PI) / p) + c + b;
+		}
+	}
+	return r;
+}
+
+static double __in_out_elastic(double t, double b, double c, double d)
+{
+	double r;
+	if(t == 0)
+		r = b;
+	else
+	{
+		t = t / d * 2;
+		if(t == 2)
+			r = b + c;
+		else
+		{
+			double p = d * (0.3 * 1.5);
+			double a = c;
+			double s = p / 4;
+			if(t < 1)
+			{
+				t = t - 1;
+				r = -0.5 * (a * pow(2, 10 * t) * sin((t * d - s) * (2 * M_PI) / p)) + b;
+			}
+			else
+			{
+				t = t - 1;
+				r = a * pow(2, -10 * t) * sin((t * d - s) * (2 * M_PI) / p) * 0.5 + c	+ b;
+			}
+		}
+	}
+	return r;
+}
+
+static double __out_bounce(double t, double b, double c, double d)
+{
+	t = t / d;
+	if(t < 1 / 2.75)
+		return c * (7.5625 * t * t) + b;
+	else if(t < 2 / 2.75)
+	{
+		t = t - (1.5 / 2.75);
+		return c * (7.5625 * t * t + 0.75) + b;
+	}
+	else if(t < 2.5 / 2.75)
+	{
+		t = t - (2.25 / 2.75);
+		return c * (7.5625 * t * t + 0.9375) + b;
+	}
+	else
+	{
+		t = t - (2.625 / 2.75);
+		return c * (7.5625 * t * t + 0.984375) + b;
+	}
+}
+
+static double __in_bounce(double t, double b, double c, double d)
+{
+	return c - __out_bounce(d - t, 0, c, d) + b;
+}
+
+static double __in_out_bounce(double t, double b, double c, double d)
+{
+	double r;
+	if (t < d / 2)
+		r = __in_bounce(t * 2, 0, c, d) * 0.5 + b;
+	else
+		r = __out_bounce(t * 2 - d, 0, c, d) * 0.5 + c * 0.5 + b;
+	return r;
+}
+
+static const struct {
+	const char * name;
+	leasing_func_t func;
+} __easings[] = {
+	{"linear",			__linear},
+	{"inSine",			__in_sine},
+	{"outSine",			__out_sine},
+	{"inOutSine",		__in_out_sine},
+	{"inQuad",			__in_quad},
+	{"outQuad",			__out_quad},
+	{"inOutQuad",		__in_out_quad},
+	{"inCubic",			__in_cubic},
+	{"outCubic",			__out_cubic},
+	{"inOutCubic",		__in_out_cubic},
+	{"inQuart",			__in_quart},
+	{"outQuart",			__out_quart},
+	{"inOutQuart",		__in_out_quart},
+	{"inQuint",			__in_quint},
+	{"outQuint",			__out_quint},
+	{"inOutQuint",		__in_out_quint},
+	{"inExpo",			__in_expo},
+	{"outExpo",			__out_expo},
+	{"inOutExpo",		__in_out_expo},
+	{"inCirc",			__in_circ},
+	{"outCirc",			__out_circ},
+	{"inOutCirc",		__in_out_circ},
+	{"inBack",			__in_back},
+	{"outBack",			__out_back},
+	{"inOutBack",		__in_out_back},
+	{"inElastic",		__in_elastic},
+	{"outElastic",		__out_elastic},
+	{"inOutElastic",		__in_out_elastic},
+	{"inBounce",			__in_bounce},
+	{"outBounce",		__out_bounce},
+	{"inOutBounce",		__in_out_bounce},
+};
+
+leasing_func_t leasing_find(const char * type)
+{
+	int i;
+
+	if(type)
+	{
+		for(i = 0; i < ARRAY_SIZE(__easings); i++)
+		{
+			if(strcmp(__easings[i].name, type) == 0)
+				return __easings[i].func;
+		}
+	}
+	return __linear;
+}
 
 static int l_new(lua_State * L)
 {
 	struct leasing_t * e = lua_newuserdata(L, sizeof(struct leasing_t));
-	const char * type = luaL_optstring(L, 4, "linear");
 	e->b = luaL_optnumber(L, 1, 0);
 	e->c = luaL_optnumber(L, 2, 1);
 	e->d = luaL_optnumber(L, 3, 1);
-	if(strcmp(type, "linear") == 0)
-		e->func = m_linear;
-	else if(strcmp(type, "inSine") == 0)
-		e->func = m_in_sine;
-	else if(strcmp(type, "outSine") == 0)
-		e->func = m_out_sine;
-	else if(strcmp(type, "inOutSine") == 0)
-		e->func = m_in_out_sine;
-	else if(strcmp(type, "inQuad") == 0)
-		e->func = m_in_quad;
-	else if(strcmp(type, "outQuad") == 0)
-		e->func = m_out_quad;
-	else if(strcmp(type, "inOutQuad") == 0)
-		e->func = m_in_out_quad;
-	else if(strcmp(type, "inCubic") == 0)
-		e->func = m_in_cubic;
-	else if(strcmp(type, "outCubic") == 0)
-		e->func = m_out_cubic;
-	else if(strcmp(type, "inOutCubic") == 0)
-		e->func = m_in_out_cubic;
-	else if(strcmp(type, "inQuart") == 0)
-		e->func = m_in_quart;
-	else if(strcmp(type, "outQuart") == 0)
-		e->func = m_out_quart;
-	else if(strcmp(type, "inOutQuart") == 0)
-		e->func = m_in_out_quart;
-	else if(strcmp(type, "inQuint") == 0)
-		e->func = m_in_quint;
-	else if(strcmp(type, "outQuint") == 0)
-		e->func = m_out_quint;
-	else if(strcmp(type, "inOutQuint") == 0)
-		e->func = m_in_out_quint;
-	else if(strcmp(type, "inExpo") == 0)
-		e->func = m_in_expo;
-	else if(strcmp(type, "outExpo") == 0)
-		e->func = m_out_expo;
-	else if(strcmp(type, "inOutExpo") == 0)
-		e->func = m_in_out_expo;
-	else if(strcmp(type, "inCirc") == 0)
-		e->func = m_in_circ;
-	else if(strcmp(type, "outCirc") == 0)
-		e->func = m_out_circ;
-	else if(strcmp(type, "inOutCirc") == 0)
-		e->func = m_in_out_circ;
-	else if(strcmp(type, "inBack") == 0)
-		e->func = m_in_back;
-	else if(strcmp(type, "outBack") == 0)
-		e->func = m_out_back;
-	else if(strcmp(type, "inOutBack") == 0)
-		e->func = m_in_out_back;
-	else if(strcmp(type, "inElastic") == 0)
-		e->func = m_in_elastic;
-	else if(strcmp(type, "outElastic") == 0)
-		e->func = m_out_elastic;
-	else if(strcmp(type, "inOutElastic") == 0)
-		e->func = m_in_out_elastic;
-	else if(strcmp(type, "inBounce") == 0)
-		e->func = m_in_bounce;
-	else if(strcmp(type, "outBounce") == 0)
-		e->func = m_out_bounce;
-	else if(strcmp(type, "inOutBounce") == 0)
-		e->func = m_in_out_bounce;
-	else
-		e->func = m_linear;
+	e->func = leasing_find(luaL_optstring(L, 4, "linear"));
 	luaL_setmetatable(L, MT_EASING);
 	return 1;
 }
@@ -159,15 +468,16 @@ static const luaL_Reg l_easing[] = {
 static int m_invoke_easing(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
-	return e->func(L);
+	double t = luaL_checknumber(L, 2);
+	lua_pushnumber(L, e->func(t, e->b, e->c, e->d));
+	return 1;
 }
 
 static int m_linear(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r = e->c * t / e->d + e->b;
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __linear(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -175,8 +485,7 @@ static int m_in_sine(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r = -e->c * cos(t / e->d * M_PI_2) + e->c + e->b;
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __in_sine(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -184,8 +493,7 @@ static int m_out_sine(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r = e->c * sin(t / e->d * M_PI_2) + e->b;
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __out_sine(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -193,8 +501,7 @@ static int m_in_out_sine(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r = -e->c / 2 * (cos(M_PI * t / e->d) - 1) + e->b;
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __in_out_sine(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -202,10 +509,7 @@ static int m_in_quad(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	t = t / e->d;
-	r = e->c * pow(t, 2) + e->b;
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __in_quad(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -213,10 +517,7 @@ static int m_out_quad(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	t = t / e->d;
-	r = -e->c * t * (t - 2) + e->b;
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __out_quad(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -224,13 +525,7 @@ static int m_in_out_quad(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	t = t / e->d * 2;
-	if(t < 1)
-		r =  e->c / 2 * pow(t, 2) + e->b;
-	else
-		r = -e->c / 2 * ((t - 1) * (t - 3) - 1) + e->b;
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __in_out_quad(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -238,10 +533,7 @@ static int m_in_cubic(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	t = t / e->d;
-	r = e->c * pow(t, 3) + e->b;
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __in_cubic(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -249,10 +541,7 @@ static int m_out_cubic(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	t = t / e->d - 1;
-	r = e->c * (pow(t, 3) + 1) + e->b;
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __out_cubic(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -260,16 +549,7 @@ static int m_in_out_cubic(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	t = t / e->d * 2;
-	if(t < 1)
-		r =  e->c / 2 * pow(t, 3) + e->b;
-	else
-	{
-		t = t - 2;
-		r = e->c / 2 * (pow(t, 3) + 2) + e->b;
-	}
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __in_out_cubic(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -277,10 +557,7 @@ static int m_in_quart(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	t = t / e->d;
-	r = e->c * pow(t, 4) + e->b;
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __in_quart(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -288,10 +565,7 @@ static int m_out_quart(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	t = t / e->d - 1;
-	r = -e->c * (pow(t, 4) - 1) + e->b;
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __out_quart(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -299,16 +573,7 @@ static int m_in_out_quart(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	t = t / e->d * 2;
-	if(t < 1)
-		r =  e->c / 2 * pow(t, 4) + e->b;
-	else
-	{
-		t = t - 2;
-		r = -e->c / 2 * (pow(t, 4) - 2) + e->b;
-	}
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __in_out_quart(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -316,10 +581,7 @@ static int m_in_quint(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	t = t / e->d;
-	r = e->c * pow(t, 5) + e->b;
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __in_quint(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -327,10 +589,7 @@ static int m_out_quint(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	t = t / e->d - 1;
-	r = e->c * (pow(t, 5) + 1) + e->b;
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __out_quint(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -338,16 +597,7 @@ static int m_in_out_quint(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	t = t / e->d * 2;
-	if(t < 1)
-		r = e->c / 2 * pow(t, 5) + e->b;
-	else
-	{
-		t = t - 2;
-		r = e->c / 2 * (pow(t, 5) + 2) + e->b;
-	}
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __in_out_quint(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -355,12 +605,7 @@ static int m_in_expo(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	if(t == 0)
-		r = e->b;
-	else
-		r = e->c * pow(2, 10 * (t / e->d - 1)) + e->b - e->c * 0.001;
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __in_expo(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -368,12 +613,7 @@ static int m_out_expo(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	if(t == e->d)
-		r = e->b + e->c;
-	else
-		r = e->c * 1.001 * (-pow(2, -10 * t / e->d) + 1) + e->b;
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __out_expo(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -381,23 +621,7 @@ static int m_in_out_expo(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	if(t == 0)
-		r = e->b;
-	else if(t == e->d)
-		r = e->b + e->c;
-	else
-	{
-		t = t / e->d * 2;
-		if(t < 1)
-			r = e->c / 2 * pow(2, 10 * (t - 1)) + e->b - e->c * 0.0005;
-		else
-		{
-			t = t - 1;
-			r = e->c / 2 * 1.0005 * (-pow(2, -10 * t) + 2) + e->b;
-		}
-	}
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __in_out_expo(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -405,10 +629,7 @@ static int m_in_circ(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	t = t / e->d;
-	r = -e->c * (sqrt(1 - pow(t, 2)) - 1) + e->b;
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __in_circ(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -416,10 +637,7 @@ static int m_out_circ(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	t = t / e->d - 1;
-	r = e->c * sqrt(1 - pow(t, 2)) + e->b;
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __out_circ(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -427,16 +645,7 @@ static int m_in_out_circ(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	t = t / e->d * 2;
-	if(t < 1)
-		r = -e->c / 2 * (sqrt(1 - t * t) - 1) + e->b;
-	else
-	{
-		t = t - 2;
-		r = e->c / 2 * (sqrt(1 - t * t) + 1) + e->b;
-	}
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __in_out_circ(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -444,11 +653,7 @@ static int m_in_back(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double s = 1.70158;
-	double r;
-	t = t / e->d;
-	r = e->c * t * t * ((s + 1) * t - s) + e->b;
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __in_back(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -456,11 +661,7 @@ static int m_out_back(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double s = 1.70158;
-	double r;
-	t = t / e->d - 1;
-	r = e->c * (t * t * ((s + 1) * t + s) + 1) + e->b;
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __out_back(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -468,18 +669,7 @@ static int m_in_out_back(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double s = 1.70158;
-	double r;
-	s = s * 1.525;
-	t = t / e->d * 2;
-	if(t < 1)
-		r = e->c / 2 * (t * t * ((s + 1) * t - s)) + e->b;
-	else
-	{
-		t = t - 2;
-		r = e->c / 2 * (t * t * ((s + 1) * t + s) + 2) + e->b;
-	}
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __in_out_back(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -487,24 +677,7 @@ static int m_in_elastic(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	if(t == 0)
-		r = e->b;
-	else
-	{
-		t = t / e->d;
-		if(t == 1)
-			r = e->b + e->c;
-		else
-		{
-			double p = e->d * 0.3;
-			double s = p / 4;
-			double a = e->c;
-			t = t - 1;
-			r = -(a * pow(2, 10 * t) * sin((t * e->d - s) * (2 * M_PI) / p)) + e->b;
-		}
-	}
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __in_elastic(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -512,23 +685,7 @@ static int m_out_elastic(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	if(t == 0)
-		r = e->b;
-	else
-	{
-		t = t / e->d;
-		if(t == 1)
-			r = e->b + e->c;
-		else
-		{
-			double p = e->d * 0.3;
-			double s = p / 4;
-			double a = e->c;
-			r = a * pow(2, -10 * t) * sin((t * e->d - s) * (2 * M_PI) / p) + e->c + e->b;
-		}
-	}
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __out_elastic(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -536,68 +693,15 @@ static int m_in_out_elastic(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	if(t == 0)
-		r = e->b;
-	else
-	{
-		t = t / e->d * 2;
-		if(t == 2)
-			r = e->b + e->c;
-		else
-		{
-			double p = e->d * (0.3 * 1.5);
-			double a = e->c;
-			double s = p / 4;
-			if(t < 1)
-			{
-				t = t - 1;
-				r = -0.5 * (a * pow(2, 10 * t) * sin((t * e->d - s) * (2 * M_PI) / p)) + e->b;
-			}
-			else
-			{
-				t = t - 1;
-				r = a * pow(2, -10 * t) * sin((t * e->d - s) * (2 * M_PI) / p) * 0.5 + e->c	+ e->b;
-			}
-		}
-	}
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __in_out_elastic(t, e->b, e->c, e->d));
 	return 1;
 }
 
-static double __out_bounce(double t, double b, double c, double d)
-{
-	t = t / d;
-	if(t < 1 / 2.75)
-		return c * (7.5625 * t * t) + b;
-	else if(t < 2 / 2.75)
-	{
-		t = t - (1.5 / 2.75);
-		return c * (7.5625 * t * t + 0.75) + b;
-	}
-	else if(t < 2.5 / 2.75)
-	{
-		t = t - (2.25 / 2.75);
-		return c * (7.5625 * t * t + 0.9375) + b;
-	}
-	else
-	{
-		t = t - (2.625 / 2.75);
-		return c * (7.5625 * t * t + 0.984375) + b;
-	}
-}
-
-static double __in_bounce(double t, double b, double c, double d)
-{
-	return c - __out_bounce(d - t, 0, c, d) + b;
-}
-
 static int m_in_bounce(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r = __in_bounce(t, e->b, e->c, e->d);
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __in_bounce(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -605,8 +709,7 @@ static int m_out_bounce(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r = __out_bounce(t, e->b, e->c, e->d);
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __out_bounce(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -614,12 +717,7 @@ static int m_in_out_bounce(lua_State * L)
 {
 	struct leasing_t * e = luaL_checkudata(L, 1, MT_EASING);
 	double t = luaL_checknumber(L, 2);
-	double r;
-	if (t < e->d / 2)
-		r = __in_bounce(t * 2, 0, e->c, e->d) * 0.5 + e->b;
-	else
-		r = __out_bounce(t * 2 - e->d, 0, e->c, e->d) * 0.5 + e->c * 0.5 + e->b;
-	lua_pushnumber(L, r);
+	lua_pushnumber(L, __in_out_bounce(t, e->b, e->c, e->d));
 	return 1;
 }
 
@@ -31,12 +31,14 @@
 #include <cairo-ft.h>
 #include <xfs/xfs.h>
 #include <framework/display/l-display.h>
+#include <framework/display/glyph.h>
 
 struct lfont_t {
 	FT_Library library;
 	FT_Face fface;
 	cairo_font_face_t * face;
 	cairo_scaled_font_t * sfont;
+	struct glyph_cache_t * cache;
 };
 
 cairo_scaled_font_t * luaL_checkudata_scaled_font(lua_State * L, int ud, const char * tname)
@@ -45,6 +47,12 @@ cairo_scaled_font_t * luaL_checkudata_scaled_font(lua_State * L, int ud, const c
 	return font->sfont;
 }
 
+struct glyph_cache_t * luaL_checkudata_glyph_cache(lua_State * L, int ud, const char * tname)
+{
+	struct lfont_t * font = luaL_checkudata(L, ud, tname);
+	return font->cache;
+}
+
 static unsigned long ft_xfs_stream_io(FT_Stream stream, unsigned long offset, unsigned char * buffer, unsigned long count)
 {
 	struct xfs_file_t * file = ((struct xfs_file_t *)stream->descriptor.pointer);
@@ -149,6 +157,7 @@ static int l_font_new(lua_State * L)
 		cairo_scaled_font_destroy(font->sfont);
 		return 0;
 	}
+	font->cache = glyph_cache_alloc(font->face);
 	luaL_setmetatable(L, MT_FONT);
 	return 1;
 }
@@ -161,6 +170,7 @@ static const luaL_Reg l_font[] = {
 static int m_font_gc(lua_State * L)
 {
 	struct lfont_t * font = luaL_checkudata(L, 1, MT_FONT);
+	glyph_cache_free(font->cache);
 	FT_Done_Face(font->fface);
 	FT_Done_FreeType(font->library);
 	cairo_font_face_destroy(font->face);
@@ -30,12 +30,50 @@
 #include <cairoint.h>
 #include <framework/display/l-display.h>
 
+extern cairo_scaled_font_t * luaL_checkudata_scaled_font(lua_State * L, int ud, const char * tname);
+extern struct glyph_cache_t * luaL_checkudata_glyph_cache(lua_State * L, int ud, const char * tname);
+
+/*
+ * Weak valued registry table, mapping an object to the display object owning it
+ */
+static const char __owners = 0;
+
+static void __object_invalidate(struct lobject_t * object)
+{
+	while(object)
+	{
+		if(object->__cache_enable)
+			object->__cache_dirty = 1;
+		object->__extents_valid = 0;
+		object = object->parent;
+	}
+}
+
+static void __object_unlink(struct lobject_t * object)
+{
+	if(object->parent)
+	{
+		__object_invalidate(object->parent);
+		list_del(&object->entry);
+		object->parent = NULL;
+	}
+}
+
+static void __object_anchor(lua_State * L, const char * key, int idx)
+{
+	lua_getuservalue(L, 1);
+	lua_pushvalue(L, idx);
+	lua_setfield(L, -2, key);
+	lua_pop(L, 1);
+}
+
 static void __object_translate(struct lobject_t * object, double dx, double dy)
 {
 	object->x = object->x + dx;
 	object->y = object->y + dy;
 	object->__translate = ((object->x != 0) || (object->y != 0)) ? 1 : 0;
 	object->__obj_matrix_valid = 0;
+	__object_invalidate(object->parent);
 }
 
 static void __object_translate_fill(struct lobject_t * object, double x, double y, double w, double h)
@@ -57,6 +95,7 @@ static void __object_translate_fill(struct lobject_t * object, double x, double
 	object->anchory = 0;
 	object->__anchor = 0;
 	object->__obj_matrix_valid = 0;
+	__object_invalidate(object->parent);
 }
 
 static inline cairo_matrix_t * __get_obj_matrix(struct lobject_t * object)
@@ -78,9 +117,328 @@ static inline cairo_matrix_t * __get_obj_matrix(struct lobject_t * object)
 	return m;
 }
 
+cairo_matrix_t * lobject_get_matrix(struct lobject_t * object)
+{
+	return __get_obj_matrix(object);
+}
+
+/*
+ * The bounding box of an object and all of it's descendants in the object's own
+ * coordinate space, cached until one of them is moved, resized, added or removed.
+ * Returns zero if the subtree draws through a lua hook and so can't be bounded.
+ */
+int lobject_get_extents(struct lobject_t * object, double * x1, double * y1, double * x2, double * y2)
+{
+	struct lobject_t * pos;
+	double bx1, by1, bx2, by2;
+
+	if(!object->__extents_valid)
+	{
+		object->__extents[0] = 0;
+		object->__extents[1] = 0;
+		object->__extents[2] = object->width;
+		object->__extents[3] = object->height;
+		object->__extents_bounded = object->__draw_hook ? 0 : 1;
+		list_for_each_entry(pos, &object->children, entry)
+		{
+			if(!lobject_get_extents(pos, &bx1, &by1, &bx2, &by2))
+				object->__extents_bounded = 0;
+			_cairo_matrix_transform_bounding_box(__get_obj_matrix(pos), &bx1, &by1, &bx2, &by2, NULL);
+			pos->__box[0] = bx1;
+			pos->__box[1] = by1;
+			pos->__box[2] = bx2;
+			pos->__box[3] = by2;
+			if(bx1 < object->__extents[0])
+				object->__extents[0] = bx1;
+			if(by1 < object->__extents[1])
+				object->__extents[1] = by1;
+			if(bx2 > object->__extents[2])
+				object->__extents[2] = bx2;
+			if(by2 > object->__extents[3])
+				object->__extents[3] = by2;
+		}
+		object->__extents_valid = 1;
+	}
+	*x1 = object->__extents[0];
+	*y1 = object->__extents[1];
+	*x2 = object->__extents[2];
+	*y2 = object->__extents[3];
+	return object->__extents_bounded;
+}
+
+int lobject_push_owner(lua_State * L, struct lobject_t * object)
+{
+	lua_rawgetp(L, LUA_REGISTRYINDEX, &__owners);
+	lua_rawgetp(L, -1, object);
+	lua_remove(L, -2);
+	if(lua_istable(L, -1))
+		return 1;
+	lua_pop(L, 1);
+	return 0;
+}
+
+/*
+ * Registry table anchoring every object with queued tweens, and the completion
+ * callbacks of those tweens, keyed by the object and the tween respectively
+ */
+static const char __tweens = 0;
+
+/*
+ * Registry userdata holding the list of objects with queued tweens
+ */
+static const char __animating = 0;
+
+enum tween_field_t {
+	TWEEN_X				= 0,
+	TWEEN_Y				= 1,
+	TWEEN_ROTATION		= 2,
+	TWEEN_SCALEX		= 3,
+	TWEEN_SCALEY		= 4,
+	TWEEN_ALPHA			= 5,
+	TWEEN_CUSTOM		= 6,
+};
+
+struct ltween_prop_t {
+	enum tween_field_t field;
+	char * key;
+	double to;
+	double b, c;
+};
+
+struct ltween_t {
+	struct list_head entry;
+	leasing_func_t func;
+	double duration;
+	ktime_t start;
+	int started;
+	int nprop;
+	struct ltween_prop_t prop[0];
+};
+
+static struct list_head * __animating_list(lua_State * L)
+{
+	struct list_head * head;
+
+	lua_rawgetp(L, LUA_REGISTRYINDEX, &__animating);
+	head = lua_touserdata(L, -1);
+	lua_pop(L, 1);
+	return head;
+}
+
+static void __tween_start(lua_State * L, struct lobject_t * object, struct ltween_t * tween, ktime_t start)
+{
+	struct ltween_prop_t * p;
+	double b;
+	int i;
+
+	for(i = 0; i < tween->nprop; i++)
+	{
+		p = &tween->prop[i];
+		switch(p->field)
+		{
+		case TWEEN_X:
+			b = object->x;
+			break;
+		case TWEEN_Y:
+			b = object->y;
+			break;
+		case TWEEN_ROTATION:
+			b = object->rotation;
+			break;
+		case TWEEN_SCALEX:
+			b = object->scalex;
+			break;
+		case TWEEN_SCALEY:
+			b = object->scaley;
+			break;
+		case TWEEN_ALPHA:
+			b = object->alpha;
+			break;
+		default:
+			b = p->to;
+			if(lobject_push_owner(L, object))
+			{
+				lua_getfield(L, -1, p->key);
+				if(lua_type(L, -1) == LUA_TNUMBER)
+					b = lua_tonumber(L, -1);
+				lua_pop(L, 2);
+			}
+			break;
+		}
+		p->b = b;
+		p->c = p->to - b;
+	}
+	tween->start = start;
+	tween->started = 1;
+}
+
+static void __tween_apply(lua_State * L, struct lobject_t * object, struct ltween_t * tween, double t)
+{
+	struct ltween_prop_t * p;
+	double v;
+	int owner = 0;
+	int i;
+
+	for(i = 0; i < tween->nprop; i++)
+	{
+		p = &tween->prop[i];
+		v = (t < tween->duration) ? tween->func(t, p->b, p->c, tween->duration) : p->to;
+		switch(p->field)
+		{
+		case TWEEN_X:
+			object->x = v;
+			object->__translate = ((object->x != 0) || (object->y != 0)) ? 1 : 0;
+			break;
+		case TWEEN_Y:
+			object->y = v;
+			object->__translate = ((object->x != 0) || (object->y != 0)) ? 1 : 0;
+			break;
+		case TWEEN_ROTATION:
+			while(v < 0)
+				v = v + (M_PI * 2);
+			while(v > (M_PI * 2))
+				v = v - (M_PI * 2);
+			object->rotation = v;
+			object->__rotate = (object->rotation != 0) ? 1 : 0;
+			break;
+		case TWEEN_SCALEX:
+			object->scalex = v;
+			object->__scale = ((object->scalex != 1) || (object->scaley != 1)) ? 1 : 0;
+			break;
+		case TWEEN_SCALEY:
+			object->scaley = v;
+			object->__scale = ((object->scalex != 1) || (object->scaley != 1)) ? 1 : 0;
+			break;
+		case TWEEN_ALPHA:
+			object->alpha = v;
+			break;
+		default:
+			if(!owner)
+				owner = lobject_push_owner(L, object) ? lua_gettop(L) : -1;
+			if(owner > 0)
+			{
+				lua_pushnumber(L, v);
+				lua_setfield(L, owner, p->key);
+			}
+			break;
+		}
+	}
+	if(owner > 0)
+		lua_remove(L, owner);
+	object->__obj_matrix_valid = 0;
+	__object_invalidate(object->parent);
+}
+
+static void __tween_free(struct ltween_t * tween)
+{
+	int i;
+
+	list_del(&tween->entry);
+	for(i = 0; i < tween->nprop; i++)
+	{
+		if(tween->prop[i].key)
+			free(tween->prop[i].key);
+	}
+	free(tween);
+}
+
+static int __tween_stop(lua_State * L, struct lobject_t * object)
+{
+	struct ltween_t * pos, * n;
+
+	if(list_empty(&object->__tweens))
+		return 0;
+	lua_rawgetp(L, LUA_REGISTRYINDEX, &__tweens);
+	list_for_each_entry_safe(pos, n, &object->__tweens, entry)
+	{
+		lua_pushnil(L);
+		lua_rawsetp(L, -2, pos);
+		__tween_free(pos);
+	}
+	list_del_init(&object->__tween_entry);
+	lua_pushnil(L);
+	lua_rawsetp(L, -2, object);
+	lua_pop(L, 1);
+	return 1;
+}
+
+/*
+ * Advance the tweens of all animating objects to the current time in one pass,
+ * before the frame is rendered. A finished tween hands over to the next one queued
+ * on it's object at the exact time it ended, so chained tweens don't drift with the
+ * frame rate. Completion callbacks are invoked after the pass, with the owner of
+ * the object as the argument, and are free to start or stop any tweens.
+ */
+void lobject_animate(lua_State * L)
+{
+	struct list_head * head = __animating_list(L);
+	struct lobject_t * object, * n;
+	struct ltween_t * tween, * next;
+	ktime_t now = ktime_get();
+	double elapsed;
+	int top, i, count = 0;
+
+	if(!head || list_empty(head))
+		return;
+	top = lua_gettop(L);
+	lua_rawgetp(L, LUA_REGISTRYINDEX, &__tweens);
+	lua_newtable(L);
+	list_for_each_entry_safe(object, n, head, __tween_entry)
+	{
+		while(!list_empty(&object->__tweens))
+		{
+			tween = list_first_entry(&object->__tweens, struct ltween_t, entry);
+			if(!tween->started)
+				__tween_start(L, object, tween, now);
+			elapsed = (double)ktime_to_ns(ktime_sub(now, tween->start)) / (double)1000000000.0;
+			__tween_apply(L, object, tween, elapsed);
+			if(elapsed < tween->duration)
+				break;
+			lua_rawgetp(L, top + 1, tween);
+			if(lua_isfunction(L, -1) && lobject_push_owner(L, object))
+			{
+				lua_rawseti(L, top + 2, ++count * 2);
+				lua_rawseti(L, top + 2, count * 2 - 1);
+			}
+			else
+				lua_pop(L, 1);
+			lua_pushnil(L);
+			lua_rawsetp(L, top + 1, tween);
+			if(tween->entry.next != &object->__tweens)
+			{
+				next = list_next_entry(tween, entry);
+				__tween_start(L, object, next, ktime_add_ns(tween->start, (s64_t)(tween->duration * 1000000000.0)));
+			}
+			__tween_free(tween);
+		}
+		if(list_empty(&object->__tweens))
+		{
+			list_del_init(&object->__tween_entry);
+			lua_pushnil(L);
+			lua_rawsetp(L, top + 1, object);
+		}
+	}
+	for(i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, top + 2, i * 2 - 1);
+		lua_rawgeti(L, top + 2, i * 2);
+		lua_call(L, 1, 0);
+	}
+	lua_settop(L, top);
+}
+
 static int l_object_new(lua_State * L)
 {
 	struct lobject_t * object = lua_newuserdata(L, sizeof(struct lobject_t));
+	lua_newtable(L);
+	lua_setuservalue(L, -2);
+	if(lua_istable(L, 1))
+	{
+		lua_rawgetp(L, LUA_REGISTRYINDEX, &__owners);
+		lua_pushvalue(L, 1);
+		lua_rawsetp(L, -2, object);
+		lua_pop(L, 1);
+	}
 	object->width = 0;
 	object->height = 0;
 	object->x = 0;
@@ -95,6 +453,10 @@ static int l_object_new(lua_State * L)
 	object->visible = 1;
 	object->touchable = 1;
 
+	object->parent = NULL;
+	init_list_head(&object->entry);
+	init_list_head(&object->children);
+
 	object->__translate = 0;
 	object->__rotate = 0;
 	object->__scale = 0;
@@ -104,6 +466,29 @@ static int l_object_new(lua_State * L)
 	cairo_matrix_init_identity(&object->__obj_matrix);
 	cairo_matrix_init_identity(&object->__transform_matrix);
 
+	object->__drawable = DRAWABLE_NONE;
+	object->__shape = NULL;
+	object->__texture = NULL;
+	object->__ninepatch = NULL;
+	object->__pattern = NULL;
+	object->__sfont = NULL;
+	object->__glyph = NULL;
+	object->__text = NULL;
+	object->__draw_hook = 0;
+	object->__enter_frame = 0;
+	init_list_head(&object->__tween_entry);
+	init_list_head(&object->__tweens);
+
+	object->__extents_valid = 0;
+	object->__extents_bounded = 1;
+	object->__bounds_valid = 0;
+	object->__inverse_valid = 0;
+
+	object->__cache_enable = 0;
+	object->__cache_dirty = 0;
+	object->__cache = NULL;
+	cairo_matrix_init_identity(&object->__cache_matrix);
+
 	luaL_setmetatable(L, MT_OBJECT);
 	return 1;
 }
@@ -113,6 +498,24 @@ static const luaL_Reg l_object[] = {
 	{NULL,	NULL}
 };
 
+static int m_object_gc(lua_State * L)
+{
+	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
+	struct lobject_t * pos, * n;
+	__object_unlink(object);
+	list_for_each_entry_safe(pos, n, &object->children, entry)
+	{
+		list_del_init(&pos->entry);
+		pos->parent = NULL;
+	}
+	if(object->__cache)
+		cairo_surface_destroy(object->__cache);
+	while(!list_empty(&object->__tweens))
+		__tween_free(list_first_entry(&object->__tweens, struct ltween_t, entry));
+	list_del(&object->__tween_entry);
+	return 0;
+}
+
 static int m_set_size(lua_State * L)
 {
 	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
@@ -120,6 +523,8 @@ static int m_set_size(lua_State * L)
 	double h = luaL_checknumber(L, 3);
 	object->width = w;
 	object->height = h;
+	object->__bounds_valid = 0;
+	__object_invalidate(object);
 	return 0;
 }
 
@@ -138,6 +543,7 @@ static int m_set_x(lua_State * L)
 	object->x = x;
 	object->__translate = ((object->x != 0) || (object->y != 0)) ? 1 : 0;
 	object->__obj_matrix_valid = 0;
+	__object_invalidate(object->parent);
 	return 0;
 }
 
@@ -155,6 +561,7 @@ static int m_set_y(lua_State * L)
 	object->y = y;
 	object->__translate = ((object->x != 0) || (object->y != 0)) ? 1 : 0;
 	object->__obj_matrix_valid = 0;
+	__object_invalidate(object->parent);
 	return 0;
 }
 
@@ -174,6 +581,7 @@ static int m_set_position(lua_State * L)
 	object->y = y;
 	object->__translate = ((object->x != 0) || (object->y != 0)) ? 1 : 0;
 	object->__obj_matrix_valid = 0;
+	__object_invalidate(object->parent);
 	return 0;
 }
 
@@ -196,6 +604,7 @@ static int m_set_rotation(lua_State * L)
 		object->rotation = object->rotation - (M_PI * 2);
 	object->__rotate = (object->rotation != 0) ? 1 : 0;
 	object->__obj_matrix_valid = 0;
+	__object_invalidate(object->parent);
 	return 0;
 }
 
@@ -213,6 +622,7 @@ static int m_set_scale_x(lua_State * L)
 	object->scalex = x;
 	object->__scale = ((object->scalex != 1) || (object->scaley != 1)) ? 1 : 0;
 	object->__obj_matrix_valid = 0;
+	__object_invalidate(object->parent);
 	return 0;
 }
 
@@ -230,6 +640,7 @@ static int m_set_scale_y(lua_State * L)
 	object->scaley = y;
 	object->__scale = ((object->scalex != 1) || (object->scaley != 1)) ? 1 : 0;
 	object->__obj_matrix_valid = 0;
+	__object_invalidate(object->parent);
 	return 0;
 }
 
@@ -249,6 +660,7 @@ static int m_set_scale(lua_State * L)
 	object->scaley = y;
 	object->__scale = ((object->scalex != 1) || (object->scaley != 1)) ? 1 : 0;
 	object->__obj_matrix_valid = 0;
+	__object_invalidate(object->parent);
 	return 0;
 }
 
@@ -269,6 +681,7 @@ static int m_set_archor(lua_State * L)
 	object->anchory = y;
 	object->__anchor = ((object->anchorx != 0) || (object->anchory != 0)) ? 1 : 0;
 	object->__obj_matrix_valid = 0;
+	__object_invalidate(object->parent);
 	return 0;
 }
 
@@ -285,6 +698,7 @@ static int m_set_alpha(lua_State * L)
 	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
 	double alpha = luaL_checknumber(L, 2);
 	object->alpha = alpha;
+	__object_invalidate(object->parent);
 	return 0;
 }
 
@@ -313,6 +727,7 @@ static int m_set_visible(lua_State * L)
 {
 	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
 	object->visible = lua_toboolean(L, 2) ? 1 : 0;
+	__object_invalidate(object);
 	return 0;
 }
 
@@ -361,13 +776,34 @@ static int m_get_transform_matrix(lua_State * L)
 	return 1;
 }
 
+/*
+ * Refresh the screen bounds and the inverse of the transform matrix, both are
+ * kept until the transform matrix or the size of the object changes.
+ */
+static void __object_update_bounds(struct lobject_t * object)
+{
+	double * b = object->__bounds;
+	if(!object->__bounds_valid || (memcmp(&object->__bounds_matrix, &object->__transform_matrix, sizeof(cairo_matrix_t)) != 0))
+	{
+		b[0] = 0;
+		b[1] = 0;
+		b[2] = object->width;
+		b[3] = object->height;
+		_cairo_matrix_transform_bounding_box(&object->__transform_matrix, &b[0], &b[1], &b[2], &b[3], NULL);
+		object->__bounds_matrix = object->__transform_matrix;
+		object->__inverse_matrix = object->__transform_matrix;
+		object->__inverse_valid = (cairo_matrix_invert(&object->__inverse_matrix) == CAIRO_STATUS_SUCCESS) ? 1 : 0;
+		object->__bounds_valid = 1;
+	}
+}
+
 static int m_global_to_local(lua_State * L)
 {
 	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
 	double x = luaL_checknumber(L, 2);
 	double y = luaL_checknumber(L, 3);
-	cairo_matrix_invert(&object->__transform_matrix);
-	cairo_matrix_transform_point(&object->__transform_matrix, &x, &y);
+	__object_update_bounds(object);
+	cairo_matrix_transform_point(&object->__inverse_matrix, &x, &y);
 	lua_pushnumber(L, x);
 	lua_pushnumber(L, y);
 	return 2;
@@ -389,27 +825,311 @@ static int m_hit_test_point(lua_State * L)
 	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
 	double x = luaL_checknumber(L, 2);
 	double y = luaL_checknumber(L, 3);
-	cairo_matrix_invert(&object->__transform_matrix);
-	cairo_matrix_transform_point(&object->__transform_matrix, &x, &y);
+	double * b = object->__bounds;
+	__object_update_bounds(object);
+	if(!object->__inverse_valid || (x < b[0]) || (y < b[1]) || (x > b[2]) || (y > b[3]))
+	{
+		lua_pushboolean(L, 0);
+		return 1;
+	}
+	cairo_matrix_transform_point(&object->__inverse_matrix, &x, &y);
 	lua_pushboolean(L, ((x >= 0) && (y >= 0) && (x <= object->width) && (y <= object->height)) ? 1 : 0);
 	return 1;
 }
 
+/*
+ * Find the topmost visible and touchable object under a point given in the
+ * object's own space. The cached boxes of the children, which bound their
+ * whole subtrees, work as a bounding volume hierarchy for pruning.
+ */
+static struct lobject_t * __object_pick(struct lobject_t * object, double x, double y)
+{
+	struct lobject_t * pos, * o;
+	cairo_matrix_t m;
+	double x1, y1, x2, y2;
+	double px, py;
+
+	lobject_get_extents(object, &x1, &y1, &x2, &y2);
+	list_for_each_entry_reverse(pos, &object->children, entry)
+	{
+		if(pos->__extents_bounded && ((x < pos->__box[0]) || (y < pos->__box[1]) || (x > pos->__box[2]) || (y > pos->__box[3])))
+			continue;
+		m = *__get_obj_matrix(pos);
+		if(cairo_matrix_invert(&m) != CAIRO_STATUS_SUCCESS)
+			continue;
+		px = x;
+		py = y;
+		cairo_matrix_transform_point(&m, &px, &py);
+		if((o = __object_pick(pos, px, py)))
+			return o;
+	}
+	if(object->visible && object->touchable && (x >= 0) && (y >= 0) && (x <= object->width) && (y <= object->height))
+		return object;
+	return NULL;
+}
+
+static int m_pick(lua_State * L)
+{
+	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
+	double x = luaL_checknumber(L, 2);
+	double y = luaL_checknumber(L, 3);
+	struct lobject_t * pos;
+	cairo_matrix_t m;
+
+	m = *__get_obj_matrix(object);
+	for(pos = object->parent; pos; pos = pos->parent)
+		cairo_matrix_multiply(&m, &m, __get_obj_matrix(pos));
+	if(cairo_matrix_invert(&m) != CAIRO_STATUS_SUCCESS)
+		return 0;
+	cairo_matrix_transform_point(&m, &x, &y);
+	pos = __object_pick(object, x, y);
+	if(pos && lobject_push_owner(L, pos))
+		return 1;
+	return 0;
+}
+
 static int m_bounds(lua_State * L)
 {
 	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
-	double x1 = 0;
-	double y1 = 0;
-	double x2 = object->width;
-	double y2 = object->height;
-	_cairo_matrix_transform_bounding_box(&object->__transform_matrix, &x1, &y1, &x2, &y2, NULL);
-	lua_pushnumber(L, x1);
-	lua_pushnumber(L, y1);
-	lua_pushnumber(L, x2 - x1);
-	lua_pushnumber(L, y2 - y1);
+	double * b = object->__bounds;
+	__object_update_bounds(object);
+	lua_pushnumber(L, b[0]);
+	lua_pushnumber(L, b[1]);
+	lua_pushnumber(L, b[2] - b[0]);
+	lua_pushnumber(L, b[3] - b[1]);
 	return 4;
 }
 
+static int m_add_child(lua_State * L)
+{
+	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
+	struct lobject_t * child = luaL_checkudata(L, 2, MT_OBJECT);
+	int back = lua_toboolean(L, 3);
+	if(child != object)
+	{
+		__object_unlink(child);
+		if(back)
+			list_add(&child->entry, &object->children);
+		else
+			list_add_tail(&child->entry, &object->children);
+		child->parent = object;
+		__object_invalidate(object);
+	}
+	return 0;
+}
+
+static int m_remove_child(lua_State * L)
+{
+	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
+	struct lobject_t * child = luaL_checkudata(L, 2, MT_OBJECT);
+	if(child->parent == object)
+		__object_unlink(child);
+	return 0;
+}
+
+static int m_set_shape(lua_State * L)
+{
+	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
+	cairo_t ** shape = luaL_checkudata(L, 2, MT_SHAPE);
+	__object_anchor(L, "shape", 2);
+	object->__drawable = DRAWABLE_SHAPE;
+	object->__shape = shape;
+	__object_invalidate(object);
+	return 0;
+}
+
+static int m_set_text(lua_State * L)
+{
+	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
+	cairo_scaled_font_t * sfont = luaL_checkudata_scaled_font(L, 2, MT_FONT);
+	const char * text = luaL_checkstring(L, 3);
+	struct lpattern_t * pattern = luaL_checkudata(L, 4, MT_PATTERN);
+	__object_anchor(L, "font", 2);
+	__object_anchor(L, "text", 3);
+	__object_anchor(L, "pattern", 4);
+	object->__drawable = DRAWABLE_TEXT;
+	object->__sfont = sfont;
+	object->__glyph = luaL_checkudata_glyph_cache(L, 2, MT_FONT);
+	object->__text = text;
+	object->__pattern = pattern;
+	__object_invalidate(object);
+	return 0;
+}
+
+static int m_set_texture(lua_State * L)
+{
+	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
+	struct ltexture_t * texture = luaL_checkudata(L, 2, MT_TEXTURE);
+	__object_anchor(L, "texture", 2);
+	object->__drawable = DRAWABLE_TEXTURE;
+	object->__texture = texture;
+	__object_invalidate(object);
+	return 0;
+}
+
+static int m_set_texture_mask(lua_State * L)
+{
+	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
+	struct ltexture_t * texture = luaL_checkudata(L, 2, MT_TEXTURE);
+	struct lpattern_t * pattern = luaL_checkudata(L, 3, MT_PATTERN);
+	__object_anchor(L, "texture", 2);
+	__object_anchor(L, "pattern", 3);
+	object->__drawable = DRAWABLE_TEXTURE_MASK;
+	object->__texture = texture;
+	object->__pattern = pattern;
+	__object_invalidate(object);
+	return 0;
+}
+
+static int m_set_ninepatch(lua_State * L)
+{
+	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
+	struct lninepatch_t * ninepatch = luaL_checkudata(L, 2, MT_NINEPATCH);
+	__object_anchor(L, "ninepatch", 2);
+	object->__drawable = DRAWABLE_NINEPATCH;
+	object->__ninepatch = ninepatch;
+	__object_invalidate(object);
+	return 0;
+}
+
+static int m_set_draw_hook(lua_State * L)
+{
+	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
+	int hook = lua_toboolean(L, 2) ? 1 : 0;
+	if(object->__draw_hook != hook)
+	{
+		object->__draw_hook = hook;
+		__object_invalidate(object);
+	}
+	return 0;
+}
+
+static int m_set_enter_frame(lua_State * L)
+{
+	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
+	object->__enter_frame = lua_toboolean(L, 2) ? 1 : 0;
+	return 0;
+}
+
+static int m_set_cache(lua_State * L)
+{
+	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
+	object->__cache_enable = lua_toboolean(L, 2) ? 1 : 0;
+	object->__cache_dirty = 1;
+	if(!object->__cache_enable && object->__cache)
+	{
+		cairo_surface_destroy(object->__cache);
+		object->__cache = NULL;
+	}
+	__object_invalidate(object->parent);
+	return 0;
+}
+
+static int m_get_cache(lua_State * L)
+{
+	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
+	lua_pushboolean(L, object->__cache_enable);
+	return 1;
+}
+
+static int m_invalidate(lua_State * L)
+{
+	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
+	__object_invalidate(object);
+	return 0;
+}
+
+static int m_animate(lua_State * L)
+{
+	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
+	double duration = luaL_optnumber(L, 3, 1);
+	const char * type = luaL_optstring(L, 4, "linear");
+	struct ltween_t * tween;
+	struct ltween_prop_t * p;
+	const char * key;
+	int nprop = 0;
+
+	luaL_checktype(L, 2, LUA_TTABLE);
+	lua_pushnil(L);
+	while(lua_next(L, 2) != 0)
+	{
+		if((lua_type(L, -2) == LUA_TSTRING) && (lua_type(L, -1) == LUA_TNUMBER))
+			nprop++;
+		lua_pop(L, 1);
+	}
+	tween = malloc(sizeof(struct ltween_t) + sizeof(struct ltween_prop_t) * nprop);
+	if(!tween)
+		return luaL_error(L, "Out of memory");
+	tween->func = leasing_find(type);
+	tween->duration = duration > 0 ? duration : 0;
+	tween->started = 0;
+	tween->nprop = 0;
+	lua_pushnil(L);
+	while(lua_next(L, 2) != 0)
+	{
+		if((lua_type(L, -2) == LUA_TSTRING) && (lua_type(L, -1) == LUA_TNUMBER) && (tween->nprop < nprop))
+		{
+			p = &tween->prop[tween->nprop++];
+			key = lua_tostring(L, -2);
+			p->to = lua_tonumber(L, -1);
+			p->key = NULL;
+			if(strcmp(key, "x") == 0)
+				p->field = TWEEN_X;
+			else if(strcmp(key, "y") == 0)
+				p->field = TWEEN_Y;
+			else if(strcmp(key, "rotation") == 0)
+			{
+				p->field = TWEEN_ROTATION;
+				p->to = p->to * (M_PI / 180.0);
+			}
+			else if(strcmp(key, "scalex") == 0)
+				p->field = TWEEN_SCALEX;
+			else if(strcmp(key, "scaley") == 0)
+				p->field = TWEEN_SCALEY;
+			else if(strcmp(key, "alpha") == 0)
+				p->field = TWEEN_ALPHA;
+			else
+			{
+				p->field = TWEEN_CUSTOM;
+				p->key = strdup(key);
+			}
+		}
+		lua_pop(L, 1);
+	}
+	lua_rawgetp(L, LUA_REGISTRYINDEX, &__tweens);
+	if(lua_isfunction(L, 5))
+	{
+		lua_pushvalue(L, 5);
+		lua_rawsetp(L, -2, tween);
+	}
+	if(list_empty(&object->__tweens))
+	{
+		list_add_tail(&object->__tween_entry, __animating_list(L));
+		lua_pushvalue(L, 1);
+		lua_rawsetp(L, -2, object);
+		list_add_tail(&tween->entry, &object->__tweens);
+		__tween_start(L, object, tween, ktime_get());
+	}
+	else
+		list_add_tail(&tween->entry, &object->__tweens);
+	lua_pop(L, 1);
+	return 0;
+}
+
+static int m_stop_animate(lua_State * L)
+{
+	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
+	lua_pushboolean(L, __tween_stop(L, object));
+	return 1;
+}
+
+static int m_is_animating(lua_State * L)
+{
+	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
+	lua_pushboolean(L, !list_empty(&object->__tweens));
+	return 1;
+}
+
 static int m_layout(lua_State * L)
 {
 	struct lobject_t * object = luaL_checkudata(L, 1, MT_OBJECT);
@@ -562,6 +1282,7 @@ static int m_layout(lua_State * L)
 }
 
 static const luaL_Reg m_object[] = {
+	{"__gc",					m_object_gc},
 	{"setSize",					m_set_size},
 	{"getSize",					m_get_size},
 	{"setX",					m_set_x},
@@ -595,12 +1316,48 @@ static const luaL_Reg m_object[] = {
 	{"localToGlobal",			m_local_to_global},
 	{"hitTestPoint",			m_hit_test_point},
 	{"bounds",					m_bounds},
+	{"pick",					m_pick},
+	{"addChild",				m_add_child},
+	{"removeChild",				m_remove_child},
+	{"setShape",				m_set_shape},
+	{"setText",					m_set_text},
+	{"setTexture",				m_set_texture},
+	{"setTextureMask",			m_set_texture_mask},
+	{"setNinepatch",			m_set_ninepatch},
+	{"setDrawHook",				m_set_draw_hook},
+	{"setEnterFrame",			m_set_enter_frame},
+	{"setCache",				m_set_cache},
+	{"getCache",				m_get_cache},
+	{"invalidate",				m_invalidate},
+	{"animate",					m_animate},
+	{"stopAnimate",				m_stop_animate},
+	{"isAnimating",				m_is_animating},
 	{"layout",					m_layout},
 	{NULL,						NULL}
 };
 
 int luaopen_object(lua_State * L)
 {
+	lua_rawgetp(L, LUA_REGISTRYINDEX, &__owners);
+	if(!lua_istable(L, -1))
+	{
+		lua_newtable(L);
+		lua_newtable(L);
+		lua_pushstring(L, "v");
+		lua_setfield(L, -2, "__mode");
+		lua_setmetatable(L, -2);
+		lua_rawsetp(L, LUA_REGISTRYINDEX, &__owners);
+	}
+	lua_pop(L, 1);
+	lua_rawgetp(L, LUA_REGISTRYINDEX, &__tweens);
+	if(!lua_istable(L, -1))
+	{
+		lua_newtable(L);
+		lua_rawsetp(L, LUA_REGISTRYINDEX, &__tweens);
+		init_list_head(lua_newuserdata(L, sizeof(struct list_head)));
+		lua_rawsetp(L, LUA_REGISTRYINDEX, &__animating);
+	}
+	lua_pop(L, 1);
 	luaL_newlib(L, l_object);
 	/* enum alignment_t */
 	luahelper_set_intfield(L, "ALIGN_NONE", 				ALIGN_NONE);
@@ -0,0 +1,623 @@
+/*
+ * framework/display/tiler.c
+ *
+ * Copyright(c) 2007-2018 Jianjun Jiang <8192542@qq.com>
+ * Official site: http://xboot.org
+ * Mobile phone: +86-18665388956
+ * QQ: 8192542
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <xboot.h>
+#include <xboot/mutex.h>
+#include <framework/display/tiler.h>
+
+/*
+ * Tiled rasterization. Draw calls are recorded into a display list and
+ * binned by their device space bounding box into fixed size screen tiles.
+ * On flush the tiles are handed out one at a time to whichever cpu asks
+ * first. Every tile owns a cairo context on the whole frame buffer clipped
+ * to its own rectangle, so tiles never touch each other's pixels and the
+ * sampling is bit identical to drawing without tiles.
+ *
+ * If the display list can't grow, everything recorded so far is rendered
+ * at once and the new command is drawn straight into the tiles it covers,
+ * so running out of memory costs parallelism but never drops a draw call.
+ */
+enum tiler_cmd_type_t {
+	TILER_CMD_PAINT		= 0,
+	TILER_CMD_MASK		= 1,
+	TILER_CMD_FILL		= 2,
+	TILER_CMD_MASK_SURFACE	= 3,
+};
+
+struct tiler_cmd_t {
+	enum tiler_cmd_type_t type;
+	cairo_matrix_t matrix;
+	cairo_surface_t * surface;
+	cairo_pattern_t * pattern;
+	cairo_path_t * path;
+	cairo_filter_t filter;
+	double alpha;
+};
+
+struct tiler_tile_t {
+	cairo_surface_t * cs;
+	cairo_t * cr;
+	int * cmds;
+	int ncmd;
+	int mcmd;
+};
+
+struct tiler_t {
+	cairo_surface_t * cs;
+	int width, height;
+	int size;
+	int cols, rows;
+	struct tiler_tile_t * tiles;
+	int ntile;
+
+	struct tiler_cmd_t * cmds;
+	int ncmd;
+	int mcmd;
+
+	int opaque;
+	int cleared;
+
+	atomic_t next;
+	atomic_t done;
+};
+
+/*
+ * The job being rendered is published under the spinlock, and helpers
+ * count themselves in __tiler_active while they hold it. Unpublishing and
+ * waiting for the count to drain guarantees no helper still touches it.
+ */
+static struct tiler_t * __tiler_job = NULL;
+static int __tiler_active = 0;
+static spinlock_t __tiler_lock = SPIN_LOCK_INIT();
+static struct mutex_t __tiler_mutex;
+
+static void tiler_render_cmd(cairo_t * cr, struct tiler_cmd_t * cmd)
+{
+	cairo_save(cr);
+	switch(cmd->type)
+	{
+	case TILER_CMD_PAINT:
+		cairo_set_matrix(cr, &cmd->matrix);
+		cairo_set_source_surface(cr, cmd->surface, 0, 0);
+		cairo_pattern_set_filter(cairo_get_source(cr), cmd->filter);
+		cairo_paint_with_alpha(cr, cmd->alpha);
+		break;
+	case TILER_CMD_MASK:
+		cairo_set_matrix(cr, &cmd->matrix);
+		cairo_set_source_surface(cr, cmd->surface, 0, 0);
+		cairo_pattern_set_filter(cairo_get_source(cr), cmd->filter);
+		cairo_mask(cr, cmd->pattern);
+		break;
+	case TILER_CMD_MASK_SURFACE:
+		cairo_set_source(cr, cmd->pattern);
+		cairo_mask_surface(cr, cmd->surface, cmd->matrix.x0, cmd->matrix.y0);
+		break;
+	case TILER_CMD_FILL:
+		cairo_new_path(cr);
+		cairo_append_path(cr, cmd->path);
+		cairo_set_source(cr, cmd->pattern);
+		cairo_fill(cr);
+		break;
+	default:
+		break;
+	}
+	cairo_restore(cr);
+}
+
+static void tiler_render_tile(struct tiler_t * t, struct tiler_tile_t * tile)
+{
+	cairo_t * cr = tile->cr;
+	int i;
+
+	if(!t->opaque && !t->cleared)
+	{
+		cairo_save(cr);
+		cairo_set_source_rgb(cr, 1, 1, 1);
+		cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+		cairo_paint(cr);
+		cairo_restore(cr);
+	}
+	for(i = 0; i < tile->ncmd; i++)
+		tiler_render_cmd(cr, &t->cmds[tile->cmds[i]]);
+	cairo_surface_flush(tile->cs);
+}
+
+static void tiler_run(struct tiler_t * t)
+{
+	int i;
+
+	while((i = atomic_add_return(&t->next, 1) - 1) < t->ntile)
+	{
+		tiler_render_tile(t, &t->tiles[i]);
+		smp_mb();
+		atomic_inc(&t->done);
+	}
+}
+
+#if defined(CONFIG_MAX_SMP_CPUS) && (CONFIG_MAX_SMP_CPUS > 1)
+static struct task_t * __tiler_task[CONFIG_MAX_SMP_CPUS] = { NULL };
+
+/*
+ * Helpers park suspended while there is nothing to render. A flush that
+ * publishes a job resumes them, and a helper that misses the wakeup only
+ * leaves its share of the tiles to the flushing task.
+ */
+static void tiler_task(struct task_t * task, void * data)
+{
+	struct tiler_t * t;
+
+	while(1)
+	{
+		spin_lock(&__tiler_lock);
+		t = __tiler_job;
+		if(t)
+			__tiler_active++;
+		spin_unlock(&__tiler_lock);
+
+		if(t)
+		{
+			tiler_run(t);
+			spin_lock(&__tiler_lock);
+			__tiler_active--;
+			spin_unlock(&__tiler_lock);
+			task_yield();
+		}
+		else
+		{
+			task_suspend(task);
+		}
+	}
+}
+
+static void tiler_helpers_start(void)
+{
+	int i;
+
+	mutex_lock(&__tiler_mutex);
+	for(i = 0; i < CONFIG_MAX_SMP_CPUS; i++)
+	{
+		if(!__tiler_task[i])
+			__tiler_task[i] = task_create(&__sched[i], "tiler", tiler_task, NULL, 0, 19);
+	}
+	mutex_unlock(&__tiler_mutex);
+}
+
+static void tiler_helpers_wakeup(void)
+{
+	int i;
+
+	for(i = 0; i < CONFIG_MAX_SMP_CPUS; i++)
+	{
+		if(__tiler_task[i])
+			task_resume(__tiler_task[i]);
+	}
+}
+#else
+static void tiler_helpers_start(void)
+{
+}
+
+static void tiler_helpers_wakeup(void)
+{
+}
+#endif
+
+/*
+ * Render all recorded commands on every cpu that is willing to help and
+ * start a new display list. Called with the tiler mutex held.
+ */
+static void tiler_render(struct tiler_t * t)
+{
+	struct tiler_cmd_t * cmd;
+	int i;
+
+	atomic_set(&t->done, 0);
+	atomic_set(&t->next, 0);
+	smp_mb();
+	spin_lock(&__tiler_lock);
+	__tiler_job = t;
+	spin_unlock(&__tiler_lock);
+	tiler_helpers_wakeup();
+
+	tiler_run(t);
+	while(atomic_get(&t->done) < t->ntile)
+		task_yield();
+
+	spin_lock(&__tiler_lock);
+	__tiler_job = NULL;
+	spin_unlock(&__tiler_lock);
+	while(1)
+	{
+		spin_lock(&__tiler_lock);
+		i = __tiler_active;
+		spin_unlock(&__tiler_lock);
+		if(i == 0)
+			break;
+		task_yield();
+	}
+	atomic_set(&t->next, t->ntile);
+	t->cleared = 1;
+
+	for(i = 0; i < t->ncmd; i++)
+	{
+		cmd = &t->cmds[i];
+		if(cmd->surface)
+			cairo_surface_destroy(cmd->surface);
+		if(cmd->pattern)
+			cairo_pattern_destroy(cmd->pattern);
+		if(cmd->path)
+			cairo_path_destroy(cmd->path);
+	}
+	t->ncmd = 0;
+	for(i = 0; i < t->ntile; i++)
+		t->tiles[i].ncmd = 0;
+}
+
+static int tiler_cmd_reserve(struct tiler_t * t)
+{
+	struct tiler_cmd_t * cmds;
+	int mcmd;
+
+	if(t->ncmd >= t->mcmd)
+	{
+		mcmd = t->mcmd ? t->mcmd << 1 : 64;
+		cmds = realloc(t->cmds, mcmd * sizeof(struct tiler_cmd_t));
+		if(!cmds)
+			return 0;
+		t->cmds = cmds;
+		t->mcmd = mcmd;
+	}
+	return 1;
+}
+
+static int tiler_tile_reserve(struct tiler_tile_t * tile)
+{
+	int * cmds;
+	int mcmd;
+
+	if(tile->ncmd >= tile->mcmd)
+	{
+		mcmd = tile->mcmd ? tile->mcmd << 1 : 16;
+		cmds = realloc(tile->cmds, mcmd * sizeof(int));
+		if(!cmds)
+			return 0;
+		tile->cmds = cmds;
+		tile->mcmd = mcmd;
+	}
+	return 1;
+}
+
+static int tiler_clip(struct tiler_t * t, double * x1, double * y1, double * x2, double * y2)
+{
+	/* One device pixel of slack covers antialiasing and minifying filters */
+	*x1 = floor(*x1) - 1;
+	*y1 = floor(*y1) - 1;
+	*x2 = ceil(*x2) + 1;
+	*y2 = ceil(*y2) + 1;
+	if(*x1 < 0)
+		*x1 = 0;
+	if(*y1 < 0)
+		*y1 = 0;
+	if(*x2 > t->width)
+		*x2 = t->width;
+	if(*y2 > t->height)
+		*y2 = t->height;
+	return ((*x2 > *x1) && (*y2 > *y1)) ? 1 : 0;
+}
+
+/*
+ * Append a command to the display list and bin it. The tiler takes over
+ * the references held by the command either way.
+ */
+static void tiler_record(struct tiler_t * t, struct tiler_cmd_t * cmd, double x1, double y1, double x2, double y2)
+{
+	struct tiler_tile_t * tile;
+	int c1 = (int)x1 / t->size;
+	int r1 = (int)y1 / t->size;
+	int c2 = ((int)x2 - 1) / t->size;
+	int r2 = ((int)y2 - 1) / t->size;
+	int c, r;
+
+	if(tiler_cmd_reserve(t))
+	{
+		for(r = r1; r <= r2; r++)
+		{
+			for(c = c1; c <= c2; c++)
+			{
+				if(!tiler_tile_reserve(&t->tiles[r * t->cols + c]))
+					goto direct;
+			}
+		}
+		t->cmds[t->ncmd] = *cmd;
+		for(r = r1; r <= r2; r++)
+		{
+			for(c = c1; c <= c2; c++)
+			{
+				tile = &t->tiles[r * t->cols + c];
+				tile->cmds[tile->ncmd++] = t->ncmd;
+			}
+		}
+		t->ncmd++;
+		return;
+	}
+
+direct:
+	mutex_lock(&__tiler_mutex);
+	tiler_render(t);
+	mutex_unlock(&__tiler_mutex);
+	for(r = r1; r <= r2; r++)
+	{
+		for(c = c1; c <= c2; c++)
+		{
+			tile = &t->tiles[r * t->cols + c];
+			tiler_render_cmd(tile->cr, cmd);
+			cairo_surface_flush(tile->cs);
+		}
+	}
+	if(cmd->surface)
+		cairo_surface_destroy(cmd->surface);
+	if(cmd->pattern)
+		cairo_pattern_destroy(cmd->pattern);
+	if(cmd->path)
+		cairo_path_destroy(cmd->path);
+}
+
+static void tiler_surface_extents(struct tiler_t * t, cairo_matrix_t * m, cairo_surface_t * surface, double * x1, double * y1, double * x2, double * y2)
+{
+	double px[4], py[4];
+	double w, h;
+	int i;
+
+	if(cairo_surface_get_type(surface) != CAIRO_SURFACE_TYPE_IMAGE)
+	{
+		*x1 = 0;
+		*y1 = 0;
+		*x2 = t->width;
+		*y2 = t->height;
+		return;
+	}
+	/* Grow by one source pixel for the footprint of magnifying filters */
+	w = cairo_image_surface_get_width(surface) + 1;
+	h = cairo_image_surface_get_height(surface) + 1;
+	px[0] = -1; py[0] = -1;
+	px[1] = w; py[1] = -1;
+	px[2] = -1; py[2] = h;
+	px[3] = w; py[3] = h;
+	for(i = 0; i < 4; i++)
+		cairo_matrix_transform_point(m, &px[i], &py[i]);
+	*x1 = *x2 = px[0];
+	*y1 = *y2 = py[0];
+	for(i = 1; i < 4; i++)
+	{
+		if(px[i] < *x1)
+			*x1 = px[i];
+		if(px[i] > *x2)
+			*x2 = px[i];
+		if(py[i] < *y1)
+			*y1 = py[i];
+		if(py[i] > *y2)
+			*y2 = py[i];
+	}
+}
+
+struct tiler_t * tiler_alloc(cairo_surface_t * cs, int size)
+{
+	struct tiler_t * t;
+	struct tiler_tile_t * tile;
+	unsigned char * pixels;
+	int stride;
+	int x, y, w, h;
+	int r, c;
+
+	if(!cs || (cairo_surface_get_type(cs) != CAIRO_SURFACE_TYPE_IMAGE))
+		return NULL;
+
+	if(size <= 0)
+		size = 128;
+	size = (size + 15) & ~15;
+
+	t = malloc(sizeof(struct tiler_t));
+	if(!t)
+		return NULL;
+	memset(t, 0, sizeof(struct tiler_t));
+
+	t->width = cairo_image_surface_get_width(cs);
+	t->height = cairo_image_surface_get_height(cs);
+	t->size = size;
+	t->cols = (t->width + size - 1) / size;
+	t->rows = (t->height + size - 1) / size;
+	t->ntile = t->cols * t->rows;
+	t->tiles = malloc(t->ntile * sizeof(struct tiler_tile_t));
+	if(!t->tiles)
+	{
+		free(t);
+		return NULL;
+	}
+	memset(t->tiles, 0, t->ntile * sizeof(struct tiler_tile_t));
+
+	pixels = cairo_image_surface_get_data(cs);
+	stride = cairo_image_surface_get_stride(cs);
+	for(r = 0; r < t->rows; r++)
+	{
+		for(c = 0; c < t->cols; c++)
+		{
+			tile = &t->tiles[r * t->cols + c];
+			x = c * size;
+			y = r * size;
+			w = (x + size > t->width) ? t->width - x : size;
+			h = (y + size > t->height) ? t->height - y : size;
+			tile->cs = cairo_image_surface_create_for_data(pixels,
+					cairo_image_surface_get_format(cs), t->width, t->height, stride);
+			tile->cr = cairo_create(tile->cs);
+			cairo_rectangle(tile->cr, x, y, w, h);
+			cairo_clip(tile->cr);
+		}
+	}
+	t->cs = cairo_surface_reference(cs);
+	atomic_set(&t->next, t->ntile);
+	atomic_set(&t->done, 0);
+	tiler_helpers_start();
+
+	return t;
+}
+
+void tiler_free(struct tiler_t * t)
+{
+	struct tiler_tile_t * tile;
+	int i;
+
+	if(t)
+	{
+		/* A flush in progress on another task owns the tiler until it returns */
+		mutex_lock(&__tiler_mutex);
+		mutex_unlock(&__tiler_mutex);
+
+		for(i = 0; i < t->ncmd; i++)
+		{
+			if(t->cmds[i].surface)
+				cairo_surface_destroy(t->cmds[i].surface);
+			if(t->cmds[i].pattern)
+				cairo_pattern_destroy(t->cmds[i].pattern);
+			if(t->cmds[i].path)
+				cairo_path_destroy(t->cmds[i].path);
+		}
+		for(i = 0; i < t->ntile; i++)
+		{
+			tile = &t->tiles[i];
+			cairo_destroy(tile->cr);
+			cairo_surface_destroy(tile->cs);
+			if(tile->cmds)
+				free(tile->cmds);
+		}
+		if(t->cmds)
+			free(t->cmds);
+		free(t->tiles);
+		cairo_surface_destroy(t->cs);
+		free(t);
+	}
+}
+
+void tiler_paint(struct tiler_t * t, cairo_matrix_t * m, cairo_surface_t * surface, cairo_filter_t filter, double alpha)
+{
+	struct tiler_cmd_t cmd;
+	double x1, y1, x2, y2;
+
+	if(alpha <= 0)
+		return;
+	tiler_surface_extents(t, m, surface, &x1, &y1, &x2, &y2);
+	if(!tiler_clip(t, &x1, &y1, &x2, &y2))
+		return;
+	cmd.type = TILER_CMD_PAINT;
+	cmd.matrix = *m;
+	cmd.surface = cairo_surface_reference(surface);
+	cmd.pattern = NULL;
+	cmd.path = NULL;
+	cmd.filter = filter;
+	cmd.alpha = alpha;
+	tiler_record(t, &cmd, x1, y1, x2, y2);
+}
+
+void tiler_mask(struct tiler_t * t, cairo_matrix_t * m, cairo_surface_t * surface, cairo_pattern_t * pattern)
+{
+	struct tiler_cmd_t cmd;
+	double x1, y1, x2, y2;
+
+	tiler_surface_extents(t, m, surface, &x1, &y1, &x2, &y2);
+	if(!tiler_clip(t, &x1, &y1, &x2, &y2))
+		return;
+	cmd.type = TILER_CMD_MASK;
+	cmd.matrix = *m;
+	cmd.surface = cairo_surface_reference(surface);
+	cmd.pattern = cairo_pattern_reference(pattern);
+	cmd.path = NULL;
+	cmd.filter = CAIRO_FILTER_FAST;
+	cmd.alpha = 1;
+	tiler_record(t, &cmd, x1, y1, x2, y2);
+}
+
+void tiler_mask_surface(struct tiler_t * t, cairo_pattern_t * pattern, cairo_surface_t * surface, int x, int y)
+{
+	struct tiler_cmd_t cmd;
+	double x1 = x, y1 = y;
+	double x2 = x + cairo_image_surface_get_width(surface);
+	double y2 = y + cairo_image_surface_get_height(surface);
+
+	if(!tiler_clip(t, &x1, &y1, &x2, &y2))
+		return;
+	cmd.type = TILER_CMD_MASK_SURFACE;
+	cairo_matrix_init_translate(&cmd.matrix, x, y);
+	cmd.surface = cairo_surface_reference(surface);
+	cmd.pattern = cairo_pattern_reference(pattern);
+	cmd.path = NULL;
+	cmd.filter = CAIRO_FILTER_FAST;
+	cmd.alpha = 1;
+	tiler_record(t, &cmd, x1, y1, x2, y2);
+}
+
+void tiler_fill(struct tiler_t * t, cairo_path_t * path, cairo_pattern_t * pattern, double x1, double y1, double x2, double y2)
+{
+	struct tiler_cmd_t cmd;
+
+	if(!tiler_clip(t, &x1, &y1, &x2, &y2))
+	{
+		cairo_path_destroy(path);
+		return;
+	}
+	cmd.type = TILER_CMD_FILL;
+	cairo_matrix_init_identity(&cmd.matrix);
+	cmd.surface = NULL;
+	cmd.pattern = cairo_pattern_reference(pattern);
+	cmd.path = path;
+	cmd.filter = CAIRO_FILTER_GOOD;
+	cmd.alpha = 1;
+	tiler_record(t, &cmd, x1, y1, x2, y2);
+}
+
+void tiler_opaque(struct tiler_t * t, int opaque)
+{
+	if(t)
+		t->opaque = opaque ? 1 : 0;
+}
+
+void tiler_flush(struct tiler_t * t)
+{
+	if(!t)
+		return;
+
+	mutex_lock(&__tiler_mutex);
+	tiler_render(t);
+	mutex_unlock(&__tiler_mutex);
+	t->cleared = 0;
+	cairo_surface_mark_dirty(t->cs);
+}
+
+static __init void tiler_init(void)
+{
+	mutex_init(&__tiler_mutex);
+}
+pure_initcall(tiler_init);
@@ -51,7 +51,7 @@ function M:hasEventListener(type, listener, data)
 	return false
 end
 
-function M:addEventListener(type, listener, data)
+function M:addEventListener(type, listener, data, capture)
 	local data = data or self
 
 	if self:hasEventListener(type, listener, data) then
@@ -63,7 +63,7 @@ function M:addEventListener(type, listener, data)
 	end
 
 	local els = self.eventListenersMap[type]
-	local el = {type = type, listener = listener, data = data}
+	local el = {type = type, listener = listener, data = data, capture = capture and true or false}
 	table.insert(els, el)
 
 	return self
@@ -99,8 +99,11 @@ function M:dispatchEvent(event)
 		return self
 	end
 
+	local phase = event.phase
+	local capture = phase == Event.CAPTURING_PHASE
+
 	for i, v in ipairs(els) do
-		if v.type == event.type then
+		if v.type == event.type and (phase == nil or phase == Event.AT_TARGET or v.capture == capture) then
 			v.listener(v.data, event)
 		end
 	end
@@ -72,262 +72,274 @@ static int l_event_new(lua_State * L)
 	return 1;
 }
 
-static int l_event_pump(lua_State * L)
+/*
+ * Registry table caching the strings of pumped events, the type names at their
+ * kernel event type and the names of input devices at the device
+ */
+static const char __event_cache = 0;
+
+/*
+ * Registry table holding one reusable event table per kernel event type
+ */
+static const char __event_pool = 0;
+
+static void event_push_device(lua_State * L, int cache, struct input_t * input)
 {
-	struct event_t e;
+	if(lua_rawgetp(L, cache, input) == LUA_TSTRING)
+	{
+		if(strcmp(lua_tostring(L, -1), input->name) == 0)
+			return;
+	}
+	lua_pop(L, 1);
+	lua_pushstring(L, input->name);
+	lua_pushvalue(L, -1);
+	lua_rawsetp(L, cache, input);
+}
 
-	if(!pump_event(&e))
-		return 0;
+static void event_push_type(lua_State * L, int cache, int type, const char * name)
+{
+	if(lua_rawgeti(L, cache, type) == LUA_TSTRING)
+		return;
+	lua_pop(L, 1);
+	lua_pushstring(L, name);
+	lua_pushvalue(L, -1);
+	lua_rawseti(L, cache, type);
+}
+
+static inline void event_set_integer(lua_State * L, const char * key, lua_Integer v)
+{
+	lua_pushinteger(L, v);
+	lua_setfield(L, -2, key);
+}
+
+/*
+ * Push a kernel event as an event table. Without a pool a new table is created,
+ * otherwise the pooled table of the event's type is refilled, clearing the fields
+ * left over by the dispatch of the previous event of that type.
+ */
+static int event_push(lua_State * L, struct event_t * e, int cache, int pool)
+{
+	const char * name;
 
-	switch(e.type)
+	switch(e->type)
 	{
 	case EVENT_TYPE_KEY_DOWN:
-		lua_newtable(L);
-		lua_pushstring(L, ((struct input_t *)e.device)->name);
-		lua_setfield(L, -2, "device");
-		lua_pushstring(L, EVT_KEY_DOWN);
-		lua_setfield(L, -2, "type");
-		lua_pushnumber(L, ktime_to_ns(e.timestamp));
-		lua_setfield(L, -2, "time");
-		lua_pushinteger(L, e.e.key_down.key);
-		lua_setfield(L, -2, "key");
-		return 1;
-
+		name = EVT_KEY_DOWN;
+		break;
 	case EVENT_TYPE_KEY_UP:
-		lua_newtable(L);
-		lua_pushstring(L, ((struct input_t *)e.device)->name);
-		lua_setfield(L, -2, "device");
-		lua_pushstring(L, EVT_KEY_UP);
-		lua_setfield(L, -2, "type");
-		lua_pushnumber(L, ktime_to_ns(e.timestamp));
-		lua_setfield(L, -2, "time");
-		lua_pushinteger(L, e.e.key_up.key);
-		lua_setfield(L, -2, "key");
-		return 1;
-
+		name = EVT_KEY_UP;
+		break;
 	case EVENT_TYPE_ROTARY_TURN:
-		lua_newtable(L);
-		lua_pushstring(L, ((struct input_t *)e.device)->name);
-		lua_setfield(L, -2, "device");
-		lua_pushstring(L, EVT_ROTARY_TURN);
-		lua_setfield(L, -2, "type");
-		lua_pushnumber(L, ktime_to_ns(e.timestamp));
-		lua_setfield(L, -2, "time");
-		lua_pushinteger(L, e.e.rotary_turn.v);
-		lua_setfield(L, -2, "v");
-		return 1;
-
+		name = EVT_ROTARY_TURN;
+		break;
 	case EVENT_TYPE_ROTARY_SWITCH:
-		lua_newtable(L);
-		lua_pushstring(L, ((struct input_t *)e.device)->name);
-		lua_setfield(L, -2, "device");
-		lua_pushstring(L, EVT_ROTARY_SWITCH);
-		lua_setfield(L, -2, "type");
-		lua_pushnumber(L, ktime_to_ns(e.timestamp));
-		lua_setfield(L, -2, "time");
-		lua_pushinteger(L, e.e.rotary_switch.v);
-		lua_setfield(L, -2, "v");
-		return 1;
-
+		name = EVT_ROTARY_SWITCH;
+		break;
 	case EVENT_TYPE_MOUSE_DOWN:
-		lua_newtable(L);
-		lua_pushstring(L, ((struct input_t *)e.device)->name);
-		lua_setfield(L, -2, "device");
-		lua_pushstring(L, EVT_MOUSE_DOWN);
-		lua_setfield(L, -2, "type");
-		lua_pushnumber(L, ktime_to_ns(e.timestamp));
-		lua_setfield(L, -2, "time");
-		lua_pushinteger(L, e.e.mouse_down.x);
-		lua_setfield(L, -2, "x");
-		lua_pushinteger(L, e.e.mouse_down.y);
-		lua_setfield(L, -2, "y");
-		lua_pushinteger(L, e.e.mouse_down.button);
-		lua_setfield(L, -2, "button");
-		return 1;
-
+		name = EVT_MOUSE_DOWN;
+		break;
 	case EVENT_TYPE_MOUSE_MOVE:
-		lua_newtable(L);
-		lua_pushstring(L, ((struct input_t *)e.device)->name);
-		lua_setfield(L, -2, "device");
-		lua_pushstring(L, EVT_MOUSE_MOVE);
-		lua_setfield(L, -2, "type");
-		lua_pushnumber(L, ktime_to_ns(e.timestamp));
-		lua_setfield(L, -2, "time");
-		lua_pushinteger(L, e.e.mouse_move.x);
-		lua_setfield(L, -2, "x");
-		lua_pushinteger(L, e.e.mouse_move.y);
-		lua_setfield(L, -2, "y");
-		return 1;
-
+		name = EVT_MOUSE_MOVE;
+		break;
 	case EVENT_TYPE_MOUSE_UP:
-		lua_newtable(L);
-		lua_pushstring(L, ((struct input_t *)e.device)->name);
-		lua_setfield(L, -2, "device");
-		lua_pushstring(L, EVT_MOUSE_UP);
-		lua_setfield(L, -2, "type");
-		lua_pushnumber(L, ktime_to_ns(e.timestamp));
-		lua_setfield(L, -2, "time");
-		lua_pushinteger(L, e.e.mouse_up.x);
-		lua_setfield(L, -2, "x");
-		lua_pushinteger(L, e.e.mouse_up.y);
-		lua_setfield(L, -2, "y");
-		lua_pushinteger(L, e.e.mouse_up.button);
-		lua_setfield(L, -2, "button");
-		return 1;
-
+		name = EVT_MOUSE_UP;
+		break;
 	case EVENT_TYPE_MOUSE_WHEEL:
-		lua_newtable(L);
-		lua_pushstring(L, ((struct input_t *)e.device)->name);
-		lua_setfield(L, -2, "device");
-		lua_pushstring(L, EVT_MOUSE_WHEEL);
-		lua_setfield(L, -2, "type");
-		lua_pushnumber(L, ktime_to_ns(e.timestamp));
-		lua_setfield(L, -2, "time");
-		lua_pushinteger(L, e.e.mouse_wheel.dx);
-		lua_setfield(L, -2, "dx");
-		lua_pushinteger(L, e.e.mouse_wheel.dy);
-		lua_setfield(L, -2, "dy");
-		return 1;
-
+		name = EVT_MOUSE_WHEEL;
+		break;
 	case EVENT_TYPE_TOUCH_BEGIN:
-		lua_newtable(L);
-		lua_pushstring(L, ((struct input_t *)e.device)->name);
-		lua_setfield(L, -2, "device");
-		lua_pushstring(L, EVT_TOUCH_BEGIN);
-		lua_setfield(L, -2, "type");
-		lua_pushnumber(L, ktime_to_ns(e.timestamp));
-		lua_setfield(L, -2, "time");
-		lua_pushinteger(L, e.e.touch_begin.x);
-		lua_setfield(L, -2, "x");
-		lua_pushinteger(L, e.e.touch_begin.y);
-		lua_setfield(L, -2, "y");
-		lua_pushinteger(L, e.e.touch_begin.id);
-		lua_setfield(L, -2, "id");
-		return 1;
-
+		name = EVT_TOUCH_BEGIN;
+		break;
 	case EVENT_TYPE_TOUCH_MOVE:
-		lua_newtable(L);
-		lua_pushstring(L, ((struct input_t *)e.device)->name);
-		lua_setfield(L, -2, "device");
-		lua_pushstring(L, EVT_TOUCH_MOVE);
-		lua_setfield(L, -2, "type");
-		lua_pushnumber(L, ktime_to_ns(e.timestamp));
-		lua_setfield(L, -2, "time");
-		lua_pushinteger(L, e.e.touch_move.x);
-		lua_setfield(L, -2, "x");
-		lua_pushinteger(L, e.e.touch_move.y);
-		lua_setfield(L, -2, "y");
-		lua_pushinteger(L, e.e.touch_move.id);
-		lua_setfield(L, -2, "id");
-		return 1;
-
+		name = EVT_TOUCH_MOVE;
+		break;
 	case EVENT_TYPE_TOUCH_END:
-		lua_newtable(L);
-		lua_pushstring(L, ((struct input_t *)e.device)->name);
-		lua_setfield(L, -2, "device");
-		lua_pushstring(L, EVT_TOUCH_END);
-		lua_setfield(L, -2, "type");
-		lua_pushnumber(L, ktime_to_ns(e.timestamp));
-		lua_setfield(L, -2, "time");
-		lua_pushinteger(L, e.e.touch_end.x);
-		lua_setfield(L, -2, "x");
-		lua_pushinteger(L, e.e.touch_end.y);
-		lua_setfield(L, -2, "y");
-		lua_pushinteger(L, e.e.touch_end.id);
-		lua_setfield(L, -2, "id");
-		return 1;
-
+		name = EVT_TOUCH_END;
+		break;
 	case EVENT_TYPE_JOYSTICK_LEFTSTICK:
-		lua_newtable(L);
-		lua_pushstring(L, ((struct input_t *)e.device)->name);
-		lua_setfield(L, -2, "device");
-		lua_pushstring(L, EVT_JOYSTICK_LEFTSTICK);
-		lua_setfield(L, -2, "type");
-		lua_pushnumber(L, ktime_to_ns(e.timestamp));
-		lua_setfield(L, -2, "time");
-		lua_pushinteger(L, e.e.joystick_left_stick.x);
-		lua_setfield(L, -2, "x");
-		lua_pushinteger(L, e.e.joystick_left_stick.y);
-		lua_setfield(L, -2, "y");
-		return 1;
-
+		name = EVT_JOYSTICK_LEFTSTICK;
+		break;
 	case EVENT_TYPE_JOYSTICK_RIGHTSTICK:
-		lua_newtable(L);
-		lua_pushstring(L, ((struct input_t *)e.device)->name);
-		lua_setfield(L, -2, "device");
-		lua_pushstring(L, EVT_JOYSTICK_RIGHTSTICK);
-		lua_setfield(L, -2, "type");
-		lua_pushnumber(L, ktime_to_ns(e.timestamp));
-		lua_setfield(L, -2, "time");
-		lua_pushinteger(L, e.e.joystick_right_stick.x);
-		lua_setfield(L, -2, "x");
-		lua_pushinteger(L, e.e.joystick_right_stick.y);
-		lua_setfield(L, -2, "y");
-		return 1;
-
+		name = EVT_JOYSTICK_RIGHTSTICK;
+		break;
 	case EVENT_TYPE_JOYSTICK_LEFTTRIGGER:
-		lua_newtable(L);
-		lua_pushstring(L, ((struct input_t *)e.device)->name);
-		lua_setfield(L, -2, "device");
-		lua_pushstring(L, EVT_JOYSTICK_LEFTTRIGGER);
-		lua_setfield(L, -2, "type");
-		lua_pushnumber(L, ktime_to_ns(e.timestamp));
-		lua_setfield(L, -2, "time");
-		lua_pushinteger(L, e.e.joystick_left_trigger.v);
-		lua_setfield(L, -2, "v");
-		return 1;
-
+		name = EVT_JOYSTICK_LEFTTRIGGER;
+		break;
 	case EVENT_TYPE_JOYSTICK_RIGHTTRIGGER:
-		lua_newtable(L);
-		lua_pushstring(L, ((struct input_t *)e.device)->name);
-		lua_setfield(L, -2, "device");
-		lua_pushstring(L, EVT_JOYSTICK_RIGHTTRIGGER);
-		lua_setfield(L, -2, "type");
-		lua_pushnumber(L, ktime_to_ns(e.timestamp));
-		lua_setfield(L, -2, "time");
-		lua_pushinteger(L, e.e.joystick_right_trigger.v);
-		lua_setfield(L, -2, "v");
-		return 1;
-
+		name = EVT_JOYSTICK_RIGHTTRIGGER;
+		break;
 	case EVENT_TYPE_JOYSTICK_BUTTONDOWN:
-		lua_newtable(L);
-		lua_pushstring(L, ((struct input_t *)e.device)->name);
-		lua_setfield(L, -2, "device");
-		lua_pushstring(L, EVT_JOYSTICK_BUTTONDOWN);
-		lua_setfield(L, -2, "type");
-		lua_pushnumber(L, ktime_to_ns(e.timestamp));
-		lua_setfield(L, -2, "time");
-		lua_pushinteger(L, e.e.joystick_button_down.button);
-		lua_setfield(L, -2, "button");
-		return 1;
-
+		name = EVT_JOYSTICK_BUTTONDOWN;
+		break;
 	case EVENT_TYPE_JOYSTICK_BUTTONUP:
-		lua_newtable(L);
-		lua_pushstring(L, ((struct input_t *)e.device)->name);
-		lua_setfield(L, -2, "device");
-		lua_pushstring(L, EVT_JOYSTICK_BUTTONUP);
-		lua_setfield(L, -2, "type");
-		lua_pushnumber(L, ktime_to_ns(e.timestamp));
-		lua_setfield(L, -2, "time");
-		lua_pushinteger(L, e.e.joystick_button_up.button);
-		lua_setfield(L, -2, "button");
-		return 1;
-
+		name = EVT_JOYSTICK_BUTTONUP;
+		break;
 	default:
 		return 0;
 	}
 
-	return 0;
+	if(pool && (lua_rawgeti(L, pool, e->type) == LUA_TTABLE))
+	{
+		lua_pushnil(L);
+		lua_setfield(L, -2, "stop");
+		lua_pushnil(L);
+		lua_setfield(L, -2, "phase");
+		lua_pushnil(L);
+		lua_setfield(L, -2, "target");
+	}
+	else
+	{
+		if(pool)
+			lua_pop(L, 1);
+		lua_createtable(L, 0, 8);
+		if(pool)
+		{
+			lua_pushvalue(L, -1);
+			lua_rawseti(L, pool, e->type);
+		}
+	}
+	event_push_device(L, cache, (struct input_t *)e->device);
+	lua_setfield(L, -2, "device");
+	event_push_type(L, cache, e->type, name);
+	lua_setfield(L, -2, "type");
+	lua_pushnumber(L, ktime_to_ns(e->timestamp));
+	lua_setfield(L, -2, "time");
+
+	switch(e->type)
+	{
+	case EVENT_TYPE_KEY_DOWN:
+		event_set_integer(L, "key", e->e.key_down.key);
+		break;
+	case EVENT_TYPE_KEY_UP:
+		event_set_integer(L, "key", e->e.key_up.key);
+		break;
+	case EVENT_TYPE_ROTARY_TURN:
+		event_set_integer(L, "v", e->e.rotary_turn.v);
+		break;
+	case EVENT_TYPE_ROTARY_SWITCH:
+		event_set_integer(L, "v", e->e.rotary_switch.v);
+		break;
+	case EVENT_TYPE_MOUSE_DOWN:
+		event_set_integer(L, "x", e->e.mouse_down.x);
+		event_set_integer(L, "y", e->e.mouse_down.y);
+		event_set_integer(L, "button", e->e.mouse_down.button);
+		break;
+	case EVENT_TYPE_MOUSE_MOVE:
+		event_set_integer(L, "x", e->e.mouse_move.x);
+		event_set_integer(L, "y", e->e.mouse_move.y);
+		break;
+	case EVENT_TYPE_MOUSE_UP:
+		event_set_integer(L, "x", e->e.mouse_up.x);
+		event_set_integer(L, "y", e->e.mouse_up.y);
+		event_set_integer(L, "button", e->e.mouse_up.button);
+		break;
+	case EVENT_TYPE_MOUSE_WHEEL:
+		event_set_integer(L, "dx", e->e.mouse_wheel.dx);
+		event_set_integer(L, "dy", e->e.mouse_wheel.dy);
+		break;
+	case EVENT_TYPE_TOUCH_BEGIN:
+		event_set_integer(L, "x", e->e.touch_begin.x);
+		event_set_integer(L, "y", e->e.touch_begin.y);
+		event_set_integer(L, "id", e->e.touch_begin.id);
+		break;
+	case EVENT_TYPE_TOUCH_MOVE:
+		event_set_integer(L, "x", e->e.touch_move.x);
+		event_set_integer(L, "y", e->e.touch_move.y);
+		event_set_integer(L, "id", e->e.touch_move.id);
+		break;
+	case EVENT_TYPE_TOUCH_END:
+		event_set_integer(L, "x", e->e.touch_end.x);
+		event_set_integer(L, "y", e->e.touch_end.y);
+		event_set_integer(L, "id", e->e.touch_end.id);
+		break;
+	case EVENT_TYPE_JOYSTICK_LEFTSTICK:
+		event_set_integer(L, "x", e->e.joystick_left_stick.x);
+		event_set_integer(L, "y", e->e.joystick_left_stick.y);
+		break;
+	case EVENT_TYPE_JOYSTICK_RIGHTSTICK:
+		event_set_integer(L, "x", e->e.joystick_right_stick.x);
+		event_set_integer(L, "y", e->e.joystick_right_stick.y);
+		break;
+	case EVENT_TYPE_JOYSTICK_LEFTTRIGGER:
+		event_set_integer(L, "v", e->e.joystick_left_trigger.v);
+		break;
+	case EVENT_TYPE_JOYSTICK_RIGHTTRIGGER:
+		event_set_integer(L, "v", e->e.joystick_right_trigger.v);
+		break;
+	case EVENT_TYPE_JOYSTICK_BUTTONDOWN:
+		event_set_integer(L, "button", e->e.joystick_button_down.button);
+		break;
+	case EVENT_TYPE_JOYSTICK_BUTTONUP:
+		event_set_integer(L, "button", e->e.joystick_button_up.button);
+		break;
+	default:
+		break;
+	}
+	return 1;
+}
+
+static int l_event_pump(lua_State * L)
+{
+	struct event_t e;
+	int ret;
+
+	if(!pump_event(&e))
+		return 0;
+
+	lua_rawgetp(L, LUA_REGISTRYINDEX, &__event_cache);
+	ret = event_push(L, &e, lua_gettop(L), 0);
+	lua_remove(L, -1 - ret);
+	return ret;
+}
+
+/*
+ * Drain the event queue in one call, invoking 'func(data, event)' for each event.
+ * The event tables are pooled per type and refilled by the next event of the same
+ * type, so a listener keeping an event beyond the call must copy it.
+ */
+static int l_event_pump_all(lua_State * L)
+{
+	struct event_t e;
+	int n = 0;
+
+	luaL_checktype(L, 1, LUA_TFUNCTION);
+	lua_settop(L, 2);
+	lua_rawgetp(L, LUA_REGISTRYINDEX, &__event_cache);
+	lua_rawgetp(L, LUA_REGISTRYINDEX, &__event_pool);
+	while(pump_event(&e))
+	{
+		lua_pushvalue(L, 1);
+		lua_pushvalue(L, 2);
+		if(event_push(L, &e, 3, 4))
+		{
+			lua_call(L, 2, 0);
+			n++;
+		}
+		else
+			lua_pop(L, 2);
+	}
+	lua_pushinteger(L, n);
+	return 1;
 }
 
 static const luaL_Reg l_event[] = {
 	{"new",		l_event_new},
 	{"pump",	l_event_pump},
+	{"pumpAll",	l_event_pump_all},
 	{NULL,		NULL}
 };
 
 int luaopen_event(lua_State * L)
 {
+	lua_rawgetp(L, LUA_REGISTRYINDEX, &__event_cache);
+	if(!lua_istable(L, -1))
+	{
+		lua_newtable(L);
+		lua_rawsetp(L, LUA_REGISTRYINDEX, &__event_cache);
+		lua_newtable(L);
+		lua_rawsetp(L, LUA_REGISTRYINDEX, &__event_pool);
+	}
+	lua_pop(L, 1);
 	luaL_newlib(L, l_event);
 	luahelper_set_strfield(L, "KEY_DOWN",				EVT_KEY_DOWN);
 	luahelper_set_strfield(L, "KEY_UP",					EVT_KEY_UP);
@@ -348,5 +360,8 @@ int luaopen_event(lua_State * L)
 	luahelper_set_strfield(L, "JOYSTICK_BUTTONUP",		EVT_JOYSTICK_BUTTONUP);
 	luahelper_set_strfield(L, "ENTER_FRAME",			EVT_ENTER_FRAME);
 	luahelper_set_strfield(L, "ANIMATE_COMPLETE",		EVT_ANIMATE_COMPLETE);
+	luahelper_set_intfield(L, "CAPTURING_PHASE",		1);
+	luahelper_set_intfield(L, "AT_TARGET",				2);
+	luahelper_set_intfield(L, "BUBBLING_PHASE",			3);
 	return 1;
 }
@@ -0,0 +1,483 @@
+/*
+ * framework/timer/l-timer-wheel.c
+ *
+ * Copyright(c) 2007-2018 Jianjun Jiang <8192542@qq.com>
+ * Official site: http://xboot.org
+ * Mobile phone: +86-18665388956
+ * QQ: 8192542
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <framework/timer/l-timer-wheel.h>
+
+/*
+ * Hierarchical timer wheel, in the way of the classic kernel timer list. A tick
+ * is 2^20 nanoseconds, about one millisecond. The first level resolves the next
+ * 64 ticks exactly, every following level covers 64 times the span of the one
+ * below and is cascaded into it as the wheel turns. Adding and cancelling a timer
+ * are constant time, and turning the wheel only looks at the slots it passes.
+ */
+#define WHEEL_TICK_SHIFT	(20)
+#define WHEEL_BITS			(6)
+#define WHEEL_SIZE			(1 << WHEEL_BITS)
+#define WHEEL_MASK			(WHEEL_SIZE - 1)
+#define WHEEL_LEVELS		(4)
+#define WHEEL_MAX_DELTA		((1ULL << (WHEEL_BITS * WHEEL_LEVELS)) - 1)
+
+enum wheel_catchup_t {
+	WHEEL_CATCHUP_SKIP	= 0,
+	WHEEL_CATCHUP_BURST	= 1,
+	WHEEL_CATCHUP_DELAY	= 2,
+};
+
+enum wheel_state_t {
+	WHEEL_STATE_QUEUED	= 0,
+	WHEEL_STATE_PAUSED	= 1,
+	WHEEL_STATE_FIRING	= 2,
+	WHEEL_STATE_DEAD	= 3,
+};
+
+struct wheel_timer_t {
+	struct list_head entry;
+	enum wheel_state_t state;
+	enum wheel_catchup_t catchup;
+	u64_t expires;
+	u64_t period;
+	u64_t last;
+	u64_t remain;
+	int iteration;
+	int count;
+	int firing;
+};
+
+struct ltimer_wheel_t {
+	u64_t time;
+	u64_t tick;
+	int running;
+	struct list_head slots[WHEEL_LEVELS][WHEEL_SIZE];
+	struct list_head pending;
+	struct list_head paused;
+};
+
+static void wheel_enqueue(struct ltimer_wheel_t * w, struct wheel_timer_t * t)
+{
+	u64_t expires = (t->expires + (1ULL << WHEEL_TICK_SHIFT) - 1) >> WHEEL_TICK_SHIFT;
+	u64_t delta = expires - w->tick;
+	struct list_head * slot;
+
+	if(expires < w->tick)
+		slot = &w->slots[0][w->tick & WHEEL_MASK];
+	else if(delta < (1ULL << WHEEL_BITS))
+		slot = &w->slots[0][expires & WHEEL_MASK];
+	else if(delta < (1ULL << (WHEEL_BITS * 2)))
+		slot = &w->slots[1][(expires >> WHEEL_BITS) & WHEEL_MASK];
+	else if(delta < (1ULL << (WHEEL_BITS * 3)))
+		slot = &w->slots[2][(expires >> (WHEEL_BITS * 2)) & WHEEL_MASK];
+	else
+	{
+		if(delta > WHEEL_MAX_DELTA)
+			expires = w->tick + WHEEL_MAX_DELTA;
+		slot = &w->slots[3][(expires >> (WHEEL_BITS * 3)) & WHEEL_MASK];
+	}
+	list_add_tail(&t->entry, slot);
+	t->state = WHEEL_STATE_QUEUED;
+}
+
+static int wheel_cascade(struct ltimer_wheel_t * w, int level)
+{
+	int index = (w->tick >> (WHEEL_BITS * level)) & WHEEL_MASK;
+	struct wheel_timer_t * pos, * n;
+	struct list_head list;
+
+	init_list_head(&list);
+	list_splice_init(&w->slots[level][index], &list);
+	list_for_each_entry_safe(pos, n, &list, entry)
+	{
+		list_del(&pos->entry);
+		wheel_enqueue(w, pos);
+	}
+	return index;
+}
+
+static inline u64_t wheel_seconds_to_ns(double s)
+{
+	return (s > 0) ? (u64_t)(s * 1000000000.0) : 0;
+}
+
+static struct wheel_timer_t * wheel_lookup(lua_State * L, int idx)
+{
+	struct wheel_timer_t * t;
+
+	lua_getuservalue(L, 1);
+	lua_pushvalue(L, idx);
+	lua_rawget(L, -2);
+	t = lua_touserdata(L, -1);
+	lua_pop(L, 2);
+	return t;
+}
+
+static void wheel_forget(lua_State * L, struct wheel_timer_t * t)
+{
+	lua_getuservalue(L, 1);
+	lua_rawgetp(L, -1, t);
+	lua_pushnil(L);
+	lua_rawset(L, -3);
+	lua_pushnil(L);
+	lua_rawsetp(L, -2, t);
+	lua_pop(L, 1);
+}
+
+static int l_timer_wheel_new(lua_State * L)
+{
+	struct ltimer_wheel_t * w = lua_newuserdata(L, sizeof(struct ltimer_wheel_t));
+	int i, j;
+
+	w->time = 0;
+	w->tick = 0;
+	w->running = 0;
+	for(i = 0; i < WHEEL_LEVELS; i++)
+	{
+		for(j = 0; j < WHEEL_SIZE; j++)
+			init_list_head(&w->slots[i][j]);
+	}
+	init_list_head(&w->pending);
+	init_list_head(&w->paused);
+	lua_newtable(L);
+	lua_setuservalue(L, -2);
+	luaL_setmetatable(L, MT_TIMER_WHEEL);
+	return 1;
+}
+
+static const luaL_Reg l_timer_wheel[] = {
+	{"new",	l_timer_wheel_new},
+	{NULL,	NULL}
+};
+
+static void wheel_free_list(struct list_head * head)
+{
+	struct wheel_timer_t * pos, * n;
+
+	list_for_each_entry_safe(pos, n, head, entry)
+	{
+		list_del(&pos->entry);
+		free(pos);
+	}
+}
+
+static int m_timer_wheel_gc(lua_State * L)
+{
+	struct ltimer_wheel_t * w = luaL_checkudata(L, 1, MT_TIMER_WHEEL);
+	int i, j;
+
+	for(i = 0; i < WHEEL_LEVELS; i++)
+	{
+		for(j = 0; j < WHEEL_SIZE; j++)
+			wheel_free_list(&w->slots[i][j]);
+	}
+	wheel_free_list(&w->pending);
+	wheel_free_list(&w->paused);
+	return 0;
+}
+
+static int m_timer_wheel_add(lua_State * L)
+{
+	struct ltimer_wheel_t * w = luaL_checkudata(L, 1, MT_TIMER_WHEEL);
+	struct wheel_timer_t * t;
+	const char * catchup;
+
+	luaL_checktype(L, 2, LUA_TTABLE);
+	if(wheel_lookup(L, 2))
+	{
+		lua_pushboolean(L, 0);
+		return 1;
+	}
+	t = malloc(sizeof(struct wheel_timer_t));
+	if(!t)
+		return luaL_error(L, "Out of memory");
+	lua_getfield(L, 2, "delay");
+	t->period = wheel_seconds_to_ns(luaL_optnumber(L, -1, 1));
+	lua_getfield(L, 2, "iteration");
+	t->iteration = luaL_optinteger(L, -1, 1);
+	lua_getfield(L, 2, "catchup");
+	catchup = luaL_optstring(L, -1, "skip");
+	if(strcmp(catchup, "burst") == 0)
+		t->catchup = WHEEL_CATCHUP_BURST;
+	else if(strcmp(catchup, "delay") == 0)
+		t->catchup = WHEEL_CATCHUP_DELAY;
+	else
+		t->catchup = WHEEL_CATCHUP_SKIP;
+	lua_getfield(L, 2, "running");
+	t->count = 0;
+	t->firing = 0;
+	t->last = w->time;
+	t->expires = w->time + t->period;
+	if(lua_toboolean(L, -1))
+		wheel_enqueue(w, t);
+	else
+	{
+		t->remain = t->period;
+		t->state = WHEEL_STATE_PAUSED;
+		list_add_tail(&t->entry, &w->paused);
+	}
+	lua_pop(L, 4);
+	lua_getuservalue(L, 1);
+	lua_pushvalue(L, 2);
+	lua_pushlightuserdata(L, t);
+	lua_rawset(L, -3);
+	lua_pushvalue(L, 2);
+	lua_rawsetp(L, -2, t);
+	lua_pop(L, 1);
+	lua_pushboolean(L, 1);
+	return 1;
+}
+
+static int m_timer_wheel_remove(lua_State * L)
+{
+	struct wheel_timer_t * t;
+
+	luaL_checkudata(L, 1, MT_TIMER_WHEEL);
+	t = wheel_lookup(L, 2);
+	if(!t)
+	{
+		lua_pushboolean(L, 0);
+		return 1;
+	}
+	wheel_forget(L, t);
+	if(t->state != WHEEL_STATE_FIRING)
+		list_del(&t->entry);
+	if(t->firing)
+		t->state = WHEEL_STATE_DEAD;
+	else
+		free(t);
+	lua_pushboolean(L, 1);
+	return 1;
+}
+
+static int m_timer_wheel_has(lua_State * L)
+{
+	luaL_checkudata(L, 1, MT_TIMER_WHEEL);
+	lua_pushboolean(L, wheel_lookup(L, 2) ? 1 : 0);
+	return 1;
+}
+
+static int m_timer_wheel_pause(lua_State * L)
+{
+	struct ltimer_wheel_t * w = luaL_checkudata(L, 1, MT_TIMER_WHEEL);
+	struct wheel_timer_t * t = wheel_lookup(L, 2);
+
+	if(!t || (t->state == WHEEL_STATE_PAUSED) || (t->state == WHEEL_STATE_DEAD))
+	{
+		lua_pushboolean(L, 0);
+		return 1;
+	}
+	if(t->state == WHEEL_STATE_QUEUED)
+	{
+		list_del(&t->entry);
+		t->remain = (t->expires > w->time) ? t->expires - w->time : 0;
+	}
+	else
+		t->remain = t->period;
+	t->state = WHEEL_STATE_PAUSED;
+	list_add_tail(&t->entry, &w->paused);
+	lua_pushboolean(L, 1);
+	return 1;
+}
+
+static int m_timer_wheel_resume(lua_State * L)
+{
+	struct ltimer_wheel_t * w = luaL_checkudata(L, 1, MT_TIMER_WHEEL);
+	struct wheel_timer_t * t = wheel_lookup(L, 2);
+
+	if(!t || (t->state != WHEEL_STATE_PAUSED))
+	{
+		lua_pushboolean(L, 0);
+		return 1;
+	}
+	list_del(&t->entry);
+	t->expires = w->time + t->remain;
+	t->last = t->expires - t->period;
+	wheel_enqueue(w, t);
+	lua_pushboolean(L, 1);
+	return 1;
+}
+
+/*
+ * The table passed to timer listeners, reused for every firing of the wheel
+ */
+static const char __event = 0;
+
+static void wheel_push_event(lua_State * L)
+{
+	lua_getuservalue(L, 1);
+	if(lua_rawgetp(L, -1, &__event) != LUA_TTABLE)
+	{
+		lua_pop(L, 1);
+		lua_createtable(L, 0, 2);
+		lua_pushvalue(L, -1);
+		lua_rawsetp(L, -3, &__event);
+	}
+	lua_remove(L, -2);
+}
+
+/*
+ * Fire one expired timer. A timer removed by it's own listener is released here,
+ * one paused or paused and resumed by it is left where the listener put it, and
+ * all others are re-armed according to their catch-up policy: 'skip' keeps the
+ * phase and drops the periods that were missed, 'burst' fires once for every
+ * missed period, and 'delay' restarts the period from now. Returns non zero with
+ * the error on the top of the stack if the listener raised one, after the timer
+ * itself has been taken care of.
+ */
+static int wheel_fire(lua_State * L, struct ltimer_wheel_t * w, struct wheel_timer_t * t)
+{
+	u64_t now = w->time;
+	int running;
+	int err = 0;
+
+	t->state = WHEEL_STATE_FIRING;
+	t->firing = 1;
+	lua_getuservalue(L, 1);
+	lua_rawgetp(L, -1, t);
+	lua_remove(L, -2);
+	lua_getfield(L, -1, "running");
+	running = lua_toboolean(L, -1);
+	lua_pop(L, 1);
+	if(running)
+	{
+		t->count++;
+		lua_getfield(L, -1, "listener");
+		if(lua_isfunction(L, -1))
+		{
+			lua_pushvalue(L, -2);
+			wheel_push_event(L);
+			lua_pushnumber(L, (double)(now - t->last) / (double)1000000000.0);
+			lua_setfield(L, -2, "time");
+			lua_pushinteger(L, t->count);
+			lua_setfield(L, -2, "count");
+			if(lua_pcall(L, 2, 0, 0) != LUA_OK)
+			{
+				lua_insert(L, -2);
+				err = 1;
+			}
+		}
+		else
+			lua_pop(L, 1);
+		t->last = now;
+	}
+	t->firing = 0;
+	if(t->state == WHEEL_STATE_DEAD)
+	{
+		lua_pop(L, 1);
+		free(t);
+		return err;
+	}
+	if((t->iteration > 0) && (t->count >= t->iteration))
+	{
+		lua_pushboolean(L, 0);
+		lua_setfield(L, -2, "running");
+		lua_pop(L, 1);
+		if(t->state != WHEEL_STATE_FIRING)
+			list_del(&t->entry);
+		wheel_forget(L, t);
+		free(t);
+		return err;
+	}
+	lua_pop(L, 1);
+	if(t->state != WHEEL_STATE_FIRING)
+		return err;
+	switch(t->catchup)
+	{
+	case WHEEL_CATCHUP_BURST:
+		t->expires += t->period;
+		break;
+	case WHEEL_CATCHUP_DELAY:
+		t->expires = now + t->period;
+		break;
+	default:
+		t->expires += t->period;
+		if((t->expires <= now) && (t->period > 0))
+			t->expires += ((now - t->expires) / t->period + 1) * t->period;
+		break;
+	}
+	wheel_enqueue(w, t);
+	return err;
+}
+
+static int m_timer_wheel_schedule(lua_State * L)
+{
+	struct ltimer_wheel_t * w = luaL_checkudata(L, 1, MT_TIMER_WHEEL);
+	double dt = luaL_checknumber(L, 2);
+	struct wheel_timer_t * t, * n;
+	u64_t target;
+	int index;
+
+	if(w->running)
+		return 0;
+	w->running = 1;
+	w->time += wheel_seconds_to_ns(dt);
+	target = w->time >> WHEEL_TICK_SHIFT;
+	while(w->tick <= target)
+	{
+		index = w->tick & WHEEL_MASK;
+		if(!index && !wheel_cascade(w, 1) && !wheel_cascade(w, 2))
+			wheel_cascade(w, 3);
+		list_splice_init(&w->slots[0][index], &w->pending);
+		w->tick++;
+		while(!list_empty(&w->pending))
+		{
+			t = list_first_entry(&w->pending, struct wheel_timer_t, entry);
+			list_del(&t->entry);
+			if(t->expires > w->time)
+				wheel_enqueue(w, t);
+			else if(wheel_fire(L, w, t) != 0)
+			{
+				/* Put back what was left to fire and pass the error on */
+				list_for_each_entry_safe(t, n, &w->pending, entry)
+				{
+					list_del(&t->entry);
+					wheel_enqueue(w, t);
+				}
+				w->running = 0;
+				return lua_error(L);
+			}
+		}
+	}
+	w->running = 0;
+	return 0;
+}
+
+static const luaL_Reg m_timer_wheel[] = {
+	{"__gc",		m_timer_wheel_gc},
+	{"add",			m_timer_wheel_add},
+	{"remove",		m_timer_wheel_remove},
+	{"has",			m_timer_wheel_has},
+	{"pause",		m_timer_wheel_pause},
+	{"resume",		m_timer_wheel_resume},
+	{"schedule",	m_timer_wheel_schedule},
+	{NULL,			NULL}
+};
+
+int luaopen_timer_wheel(lua_State * L)
+{
+	luaL_newlib(L, l_timer_wheel);
+	luahelper_create_metatable(L, MT_TIMER_WHEEL, m_timer_wheel);
+	return 1;
+}
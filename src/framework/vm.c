@@ -34,6 +34,7 @@
 #include <framework/codec/l-base64.h>
 #include <framework/codec/l-json.h>
 #include <framework/stopwatch/l-stopwatch.h>
+#include <framework/timer/l-timer-wheel.h>
 #include <framework/display/l-display.h>
 #include <framework/hardware/l-hardware.h>
 #include <framework/vm.h>
@@ -62,6 +63,7 @@ static void luaopen_prelibs(lua_State * L)
 		{ "codec.json",				luaopen_cjson_safe },
 
 		{ "builtin.stopwatch",		luaopen_stopwatch },
+		{ "builtin.timerwheel",	luaopen_timer_wheel },
 		{ "builtin.matrix",			luaopen_matrix },
 		{ "builtin.easing",			luaopen_easing },
 		{ "builtin.object",			luaopen_object },
@@ -114,6 +116,7 @@ static const char boot_lua[] = X(
 	Json = require "codec.json"
 
 	Stopwatch = require "builtin.stopwatch"
+	TimerWheel = require "builtin.timerwheel"
 	Matrix = require "builtin.matrix"
 	Easing = require "builtin.easing"
 	Object = require "builtin.object"
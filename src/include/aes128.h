@@ -14,12 +14,14 @@ struct aes128_ctx_t {
 };
 
 void aes128_set_key(struct aes128_ctx_t * ctx, uint8_t * key);
-void aes128_ecb_encrypt(struct aes128_ctx_t * ctx, uint8_t * in, uint8_t * out, int blks);
-void aes128_ecb_decrypt(struct aes128_ctx_t * ctx, uint8_t * in, uint8_t * out, int blks);
-void aes128_cbc_encrypt(struct aes128_ctx_t * ctx, uint8_t * iv, uint8_t * in, uint8_t * out, int blks);
-void aes128_cbc_decrypt(struct aes128_ctx_t * ctx, uint8_t * iv, uint8_t * in, uint8_t * out, int blks);
-void aes128_ctr_encrypt(struct aes128_ctx_t * ctx, uint64_t offset, uint8_t * in, uint8_t * out, int bytes);
-void aes128_ctr_decrypt(struct aes128_ctx_t * ctx, uint64_t offset, uint8_t * in, uint8_t * out, int bytes);
+void aes128_encrypt_blocks(struct aes128_ctx_t * ctx, const uint8_t * in, uint8_t * out, size_t blks);
+void aes128_decrypt_blocks(struct aes128_ctx_t * ctx, const uint8_t * in, uint8_t * out, size_t blks);
+void aes128_ecb_encrypt(struct aes128_ctx_t * ctx, uint8_t * in, uint8_t * out, size_t blks);
+void aes128_ecb_decrypt(struct aes128_ctx_t * ctx, uint8_t * in, uint8_t * out, size_t blks);
+void aes128_cbc_encrypt(struct aes128_ctx_t * ctx, uint8_t * iv, uint8_t * in, uint8_t * out, size_t blks);
+void aes128_cbc_decrypt(struct aes128_ctx_t * ctx, uint8_t * iv, uint8_t * in, uint8_t * out, size_t blks);
+void aes128_ctr_encrypt(struct aes128_ctx_t * ctx, uint8_t * iv, uint64_t offset, uint8_t * in, uint8_t * out, size_t bytes);
+void aes128_ctr_decrypt(struct aes128_ctx_t * ctx, uint8_t * iv, uint64_t offset, uint8_t * in, uint8_t * out, size_t bytes);
 
 #ifdef __cplusplus
 }
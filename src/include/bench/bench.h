@@ -0,0 +1,49 @@
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <types.h>
+#include <stdint.h>
+#include <list.h>
+#include <xboot/initcall.h>
+
+struct bench_t
+{
+	struct list_head list;
+	const char * name;
+	const char * desc;
+
+	void * (*init)(struct bench_t * bench);
+	void (*exit)(struct bench_t * bench, void * ctx);
+	uint64_t (*run)(struct bench_t * bench, void * ctx);
+	void * priv;
+};
+
+struct bench_result_t
+{
+	int samples;
+	uint64_t loops;
+	uint64_t bytes;
+	double min;
+	double max;
+	double mean;
+	double median;
+	double p99;
+	double stddev;
+};
+
+extern struct list_head __bench_list;
+
+struct bench_t * search_bench(const char * name);
+bool_t register_bench(struct bench_t * bench);
+bool_t unregister_bench(struct bench_t * bench);
+bool_t bench_run(struct bench_t * bench, int warmup, int repeat, uint64_t mintime, struct bench_result_t * result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BENCH_H__ */
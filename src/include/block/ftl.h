@@ -0,0 +1,40 @@
+#ifndef __FTL_H__
+#define __FTL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <xboot.h>
+#include <block/block.h>
+
+struct ftl_flash_t
+{
+	/* The size of erase block, the smallest erasable unit */
+	u32_t erasesz;
+
+	/* The total size of flash */
+	u64_t capacity;
+
+	/* Read flash, any address and length */
+	bool_t (*read)(struct ftl_flash_t * flash, u64_t addr, u8_t * buf, u32_t count);
+
+	/* Program erased flash without erasing it, bits can only be cleared */
+	bool_t (*program)(struct ftl_flash_t * flash, u64_t addr, u8_t * buf, u32_t count);
+
+	/* Erase the erase block at the address to all ones */
+	bool_t (*erase)(struct ftl_flash_t * flash, u64_t addr);
+
+	/* Private data */
+	void * priv;
+};
+
+struct block_t * ftl_alloc(struct ftl_flash_t * flash);
+void ftl_free(struct block_t * blk);
+struct ftl_flash_t * ftl_flash(struct block_t * blk);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FTL_H__ */
@@ -74,6 +74,12 @@ struct framebuffer_t
 	/* Present a render */
 	void (*present)(struct framebuffer_t * fb, struct render_t * render, struct dirty_rect_t * rect, int nrect);
 
+	/* Scan out a render directly without copy, optional, renders must be created from scan out memory */
+	void (*flip)(struct framebuffer_t * fb, struct render_t * render);
+
+	/* Wait for the next vertical blanking, return the count of vertical blankings so far, optional */
+	u64_t (*vsync)(struct framebuffer_t * fb);
+
 	/* Alone render - create by register */
 	struct render_t * alone;
 
@@ -94,6 +100,9 @@ int framebuffer_get_bpp(struct framebuffer_t * fb);
 struct render_t * framebuffer_create_render(struct framebuffer_t * fb);
 void framebuffer_destroy_render(struct framebuffer_t * fb, struct render_t * render);
 void framebuffer_present_render(struct framebuffer_t * fb, struct render_t * render, struct dirty_rect_t * rect, int nrect);
+bool_t framebuffer_can_flip(struct framebuffer_t * fb);
+void framebuffer_flip_render(struct framebuffer_t * fb, struct render_t * render);
+u64_t framebuffer_wait_vsync(struct framebuffer_t * fb);
 void framebuffer_set_backlight(struct framebuffer_t * fb, int brightness);
 int framebuffer_get_backlight(struct framebuffer_t * fb);
 
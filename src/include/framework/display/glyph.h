@@ -0,0 +1,21 @@
+#ifndef __FRAMEWORK_GLYPH_H__
+#define __FRAMEWORK_GLYPH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <xboot.h>
+#include <cairo.h>
+
+struct glyph_cache_t;
+
+struct glyph_cache_t * glyph_cache_alloc(cairo_font_face_t * face);
+void glyph_cache_free(struct glyph_cache_t * c);
+cairo_surface_t * glyph_cache_lookup(struct glyph_cache_t * c, const char * text, cairo_matrix_t * m, int * x, int * y);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FRAMEWORK_GLYPH_H__ */
@@ -5,6 +5,7 @@
 extern "C" {
 #endif
 
+#include <xboot.h>
 #include <cairo.h>
 #include <framework/luahelper.h>
 
@@ -44,6 +45,22 @@ enum alignment_t {
 	ALIGN_CENTER_FILL			= 22,
 };
 
+enum drawable_t {
+	DRAWABLE_NONE				= 0,
+	DRAWABLE_SHAPE				= 1,
+	DRAWABLE_TEXT				= 2,
+	DRAWABLE_TEXTURE			= 3,
+	DRAWABLE_TEXTURE_MASK		= 4,
+	DRAWABLE_NINEPATCH			= 5,
+};
+
+typedef double (*leasing_func_t)(double t, double b, double c, double d);
+
+struct ltexture_t;
+struct lninepatch_t;
+struct lpattern_t;
+struct glyph_cache_t;
+
 struct lobject_t {
 	double width, height;
 	double x, y;
@@ -55,6 +72,10 @@ struct lobject_t {
 	int visible;
 	int touchable;
 
+	struct lobject_t * parent;
+	struct list_head entry;
+	struct list_head children;
+
 	int __translate;
 	int __rotate;
 	int __scale;
@@ -63,6 +84,36 @@ struct lobject_t {
 	int __obj_matrix_valid;
 	cairo_matrix_t __obj_matrix;
 	cairo_matrix_t __transform_matrix;
+
+	int __extents_valid;
+	int __extents_bounded;
+	double __extents[4];
+	double __box[4];
+
+	int __bounds_valid;
+	cairo_matrix_t __bounds_matrix;
+	cairo_matrix_t __inverse_matrix;
+	int __inverse_valid;
+	double __bounds[4];
+
+	enum drawable_t __drawable;
+	cairo_t ** __shape;
+	struct ltexture_t * __texture;
+	struct lninepatch_t * __ninepatch;
+	struct lpattern_t * __pattern;
+	cairo_scaled_font_t * __sfont;
+	struct glyph_cache_t * __glyph;
+	const char * __text;
+	int __draw_hook;
+	int __enter_frame;
+
+	struct list_head __tween_entry;
+	struct list_head __tweens;
+
+	int __cache_enable;
+	int __cache_dirty;
+	cairo_surface_t * __cache;
+	cairo_matrix_t __cache_matrix;
 };
 
 struct ltexture_t {
@@ -89,6 +140,12 @@ struct lpattern_t {
 	cairo_pattern_t * pattern;
 };
 
+cairo_matrix_t * lobject_get_matrix(struct lobject_t * object);
+int lobject_push_owner(lua_State * L, struct lobject_t * object);
+int lobject_get_extents(struct lobject_t * object, double * x1, double * y1, double * x2, double * y2);
+void lobject_animate(lua_State * L);
+leasing_func_t leasing_find(const char * type);
+
 int luaopen_matrix(lua_State * L);
 int luaopen_easing(lua_State * L);
 int luaopen_object(lua_State * L);
@@ -0,0 +1,26 @@
+#ifndef __FRAMEWORK_TILER_H__
+#define __FRAMEWORK_TILER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <xboot.h>
+#include <cairo.h>
+
+struct tiler_t;
+
+struct tiler_t * tiler_alloc(cairo_surface_t * cs, int size);
+void tiler_free(struct tiler_t * t);
+void tiler_paint(struct tiler_t * t, cairo_matrix_t * m, cairo_surface_t * surface, cairo_filter_t filter, double alpha);
+void tiler_mask(struct tiler_t * t, cairo_matrix_t * m, cairo_surface_t * surface, cairo_pattern_t * pattern);
+void tiler_mask_surface(struct tiler_t * t, cairo_pattern_t * pattern, cairo_surface_t * surface, int x, int y);
+void tiler_fill(struct tiler_t * t, cairo_path_t * path, cairo_pattern_t * pattern, double x1, double y1, double x2, double y2);
+void tiler_opaque(struct tiler_t * t, int opaque);
+void tiler_flush(struct tiler_t * t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FRAMEWORK_TILER_H__ */
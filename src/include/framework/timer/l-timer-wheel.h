@@ -0,0 +1,18 @@
+#ifndef __FRAMEWORK_L_TIMER_WHEEL_H__
+#define __FRAMEWORK_L_TIMER_WHEEL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <framework/luahelper.h>
+
+#define	MT_TIMER_WHEEL	"mt_timer_wheel"
+
+int luaopen_timer_wheel(lua_State * L);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FRAMEWORK_L_TIMER_WHEEL_H__ */
@@ -56,10 +56,28 @@ struct json_value_t {
 struct json_object_entry_t {
 	char * name;
 	unsigned int name_length;
+	unsigned int hash;
 	struct json_value_t * value;
 };
 
+/*
+ * Sax callbacks, return zero to continue or nonzero to abort the parse.
+ * Scalar values are reported through a temporary json value, the string
+ * of a key or value is only valid during the callback.
+ */
+struct json_sax_t {
+	int (*object_begin)(void * data);
+	int (*object_end)(void * data);
+	int (*array_begin)(void * data);
+	int (*array_end)(void * data);
+	int (*key)(void * data, const char * name, unsigned int length);
+	int (*value)(void * data, struct json_value_t * value);
+};
+
 struct json_value_t * json_parse(const char * json, size_t length, char * errbuf);
+struct json_value_t * json_parse_insitu(char * json, size_t length, char * errbuf);
+int json_parse_sax(const char * json, size_t length, struct json_sax_t * sax, void * data, char * errbuf);
+struct json_value_t * json_object_lookup(struct json_value_t * value, const char * name, enum json_type_t type);
 void json_free(struct json_value_t * value);
 
 #ifdef __cplusplus
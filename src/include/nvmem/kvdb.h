@@ -21,9 +21,10 @@ void kvdb_free(struct kvdb_t * db);
 void kvdb_clear(struct kvdb_t * db);
 void kvdb_set(struct kvdb_t * db, const char * key, const char * value);
 char * kvdb_get(struct kvdb_t * db, const char * key, const char * def);
-void kvdb_from_string(struct kvdb_t * db, char * str);
+bool_t kvdb_from_string(struct kvdb_t * db, char * str);
 char * kvdb_to_string(struct kvdb_t * db);
 int kvdb_summary(struct kvdb_t * db, void * buf);
+void kvdb_foreach(struct kvdb_t * db, void (*cb)(const char * key, const char * value, void * data), void * data);
 
 #ifdef __cplusplus
 }
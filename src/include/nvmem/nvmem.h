@@ -12,6 +12,9 @@ struct nvmem_t
 {
 	char * name;
 	struct kvdb_t * db;
+	uint32_t gen;
+	int tail;
+	int dirty;
 	int (*capacity)(struct nvmem_t * m);
 	int (*read)(struct nvmem_t * m, void * buf, int offset, int count);
 	int (*write)(struct nvmem_t * m, void * buf, int offset, int count);
@@ -16,9 +16,10 @@ struct sha1_ctx_t {
 };
 
 void sha1_init(struct sha1_ctx_t * ctx);
-void sha1_update(struct sha1_ctx_t * ctx, const void * data, int len);
+void sha1_blocks(uint32_t * state, const uint8_t * data, size_t blocks);
+void sha1_update(struct sha1_ctx_t * ctx, const void * data, size_t len);
 const uint8_t * sha1_final(struct sha1_ctx_t * ctx);
-const uint8_t * sha1_hash(const void * data, int len, uint8_t * digest);
+const uint8_t * sha1_hash(const void * data, size_t len, uint8_t * digest);
 
 #ifdef __cplusplus
 }
@@ -16,9 +16,10 @@ struct sha256_ctx_t {
 };
 
 void sha256_init(struct sha256_ctx_t * ctx);
-void sha256_update(struct sha256_ctx_t * ctx, const void * data, int len);
+void sha256_blocks(uint32_t * state, const uint8_t * data, size_t blocks);
+void sha256_update(struct sha256_ctx_t * ctx, const void * data, size_t len);
 const uint8_t * sha256_final(struct sha256_ctx_t * ctx);
-const uint8_t * sha256_hash(const void * data, int len, uint8_t * digest);
+const uint8_t * sha256_hash(const void * data, size_t len, uint8_t * digest);
 
 #ifdef __cplusplus
 }
@@ -9,6 +9,18 @@ extern "C" {
 #include <stddef.h>
 #include <list.h>
 
+enum profiler_event_t {
+	PROFILER_EVENT_TIME			= 0,
+	PROFILER_EVENT_CYCLE		= (1 << 0),
+	PROFILER_EVENT_INSTRUCTION	= (1 << 1),
+	PROFILER_EVENT_CACHE_ACCESS	= (1 << 2),
+	PROFILER_EVENT_CACHE_MISS	= (1 << 3),
+	PROFILER_EVENT_BRANCH		= (1 << 4),
+	PROFILER_EVENT_BRANCH_MISS	= (1 << 5),
+	PROFILER_EVENT_ALL			= (0x3f),
+};
+#define PROFILER_EVENT_MAX		(6)
+
 struct profiler_t
 {
 	struct hlist_node node;
@@ -18,6 +30,8 @@ struct profiler_t
 	uint64_t begin;
 	uint64_t end;
 	uint64_t count;
+	uint64_t cbegin[PROFILER_EVENT_MAX];
+	uint64_t cend[PROFILER_EVENT_MAX];
 };
 
 struct profiler_t * profiler_search(const char * name);
@@ -0,0 +1,285 @@
+/*
+ * kernel/bench/bench-crypto.c
+ *
+ * Copyright(c) 2007-2018 Jianjun Jiang <8192542@qq.com>
+ * Official site: http://xboot.org
+ * Mobile phone: +86-18665388956
+ * QQ: 8192542
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <xboot.h>
+#include <crc8.h>
+#include <crc16.h>
+#include <crc32.h>
+#include <sha1.h>
+#include <sha256.h>
+#include <aes128.h>
+#include <bench/bench.h>
+
+struct bench_crypto_t {
+	size_t size;
+	uint8_t * in;
+	uint8_t * out;
+	uint8_t iv[AES128_BLOCK_SIZE];
+	struct aes128_ctx_t aes;
+};
+
+/*
+ * Known answers from fips 180-2, fips 197 and sp 800-38a, checked once
+ * before the first crypto bench, so a broken accelerated path never
+ * reports a speed.
+ */
+static bool_t crypto_check(void)
+{
+	static const uint8_t sha1_abc[20] = {
+		0xa9, 0x99, 0x3e, 0x36, 0x47, 0x06, 0x81, 0x6a, 0xba, 0x3e,
+		0x25, 0x71, 0x78, 0x50, 0xc2, 0x6c, 0x9c, 0xd0, 0xd8, 0x9d,
+	};
+	static const uint8_t sha256_abc[32] = {
+		0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+		0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+	};
+	static const uint8_t aes_key[16] = {
+		0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c,
+	};
+	static const uint8_t aes_iv[16] = {
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+	};
+	static const uint8_t aes_pt[64] = {
+		0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+		0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+		0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+		0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10,
+	};
+	static const uint8_t aes_ecb[64] = {
+		0x3a, 0xd7, 0x7b, 0xb4, 0x0d, 0x7a, 0x36, 0x60, 0xa8, 0x9e, 0xca, 0xf3, 0x24, 0x66, 0xef, 0x97,
+		0xf5, 0xd3, 0xd5, 0x85, 0x03, 0xb9, 0x69, 0x9d, 0xe7, 0x85, 0x89, 0x5a, 0x96, 0xfd, 0xba, 0xaf,
+		0x43, 0xb1, 0xcd, 0x7f, 0x59, 0x8e, 0xce, 0x23, 0x88, 0x1b, 0x00, 0xe3, 0xed, 0x03, 0x06, 0x88,
+		0x7b, 0x0c, 0x78, 0x5e, 0x27, 0xe8, 0xad, 0x3f, 0x82, 0x23, 0x20, 0x71, 0x04, 0x72, 0x5d, 0xd4,
+	};
+	static const uint8_t aes_cbc[64] = {
+		0x76, 0x49, 0xab, 0xac, 0x81, 0x19, 0xb2, 0x46, 0xce, 0xe9, 0x8e, 0x9b, 0x12, 0xe9, 0x19, 0x7d,
+		0x50, 0x86, 0xcb, 0x9b, 0x50, 0x72, 0x19, 0xee, 0x95, 0xdb, 0x11, 0x3a, 0x91, 0x76, 0x78, 0xb2,
+		0x73, 0xbe, 0xd6, 0xb8, 0xe3, 0xc1, 0x74, 0x3b, 0x71, 0x16, 0xe6, 0x9e, 0x22, 0x22, 0x95, 0x16,
+		0x3f, 0xf1, 0xca, 0xa1, 0x68, 0x1f, 0xac, 0x09, 0x12, 0x0e, 0xca, 0x30, 0x75, 0x86, 0xe1, 0xa7,
+	};
+	static const uint8_t aes_ctr_iv[16] = {
+		0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff,
+	};
+	static const uint8_t aes_ctr[64] = {
+		0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26, 0x1b, 0xef, 0x68, 0x64, 0x99, 0x0d, 0xb6, 0xce,
+		0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff, 0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff,
+		0x5a, 0xe4, 0xdf, 0x3e, 0xdb, 0xd5, 0xd3, 0x5e, 0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab,
+		0x1e, 0x03, 0x1d, 0xda, 0x2f, 0xbe, 0x03, 0xd1, 0x79, 0x21, 0x70, 0xa0, 0xf3, 0x00, 0x9c, 0xee,
+	};
+	static int result = 0;
+	struct aes128_ctx_t aes;
+	const char * fail = NULL;
+	uint8_t key[16], iv[16];
+	uint8_t in[64], out[64];
+	uint8_t digest[32];
+
+	if(result != 0)
+		return (result > 0) ? TRUE : FALSE;
+
+	memcpy(key, aes_key, 16);
+	memcpy(iv, aes_iv, 16);
+	memcpy(in, aes_pt, 64);
+	aes128_set_key(&aes, key);
+	if(memcmp(sha1_hash("abc", 3, digest), sha1_abc, 20) != 0)
+		fail = "sha1";
+	if(memcmp(sha256_hash("abc", 3, digest), sha256_abc, 32) != 0)
+		fail = "sha256";
+	aes128_ecb_encrypt(&aes, in, out, 4);
+	if(memcmp(out, aes_ecb, 64) != 0)
+		fail = "aes128 ecb encrypt";
+	aes128_ecb_decrypt(&aes, out, out, 4);
+	if(memcmp(out, aes_pt, 64) != 0)
+		fail = "aes128 ecb decrypt";
+	aes128_cbc_encrypt(&aes, iv, in, out, 4);
+	if(memcmp(out, aes_cbc, 64) != 0)
+		fail = "aes128 cbc encrypt";
+	aes128_cbc_decrypt(&aes, iv, out, out, 4);
+	if(memcmp(out, aes_pt, 64) != 0)
+		fail = "aes128 cbc decrypt";
+	memcpy(iv, aes_ctr_iv, 16);
+	aes128_ctr_encrypt(&aes, iv, 0, in, out, 64);
+	if(memcmp(out, aes_ctr, 64) != 0)
+		fail = "aes128 ctr encrypt";
+	aes128_ctr_decrypt(&aes, iv, 21, &out[21], &out[21], 43);
+	if(memcmp(&out[21], &aes_pt[21], 43) != 0)
+		fail = "aes128 ctr decrypt";
+	if(fail)
+		printf("%s known answer test failed\r\n", fail);
+	result = fail ? -1 : 1;
+	return fail ? FALSE : TRUE;
+}
+
+static void * crypto_init(struct bench_t * bench)
+{
+	struct bench_crypto_t * ctx;
+	uint8_t key[16];
+	int i;
+
+	if(!crypto_check())
+		return NULL;
+	ctx = malloc(sizeof(struct bench_crypto_t));
+	if(!ctx)
+		return NULL;
+	ctx->size = (size_t)bench->priv;
+	ctx->in = malloc(ctx->size);
+	ctx->out = malloc(ctx->size);
+	if(!ctx->in || !ctx->out)
+	{
+		if(ctx->in)
+			free(ctx->in);
+		if(ctx->out)
+			free(ctx->out);
+		free(ctx);
+		return NULL;
+	}
+	for(i = 0; i < ctx->size; i++)
+		ctx->in[i] = i * 7 + 3;
+	for(i = 0; i < 16; i++)
+	{
+		key[i] = i;
+		ctx->iv[i] = 0xf0 | i;
+	}
+	aes128_set_key(&ctx->aes, key);
+	return ctx;
+}
+
+static void crypto_exit(struct bench_t * bench, void * ctx)
+{
+	struct bench_crypto_t * c = (struct bench_crypto_t *)ctx;
+
+	free(c->in);
+	free(c->out);
+	free(c);
+}
+
+static uint64_t crc8_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_crypto_t * c = (struct bench_crypto_t *)ctx;
+
+	c->out[0] = crc8_sum(0, c->in, c->size);
+	return c->size;
+}
+
+static uint64_t crc16_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_crypto_t * c = (struct bench_crypto_t *)ctx;
+
+	c->out[0] = crc16_sum(0, c->in, c->size);
+	return c->size;
+}
+
+static uint64_t crc32_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_crypto_t * c = (struct bench_crypto_t *)ctx;
+
+	c->out[0] = crc32_sum(0, c->in, c->size);
+	return c->size;
+}
+
+static uint64_t sha1_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_crypto_t * c = (struct bench_crypto_t *)ctx;
+
+	sha1_hash(c->in, c->size, c->out);
+	return c->size;
+}
+
+static uint64_t sha256_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_crypto_t * c = (struct bench_crypto_t *)ctx;
+
+	sha256_hash(c->in, c->size, c->out);
+	return c->size;
+}
+
+static uint64_t aes128_ecb_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_crypto_t * c = (struct bench_crypto_t *)ctx;
+
+	aes128_ecb_encrypt(&c->aes, c->in, c->out, c->size / AES128_BLOCK_SIZE);
+	return c->size;
+}
+
+static uint64_t aes128_cbc_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_crypto_t * c = (struct bench_crypto_t *)ctx;
+
+	aes128_cbc_encrypt(&c->aes, c->iv, c->in, c->out, c->size / AES128_BLOCK_SIZE);
+	return c->size;
+}
+
+static uint64_t aes128_cbc_decrypt_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_crypto_t * c = (struct bench_crypto_t *)ctx;
+
+	aes128_cbc_decrypt(&c->aes, c->iv, c->in, c->out, c->size / AES128_BLOCK_SIZE);
+	return c->size;
+}
+
+static uint64_t aes128_ctr_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_crypto_t * c = (struct bench_crypto_t *)ctx;
+
+	aes128_ctr_encrypt(&c->aes, c->iv, 0, c->in, c->out, c->size);
+	return c->size;
+}
+
+static struct bench_t bench_crypto[] = {
+	{ .name = "crc8-4k",		.desc = "crc8 checksum 4K bytes",		.init = crypto_init, .exit = crypto_exit, .run = crc8_run,			.priv = (void *)SZ_4K },
+	{ .name = "crc16-4k",		.desc = "crc16 checksum 4K bytes",		.init = crypto_init, .exit = crypto_exit, .run = crc16_run,			.priv = (void *)SZ_4K },
+	{ .name = "crc32-4k",		.desc = "crc32 checksum 4K bytes",		.init = crypto_init, .exit = crypto_exit, .run = crc32_run,			.priv = (void *)SZ_4K },
+	{ .name = "crc32-1m",		.desc = "crc32 checksum 1M bytes",		.init = crypto_init, .exit = crypto_exit, .run = crc32_run,			.priv = (void *)SZ_1M },
+	{ .name = "sha1-4k",		.desc = "sha1 digest 4K bytes",			.init = crypto_init, .exit = crypto_exit, .run = sha1_run,			.priv = (void *)SZ_4K },
+	{ .name = "sha1-1m",		.desc = "sha1 digest 1M bytes",			.init = crypto_init, .exit = crypto_exit, .run = sha1_run,			.priv = (void *)SZ_1M },
+	{ .name = "sha256-4k",		.desc = "sha256 digest 4K bytes",		.init = crypto_init, .exit = crypto_exit, .run = sha256_run,		.priv = (void *)SZ_4K },
+	{ .name = "sha256-1m",		.desc = "sha256 digest 1M bytes",		.init = crypto_init, .exit = crypto_exit, .run = sha256_run,		.priv = (void *)SZ_1M },
+	{ .name = "aes128-ecb-4k",	.desc = "aes128 ecb encrypt 4K bytes",	.init = crypto_init, .exit = crypto_exit, .run = aes128_ecb_run,	.priv = (void *)SZ_4K },
+	{ .name = "aes128-cbc-4k",	.desc = "aes128 cbc encrypt 4K bytes",	.init = crypto_init, .exit = crypto_exit, .run = aes128_cbc_run,	.priv = (void *)SZ_4K },
+	{ .name = "aes128-cbcd-4k",	.desc = "aes128 cbc decrypt 4K bytes",	.init = crypto_init, .exit = crypto_exit, .run = aes128_cbc_decrypt_run,	.priv = (void *)SZ_4K },
+	{ .name = "aes128-ctr-4k",	.desc = "aes128 ctr encrypt 4K bytes",	.init = crypto_init, .exit = crypto_exit, .run = aes128_ctr_run,	.priv = (void *)SZ_4K },
+	{ .name = "aes128-ctr-1m",	.desc = "aes128 ctr encrypt 1M bytes",	.init = crypto_init, .exit = crypto_exit, .run = aes128_ctr_run,	.priv = (void *)SZ_1M },
+};
+
+static __init void bench_crypto_init(void)
+{
+	int i;
+
+	for(i = 0; i < ARRAY_SIZE(bench_crypto); i++)
+		register_bench(&bench_crypto[i]);
+}
+
+static __exit void bench_crypto_exit(void)
+{
+	int i;
+
+	for(i = 0; i < ARRAY_SIZE(bench_crypto); i++)
+		unregister_bench(&bench_crypto[i]);
+}
+
+command_initcall(bench_crypto_init);
+command_exitcall(bench_crypto_exit);
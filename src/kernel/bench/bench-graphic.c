@@ -0,0 +1,245 @@
+/*
+ * kernel/bench/bench-graphic.c
+ *
+ * Copyright(c) 2007-2018 Jianjun Jiang <8192542@qq.com>
+ * Official site: http://xboot.org
+ * Mobile phone: +86-18665388956
+ * QQ: 8192542
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <xboot.h>
+#include <cairo.h>
+#include <cairo-ft.h>
+#include <pixman.h>
+#include <bench/bench.h>
+
+#define GRAPHIC_WIDTH		(800)
+#define GRAPHIC_HEIGHT		(480)
+#define GRAPHIC_FONT		"/framework/assets/fonts/Roboto-Regular.ttf"
+
+struct bench_graphic_t {
+	cairo_surface_t * dst;
+	cairo_surface_t * src;
+	cairo_t * cr;
+	pixman_image_t * pdst;
+	pixman_image_t * psrc;
+	pixman_image_t * pmask;
+	pixman_image_t * psolid;
+	FT_Library library;
+	FT_Face fface;
+	cairo_font_face_t * face;
+	void * font;
+};
+
+static void * graphic_load_font(const char * path, size_t * len)
+{
+	struct vfs_stat_t st;
+	void * buf;
+	int fd;
+
+	if(vfs_stat(path, &st) < 0 || !S_ISREG(st.st_mode) || st.st_size <= 0)
+		return NULL;
+	fd = vfs_open(path, O_RDONLY, 0);
+	if(fd < 0)
+		return NULL;
+	buf = malloc(st.st_size);
+	if(buf && (vfs_read(fd, buf, st.st_size) != st.st_size))
+	{
+		free(buf);
+		buf = NULL;
+	}
+	vfs_close(fd);
+	*len = st.st_size;
+	return buf;
+}
+
+static void graphic_exit(struct bench_t * bench, void * ctx)
+{
+	struct bench_graphic_t * g = (struct bench_graphic_t *)ctx;
+
+	if(g->cr)
+		cairo_destroy(g->cr);
+	if(g->dst)
+		cairo_surface_destroy(g->dst);
+	if(g->src)
+		cairo_surface_destroy(g->src);
+	if(g->pdst)
+		pixman_image_unref(g->pdst);
+	if(g->psrc)
+		pixman_image_unref(g->psrc);
+	if(g->pmask)
+		pixman_image_unref(g->pmask);
+	if(g->psolid)
+		pixman_image_unref(g->psolid);
+	if(g->face)
+		cairo_font_face_destroy(g->face);
+	if(g->fface)
+		FT_Done_Face(g->fface);
+	if(g->library)
+		FT_Done_FreeType(g->library);
+	if(g->font)
+		free(g->font);
+	free(g);
+}
+
+static void * graphic_init(struct bench_t * bench)
+{
+	struct bench_graphic_t * ctx;
+	pixman_color_t color = { 0x8000, 0x4000, 0x2000, 0x8000 };
+	size_t len = 0;
+
+	ctx = malloc(sizeof(struct bench_graphic_t));
+	if(!ctx)
+		return NULL;
+	memset(ctx, 0, sizeof(struct bench_graphic_t));
+
+	ctx->dst = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, GRAPHIC_WIDTH, GRAPHIC_HEIGHT);
+	ctx->src = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, GRAPHIC_WIDTH, GRAPHIC_HEIGHT);
+	ctx->cr = cairo_create(ctx->dst);
+	if(cairo_status(ctx->cr) != CAIRO_STATUS_SUCCESS)
+	{
+		graphic_exit(bench, ctx);
+		return NULL;
+	}
+	cairo_t * cr = cairo_create(ctx->src);
+	cairo_set_source_rgba(cr, 0.2, 0.4, 0.6, 0.5);
+	cairo_paint(cr);
+	cairo_destroy(cr);
+	cairo_surface_flush(ctx->src);
+
+	ctx->pdst = pixman_image_create_bits(PIXMAN_a8r8g8b8, GRAPHIC_WIDTH, GRAPHIC_HEIGHT, (uint32_t *)cairo_image_surface_get_data(ctx->dst), cairo_image_surface_get_stride(ctx->dst));
+	ctx->psrc = pixman_image_create_bits(PIXMAN_a8r8g8b8, GRAPHIC_WIDTH, GRAPHIC_HEIGHT, (uint32_t *)cairo_image_surface_get_data(ctx->src), cairo_image_surface_get_stride(ctx->src));
+	ctx->pmask = pixman_image_create_bits(PIXMAN_a8, GRAPHIC_WIDTH, GRAPHIC_HEIGHT, NULL, 0);
+	ctx->psolid = pixman_image_create_solid_fill(&color);
+	if(!ctx->pdst || !ctx->psrc || !ctx->pmask || !ctx->psolid)
+	{
+		graphic_exit(bench, ctx);
+		return NULL;
+	}
+	memset(pixman_image_get_data(ctx->pmask), 0x80, pixman_image_get_stride(ctx->pmask) * GRAPHIC_HEIGHT);
+
+	if(bench->priv)
+	{
+		ctx->font = graphic_load_font(GRAPHIC_FONT, &len);
+		if(!ctx->font || FT_Init_FreeType(&ctx->library) || FT_New_Memory_Face(ctx->library, ctx->font, len, 0, &ctx->fface))
+		{
+			graphic_exit(bench, ctx);
+			return NULL;
+		}
+		ctx->face = cairo_ft_font_face_create_for_ft_face(ctx->fface, 0);
+		cairo_set_font_face(ctx->cr, ctx->face);
+		cairo_set_font_size(ctx->cr, 24);
+		cairo_set_source_rgb(ctx->cr, 0, 0, 0);
+	}
+	return ctx;
+}
+
+static uint64_t cairo_fill_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_graphic_t * g = (struct bench_graphic_t *)ctx;
+
+	cairo_set_source_rgba(g->cr, 0.8, 0.2, 0.1, 0.6);
+	cairo_rectangle(g->cr, 0, 0, GRAPHIC_WIDTH, GRAPHIC_HEIGHT);
+	cairo_fill(g->cr);
+	return GRAPHIC_WIDTH * GRAPHIC_HEIGHT * 4;
+}
+
+static uint64_t cairo_blit_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_graphic_t * g = (struct bench_graphic_t *)ctx;
+
+	cairo_set_source_surface(g->cr, g->src, 0, 0);
+	cairo_paint(g->cr);
+	return GRAPHIC_WIDTH * GRAPHIC_HEIGHT * 4;
+}
+
+static uint64_t cairo_text_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_graphic_t * g = (struct bench_graphic_t *)ctx;
+
+	cairo_move_to(g->cr, 16, 64);
+	cairo_show_text(g->cr, "The quick brown fox jumps over the lazy dog");
+	return 0;
+}
+
+static uint64_t cairo_text_path_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_graphic_t * g = (struct bench_graphic_t *)ctx;
+
+	cairo_move_to(g->cr, 16, 64);
+	cairo_text_path(g->cr, "The quick brown fox jumps over the lazy dog");
+	cairo_fill(g->cr);
+	return 0;
+}
+
+static uint64_t pixman_over_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_graphic_t * g = (struct bench_graphic_t *)ctx;
+
+	pixman_image_composite32(PIXMAN_OP_OVER, g->psrc, NULL, g->pdst, 0, 0, 0, 0, 0, 0, GRAPHIC_WIDTH, GRAPHIC_HEIGHT);
+	return GRAPHIC_WIDTH * GRAPHIC_HEIGHT * 4;
+}
+
+static uint64_t pixman_src_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_graphic_t * g = (struct bench_graphic_t *)ctx;
+
+	pixman_image_composite32(PIXMAN_OP_SRC, g->psrc, NULL, g->pdst, 0, 0, 0, 0, 0, 0, GRAPHIC_WIDTH, GRAPHIC_HEIGHT);
+	return GRAPHIC_WIDTH * GRAPHIC_HEIGHT * 4;
+}
+
+static uint64_t pixman_mask_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_graphic_t * g = (struct bench_graphic_t *)ctx;
+
+	pixman_image_composite32(PIXMAN_OP_OVER, g->psolid, g->pmask, g->pdst, 0, 0, 0, 0, 0, 0, GRAPHIC_WIDTH, GRAPHIC_HEIGHT);
+	return GRAPHIC_WIDTH * GRAPHIC_HEIGHT * 4;
+}
+
+static struct bench_t bench_graphic[] = {
+	{ .name = "cairo-fill",			.desc = "cairo fill 800x480 translucent rectangle",	.init = graphic_init, .exit = graphic_exit, .run = cairo_fill_run },
+	{ .name = "cairo-blit",			.desc = "cairo paint 800x480 argb surface",			.init = graphic_init, .exit = graphic_exit, .run = cairo_blit_run },
+	{ .name = "cairo-text",			.desc = "cairo show_text 43 glyphs",				.init = graphic_init, .exit = graphic_exit, .run = cairo_text_run,		.priv = (void *)1 },
+	{ .name = "cairo-text-path",	.desc = "cairo text_path and fill 43 glyphs",		.init = graphic_init, .exit = graphic_exit, .run = cairo_text_path_run,	.priv = (void *)1 },
+	{ .name = "pixman-over",		.desc = "pixman argb over argb 800x480",			.init = graphic_init, .exit = graphic_exit, .run = pixman_over_run },
+	{ .name = "pixman-src",			.desc = "pixman argb src argb 800x480",				.init = graphic_init, .exit = graphic_exit, .run = pixman_src_run },
+	{ .name = "pixman-mask",		.desc = "pixman solid in a8 over argb 800x480",		.init = graphic_init, .exit = graphic_exit, .run = pixman_mask_run },
+};
+
+static __init void bench_graphic_init(void)
+{
+	int i;
+
+	for(i = 0; i < ARRAY_SIZE(bench_graphic); i++)
+		register_bench(&bench_graphic[i]);
+}
+
+static __exit void bench_graphic_exit(void)
+{
+	int i;
+
+	for(i = 0; i < ARRAY_SIZE(bench_graphic); i++)
+		unregister_bench(&bench_graphic[i]);
+}
+
+command_initcall(bench_graphic_init);
+command_exitcall(bench_graphic_exit);
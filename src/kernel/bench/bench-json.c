@@ -0,0 +1,164 @@
+/*
+ * kernel/bench/bench-json.c
+ *
+ * Copyright(c) 2007-2018 Jianjun Jiang <8192542@qq.com>
+ * Official site: http://xboot.org
+ * Mobile phone: +86-18665388956
+ * QQ: 8192542
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <xboot.h>
+#include <json.h>
+#include <bench/bench.h>
+
+struct bench_json_t {
+	char * buf;
+	char * tmp;
+	size_t len;
+};
+
+static void * json_init(struct bench_t * bench)
+{
+	struct bench_json_t * ctx;
+	int count = (int)(unsigned long)bench->priv;
+	size_t size = count * 160 + 64;
+	int i;
+
+	ctx = malloc(sizeof(struct bench_json_t));
+	if(!ctx)
+		return NULL;
+	ctx->buf = malloc(size);
+	ctx->tmp = malloc(size);
+	if(!ctx->buf || !ctx->tmp)
+	{
+		free(ctx->buf);
+		free(ctx->tmp);
+		free(ctx);
+		return NULL;
+	}
+	ctx->len = snprintf(ctx->buf, size, "{\"items\":[");
+	for(i = 0; i < count; i++)
+	{
+		ctx->len += snprintf(ctx->buf + ctx->len, size - ctx->len,
+			"%s{\"name\":\"device-%d\",\"id\":%d,\"value\":%d.%03d,\"enabled\":%s,\"tags\":[\"gpio\",\"irq\"],\"parent\":null}",
+			(i > 0) ? "," : "", i, i, i, (i * 37) % 1000, (i & 0x1) ? "true" : "false");
+	}
+	ctx->len += snprintf(ctx->buf + ctx->len, size - ctx->len, "]}");
+	return ctx;
+}
+
+static void json_exit(struct bench_t * bench, void * ctx)
+{
+	struct bench_json_t * j = (struct bench_json_t *)ctx;
+
+	free(j->buf);
+	free(j->tmp);
+	free(j);
+}
+
+static uint64_t json_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_json_t * j = (struct bench_json_t *)ctx;
+	struct json_value_t * v;
+
+	v = json_parse(j->buf, j->len, NULL);
+	if(!v)
+		return 0;
+	json_free(v);
+	return j->len;
+}
+
+static uint64_t json_run_insitu(struct bench_t * bench, void * ctx)
+{
+	struct bench_json_t * j = (struct bench_json_t *)ctx;
+	struct json_value_t * v;
+
+	memcpy(j->tmp, j->buf, j->len);
+	v = json_parse_insitu(j->tmp, j->len, NULL);
+	if(!v)
+		return 0;
+	json_free(v);
+	return j->len;
+}
+
+static int json_sax_count(void * data)
+{
+	(*(int *)data)++;
+	return 0;
+}
+
+static int json_sax_key(void * data, const char * name, unsigned int length)
+{
+	(*(int *)data)++;
+	return 0;
+}
+
+static int json_sax_value(void * data, struct json_value_t * value)
+{
+	(*(int *)data)++;
+	return 0;
+}
+
+static struct json_sax_t json_sax = {
+	.object_begin	= json_sax_count,
+	.object_end		= json_sax_count,
+	.array_begin	= json_sax_count,
+	.array_end		= json_sax_count,
+	.key			= json_sax_key,
+	.value			= json_sax_value,
+};
+
+static uint64_t json_run_sax(struct bench_t * bench, void * ctx)
+{
+	struct bench_json_t * j = (struct bench_json_t *)ctx;
+	int count = 0;
+
+	if(json_parse_sax(j->buf, j->len, &json_sax, &count, NULL) != 0)
+		return 0;
+	return j->len;
+}
+
+static struct bench_t bench_json[] = {
+	{ .name = "json-parse-small",	.desc = "json_parse 8 objects document",	.init = json_init, .exit = json_exit, .run = json_run, .priv = (void *)8 },
+	{ .name = "json-parse-large",	.desc = "json_parse 512 objects document",	.init = json_init, .exit = json_exit, .run = json_run, .priv = (void *)512 },
+	{ .name = "json-parse-insitu",	.desc = "json_parse_insitu 512 objects document",	.init = json_init, .exit = json_exit, .run = json_run_insitu, .priv = (void *)512 },
+	{ .name = "json-parse-sax",		.desc = "json_parse_sax 512 objects document",	.init = json_init, .exit = json_exit, .run = json_run_sax, .priv = (void *)512 },
+};
+
+static __init void bench_json_init(void)
+{
+	int i;
+
+	for(i = 0; i < ARRAY_SIZE(bench_json); i++)
+		register_bench(&bench_json[i]);
+}
+
+static __exit void bench_json_exit(void)
+{
+	int i;
+
+	for(i = 0; i < ARRAY_SIZE(bench_json); i++)
+		unregister_bench(&bench_json[i]);
+}
+
+command_initcall(bench_json_init);
+command_exitcall(bench_json_exit);
@@ -0,0 +1,140 @@
+/*
+ * kernel/bench/bench-lua.c
+ *
+ * Copyright(c) 2007-2018 Jianjun Jiang <8192542@qq.com>
+ * Official site: http://xboot.org
+ * Mobile phone: +86-18665388956
+ * QQ: 8192542
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <xboot.h>
+#include <lua.h>
+#include <lualib.h>
+#include <lauxlib.h>
+#include <bench/bench.h>
+
+static const char bench_lua_chunk[] =
+	"function f(a) return a end\n"
+	"function g(n) local s = 0 for i = 1, n do s = s + f(i) end return s end\n";
+
+struct bench_lua_t {
+	lua_State * L;
+	int f;
+	int g;
+};
+
+static void * lua_init(struct bench_t * bench)
+{
+	struct bench_lua_t * ctx;
+
+	ctx = malloc(sizeof(struct bench_lua_t));
+	if(!ctx)
+		return NULL;
+	ctx->L = luaL_newstate();
+	if(!ctx->L)
+	{
+		free(ctx);
+		return NULL;
+	}
+	luaL_requiref(ctx->L, "_G", luaopen_base, 1);
+	lua_pop(ctx->L, 1);
+	if(luaL_dostring(ctx->L, bench_lua_chunk) != LUA_OK)
+	{
+		lua_close(ctx->L);
+		free(ctx);
+		return NULL;
+	}
+	lua_getglobal(ctx->L, "f");
+	ctx->f = luaL_ref(ctx->L, LUA_REGISTRYINDEX);
+	lua_getglobal(ctx->L, "g");
+	ctx->g = luaL_ref(ctx->L, LUA_REGISTRYINDEX);
+	return ctx;
+}
+
+static void lua_exit(struct bench_t * bench, void * ctx)
+{
+	struct bench_lua_t * l = (struct bench_lua_t *)ctx;
+
+	lua_close(l->L);
+	free(l);
+}
+
+static uint64_t lua_c2lua_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_lua_t * l = (struct bench_lua_t *)ctx;
+
+	lua_rawgeti(l->L, LUA_REGISTRYINDEX, l->f);
+	lua_pushinteger(l->L, 1);
+	lua_call(l->L, 1, 1);
+	lua_pop(l->L, 1);
+	return 0;
+}
+
+static uint64_t lua_lua2lua_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_lua_t * l = (struct bench_lua_t *)ctx;
+
+	lua_rawgeti(l->L, LUA_REGISTRYINDEX, l->g);
+	lua_pushinteger(l->L, 100);
+	lua_call(l->L, 1, 1);
+	lua_pop(l->L, 1);
+	return 0;
+}
+
+static uint64_t lua_gc_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_lua_t * l = (struct bench_lua_t *)ctx;
+	int i;
+
+	for(i = 0; i < 100; i++)
+	{
+		lua_createtable(l->L, 0, 4);
+		lua_pop(l->L, 1);
+	}
+	lua_gc(l->L, LUA_GCSTEP, 0);
+	return 0;
+}
+
+static struct bench_t bench_lua[] = {
+	{ .name = "lua-call-c2lua",		.desc = "lua_call of an empty lua function",			.init = lua_init, .exit = lua_exit, .run = lua_c2lua_run },
+	{ .name = "lua-call-lua2lua",	.desc = "100 lua to lua calls in a loop",				.init = lua_init, .exit = lua_exit, .run = lua_lua2lua_run },
+	{ .name = "lua-table-gc",		.desc = "100 table allocations and one gc step",		.init = lua_init, .exit = lua_exit, .run = lua_gc_run },
+};
+
+static __init void bench_lua_init(void)
+{
+	int i;
+
+	for(i = 0; i < ARRAY_SIZE(bench_lua); i++)
+		register_bench(&bench_lua[i]);
+}
+
+static __exit void bench_lua_exit(void)
+{
+	int i;
+
+	for(i = 0; i < ARRAY_SIZE(bench_lua); i++)
+		unregister_bench(&bench_lua[i]);
+}
+
+command_initcall(bench_lua_init);
+command_exitcall(bench_lua_exit);
@@ -0,0 +1,144 @@
+/*
+ * kernel/bench/bench-malloc.c
+ *
+ * Copyright(c) 2007-2018 Jianjun Jiang <8192542@qq.com>
+ * Official site: http://xboot.org
+ * Mobile phone: +86-18665388956
+ * QQ: 8192542
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <xboot.h>
+#include <bench/bench.h>
+
+#define MALLOC_SLOTS	(256)
+
+struct bench_malloc_t {
+	void * slot[MALLOC_SLOTS];
+	size_t size[MALLOC_SLOTS];
+	int order[MALLOC_SLOTS];
+};
+
+static void * malloc_init(struct bench_t * bench)
+{
+	struct bench_malloc_t * ctx;
+	uint32_t seed = 0x12345678;
+	int i, j, t;
+
+	ctx = malloc(sizeof(struct bench_malloc_t));
+	if(!ctx)
+		return NULL;
+
+	/*
+	 * Deterministic pseudo random sizes and free order, so that results are
+	 * reproducible between runs and boards.
+	 */
+	for(i = 0; i < MALLOC_SLOTS; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		ctx->slot[i] = NULL;
+		ctx->size[i] = 16 + ((seed >> 16) % 2048);
+		ctx->order[i] = i;
+	}
+	for(i = MALLOC_SLOTS - 1; i > 0; i--)
+	{
+		seed = seed * 1103515245 + 12345;
+		j = (seed >> 16) % (i + 1);
+		t = ctx->order[i];
+		ctx->order[i] = ctx->order[j];
+		ctx->order[j] = t;
+	}
+	return ctx;
+}
+
+static void malloc_exit(struct bench_t * bench, void * ctx)
+{
+	free(ctx);
+}
+
+static uint64_t malloc_fixed_run(struct bench_t * bench, void * ctx)
+{
+	size_t size = (size_t)bench->priv;
+	void * p;
+
+	p = malloc(size);
+	if(p)
+		free(p);
+	return 0;
+}
+
+static uint64_t malloc_random_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_malloc_t * m = (struct bench_malloc_t *)ctx;
+	int i;
+
+	for(i = 0; i < MALLOC_SLOTS; i++)
+		m->slot[i] = malloc(m->size[i]);
+	for(i = 0; i < MALLOC_SLOTS; i++)
+	{
+		if(m->slot[m->order[i]])
+			free(m->slot[m->order[i]]);
+	}
+	return 0;
+}
+
+static uint64_t malloc_realloc_run(struct bench_t * bench, void * ctx)
+{
+	void * p = NULL, * q;
+	size_t size;
+
+	for(size = 16; size <= SZ_64K; size <<= 1)
+	{
+		q = realloc(p, size);
+		if(!q)
+			break;
+		p = q;
+	}
+	if(p)
+		free(p);
+	return 0;
+}
+
+static struct bench_t bench_malloc[] = {
+	{ .name = "malloc-32",		.desc = "malloc and free 32 bytes",				.run = malloc_fixed_run,	.priv = (void *)32 },
+	{ .name = "malloc-4k",		.desc = "malloc and free 4K bytes",				.run = malloc_fixed_run,	.priv = (void *)SZ_4K },
+	{ .name = "malloc-random",	.desc = "malloc 256 random blocks, free shuffled",	.init = malloc_init, .exit = malloc_exit, .run = malloc_random_run },
+	{ .name = "malloc-realloc",	.desc = "realloc growth from 16 bytes to 64K",	.run = malloc_realloc_run },
+};
+
+static __init void bench_malloc_init(void)
+{
+	int i;
+
+	for(i = 0; i < ARRAY_SIZE(bench_malloc); i++)
+		register_bench(&bench_malloc[i]);
+}
+
+static __exit void bench_malloc_exit(void)
+{
+	int i;
+
+	for(i = 0; i < ARRAY_SIZE(bench_malloc); i++)
+		unregister_bench(&bench_malloc[i]);
+}
+
+command_initcall(bench_malloc_init);
+command_exitcall(bench_malloc_exit);
@@ -0,0 +1,149 @@
+/*
+ * kernel/bench/bench-string.c
+ *
+ * Copyright(c) 2007-2018 Jianjun Jiang <8192542@qq.com>
+ * Official site: http://xboot.org
+ * Mobile phone: +86-18665388956
+ * QQ: 8192542
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <xboot.h>
+#include <bench/bench.h>
+
+struct bench_string_t {
+	size_t size;
+	void * src;
+	void * dst;
+};
+
+static void * string_init(struct bench_t * bench)
+{
+	struct bench_string_t * ctx;
+
+	ctx = malloc(sizeof(struct bench_string_t));
+	if(!ctx)
+		return NULL;
+	ctx->size = (size_t)bench->priv;
+	ctx->src = memalign(64, ctx->size + 64);
+	ctx->dst = memalign(64, ctx->size + 64);
+	if(!ctx->src || !ctx->dst)
+	{
+		if(ctx->src)
+			free(ctx->src);
+		if(ctx->dst)
+			free(ctx->dst);
+		free(ctx);
+		return NULL;
+	}
+	memset(ctx->src, 0x5a, ctx->size + 64);
+	memset(ctx->dst, 0x5a, ctx->size + 64);
+	return ctx;
+}
+
+static void string_exit(struct bench_t * bench, void * ctx)
+{
+	struct bench_string_t * s = (struct bench_string_t *)ctx;
+
+	free(s->src);
+	free(s->dst);
+	free(s);
+}
+
+static uint64_t memcpy_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_string_t * s = (struct bench_string_t *)ctx;
+
+	memcpy(s->dst, s->src, s->size);
+	return s->size;
+}
+
+static uint64_t memcpy_unaligned_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_string_t * s = (struct bench_string_t *)ctx;
+
+	memcpy(s->dst + 3, s->src + 1, s->size);
+	return s->size;
+}
+
+static uint64_t memset_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_string_t * s = (struct bench_string_t *)ctx;
+
+	memset(s->dst, 0xa5, s->size);
+	return s->size;
+}
+
+static uint64_t memmove_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_string_t * s = (struct bench_string_t *)ctx;
+
+	memmove(s->dst + 8, s->dst, s->size);
+	return s->size;
+}
+
+static uint64_t memcmp_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_string_t * s = (struct bench_string_t *)ctx;
+
+	return (memcmp(s->dst, s->src, s->size) == 0) ? s->size : 0;
+}
+
+static uint64_t strlen_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_string_t * s = (struct bench_string_t *)ctx;
+
+	((char *)s->src)[s->size] = '\0';
+	return strlen(s->src);
+}
+
+static struct bench_t bench_string[] = {
+	{ .name = "memcpy-64",		.desc = "memcpy 64 bytes",				.init = string_init, .exit = string_exit, .run = memcpy_run,			.priv = (void *)64 },
+	{ .name = "memcpy-4k",		.desc = "memcpy 4K bytes",				.init = string_init, .exit = string_exit, .run = memcpy_run,			.priv = (void *)SZ_4K },
+	{ .name = "memcpy-1m",		.desc = "memcpy 1M bytes",				.init = string_init, .exit = string_exit, .run = memcpy_run,			.priv = (void *)SZ_1M },
+	{ .name = "memcpy-ua-4k",	.desc = "memcpy 4K bytes unaligned",	.init = string_init, .exit = string_exit, .run = memcpy_unaligned_run,	.priv = (void *)SZ_4K },
+	{ .name = "memset-64",		.desc = "memset 64 bytes",				.init = string_init, .exit = string_exit, .run = memset_run,			.priv = (void *)64 },
+	{ .name = "memset-4k",		.desc = "memset 4K bytes",				.init = string_init, .exit = string_exit, .run = memset_run,			.priv = (void *)SZ_4K },
+	{ .name = "memset-1m",		.desc = "memset 1M bytes",				.init = string_init, .exit = string_exit, .run = memset_run,			.priv = (void *)SZ_1M },
+	{ .name = "memmove-4k",		.desc = "memmove 4K bytes overlapped",	.init = string_init, .exit = string_exit, .run = memmove_run,			.priv = (void *)SZ_4K },
+	{ .name = "memmove-1m",		.desc = "memmove 1M bytes overlapped",	.init = string_init, .exit = string_exit, .run = memmove_run,			.priv = (void *)SZ_1M },
+	{ .name = "memcmp-4k",		.desc = "memcmp 4K bytes equal",		.init = string_init, .exit = string_exit, .run = memcmp_run,			.priv = (void *)SZ_4K },
+	{ .name = "strlen-4k",		.desc = "strlen 4K bytes string",		.init = string_init, .exit = string_exit, .run = strlen_run,			.priv = (void *)SZ_4K },
+};
+
+static __init void bench_string_init(void)
+{
+	int i;
+
+	for(i = 0; i < ARRAY_SIZE(bench_string); i++)
+		register_bench(&bench_string[i]);
+}
+
+static __exit void bench_string_exit(void)
+{
+	int i;
+
+	for(i = 0; i < ARRAY_SIZE(bench_string); i++)
+		unregister_bench(&bench_string[i]);
+}
+
+command_initcall(bench_string_init);
+command_exitcall(bench_string_exit);
@@ -0,0 +1,120 @@
+/*
+ * kernel/bench/bench-task.c
+ *
+ * Copyright(c) 2007-2018 Jianjun Jiang <8192542@qq.com>
+ * Official site: http://xboot.org
+ * Mobile phone: +86-18665388956
+ * QQ: 8192542
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <xboot.h>
+#include <bench/bench.h>
+
+struct bench_task_t {
+	struct channel_t * ping;
+	struct channel_t * pong;
+	struct task_t * task;
+};
+
+static void pong_task(struct task_t * task, void * data)
+{
+	struct bench_task_t * ctx = (struct bench_task_t *)data;
+	unsigned char c;
+
+	do {
+		channel_recv(ctx->ping, &c, 1);
+		channel_send(ctx->pong, &c, 1);
+	} while(c != 0xff);
+}
+
+static void * task_init(struct bench_t * bench)
+{
+	struct bench_task_t * ctx;
+
+	ctx = malloc(sizeof(struct bench_task_t));
+	if(!ctx)
+		return NULL;
+	ctx->ping = channel_alloc(16);
+	ctx->pong = channel_alloc(16);
+	if(!ctx->ping || !ctx->pong)
+	{
+		channel_free(ctx->ping);
+		channel_free(ctx->pong);
+		free(ctx);
+		return NULL;
+	}
+	ctx->task = task_create(scheduler_self(), "bench-pong", pong_task, ctx, 0, 0);
+	if(!ctx->task)
+	{
+		channel_free(ctx->ping);
+		channel_free(ctx->pong);
+		free(ctx);
+		return NULL;
+	}
+	task_resume(ctx->task);
+	return ctx;
+}
+
+static void task_exit(struct bench_t * bench, void * ctx)
+{
+	struct bench_task_t * t = (struct bench_task_t *)ctx;
+	unsigned char c = 0xff;
+
+	channel_send(t->ping, &c, 1);
+	channel_recv(t->pong, &c, 1);
+	channel_free(t->ping);
+	channel_free(t->pong);
+	free(t);
+}
+
+static uint64_t task_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_task_t * t = (struct bench_task_t *)ctx;
+	unsigned char c = 0;
+
+	channel_send(t->ping, &c, 1);
+	channel_recv(t->pong, &c, 1);
+	return 0;
+}
+
+static struct bench_t bench_task[] = {
+	{ .name = "task-pingpong",	.desc = "channel ping-pong, two context switches",	.init = task_init, .exit = task_exit, .run = task_run },
+};
+
+static __init void bench_task_init(void)
+{
+	int i;
+
+	for(i = 0; i < ARRAY_SIZE(bench_task); i++)
+		register_bench(&bench_task[i]);
+}
+
+static __exit void bench_task_exit(void)
+{
+	int i;
+
+	for(i = 0; i < ARRAY_SIZE(bench_task); i++)
+		unregister_bench(&bench_task[i]);
+}
+
+command_initcall(bench_task_init);
+command_exitcall(bench_task_exit);
@@ -0,0 +1,209 @@
+/*
+ * kernel/bench/bench-vfs.c
+ *
+ * Copyright(c) 2007-2018 Jianjun Jiang <8192542@qq.com>
+ * Official site: http://xboot.org
+ * Mobile phone: +86-18665388956
+ * QQ: 8192542
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <xboot.h>
+#include <bench/bench.h>
+
+#define VFS_BENCH_CHUNK		(SZ_64K)
+#define VFS_BENCH_TMPSZ		(SZ_1M)
+
+struct bench_vfs_t {
+	char path[VFS_MAX_PATH];
+	s64_t size;
+	int created;
+	int fd;
+	void * buf;
+};
+
+static int vfs_mountpoint_other(struct vfs_mount_t * m, const char * path)
+{
+	struct vfs_mount_t * t;
+	int i;
+
+	for(i = 0; i < vfs_mount_count(); i++)
+	{
+		t = vfs_mount_get(i);
+		if(t && (t != m) && (strcmp(t->m_path, path) == 0))
+			return 1;
+	}
+	return 0;
+}
+
+static void vfs_find_largest(struct vfs_mount_t * m, const char * dir, struct bench_vfs_t * ctx, int depth)
+{
+	struct vfs_dirent_t d;
+	struct vfs_stat_t st;
+	char * path;
+	int fd;
+
+	if(depth <= 0)
+		return;
+	path = malloc(VFS_MAX_PATH);
+	if(!path)
+		return;
+	fd = vfs_opendir(dir);
+	if(fd >= 0)
+	{
+		while(vfs_readdir(fd, &d) >= 0)
+		{
+			if(!strcmp(d.d_name, ".") || !strcmp(d.d_name, ".."))
+				continue;
+			snprintf(path, VFS_MAX_PATH, "%s%s%s", dir, (dir[strlen(dir) - 1] == '/') ? "" : "/", d.d_name);
+			if(vfs_stat(path, &st) < 0)
+				continue;
+			if(S_ISDIR(st.st_mode))
+			{
+				if(!vfs_mountpoint_other(m, path))
+					vfs_find_largest(m, path, ctx, depth - 1);
+			}
+			else if(S_ISREG(st.st_mode) && (st.st_size > ctx->size))
+			{
+				strlcpy(ctx->path, path, VFS_MAX_PATH);
+				ctx->size = st.st_size;
+			}
+		}
+		vfs_closedir(fd);
+	}
+	free(path);
+}
+
+static int vfs_create_file(struct vfs_mount_t * m, struct bench_vfs_t * ctx)
+{
+	s64_t n;
+	int fd;
+
+	snprintf(ctx->path, VFS_MAX_PATH, "%s%s.bench", m->m_path, (m->m_path[strlen(m->m_path) - 1] == '/') ? "" : "/");
+	fd = vfs_open(ctx->path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(fd < 0)
+		return 0;
+	memset(ctx->buf, 0x5a, VFS_BENCH_CHUNK);
+	for(n = 0; n < VFS_BENCH_TMPSZ; n += VFS_BENCH_CHUNK)
+	{
+		if(vfs_write(fd, ctx->buf, VFS_BENCH_CHUNK) != VFS_BENCH_CHUNK)
+			break;
+	}
+	vfs_close(fd);
+	ctx->size = n;
+	ctx->created = 1;
+	return (n > 0) ? 1 : 0;
+}
+
+static void * vfs_init(struct bench_t * bench)
+{
+	const char * fsname = (const char *)bench->priv;
+	struct bench_vfs_t * ctx;
+	struct vfs_mount_t * m;
+	int i;
+
+	ctx = malloc(sizeof(struct bench_vfs_t));
+	if(!ctx)
+		return NULL;
+	ctx->buf = malloc(VFS_BENCH_CHUNK);
+	if(!ctx->buf)
+	{
+		free(ctx);
+		return NULL;
+	}
+	ctx->path[0] = '\0';
+	ctx->size = 0;
+	ctx->created = 0;
+	ctx->fd = -1;
+
+	for(i = 0; i < vfs_mount_count(); i++)
+	{
+		m = vfs_mount_get(i);
+		if(!m || !m->m_fs || strcmp(m->m_fs->name, fsname))
+			continue;
+		vfs_find_largest(m, m->m_path, ctx, 8);
+		if((ctx->size < VFS_BENCH_CHUNK) && ((m->m_flags & MOUNT_MASK) == MOUNT_RW))
+			vfs_create_file(m, ctx);
+		if(ctx->size > 0)
+			break;
+	}
+	if(ctx->size > 0)
+		ctx->fd = vfs_open(ctx->path, O_RDONLY, 0);
+	if(ctx->fd < 0)
+	{
+		if(ctx->created)
+			vfs_unlink(ctx->path);
+		free(ctx->buf);
+		free(ctx);
+		return NULL;
+	}
+	return ctx;
+}
+
+static void vfs_exit(struct bench_t * bench, void * ctx)
+{
+	struct bench_vfs_t * v = (struct bench_vfs_t *)ctx;
+
+	vfs_close(v->fd);
+	if(v->created)
+		vfs_unlink(v->path);
+	free(v->buf);
+	free(v);
+}
+
+static uint64_t vfs_run(struct bench_t * bench, void * ctx)
+{
+	struct bench_vfs_t * v = (struct bench_vfs_t *)ctx;
+	uint64_t bytes = 0, n;
+
+	vfs_lseek(v->fd, 0, VFS_SEEK_SET);
+	while((n = vfs_read(v->fd, v->buf, VFS_BENCH_CHUNK)) > 0)
+		bytes += n;
+	return bytes;
+}
+
+static struct bench_t bench_vfs[] = {
+	{ .name = "vfs-read-cpio",	.desc = "read the largest file on cpio",	.init = vfs_init, .exit = vfs_exit, .run = vfs_run, .priv = "cpio" },
+	{ .name = "vfs-read-tar",	.desc = "read the largest file on tar",		.init = vfs_init, .exit = vfs_exit, .run = vfs_run, .priv = "tar" },
+	{ .name = "vfs-read-lz4fs",	.desc = "read the largest file on lz4fs",	.init = vfs_init, .exit = vfs_exit, .run = vfs_run, .priv = "lz4fs" },
+	{ .name = "vfs-read-fat",	.desc = "read the largest file on fat",		.init = vfs_init, .exit = vfs_exit, .run = vfs_run, .priv = "fat" },
+	{ .name = "vfs-read-ext4",	.desc = "read the largest file on ext4",	.init = vfs_init, .exit = vfs_exit, .run = vfs_run, .priv = "ext4" },
+	{ .name = "vfs-read-ram",	.desc = "read the largest file on ram",		.init = vfs_init, .exit = vfs_exit, .run = vfs_run, .priv = "ram" },
+};
+
+static __init void bench_vfs_init(void)
+{
+	int i;
+
+	for(i = 0; i < ARRAY_SIZE(bench_vfs); i++)
+		register_bench(&bench_vfs[i]);
+}
+
+static __exit void bench_vfs_exit(void)
+{
+	int i;
+
+	for(i = 0; i < ARRAY_SIZE(bench_vfs); i++)
+		unregister_bench(&bench_vfs[i]);
+}
+
+command_initcall(bench_vfs_init);
+command_exitcall(bench_vfs_exit);
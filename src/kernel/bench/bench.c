@@ -0,0 +1,172 @@
+/*
+ * kernel/bench/bench.c
+ *
+ * Copyright(c) 2007-2018 Jianjun Jiang <8192542@qq.com>
+ * Official site: http://xboot.org
+ * Mobile phone: +86-18665388956
+ * QQ: 8192542
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <xboot.h>
+#include <bench/bench.h>
+
+struct list_head __bench_list = {
+	.next = &__bench_list,
+	.prev = &__bench_list,
+};
+static spinlock_t __bench_lock = SPIN_LOCK_INIT();
+
+struct bench_t * search_bench(const char * name)
+{
+	struct bench_t * pos, * n;
+
+	if(!name)
+		return NULL;
+
+	list_for_each_entry_safe(pos, n, &__bench_list, list)
+	{
+		if(strcmp(pos->name, name) == 0)
+			return pos;
+	}
+	return NULL;
+}
+
+bool_t register_bench(struct bench_t * bench)
+{
+	irq_flags_t flags;
+
+	if(!bench || !bench->name || !bench->run)
+		return FALSE;
+
+	if(search_bench(bench->name))
+		return FALSE;
+
+	spin_lock_irqsave(&__bench_lock, flags);
+	list_add_tail(&bench->list, &__bench_list);
+	spin_unlock_irqrestore(&__bench_lock, flags);
+	return TRUE;
+}
+
+bool_t unregister_bench(struct bench_t * bench)
+{
+	irq_flags_t flags;
+
+	if(!bench || !bench->name)
+		return FALSE;
+
+	spin_lock_irqsave(&__bench_lock, flags);
+	list_del(&bench->list);
+	spin_unlock_irqrestore(&__bench_lock, flags);
+	return TRUE;
+}
+
+static int bench_compare(const void * a, const void * b)
+{
+	double x = *((const double *)a);
+	double y = *((const double *)b);
+
+	if(x < y)
+		return -1;
+	else if(x > y)
+		return 1;
+	return 0;
+}
+
+static inline uint64_t bench_loop(struct bench_t * bench, void * ctx, uint64_t loops, uint64_t * bytes)
+{
+	uint64_t begin, end;
+	uint64_t total = 0;
+	uint64_t i;
+
+	begin = ktime_to_ns(ktime_get());
+	for(i = 0; i < loops; i++)
+		total += bench->run(bench, ctx);
+	end = ktime_to_ns(ktime_get());
+	if(bytes)
+		*bytes = total;
+	return end - begin;
+}
+
+bool_t bench_run(struct bench_t * bench, int warmup, int repeat, uint64_t mintime, struct bench_result_t * result)
+{
+	double * samples;
+	double sum, var;
+	uint64_t loops, bytes, ns;
+	void * ctx = NULL;
+	int i;
+
+	if(!bench || !result || (repeat <= 0))
+		return FALSE;
+
+	samples = malloc(sizeof(double) * repeat);
+	if(!samples)
+		return FALSE;
+
+	if(bench->init)
+	{
+		ctx = bench->init(bench);
+		if(!ctx)
+		{
+			free(samples);
+			return FALSE;
+		}
+	}
+
+	/*
+	 * Calibrate the number of loops per sample, so that each sample takes
+	 * at least mintime nanoseconds and the timer resolution can be ignored.
+	 */
+	for(loops = 1; loops < (1ULL << 32); loops <<= 1)
+	{
+		if(bench_loop(bench, ctx, loops, NULL) >= mintime)
+			break;
+	}
+	for(i = 0; i < warmup; i++)
+		bench_loop(bench, ctx, loops, NULL);
+
+	bytes = 0;
+	for(i = 0; i < repeat; i++)
+	{
+		ns = bench_loop(bench, ctx, loops, &bytes);
+		samples[i] = (double)ns / (double)loops;
+	}
+	if(bench->exit)
+		bench->exit(bench, ctx);
+
+	qsort(samples, repeat, sizeof(double), bench_compare);
+	for(i = 0, sum = 0; i < repeat; i++)
+		sum += samples[i];
+	result->mean = sum / repeat;
+	for(i = 0, var = 0; i < repeat; i++)
+		var += (samples[i] - result->mean) * (samples[i] - result->mean);
+	result->stddev = (repeat > 1) ? sqrt(var / (repeat - 1)) : 0;
+	result->samples = repeat;
+	result->loops = loops;
+	result->bytes = bytes / loops;
+	result->min = samples[0];
+	result->max = samples[repeat - 1];
+	result->median = (repeat & 0x1) ? samples[repeat / 2] : (samples[repeat / 2 - 1] + samples[repeat / 2]) / 2;
+	result->p99 = samples[(repeat * 99 + 99) / 100 - 1];
+	free(samples);
+
+	return TRUE;
+}
@@ -0,0 +1,168 @@
+/*
+ * kernel/command/cmd-bench.c
+ *
+ * Copyright(c) 2007-2018 Jianjun Jiang <8192542@qq.com>
+ * Official site: http://xboot.org
+ * Mobile phone: +86-18665388956
+ * QQ: 8192542
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <xboot.h>
+#include <shell/ctrlc.h>
+#include <bench/bench.h>
+#include <command/command.h>
+
+static void usage(void)
+{
+	printf("usage:\r\n");
+	printf("    bench [-l] [-j] [-w warmup] [-r repeat] [-t mintime-us] [name ...]\r\n");
+}
+
+static bool_t bench_match(struct bench_t * bench, int argc, char ** argv)
+{
+	int i, n = 0;
+
+	for(i = 0; i < argc; i++)
+	{
+		if(!argv[i])
+			continue;
+		if(strncmp(bench->name, argv[i], strlen(argv[i])) == 0)
+			return TRUE;
+		n++;
+	}
+	return (n == 0) ? TRUE : FALSE;
+}
+
+static void bench_print(struct bench_t * bench, struct bench_result_t * r, int json)
+{
+	double mbps = (r->bytes > 0 && r->median > 0) ? ((double)r->bytes * 1000.0 / r->median) : 0;
+
+	if(json)
+	{
+		printf("{\"name\":\"%s\",\"samples\":%d,\"loops\":%lld,\"bytes\":%lld,", bench->name, r->samples, r->loops, r->bytes);
+		printf("\"min\":%.3f,\"median\":%.3f,\"mean\":%.3f,\"p99\":%.3f,\"max\":%.3f,\"stddev\":%.3f,", r->min, r->median, r->mean, r->p99, r->max, r->stddev);
+		printf("\"mbps\":%.3f}\r\n", mbps);
+	}
+	else
+	{
+		printf(" %-24s %12.1f %12.1f %12.1f %10.1f%%", bench->name, r->median, r->p99, r->min, (r->mean > 0) ? (r->stddev * 100.0 / r->mean) : 0);
+		if(mbps > 0)
+			printf(" %10.2f MB/s", mbps);
+		printf("\r\n");
+	}
+}
+
+static int do_bench(int argc, char ** argv)
+{
+	struct bench_t * pos, * n;
+	struct bench_result_t result;
+	int list = 0, json = 0;
+	int warmup = 3, repeat = 31;
+	uint64_t mintime = 2000;
+	int i;
+
+	for(i = 1; i < argc; i++)
+	{
+		if(!strcmp(argv[i], "-l"))
+		{
+			list = 1;
+			argv[i] = NULL;
+		}
+		else if(!strcmp(argv[i], "-j"))
+		{
+			json = 1;
+			argv[i] = NULL;
+		}
+		else if(!strcmp(argv[i], "-w") && (argc > i + 1))
+		{
+			argv[i] = NULL;
+			warmup = strtol(argv[++i], NULL, 0);
+			argv[i] = NULL;
+		}
+		else if(!strcmp(argv[i], "-r") && (argc > i + 1))
+		{
+			argv[i] = NULL;
+			repeat = strtol(argv[++i], NULL, 0);
+			argv[i] = NULL;
+		}
+		else if(!strcmp(argv[i], "-t") && (argc > i + 1))
+		{
+			argv[i] = NULL;
+			mintime = strtoull(argv[++i], NULL, 0);
+			argv[i] = NULL;
+		}
+		else if(*argv[i] == '-')
+		{
+			usage();
+			return -1;
+		}
+	}
+	if(warmup < 0)
+		warmup = 0;
+	if(repeat <= 0)
+		repeat = 1;
+
+	if(list)
+	{
+		list_for_each_entry_safe(pos, n, &__bench_list, list)
+		{
+			if(bench_match(pos, argc - 1, &argv[1]))
+				printf(" %-24s - %s\r\n", pos->name, pos->desc ? pos->desc : "");
+		}
+		return 0;
+	}
+
+	if(!json)
+		printf(" %-24s %12s %12s %12s %11s\r\n", "name", "median(ns)", "p99(ns)", "min(ns)", "rsd");
+	list_for_each_entry_safe(pos, n, &__bench_list, list)
+	{
+		if(!bench_match(pos, argc - 1, &argv[1]))
+			continue;
+		if(ctrlc())
+			break;
+		if(bench_run(pos, warmup, repeat, mintime * 1000, &result))
+			bench_print(pos, &result, json);
+		else if(!json)
+			printf(" %-24s %12s\r\n", pos->name, "n/a");
+	}
+	return 0;
+}
+
+static struct command_t cmd_bench = {
+	.name	= "bench",
+	.desc	= "run the registered microbenchmarks",
+	.usage	= usage,
+	.exec	= do_bench,
+};
+
+static __init void bench_cmd_init(void)
+{
+	register_command(&cmd_bench);
+}
+
+static __exit void bench_cmd_exit(void)
+{
+	unregister_command(&cmd_bench);
+}
+
+command_initcall(bench_cmd_init);
+command_exitcall(bench_cmd_exit);
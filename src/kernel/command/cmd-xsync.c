@@ -28,9 +28,33 @@
 
 #include <xboot.h>
 #include <crc32.h>
+#include <lz4.h>
+#include <console/console.h>
 #include <command/command.h>
 
 #define PACKET_DATA_MAX		(1024)
+#define PACKET_LENGTH_MAX	(65535)
+
+/*
+ * Windowed transfer, negotiated by XSYNC_COMMAND_CONFIG. The host asks
+ * for [version, flags, window, 0, chunk(4)] and gets back the values this
+ * side accepts, a zero window means windowed transfer is unavailable and
+ * the host keeps to XSYNC_COMMAND_TRANSFER. A device without CONFIG just
+ * answers XSYNC_COMMAND_UNKOWN.
+ *
+ * Each XSYNC_COMMAND_WRITE carries [seq(4), flags, payload], the payload
+ * being file block seq of chunk bytes, lz4 compressed if flagged. Blocks
+ * inside the window may arrive out of order and are written out once
+ * contiguous. Every WRITE is answered with [next(4), mask(4)], all blocks
+ * before next are written and bit n of mask tells block next + 1 + n is
+ * held, so the host only resends the holes. While blocks are in flight
+ * the host may go quiet for longer, so the idle timeout grows as well.
+ */
+#define XSYNC_VERSION		(1)
+#define XSYNC_WINDOW_MAX	(16)
+#define XSYNC_CHUNK_MAX		(32768)
+#define XSYNC_FLAG_LZ4		(1 << 0)
+#define XSYNC_TIMEOUT		(10000)
 
 enum xsync_command_t {
 	XSYNC_COMMAND_ALIVE		= 0x00,
@@ -38,6 +62,8 @@ enum xsync_command_t {
 	XSYNC_COMMAND_TRANSFER	= 0x02,
 	XSYNC_COMMAND_STOP		= 0x03,
 	XSYNC_COMMAND_SYSTEM	= 0x04,
+	XSYNC_COMMAND_CONFIG	= 0x05,
+	XSYNC_COMMAND_WRITE		= 0x06,
 	XSYNC_COMMAND_UNKOWN	= 0xff,
 };
 
@@ -58,7 +84,7 @@ struct packet_t {
 	uint8_t header[2];
 	uint8_t length[2];
 	uint8_t command;
-	uint8_t data[4096];
+	uint8_t data[PACKET_LENGTH_MAX - 5];
 	uint8_t crc[4];
 };
 
@@ -68,6 +94,14 @@ struct xsync_ctx_t {
 	int index;
 	int fd;
 	int quit;
+	int timeout;
+
+	uint8_t * slot;
+	uint32_t size[XSYNC_WINDOW_MAX];
+	uint32_t window;
+	uint32_t chunk;
+	uint32_t flags;
+	uint32_t next;
 };
 
 static inline uint16_t packet_length(struct packet_t * packet)
@@ -94,55 +128,36 @@ static inline uint32_t packet_crc(struct packet_t * packet)
 	return crc;
 }
 
-static void packet_init(struct packet_t * packet, uint8_t command, uint8_t * data, size_t size)
+static inline uint32_t xsync_get_be32(uint8_t * p)
 {
-	uint32_t crc;
-
-	if(!data)
-		size = 0;
-	packet->header[0] = 'X';
-	packet->header[1] = 'x';
-	packet->length[0] = ((size + 5) >> 8) & 0xff;
-	packet->length[1] = ((size + 5) >> 0) & 0xff;
-	packet->command = command;
-	if(size > 0)
-		memcpy(&(packet->data[0]), data, size);
-	crc = packet_crc(packet);
-	packet->crc[0] = (crc >> 24) & 0xff;
-	packet->crc[1] = (crc >> 16) & 0xff;
-	packet->crc[2] = (crc >>  8) & 0xff;
-	packet->crc[3] = (crc >>  0) & 0xff;
+	return (p[0] << 24) | (p[1] << 16) | (p[2] << 8) | (p[3] << 0);
 }
 
-static void packet_put(struct packet_t * packet)
+static inline void xsync_put_be32(uint8_t * p, uint32_t v)
 {
-	uint16_t dsize = packet_dsize(packet);
-	int i;
-
-	putchar(packet->header[0]);
-	putchar(packet->header[1]);
-	putchar(packet->length[0]);
-	putchar(packet->length[1]);
-	putchar(packet->command);
-	fflush(stdout);
-	for(i = 0; i < dsize; i++)
-	{
-		putchar(packet->data[i]);
-		fflush(stdout);
-	}
-	putchar(packet->crc[0]);
-	putchar(packet->crc[1]);
-	putchar(packet->crc[2]);
-	putchar(packet->crc[3]);
-	fflush(stdout);
+	p[0] = (v >> 24) & 0xff;
+	p[1] = (v >> 16) & 0xff;
+	p[2] = (v >>  8) & 0xff;
+	p[3] = (v >>  0) & 0xff;
 }
 
 static void xsync_put(uint8_t command, uint8_t * data, size_t size)
 {
-	struct packet_t packet;
+	uint8_t header[5], crc[4];
 
-	packet_init(&packet, command, data, size);
-	packet_put(&packet);
+	if(!data)
+		size = 0;
+	header[0] = 'X';
+	header[1] = 'x';
+	header[2] = ((size + 5) >> 8) & 0xff;
+	header[3] = ((size + 5) >> 0) & 0xff;
+	header[4] = command;
+	xsync_put_be32(crc, crc32_sum(crc32_sum(0, header, 5), data, size));
+	fwrite(header, 5, 1, stdout);
+	if(size > 0)
+		fwrite(data, size, 1, stdout);
+	fwrite(crc, 4, 1, stdout);
+	fflush(stdout);
 }
 
 static int xsync_get(struct xsync_ctx_t * ctx, uint8_t c)
@@ -190,7 +205,12 @@ static int xsync_get(struct xsync_ctx_t * ctx, uint8_t c)
 	case PACKET_STATE_COMMAND:
 		ctx->state = PACKET_STATE_DATA;
 		length = (p[2] << 8) | (p[3] << 0);
-		if(ctx->index >= length)
+		if(length < 5)
+		{
+			ctx->index = 0;
+			ctx->state = PACKET_STATE_HEADER0;
+		}
+		else if(ctx->index >= length)
 			ctx->state = PACKET_STATE_CRC0;
 		break;
 
@@ -236,20 +256,43 @@ static int xsync_get(struct xsync_ctx_t * ctx, uint8_t c)
 	return -1;
 }
 
+/*
+ * Copy as much of the packet payload as is at hand in one go, instead of
+ * feeding it through the state machine byte by byte.
+ */
+static int xsync_get_data(struct xsync_ctx_t * ctx, uint8_t * buf, int len)
+{
+	uint8_t * p = (uint8_t *)(&ctx->packet);
+	int n = packet_length(&ctx->packet) - ctx->index;
+
+	if(n > len)
+		n = len;
+	memcpy(&p[ctx->index], buf, n);
+	ctx->index += n;
+	if(ctx->index >= packet_length(&ctx->packet))
+		ctx->state = PACKET_STATE_CRC0;
+	return n;
+}
+
 static uint8_t xsync_handle_start(struct xsync_ctx_t * ctx)
 {
 	char fpath[VFS_MAX_PATH];
 	char path[PACKET_DATA_MAX];
 	char buf[PACKET_DATA_MAX];
 	uint32_t crc1, crc2 = 0;
+	int len = packet_dsize(&ctx->packet) - 4;
 	u64_t n;
 
-	crc1  = (ctx->packet.data[0] << 24) & 0xff000000;
-	crc1 |= (ctx->packet.data[1] << 16) & 0x00ff0000;
-	crc1 |= (ctx->packet.data[2] <<  8) & 0x0000ff00;
-	crc1 |= (ctx->packet.data[3] <<  0) & 0x000000ff;
+	if(len < 0)
+		return 0;
+	if(len > sizeof(path) - 1)
+		len = sizeof(path) - 1;
+	crc1 = xsync_get_be32(&ctx->packet.data[0]);
 	memset(path, 0, sizeof(path));
-	memcpy(path, &ctx->packet.data[4], packet_dsize(&ctx->packet) - 4);
+	memcpy(path, &ctx->packet.data[4], len);
+
+	ctx->next = 0;
+	memset(ctx->size, 0, sizeof(ctx->size));
 
 	shell_realpath(path, fpath);
 	ctx->fd = vfs_open(fpath, O_RDONLY, 0);
@@ -272,6 +315,98 @@ static uint8_t xsync_handle_start(struct xsync_ctx_t * ctx)
 	return 2;
 }
 
+static void xsync_handle_config(struct xsync_ctx_t * ctx, uint8_t * buf)
+{
+	uint8_t * data = &ctx->packet.data[0];
+	uint32_t window = 0, chunk = 0, flags = 0;
+
+	if(ctx->slot)
+	{
+		free(ctx->slot);
+		ctx->slot = NULL;
+	}
+	if(packet_dsize(&ctx->packet) >= 8)
+	{
+		flags = data[1] & XSYNC_FLAG_LZ4;
+		window = data[2];
+		if(window > XSYNC_WINDOW_MAX)
+			window = XSYNC_WINDOW_MAX;
+		chunk = xsync_get_be32(&data[4]);
+		if(chunk > XSYNC_CHUNK_MAX)
+			chunk = XSYNC_CHUNK_MAX;
+		if((window > 0) && (chunk > 0))
+			ctx->slot = malloc(window * chunk);
+		if(!ctx->slot)
+		{
+			window = 0;
+			chunk = 0;
+			flags = 0;
+		}
+	}
+	ctx->timeout = (window > 0) ? XSYNC_TIMEOUT : 3000;
+	ctx->window = window;
+	ctx->chunk = chunk;
+	ctx->flags = flags;
+	ctx->next = 0;
+	memset(ctx->size, 0, sizeof(ctx->size));
+
+	buf[0] = XSYNC_VERSION;
+	buf[1] = flags;
+	buf[2] = window;
+	buf[3] = 0;
+	xsync_put_be32(&buf[4], chunk);
+}
+
+static void xsync_handle_write(struct xsync_ctx_t * ctx, uint8_t * buf)
+{
+	uint8_t * data = &ctx->packet.data[5];
+	int dsize = packet_dsize(&ctx->packet) - 5;
+	uint32_t seq, index, mask = 0;
+	int len, i;
+
+	if((ctx->fd > 0) && (dsize > 0))
+	{
+		seq = xsync_get_be32(&ctx->packet.data[0]);
+		index = seq % ctx->window;
+		if((seq - ctx->next < ctx->window) && (ctx->size[index] == 0))
+		{
+			if(ctx->packet.data[4] & XSYNC_FLAG_LZ4)
+			{
+				len = LZ4_decompress_safe((const char *)data, (char *)&ctx->slot[index * ctx->chunk], dsize, ctx->chunk);
+				if(len > 0)
+					ctx->size[index] = len;
+			}
+			else if(dsize <= ctx->chunk)
+			{
+				if(seq == ctx->next)
+				{
+					vfs_write(ctx->fd, (void *)data, dsize);
+					ctx->next++;
+				}
+				else
+				{
+					memcpy(&ctx->slot[index * ctx->chunk], data, dsize);
+					ctx->size[index] = dsize;
+				}
+			}
+		}
+		while(ctx->size[ctx->next % ctx->window] > 0)
+		{
+			index = ctx->next % ctx->window;
+			vfs_write(ctx->fd, (void *)&ctx->slot[index * ctx->chunk], ctx->size[index]);
+			ctx->size[index] = 0;
+			ctx->next++;
+		}
+	}
+	for(i = 0; i + 1 < ctx->window; i++)
+	{
+		if(ctx->size[(ctx->next + 1 + i) % ctx->window] > 0)
+			mask |= 1 << i;
+	}
+	xsync_put_be32(&buf[0], ctx->next);
+	xsync_put_be32(&buf[4], mask);
+}
+
 static void xsync_handle(struct xsync_ctx_t * ctx)
 {
 	uint8_t buf[PACKET_DATA_MAX];
@@ -311,11 +446,31 @@ static void xsync_handle(struct xsync_ctx_t * ctx)
 			vfs_close(ctx->fd);
 			ctx->fd = -1;
 		}
+		size = packet_dsize(&ctx->packet);
+		if(size > sizeof(buf) - 1)
+			size = sizeof(buf) - 1;
 		memset(buf, 0, sizeof(buf));
-		memcpy(buf, &ctx->packet.data[0], packet_dsize(&ctx->packet));
+		memcpy(buf, &ctx->packet.data[0], size);
 		shell_system((const char *)buf);
 		break;
 
+	case XSYNC_COMMAND_CONFIG:
+		xsync_handle_config(ctx, buf);
+		xsync_put(XSYNC_COMMAND_CONFIG, buf, 8);
+		break;
+
+	case XSYNC_COMMAND_WRITE:
+		if(ctx->slot)
+		{
+			xsync_handle_write(ctx, buf);
+			xsync_put(XSYNC_COMMAND_WRITE, buf, 8);
+		}
+		else
+		{
+			xsync_put(XSYNC_COMMAND_UNKOWN, 0, 0);
+		}
+		break;
+
 	default:
 		xsync_put(XSYNC_COMMAND_UNKOWN, 0, 0);
 		break;
@@ -330,37 +485,73 @@ static void usage(void)
 
 static int do_xsync(int argc, char ** argv)
 {
-	struct xsync_ctx_t ctx;
+	struct xsync_ctx_t * ctx;
 	ktime_t timeout = ktime_add_ms(ktime_get(), 3000);
-	int c;
-
-	ctx.state = PACKET_STATE_HEADER0;
-	ctx.index = 0;
-	ctx.fd = -1;
-	ctx.quit = 0;
-
-	while(ctx.quit == 0)
+	ktime_t last = ktime_get();
+	uint8_t buf[256];
+	int n, i;
+
+	ctx = malloc(sizeof(struct xsync_ctx_t));
+	if(!ctx)
+		return -1;
+	ctx->state = PACKET_STATE_HEADER0;
+	ctx->index = 0;
+	ctx->fd = -1;
+	ctx->quit = 0;
+	ctx->timeout = 3000;
+	ctx->slot = NULL;
+	ctx->window = 0;
+	ctx->chunk = 0;
+	ctx->flags = 0;
+	ctx->next = 0;
+
+	while(ctx->quit == 0)
 	{
-		if((c = getchar()) < 0)
+		if((n = console_stdin_read(buf, sizeof(buf))) <= 0)
 		{
+			/*
+			 * The host never pauses inside a packet, a packet cut short by
+			 * a lost chunk is dropped once the line goes quiet, so a bogus
+			 * length can't swallow the resent ones.
+			 */
+			if((ctx->state != PACKET_STATE_HEADER0) && ktime_after(ktime_get(), ktime_add_ms(last, 500)))
+			{
+				ctx->index = 0;
+				ctx->state = PACKET_STATE_HEADER0;
+			}
 			if(ktime_after(ktime_get(), timeout))
 			{
-				ctx.quit = 1;
-				if(ctx.fd > 0)
+				ctx->quit = 1;
+				if(ctx->fd > 0)
 				{
-					vfs_close(ctx.fd);
-					ctx.fd = -1;
+					vfs_close(ctx->fd);
+					ctx->fd = -1;
 				}
 			}
 			continue;
 		}
+		last = ktime_get();
+		timeout = ktime_add_ms(last, ctx->timeout);
 
-		if(xsync_get(&ctx, c) < 0)
-			continue;
+		for(i = 0; (i < n) && (ctx->quit == 0); i++)
+		{
+			if(ctx->state == PACKET_STATE_DATA)
+			{
+				i += xsync_get_data(ctx, &buf[i], n - i);
+				if(i >= n)
+					break;
+			}
+
+			if(xsync_get(ctx, buf[i]) < 0)
+				continue;
 
-		xsync_handle(&ctx);
-		timeout = ktime_add_ms(ktime_get(), 3000);
+			xsync_handle(ctx);
+		}
 	}
+
+	if(ctx->slot)
+		free(ctx->slot);
+	free(ctx);
 	return 0;
 }
 
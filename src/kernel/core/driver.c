@@ -142,7 +142,7 @@ bool_t unregister_driver(struct driver_t * drv)
 	return TRUE;
 }
 
-void probe_device(const char * json, int length, const char * tips)
+void probe_device(char * json, int length, const char * tips)
 {
 	struct driver_t * drv;
 	struct device_t * dev;
@@ -154,7 +154,7 @@ void probe_device(const char * json, int length, const char * tips)
 
 	if(json && (length > 0))
 	{
-		v = json_parse(json, length, errbuf);
+		v = json_parse_insitu(json, length, errbuf);
 		if(v && (v->type == JSON_OBJECT))
 		{
 			for(i = 0; i < v->u.object.length; i++)
@@ -47,204 +47,94 @@ physical_addr_t dt_read_address(struct dtnode_t * n)
 int dt_read_bool(struct dtnode_t * n, const char * name, int def)
 {
 	struct json_value_t * v;
-	int i;
 
-	if(n && n->value && (n->value->type == JSON_OBJECT))
-	{
-		for(i = 0; i < n->value->u.object.length; i++)
-		{
-			if(strcmp(n->value->u.object.values[i].name, name) == 0)
-			{
-				v = n->value->u.object.values[i].value;
-				if(v && (v->type == JSON_BOOLEAN))
-					return v->u.boolean ? 1 : 0;
-			}
-		}
-	}
+	if(n && (v = json_object_lookup(n->value, name, JSON_BOOLEAN)))
+		return v->u.boolean ? 1 : 0;
 	return def;
 }
 
 int dt_read_int(struct dtnode_t * n, const char * name, int def)
 {
 	struct json_value_t * v;
-	int i;
 
-	if(n && n->value && (n->value->type == JSON_OBJECT))
-	{
-		for(i = 0; i < n->value->u.object.length; i++)
-		{
-			if(strcmp(n->value->u.object.values[i].name, name) == 0)
-			{
-				v = n->value->u.object.values[i].value;
-				if(v && (v->type == JSON_INTEGER))
-					return (int)v->u.integer;
-			}
-		}
-	}
+	if(n && (v = json_object_lookup(n->value, name, JSON_INTEGER)))
+		return (int)v->u.integer;
 	return def;
 }
 
 long long dt_read_long(struct dtnode_t * n, const char * name, long long def)
 {
 	struct json_value_t * v;
-	int i;
 
-	if(n && n->value && (n->value->type == JSON_OBJECT))
-	{
-		for(i = 0; i < n->value->u.object.length; i++)
-		{
-			if(strcmp(n->value->u.object.values[i].name, name) == 0)
-			{
-				v = n->value->u.object.values[i].value;
-				if(v && (v->type == JSON_INTEGER))
-					return (long long)v->u.integer;
-			}
-		}
-	}
+	if(n && (v = json_object_lookup(n->value, name, JSON_INTEGER)))
+		return (long long)v->u.integer;
 	return def;
 }
 
 double dt_read_double(struct dtnode_t * n, const char * name, double def)
 {
 	struct json_value_t * v;
-	int i;
 
-	if(n && n->value && (n->value->type == JSON_OBJECT))
-	{
-		for(i = 0; i < n->value->u.object.length; i++)
-		{
-			if(strcmp(n->value->u.object.values[i].name, name) == 0)
-			{
-				v = n->value->u.object.values[i].value;
-				if(v && (v->type == JSON_DOUBLE))
-					return (double)v->u.dbl;
-			}
-		}
-	}
+	if(n && (v = json_object_lookup(n->value, name, JSON_DOUBLE)))
+		return (double)v->u.dbl;
 	return def;
 }
 
 char * dt_read_string(struct dtnode_t * n, const char * name, char * def)
 {
 	struct json_value_t * v;
-	int i;
 
-	if(n && n->value && (n->value->type == JSON_OBJECT))
-	{
-		for(i = 0; i < n->value->u.object.length; i++)
-		{
-			if(strcmp(n->value->u.object.values[i].name, name) == 0)
-			{
-				v = n->value->u.object.values[i].value;
-				if(v && (v->type == JSON_STRING))
-					return (char *)v->u.string.ptr;
-			}
-		}
-	}
+	if(n && (v = json_object_lookup(n->value, name, JSON_STRING)))
+		return (char *)v->u.string.ptr;
 	return def;
 }
 
 u8_t dt_read_u8(struct dtnode_t * n, const char * name, u8_t def)
 {
 	struct json_value_t * v;
-	int i;
 
-	if(n && n->value && (n->value->type == JSON_OBJECT))
-	{
-		for(i = 0; i < n->value->u.object.length; i++)
-		{
-			if(strcmp(n->value->u.object.values[i].name, name) == 0)
-			{
-				v = n->value->u.object.values[i].value;
-				if(v && (v->type == JSON_INTEGER))
-					return (u8_t)v->u.integer;
-			}
-		}
-	}
+	if(n && (v = json_object_lookup(n->value, name, JSON_INTEGER)))
+		return (u8_t)v->u.integer;
 	return def;
 }
 
 u16_t dt_read_u16(struct dtnode_t * n, const char * name, u16_t def)
 {
 	struct json_value_t * v;
-	int i;
 
-	if(n && n->value && (n->value->type == JSON_OBJECT))
-	{
-		for(i = 0; i < n->value->u.object.length; i++)
-		{
-			if(strcmp(n->value->u.object.values[i].name, name) == 0)
-			{
-				v = n->value->u.object.values[i].value;
-				if(v && (v->type == JSON_INTEGER))
-					return (u16_t)v->u.integer;
-			}
-		}
-	}
+	if(n && (v = json_object_lookup(n->value, name, JSON_INTEGER)))
+		return (u16_t)v->u.integer;
 	return def;
 }
 
 u32_t dt_read_u32(struct dtnode_t * n, const char * name, u32_t def)
 {
 	struct json_value_t * v;
-	int i;
 
-	if(n && n->value && (n->value->type == JSON_OBJECT))
-	{
-		for(i = 0; i < n->value->u.object.length; i++)
-		{
-			if(strcmp(n->value->u.object.values[i].name, name) == 0)
-			{
-				v = n->value->u.object.values[i].value;
-				if(v && (v->type == JSON_INTEGER))
-					return (u32_t)v->u.integer;
-			}
-		}
-	}
+	if(n && (v = json_object_lookup(n->value, name, JSON_INTEGER)))
+		return (u32_t)v->u.integer;
 	return def;
 }
 
 u64_t dt_read_u64(struct dtnode_t * n, const char * name, u64_t def)
 {
 	struct json_value_t * v;
-	int i;
 
-	if(n && n->value && (n->value->type == JSON_OBJECT))
-	{
-		for(i = 0; i < n->value->u.object.length; i++)
-		{
-			if(strcmp(n->value->u.object.values[i].name, name) == 0)
-			{
-				v = n->value->u.object.values[i].value;
-				if(v && (v->type == JSON_INTEGER))
-					return (u64_t)v->u.integer;
-			}
-		}
-	}
+	if(n && (v = json_object_lookup(n->value, name, JSON_INTEGER)))
+		return (u64_t)v->u.integer;
 	return def;
 }
 
 struct dtnode_t * dt_read_object(struct dtnode_t * n, const char * name, struct dtnode_t * o)
 {
 	struct json_value_t * v;
-	int i;
 
-	if(o && n && n->value && (n->value->type == JSON_OBJECT))
+	if(o && n && (v = json_object_lookup(n->value, name, JSON_OBJECT)))
 	{
-		for(i = 0; i < n->value->u.object.length; i++)
-		{
-			if(strcmp(n->value->u.object.values[i].name, name) == 0)
-			{
-				v = n->value->u.object.values[i].value;
-				if(v && (v->type == JSON_OBJECT))
-				{
-					o->name = name;
-					o->addr = 0;
-					o->value = v;
-					return o;
-				}
-			}
-		}
+		o->name = name;
+		o->addr = 0;
+		o->value = v;
+		return o;
 	}
 	return NULL;
 }
@@ -252,45 +142,23 @@ struct dtnode_t * dt_read_object(struct dtnode_t * n, const char * name, struct
 int dt_read_array_length(struct dtnode_t * n, const char * name)
 {
 	struct json_value_t * v;
-	int i;
 
-	if(n && n->value && (n->value->type == JSON_OBJECT))
-	{
-		for(i = 0; i < n->value->u.object.length; i++)
-		{
-			if(strcmp(n->value->u.object.values[i].name, name) == 0)
-			{
-				v = n->value->u.object.values[i].value;
-				if(v && (v->type == JSON_ARRAY))
-					return v->u.array.length;
-			}
-		}
-	}
+	if(n && (v = json_object_lookup(n->value, name, JSON_ARRAY)))
+		return v->u.array.length;
 	return 0;
 }
 
 int dt_read_array_bool(struct dtnode_t * n, const char * name, int idx, int def)
 {
 	struct json_value_t * v, * e;
-	int i;
 
-	if(n && n->value && (n->value->type == JSON_OBJECT))
+	if(n && (v = json_object_lookup(n->value, name, JSON_ARRAY)))
 	{
-		for(i = 0; i < n->value->u.object.length; i++)
+		if(idx >= 0 && (idx < v->u.array.length))
 		{
-			if(strcmp(n->value->u.object.values[i].name, name) == 0)
-			{
-				v = n->value->u.object.values[i].value;
-				if(v && (v->type == JSON_ARRAY))
-				{
-					if(idx >= 0 && (idx < v->u.array.length))
-					{
-						e = v->u.array.values[idx];
-						if(e && (e->type == JSON_BOOLEAN))
-							return e->u.boolean ? 1 : 0;
-					}
-				}
-			}
+			e = v->u.array.values[idx];
+			if(e && (e->type == JSON_BOOLEAN))
+				return e->u.boolean ? 1 : 0;
 		}
 	}
 	return def;
@@ -299,25 +167,14 @@ int dt_read_array_bool(struct dtnode_t * n, const char * name, int idx, int def)
 int dt_read_array_int(struct dtnode_t * n, const char * name, int idx, int def)
 {
 	struct json_value_t * v, * e;
-	int i;
 
-	if(n && n->value && (n->value->type == JSON_OBJECT))
+	if(n && (v = json_object_lookup(n->value, name, JSON_ARRAY)))
 	{
-		for(i = 0; i < n->value->u.object.length; i++)
+		if(idx >= 0 && (idx < v->u.array.length))
 		{
-			if(strcmp(n->value->u.object.values[i].name, name) == 0)
-			{
-				v = n->value->u.object.values[i].value;
-				if(v && (v->type == JSON_ARRAY))
-				{
-					if(idx >= 0 && (idx < v->u.array.length))
-					{
-						e = v->u.array.values[idx];
-						if(e && (e->type == JSON_INTEGER))
-							return (int)e->u.integer;
-					}
-				}
-			}
+			e = v->u.array.values[idx];
+			if(e && (e->type == JSON_INTEGER))
+				return (int)e->u.integer;
 		}
 	}
 	return def;
@@ -326,25 +183,14 @@ int dt_read_array_int(struct dtnode_t * n, const char * name, int idx, int def)
 long long dt_read_array_long(struct dtnode_t * n, const char * name, int idx, long long def)
 {
 	struct json_value_t * v, * e;
-	int i;
 
-	if(n && n->value && (n->value->type == JSON_OBJECT))
+	if(n && (v = json_object_lookup(n->value, name, JSON_ARRAY)))
 	{
-		for(i = 0; i < n->value->u.object.length; i++)
+		if(idx >= 0 && (idx < v->u.array.length))
 		{
-			if(strcmp(n->value->u.object.values[i].name, name) == 0)
-			{
-				v = n->value->u.object.values[i].value;
-				if(v && (v->type == JSON_ARRAY))
-				{
-					if(idx >= 0 && (idx < v->u.array.length))
-					{
-						e = v->u.array.values[idx];
-						if(e && (e->type == JSON_INTEGER))
-							return (long long)e->u.integer;
-					}
-				}
-			}
+			e = v->u.array.values[idx];
+			if(e && (e->type == JSON_INTEGER))
+				return (long long)e->u.integer;
 		}
 	}
 	return def;
@@ -353,25 +199,14 @@ long long dt_read_array_long(struct dtnode_t * n, const char * name, int idx, lo
 double dt_read_array_double(struct dtnode_t * n, const char * name, int idx, double def)
 {
 	struct json_value_t * v, * e;
-	int i;
 
-	if(n && n->value && (n->value->type == JSON_OBJECT))
+	if(n && (v = json_object_lookup(n->value, name, JSON_ARRAY)))
 	{
-		for(i = 0; i < n->value->u.object.length; i++)
+		if(idx >= 0 && (idx < v->u.array.length))
 		{
-			if(strcmp(n->value->u.object.values[i].name, name) == 0)
-			{
-				v = n->value->u.object.values[i].value;
-				if(v && (v->type == JSON_ARRAY))
-				{
-					if(idx >= 0 && (idx < v->u.array.length))
-					{
-						e = v->u.array.values[idx];
-						if(e && (e->type == JSON_DOUBLE))
-							return (double)e->u.dbl;
-					}
-				}
-			}
+			e = v->u.array.values[idx];
+			if(e && (e->type == JSON_DOUBLE))
+				return (double)e->u.dbl;
 		}
 	}
 	return def;
@@ -380,25 +215,14 @@ double dt_read_array_double(struct dtnode_t * n, const char * name, int idx, dou
 char * dt_read_array_string(struct dtnode_t * n, const char * name, int idx, char * def)
 {
 	struct json_value_t * v, * e;
-	int i;
 
-	if(n && n->value && (n->value->type == JSON_OBJECT))
+	if(n && (v = json_object_lookup(n->value, name, JSON_ARRAY)))
 	{
-		for(i = 0; i < n->value->u.object.length; i++)
+		if(idx >= 0 && (idx < v->u.array.length))
 		{
-			if(strcmp(n->value->u.object.values[i].name, name) == 0)
-			{
-				v = n->value->u.object.values[i].value;
-				if(v && (v->type == JSON_ARRAY))
-				{
-					if(idx >= 0 && (idx < v->u.array.length))
-					{
-						e = v->u.array.values[idx];
-						if(e && (e->type == JSON_STRING))
-							return (char *)e->u.string.ptr;
-					}
-				}
-			}
+			e = v->u.array.values[idx];
+			if(e && (e->type == JSON_STRING))
+				return (char *)e->u.string.ptr;
 		}
 	}
 	return def;
@@ -407,25 +231,14 @@ char * dt_read_array_string(struct dtnode_t * n, const char * name, int idx, cha
 u8_t dt_read_array_u8(struct dtnode_t * n, const char * name, int idx, u8_t def)
 {
 	struct json_value_t * v, * e;
-	int i;
 
-	if(n && n->value && (n->value->type == JSON_OBJECT))
+	if(n && (v = json_object_lookup(n->value, name, JSON_ARRAY)))
 	{
-		for(i = 0; i < n->value->u.object.length; i++)
+		if(idx >= 0 && (idx < v->u.array.length))
 		{
-			if(strcmp(n->value->u.object.values[i].name, name) == 0)
-			{
-				v = n->value->u.object.values[i].value;
-				if(v && (v->type == JSON_ARRAY))
-				{
-					if(idx >= 0 && (idx < v->u.array.length))
-					{
-						e = v->u.array.values[idx];
-						if(e && (e->type == JSON_INTEGER))
-							return (u8_t)e->u.integer;
-					}
-				}
-			}
+			e = v->u.array.values[idx];
+			if(e && (e->type == JSON_INTEGER))
+				return (u8_t)e->u.integer;
 		}
 	}
 	return def;
@@ -434,25 +247,14 @@ u8_t dt_read_array_u8(struct dtnode_t * n, const char * name, int idx, u8_t def)
 u16_t dt_read_array_u16(struct dtnode_t * n, const char * name, int idx, u16_t def)
 {
 	struct json_value_t * v, * e;
-	int i;
 
-	if(n && n->value && (n->value->type == JSON_OBJECT))
+	if(n && (v = json_object_lookup(n->value, name, JSON_ARRAY)))
 	{
-		for(i = 0; i < n->value->u.object.length; i++)
+		if(idx >= 0 && (idx < v->u.array.length))
 		{
-			if(strcmp(n->value->u.object.values[i].name, name) == 0)
-			{
-				v = n->value->u.object.values[i].value;
-				if(v && (v->type == JSON_ARRAY))
-				{
-					if(idx >= 0 && (idx < v->u.array.length))
-					{
-						e = v->u.array.values[idx];
-						if(e && (e->type == JSON_INTEGER))
-							return (u16_t)e->u.integer;
-					}
-				}
-			}
+			e = v->u.array.values[idx];
+			if(e && (e->type == JSON_INTEGER))
+				return (u16_t)e->u.integer;
 		}
 	}
 	return def;
@@ -461,25 +263,14 @@ u16_t dt_read_array_u16(struct dtnode_t * n, const char * name, int idx, u16_t d
 u32_t dt_read_array_u32(struct dtnode_t * n, const char * name, int idx, u32_t def)
 {
 	struct json_value_t * v, * e;
-	int i;
 
-	if(n && n->value && (n->value->type == JSON_OBJECT))
+	if(n && (v = json_object_lookup(n->value, name, JSON_ARRAY)))
 	{
-		for(i = 0; i < n->value->u.object.length; i++)
+		if(idx >= 0 && (idx < v->u.array.length))
 		{
-			if(strcmp(n->value->u.object.values[i].name, name) == 0)
-			{
-				v = n->value->u.object.values[i].value;
-				if(v && (v->type == JSON_ARRAY))
-				{
-					if(idx >= 0 && (idx < v->u.array.length))
-					{
-						e = v->u.array.values[idx];
-						if(e && (e->type == JSON_INTEGER))
-							return (u32_t)e->u.integer;
-					}
-				}
-			}
+			e = v->u.array.values[idx];
+			if(e && (e->type == JSON_INTEGER))
+				return (u32_t)e->u.integer;
 		}
 	}
 	return def;
@@ -488,25 +279,14 @@ u32_t dt_read_array_u32(struct dtnode_t * n, const char * name, int idx, u32_t d
 u64_t dt_read_array_u64(struct dtnode_t * n, const char * name, int idx, u64_t def)
 {
 	struct json_value_t * v, * e;
-	int i;
 
-	if(n && n->value && (n->value->type == JSON_OBJECT))
+	if(n && (v = json_object_lookup(n->value, name, JSON_ARRAY)))
 	{
-		for(i = 0; i < n->value->u.object.length; i++)
+		if(idx >= 0 && (idx < v->u.array.length))
 		{
-			if(strcmp(n->value->u.object.values[i].name, name) == 0)
-			{
-				v = n->value->u.object.values[i].value;
-				if(v && (v->type == JSON_ARRAY))
-				{
-					if(idx >= 0 && (idx < v->u.array.length))
-					{
-						e = v->u.array.values[idx];
-						if(e && (e->type == JSON_INTEGER))
-							return (u64_t)e->u.integer;
-					}
-				}
-			}
+			e = v->u.array.values[idx];
+			if(e && (e->type == JSON_INTEGER))
+				return (u64_t)e->u.integer;
 		}
 	}
 	return def;
@@ -515,29 +295,18 @@ u64_t dt_read_array_u64(struct dtnode_t * n, const char * name, int idx, u64_t d
 struct dtnode_t * dt_read_array_object(struct dtnode_t * n, const char * name, int idx, struct dtnode_t * o)
 {
 	struct json_value_t * v, * e;
-	int i;
 
-	if(o && n && n->value && (n->value->type == JSON_OBJECT))
+	if(o && n && (v = json_object_lookup(n->value, name, JSON_ARRAY)))
 	{
-		for(i = 0; i < n->value->u.object.length; i++)
+		if(idx >= 0 && (idx < v->u.array.length))
 		{
-			if(strcmp(n->value->u.object.values[i].name, name) == 0)
+			e = v->u.array.values[idx];
+			if(e && (e->type == JSON_OBJECT))
 			{
-				v = n->value->u.object.values[i].value;
-				if(v && (v->type == JSON_ARRAY))
-				{
-					if(idx >= 0 && (idx < v->u.array.length))
-					{
-						e = v->u.array.values[idx];
-						if(e && (e->type == JSON_OBJECT))
-						{
-							o->name = 0;
-							o->addr = 0;
-							o->value = e;
-							return o;
-						}
-					}
-				}
+				o->name = 0;
+				o->addr = 0;
+				o->value = e;
+				return o;
 			}
 		}
 	}
@@ -80,22 +80,47 @@ struct profiler_t * profiler_search(const char * name)
 	return NULL;
 }
 
+static const char * __profiler_event_name[PROFILER_EVENT_MAX] = {
+	"cycles",
+	"instructions",
+	"cache-references",
+	"cache-misses",
+	"branches",
+	"branch-misses",
+};
+
+static inline uint64_t profiler_total(struct profiler_t * p, int event)
+{
+	int i = __builtin_ctz(event);
+	return p->cend[i] - p->cbegin[i];
+}
+
+static inline int profiler_has(struct profiler_t * p, int event)
+{
+	return ((p->event & event) == event) ? 1 : 0;
+}
+
+static void profiler_ratio(const char * name, uint64_t a, uint64_t b)
+{
+	if(b > 0)
+		printf("    %-16s %.3f\r\n", name, (double)a / (double)b);
+}
+
 void profiler_snap(const char * name, int event, int data)
 {
 	struct profiler_t * p;
 	irq_flags_t flags;
 	uint32_t index;
+	int i;
 
 	p = profiler_search(name);
 	if(p)
 	{
-		if(event == 0)
+		p->end = ktime_to_ns(ktime_get());
+		for(i = 0; i < PROFILER_EVENT_MAX; i++)
 		{
-			p->end = ktime_to_ns(ktime_get());
-		}
-		else
-		{
-			p->end = cpu_profiler_read(p->event, p->data);
+			if(p->event & (1 << i))
+				p->cend[i] = cpu_profiler_read(1 << i, p->data);
 		}
 		p->count++;
 	}
@@ -108,16 +133,20 @@ void profiler_snap(const char * name, int event, int data)
 		index = string_hash(name) % CONFIG_PROFILER_HASH_SIZE;
 		init_hlist_node(&p->node);
 		p->name = strdup(name);
-		p->event = event;
+		p->event = event & PROFILER_EVENT_ALL;
 		p->data = data;
-		if(event == 0)
-		{
-			p->end = p->begin = ktime_to_ns(ktime_get());
-		}
-		else
+		p->end = p->begin = ktime_to_ns(ktime_get());
+		for(i = 0; i < PROFILER_EVENT_MAX; i++)
 		{
-			cpu_profiler_start(p->event, p->data);
-			p->end = p->begin = cpu_profiler_read(p->event, p->data);
+			if(p->event & (1 << i))
+			{
+				cpu_profiler_start(1 << i, p->data);
+				p->cend[i] = p->cbegin[i] = cpu_profiler_read(1 << i, p->data);
+			}
+			else
+			{
+				p->cend[i] = p->cbegin[i] = 0;
+			}
 		}
 		p->count = 1;
 		spin_lock_irqsave(&__profiler_lock, flags);
@@ -130,20 +159,31 @@ void profiler_dump(void)
 {
 	struct profiler_t * p;
 	struct hlist_node * n;
-	int i;
+	int i, j;
 
 	printf("Profiler analysis:\r\n");
 	for(i = 0; i < ARRAY_SIZE(__profiler_hash); i++)
 	{
 		hlist_for_each_entry_safe(p, n, &__profiler_hash[i], node)
 		{
-			if(p->event == 0)
+			printf("[%s] %lld, %lld, [%lld ~ %lld]\r\n", p->name, p->count, (p->end - p->begin) / ((p->count > 1) ? (p->count - 1) : 1), p->begin, p->end);
+			if(p->event != PROFILER_EVENT_TIME)
 			{
-				printf("[%s] %lld, %lld, [%lld ~ %lld]\r\n", p->name, p->count, (p->end - p->begin) / ((p->count > 1) ? (p->count - 1) : 1), p->begin, p->end);
-			}
-			else
-			{
-				printf("[%s] %lld, %lld, [%lld ~ %lld]\r\n", p->name, p->count, (p->end - p->begin) / ((p->count > 1) ? (p->count - 1) : 1), p->begin, p->end);
+				for(j = 0; j < PROFILER_EVENT_MAX; j++)
+				{
+					if(p->event & (1 << j))
+						printf("    %-16s %lld\r\n", __profiler_event_name[j], profiler_total(p, 1 << j) / ((p->count > 1) ? (p->count - 1) : 1));
+				}
+				if(profiler_has(p, PROFILER_EVENT_CYCLE | PROFILER_EVENT_INSTRUCTION))
+					profiler_ratio("ipc", profiler_total(p, PROFILER_EVENT_INSTRUCTION), profiler_total(p, PROFILER_EVENT_CYCLE));
+				if(profiler_has(p, PROFILER_EVENT_CACHE_ACCESS | PROFILER_EVENT_CACHE_MISS))
+					profiler_ratio("cache-miss-rate", profiler_total(p, PROFILER_EVENT_CACHE_MISS), profiler_total(p, PROFILER_EVENT_CACHE_ACCESS));
+				if(profiler_has(p, PROFILER_EVENT_BRANCH | PROFILER_EVENT_BRANCH_MISS))
+					profiler_ratio("branch-miss-rate", profiler_total(p, PROFILER_EVENT_BRANCH_MISS), profiler_total(p, PROFILER_EVENT_BRANCH));
+				if(profiler_has(p, PROFILER_EVENT_INSTRUCTION | PROFILER_EVENT_CACHE_MISS))
+					profiler_ratio("cache-mpki", profiler_total(p, PROFILER_EVENT_CACHE_MISS) * 1000, profiler_total(p, PROFILER_EVENT_INSTRUCTION));
+				if(profiler_has(p, PROFILER_EVENT_INSTRUCTION | PROFILER_EVENT_BRANCH_MISS))
+					profiler_ratio("branch-mpki", profiler_total(p, PROFILER_EVENT_BRANCH_MISS) * 1000, profiler_total(p, PROFILER_EVENT_INSTRUCTION));
 			}
 		}
 	}
@@ -154,7 +194,7 @@ void profiler_reset(void)
 	struct profiler_t * p;
 	struct hlist_node * n;
 	irq_flags_t flags;
-	int i;
+	int i, j;
 
 	for(i = 0; i < ARRAY_SIZE(__profiler_hash); i++)
 	{
@@ -162,8 +202,11 @@ void profiler_reset(void)
 		{
 			spin_lock_irqsave(&__profiler_lock, flags);
 			hlist_del(&p->node);
-			if(p->event != 0)
-				cpu_profiler_stop(p->event, p->data);
+			for(j = 0; j < PROFILER_EVENT_MAX; j++)
+			{
+				if(p->event & (1 << j))
+					cpu_profiler_stop(1 << j, p->data);
+			}
 			free(p->name);
 			free(p);
 			spin_unlock_irqrestore(&__profiler_lock, flags);
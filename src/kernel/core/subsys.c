@@ -45,7 +45,8 @@ static void subsys_init_romdisk(void)
 
 static void subsys_init_rootfs(void)
 {
-	vfs_mount("romdisk.0", "/", "cpio", MOUNT_RDONLY);
+	if(vfs_mount("romdisk.0", "/", "lz4fs", MOUNT_RDONLY) != 0)
+		vfs_mount("romdisk.0", "/", "cpio", MOUNT_RDONLY);
 	vfs_mount(NULL, "/sys", "sys", MOUNT_RDONLY);
 	vfs_mount(NULL, "/tmp", "ram", MOUNT_RW);
 	vfs_mount(NULL, "/storage" , "ram", MOUNT_RW);
@@ -46,75 +46,225 @@ struct cpio_newc_header_t {
 	u8_t c_check[8];
 } __attribute__ ((packed));
 
-static bool_t get_next_token(const char * path, const char * prefix, char * result)
+/*
+ * Directory index of the archive, built once at mount time. Every entry is hashed
+ * by its path relative to the root of the archive, and every directory keeps
+ * its children in archive order, so lookup and readdir never scan the archive.
+ * Directories only implied by the paths of their children are added as well.
+ */
+#define CPIO_HASH_SIZE		(256)
+
+struct cpio_entry_t {
+	struct hlist_node node;
+	const char * path;
+	const char * name;
+	u32_t mode;
+	u32_t mtime;
+	u32_t size;
+	u64_t offset;
+	struct cpio_entry_t ** children;
+	int nchildren;
+	int maxchildren;
+};
+
+struct cpio_index_t {
+	struct hlist_head hash[CPIO_HASH_SIZE];
+	struct cpio_entry_t * root;
+};
+
+static u32_t cpio_hash(const char * path, int len)
 {
-	const char * p, * q;
-	int l;
+	u32_t val = 0;
 
-	if(!path || !prefix || !result)
-		return FALSE;
+	while(len-- > 0)
+		val = ((val << 5) + val) + *path++;
+	return val & (CPIO_HASH_SIZE - 1);
+}
 
-	if(*path == '/')
-		path++;
+static struct cpio_entry_t * cpio_index_find(struct cpio_index_t * idx, const char * path, int len)
+{
+	struct cpio_entry_t * e;
+	struct hlist_node * pos;
 
-	if(*prefix == '/')
-		prefix++;
+	hlist_for_each(pos, &idx->hash[cpio_hash(path, len)])
+	{
+		e = hlist_entry(pos, struct cpio_entry_t, node);
+		if((strncmp(e->path, path, len) == 0) && (e->path[len] == '\0'))
+			return e;
+	}
+	return NULL;
+}
 
-	l = strlen(prefix);
-	if(strncmp(path, prefix, l) != 0)
-		return FALSE;
+static struct cpio_entry_t * cpio_index_add(struct cpio_index_t * idx, const char * path, int len)
+{
+	struct cpio_entry_t * e, * parent = NULL, ** children;
+	char * p;
+	int i;
 
-	p = &path[l];
-	if(*p == '\0')
-		return FALSE;
-	if(*p == '/')
-		p++;
-	if(*p == '\0')
-		return FALSE;
+	e = cpio_index_find(idx, path, len);
+	if(e)
+		return e;
 
-	q = strchr(p, '/');
-	if(q)
+	if(len > 0)
 	{
-		if (*(q + 1) != '\0')
-			return FALSE;
-		l = q - p;
+		for(i = len - 1; (i > 0) && (path[i] != '/'); i--);
+		parent = cpio_index_add(idx, path, i);
+		if(!parent)
+			return NULL;
+		if(parent->nchildren >= parent->maxchildren)
+		{
+			children = realloc(parent->children, sizeof(struct cpio_entry_t *) * (parent->maxchildren + 16));
+			if(!children)
+				return NULL;
+			parent->children = children;
+			parent->maxchildren += 16;
+		}
 	}
-	else
+
+	e = malloc(sizeof(struct cpio_entry_t) + len + 1);
+	if(!e)
+		return NULL;
+	p = (char *)(e + 1);
+	memcpy(p, path, len);
+	p[len] = '\0';
+	e->path = p;
+	e->name = strrchr(p, '/') ? strrchr(p, '/') + 1 : p;
+	e->mode = 0040755;
+	e->mtime = 0;
+	e->size = 0;
+	e->offset = 0;
+	e->children = NULL;
+	e->nchildren = 0;
+	e->maxchildren = 0;
+	hlist_add_head(&e->node, &idx->hash[cpio_hash(path, len)]);
+	if(parent)
+		parent->children[parent->nchildren++] = e;
+	return e;
+}
+
+static void cpio_index_free(struct cpio_index_t * idx)
+{
+	struct cpio_entry_t * e;
+	struct hlist_node * pos, * n;
+	int i;
+
+	for(i = 0; i < CPIO_HASH_SIZE; i++)
 	{
-		l = strlen(p);
+		hlist_for_each_safe(pos, n, &idx->hash[i])
+		{
+			e = hlist_entry(pos, struct cpio_entry_t, node);
+			hlist_del(&e->node);
+			if(e->children)
+				free(e->children);
+			free(e);
+		}
 	}
-	memcpy(result, p, l);
-	result[l] = '\0';
-
-	return TRUE;
+	free(idx);
 }
 
-static bool_t check_path(const char * path, const char * prefix, const char * name)
+static struct cpio_index_t * cpio_index_build(void * dev)
 {
-	int l;
+	struct cpio_newc_header_t header;
+	struct cpio_index_t * idx;
+	struct cpio_entry_t * e;
+	char path[VFS_MAX_PATH];
+	u32_t size, name_size, mode, mtime;
+	u64_t off = 0, rd;
+	char buf[9];
+	int i, len;
+
+	idx = malloc(sizeof(struct cpio_index_t));
+	if(!idx)
+		return NULL;
+	for(i = 0; i < CPIO_HASH_SIZE; i++)
+		init_hlist_head(&idx->hash[i]);
+	idx->root = cpio_index_add(idx, "", 0);
+	if(!idx->root)
+	{
+		cpio_index_free(idx);
+		return NULL;
+	}
 
-	if(!path || !prefix || !name)
-		return FALSE;
+	while(1)
+	{
+		rd = block_read(dev, (u8_t *)&header, off, sizeof(struct cpio_newc_header_t));
+		if(rd != sizeof(struct cpio_newc_header_t))
+			break;
+
+		if(strncmp((const char *)header.c_magic, "070701", 6) != 0)
+			break;
+
+		buf[8] = '\0';
+
+		memcpy(buf, &header.c_filesize, 8);
+		size = strtoul((const char *)buf, NULL, 16);
+
+		memcpy(buf, &header.c_namesize, 8);
+		name_size = strtoul((const char *)buf, NULL, 16);
+
+		memcpy(buf, &header.c_mode, 8);
+		mode = strtoul((const char *)buf, NULL, 16);
+
+		memcpy(buf, &header.c_mtime, 8);
+		mtime = strtoul((const char *)buf, NULL, 16);
 
-	if(path[0] == '/')
-		path++;
+		if((name_size == 0) || (name_size > sizeof(path)))
+			break;
 
-	if(prefix[0] == '/')
-		prefix++;
+		rd = block_read(dev, (u8_t *)path, off + sizeof(struct cpio_newc_header_t), name_size);
+		if(rd != name_size)
+			break;
+		path[name_size - 1] = '\0';
 
-	l = strlen(prefix);
-	if(l && (strncmp(path, prefix, l) != 0))
-		return FALSE;
+		if((size == 0) && (mode == 0) && (name_size == 11) && (strncmp(path, "TRAILER!!!", 10) == 0))
+			break;
 
-	path += l;
+		off += sizeof(struct cpio_newc_header_t);
+		off += (((name_size + 1) & ~3) + 2);
 
-	if(path[0] == '/')
-		path++;
+		len = strlen(path);
+		while((len > 0) && (path[len - 1] == '/'))
+			len--;
 
-	if(strcmp(path, name) != 0)
-		return FALSE;
+		if((path[0] != '.') && (path[0] != '/') && (len > 0))
+		{
+			e = cpio_index_add(idx, path, len);
+			if(!e)
+			{
+				cpio_index_free(idx);
+				return NULL;
+			}
+			if(e->offset == 0)
+			{
+				e->mode = mode;
+				e->mtime = mtime;
+				e->size = size;
+				e->offset = off;
+			}
+		}
 
-	return TRUE;
+		off += size;
+		off = (off + 3) & ~0x3;
+	}
+
+	return idx;
+}
+
+static struct cpio_entry_t * cpio_index_lookup(struct vfs_node_t * dn, const char * name)
+{
+	struct cpio_index_t * idx = (struct cpio_index_t *)dn->v_mount->m_data;
+	char path[VFS_MAX_PATH];
+	const char * p = dn->v_path;
+
+	while(*p == '/')
+		p++;
+	if(!name)
+		return cpio_index_find(idx, p, strlen(p));
+	if(*p == '\0')
+		return cpio_index_find(idx, name, strlen(name));
+	if(snprintf(path, sizeof(path), "%s/%s", p, name) >= sizeof(path))
+		return NULL;
+	return cpio_index_find(idx, path, strlen(path));
 }
 
 static int cpio_mount(struct vfs_mount_t * m, const char * dev, u32_t flags)
@@ -137,13 +287,17 @@ static int cpio_mount(struct vfs_mount_t * m, const char * dev, u32_t flags)
 
 	m->m_flags = MOUNT_RDONLY;
 	m->m_root->v_data = NULL;
-	m->m_data = NULL;
+	m->m_data = cpio_index_build(m->m_dev);
+	if(!m->m_data)
+		return -1;
 
 	return 0;
 }
 
 static int cpio_unmount(struct vfs_mount_t * m)
 {
+	if(m->m_data)
+		cpio_index_free((struct cpio_index_t *)m->m_data);
 	m->m_data = NULL;
 	return 0;
 }
@@ -201,57 +355,14 @@ static int cpio_sync(struct vfs_node_t * n)
 
 static int cpio_readdir(struct vfs_node_t * dn, s64_t off, struct vfs_dirent_t * d)
 {
-	struct cpio_newc_header_t header;
-	char path[VFS_MAX_PATH];
-	char name[VFS_MAX_NAME];
-	u32_t size, name_size, mode;
-	u64_t toff = 0, rd;
-	char buf[9];
-	int i = 0;
-
-	while(1)
-	{
-		rd = block_read(dn->v_mount->m_dev, (u8_t *)&header, toff, sizeof(struct cpio_newc_header_t));
-		if(rd != sizeof(struct cpio_newc_header_t))
-			return -1;
-
-		if(strncmp((const char *)&header.c_magic, "070701", 6) != 0)
-			return -1;
-
-		buf[8] = '\0';
-
-		memcpy(buf, &header.c_filesize, 8);
-		size = strtoul((const char *)buf, NULL, 16);
+	struct cpio_entry_t * dir, * e;
+	u32_t mode;
 
-		memcpy(buf, &header.c_namesize, 8);
-		name_size = strtoul((const char *)buf, NULL, 16);
-
-		memcpy(buf, &header.c_mode, 8);
-		mode = strtoul((const char *)buf, NULL, 16);
-
-		rd = block_read(dn->v_mount->m_dev, (u8_t *)path, toff + sizeof(struct cpio_newc_header_t), name_size);
-		if(!rd)
-			return -1;
-
-		if((size == 0) && (mode == 0) && (name_size == 11) && (strncmp(path, "TRAILER!!!", 10) == 0))
-			return -1;
-
-		toff += sizeof(struct cpio_newc_header_t);
-		toff += (((name_size + 1) & ~3) + 2) + size;
-		toff = (toff + 3) & ~3;
-
-		if(path[0] == '.')
-			continue;
-
-		if(!get_next_token(path, dn->v_path, name))
-			continue;
-
-		if(i++ == off)
-		{
-			toff = 0;
-			break;
-		}
-	}
+	dir = cpio_index_lookup(dn, NULL);
+	if(!dir || (off < 0) || (off >= dir->nchildren))
+		return -1;
+	e = dir->children[off];
+	mode = e->mode;
 
 	if((mode & 00170000) == 0140000)
 	{
@@ -286,7 +397,7 @@ static int cpio_readdir(struct vfs_node_t * dn, s64_t off, struct vfs_dirent_t *
 		d->d_type = VDT_REG;
 	}
 
-	strlcpy(d->d_name, name, sizeof(d->d_name));
+	strlcpy(d->d_name, e->name, sizeof(d->d_name));
 	d->d_off = off;
 	d->d_reclen = 1;
 
@@ -295,49 +406,14 @@ static int cpio_readdir(struct vfs_node_t * dn, s64_t off, struct vfs_dirent_t *
 
 static int cpio_lookup(struct vfs_node_t * dn, const char * name, struct vfs_node_t * n)
 {
-	struct cpio_newc_header_t header;
-	char path[VFS_MAX_PATH];
-	u64_t off = 0, rd;
-	u32_t size, name_size, mode, mtime;
-	u8_t buf[9];
-
-	while(1)
-	{
-		rd = block_read(dn->v_mount->m_dev, (u8_t *)&header, off, sizeof(struct cpio_newc_header_t));
-		if(rd != sizeof(struct cpio_newc_header_t))
-			return -1;
-
-		if(strncmp((const char *)header.c_magic, "070701", 6) != 0)
-			return -1;
-
-		buf[8] = '\0';
-
-		memcpy(buf, &header.c_filesize, 8);
-		size = strtoul((const char *)buf, NULL, 16);
-
-		memcpy(buf, &header.c_namesize, 8);
-		name_size = strtoul((const char *)buf, NULL, 16);
+	struct cpio_entry_t * e;
+	u32_t mode, mtime;
 
-		memcpy(buf, &header.c_mode, 8);
-		mode = strtoul((const char *)buf, NULL, 16);
-
-		memcpy(buf, &header.c_mtime, 8);
-		mtime = strtoul((const char *)buf, NULL, 16);
-
-		rd = block_read(dn->v_mount->m_dev, (u8_t *)path, off + sizeof(struct cpio_newc_header_t), name_size);
-		if(!rd)
-			return -1;
-
-		if((size == 0) && (mode == 0) && (name_size == 11) && (strncmp(path, "TRAILER!!!", 10) == 0))
-			return -1;
-
-		if((path[0] != '.') && check_path(path, dn->v_path, name))
-			break;
-
-		off += sizeof(struct cpio_newc_header_t);
-		off += (((name_size + 1) & ~3) + 2) + size;
-		off = (off + 3) & ~0x3;
-	}
+	e = cpio_index_lookup(dn, name);
+	if(!e)
+		return -1;
+	mode = e->mode;
+	mtime = e->mtime;
 
 	n->v_atime = mtime;
 	n->v_mtime = mtime;
@@ -393,11 +469,8 @@ static int cpio_lookup(struct vfs_node_t * dn, const char * name, struct vfs_nod
 	n->v_mode |= (mode & 00004) ? S_IROTH : 0;
 	n->v_mode |= (mode & 00002) ? S_IWOTH : 0;
 	n->v_mode |= (mode & 00001) ? S_IXOTH : 0;
-	n->v_size = size;
-
-	off += sizeof(struct cpio_newc_header_t);
-	off += (((name_size + 1) & ~3) + 2);
-	n->v_data = (void *)((unsigned long)off);
+	n->v_size = e->size;
+	n->v_data = (void *)((unsigned long)e->offset);
 
 	return 0;
 }
@@ -0,0 +1,517 @@
+/*
+ * kernel/vfs/lz4fs/lz4fs.c
+ *
+ * Copyright(c) 2007-2018 Jianjun Jiang <8192542@qq.com>
+ * Official site: http://xboot.org
+ * Mobile phone: +86-18665388956
+ * QQ: 8192542
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include <xboot.h>
+#include <lz4.h>
+#include <vfs/vfs.h>
+
+/*
+ * Read only image with per block lz4 compression, made by tools/mklz4fs.
+ *
+ * The image starts with a superblock, followed by a central index: the inode
+ * table, the block table and the name table. Inode 0 is the root directory,
+ * the children of a directory are contiguous inodes sorted by name, and the
+ * data of a file is split into fixed size blocks which are compressed one by
+ * one, so any offset can be read by inflating only the blocks it touches.
+ * All fields are little endian.
+ */
+#define LZ4FS_MAGIC				"LZ4FS\0\0\0"
+#define LZ4FS_VERSION			(1)
+#define LZ4FS_BLOCK_RAW			(0x80000000)
+#define LZ4FS_CACHE_SLOTS		(4)
+
+struct lz4fs_super_t {
+	u8_t magic[8];
+	u32_t version;
+	u32_t blkshift;
+	u32_t ninodes;
+	u32_t inode_offset;
+	u32_t nblocks;
+	u32_t block_offset;
+	u32_t name_offset;
+	u32_t size;
+	u32_t reserved[6];
+} __attribute__ ((packed));
+
+struct lz4fs_inode_t {
+	u32_t mode;
+	u32_t mtime;
+	u32_t size;
+	u32_t name;
+	u32_t namelen;
+	u32_t first;
+	u32_t count;
+	u32_t reserved;
+} __attribute__ ((packed));
+
+struct lz4fs_block_t {
+	u32_t offset;
+	u32_t csize;
+} __attribute__ ((packed));
+
+struct lz4fs_cache_t {
+	u32_t blkno;
+	u32_t length;
+	u32_t stamp;
+	u8_t * buf;
+};
+
+struct lz4fs_t {
+	struct lz4fs_super_t super;
+	struct lz4fs_cache_t cache[LZ4FS_CACHE_SLOTS];
+	struct mutex_t lock;
+	u32_t blksz;
+	u32_t stamp;
+	u8_t * cbuf;
+};
+
+static int lz4fs_read_inode(struct vfs_mount_t * m, u32_t ino, struct lz4fs_inode_t * inode)
+{
+	struct lz4fs_t * fs = (struct lz4fs_t *)m->m_data;
+	u64_t off;
+
+	if(ino >= fs->super.ninodes)
+		return -1;
+	off = fs->super.inode_offset + (u64_t)ino * sizeof(struct lz4fs_inode_t);
+	if(block_read(m->m_dev, (u8_t *)inode, off, sizeof(struct lz4fs_inode_t)) != sizeof(struct lz4fs_inode_t))
+		return -1;
+	inode->mode = le32_to_cpu(inode->mode);
+	inode->mtime = le32_to_cpu(inode->mtime);
+	inode->size = le32_to_cpu(inode->size);
+	inode->name = le32_to_cpu(inode->name);
+	inode->namelen = le32_to_cpu(inode->namelen);
+	inode->first = le32_to_cpu(inode->first);
+	inode->count = le32_to_cpu(inode->count);
+	return 0;
+}
+
+static int lz4fs_read_name(struct vfs_mount_t * m, struct lz4fs_inode_t * inode, char * name, int len)
+{
+	struct lz4fs_t * fs = (struct lz4fs_t *)m->m_data;
+
+	if(inode->namelen >= len)
+		return -1;
+	if(block_read(m->m_dev, (u8_t *)name, fs->super.name_offset + inode->name, inode->namelen) != inode->namelen)
+		return -1;
+	name[inode->namelen] = '\0';
+	return 0;
+}
+
+/*
+ * Inflate one block through the cache, the least recently used slot is recycled on a miss.
+ */
+static struct lz4fs_cache_t * lz4fs_cache_get(struct vfs_mount_t * m, u32_t blkno, u32_t length)
+{
+	struct lz4fs_t * fs = (struct lz4fs_t *)m->m_data;
+	struct lz4fs_cache_t * c = &fs->cache[0];
+	struct lz4fs_block_t b;
+	u32_t csize;
+	int i;
+
+	for(i = 0; i < LZ4FS_CACHE_SLOTS; i++)
+	{
+		if((fs->cache[i].length > 0) && (fs->cache[i].blkno == blkno))
+		{
+			fs->cache[i].stamp = ++fs->stamp;
+			return &fs->cache[i];
+		}
+		if(fs->cache[i].stamp < c->stamp)
+			c = &fs->cache[i];
+	}
+
+	if(blkno >= fs->super.nblocks)
+		return NULL;
+	if(block_read(m->m_dev, (u8_t *)&b, fs->super.block_offset + (u64_t)blkno * sizeof(struct lz4fs_block_t), sizeof(struct lz4fs_block_t)) != sizeof(struct lz4fs_block_t))
+		return NULL;
+	b.offset = le32_to_cpu(b.offset);
+	b.csize = le32_to_cpu(b.csize);
+	csize = b.csize & ~LZ4FS_BLOCK_RAW;
+
+	c->length = 0;
+	if(b.csize & LZ4FS_BLOCK_RAW)
+	{
+		if((csize != length) || (block_read(m->m_dev, c->buf, b.offset, csize) != csize))
+			return NULL;
+	}
+	else
+	{
+		if((csize > LZ4_COMPRESSBOUND(fs->blksz)) || (block_read(m->m_dev, fs->cbuf, b.offset, csize) != csize))
+			return NULL;
+		if(LZ4_decompress_safe((const char *)fs->cbuf, (char *)c->buf, csize, fs->blksz) != length)
+			return NULL;
+	}
+	c->blkno = blkno;
+	c->length = length;
+	c->stamp = ++fs->stamp;
+	return c;
+}
+
+static int lz4fs_mount(struct vfs_mount_t * m, const char * dev, u32_t flags)
+{
+	struct lz4fs_super_t super;
+	struct lz4fs_t * fs;
+	int i;
+
+	if(dev == NULL)
+		return -1;
+
+	if(block_capacity(m->m_dev) <= sizeof(struct lz4fs_super_t))
+		return -1;
+
+	if(block_read(m->m_dev, (u8_t *)(&super), 0, sizeof(struct lz4fs_super_t)) != sizeof(struct lz4fs_super_t))
+		return -1;
+
+	if(memcmp(super.magic, LZ4FS_MAGIC, sizeof(super.magic)) != 0)
+		return -1;
+	super.version = le32_to_cpu(super.version);
+	super.blkshift = le32_to_cpu(super.blkshift);
+	super.ninodes = le32_to_cpu(super.ninodes);
+	super.inode_offset = le32_to_cpu(super.inode_offset);
+	super.nblocks = le32_to_cpu(super.nblocks);
+	super.block_offset = le32_to_cpu(super.block_offset);
+	super.name_offset = le32_to_cpu(super.name_offset);
+	super.size = le32_to_cpu(super.size);
+	if((super.version != LZ4FS_VERSION) || (super.blkshift < 9) || (super.blkshift > 20) || (super.ninodes == 0))
+		return -1;
+	if(block_capacity(m->m_dev) < super.size)
+		return -1;
+
+	fs = calloc(1, sizeof(struct lz4fs_t));
+	if(!fs)
+		return -1;
+	memcpy(&fs->super, &super, sizeof(struct lz4fs_super_t));
+	mutex_init(&fs->lock);
+	fs->blksz = 1 << super.blkshift;
+	fs->cbuf = malloc(LZ4_COMPRESSBOUND(fs->blksz));
+	for(i = 0; i < LZ4FS_CACHE_SLOTS; i++)
+		fs->cache[i].buf = malloc(fs->blksz);
+	for(i = 0; i < LZ4FS_CACHE_SLOTS; i++)
+	{
+		if(!fs->cache[i].buf)
+			break;
+	}
+	if(!fs->cbuf || (i < LZ4FS_CACHE_SLOTS))
+	{
+		for(i = 0; i < LZ4FS_CACHE_SLOTS; i++)
+			free(fs->cache[i].buf);
+		free(fs->cbuf);
+		free(fs);
+		return -1;
+	}
+
+	m->m_flags = MOUNT_RDONLY;
+	m->m_root->v_data = (void *)((unsigned long)0);
+	m->m_data = fs;
+
+	return 0;
+}
+
+static int lz4fs_unmount(struct vfs_mount_t * m)
+{
+	struct lz4fs_t * fs = (struct lz4fs_t *)m->m_data;
+	int i;
+
+	if(fs)
+	{
+		for(i = 0; i < LZ4FS_CACHE_SLOTS; i++)
+			free(fs->cache[i].buf);
+		free(fs->cbuf);
+		free(fs);
+	}
+	m->m_data = NULL;
+	return 0;
+}
+
+static int lz4fs_msync(struct vfs_mount_t * m)
+{
+	return 0;
+}
+
+static int lz4fs_vget(struct vfs_mount_t * m, struct vfs_node_t * n)
+{
+	return 0;
+}
+
+static int lz4fs_vput(struct vfs_mount_t * m, struct vfs_node_t * n)
+{
+	return 0;
+}
+
+static u64_t lz4fs_read(struct vfs_node_t * n, s64_t off, void * buf, u64_t len)
+{
+	struct lz4fs_t * fs = (struct lz4fs_t *)n->v_mount->m_data;
+	struct lz4fs_inode_t inode;
+	struct lz4fs_cache_t * c;
+	u64_t pos, sz = 0;
+	u32_t blkno, boff, length, count;
+
+	if(n->v_type != VNT_REG)
+		return 0;
+
+	if(off >= n->v_size)
+		return 0;
+
+	if(lz4fs_read_inode(n->v_mount, (u32_t)((unsigned long)n->v_data), &inode) < 0)
+		return 0;
+
+	if((n->v_size - off) < len)
+		len = n->v_size - off;
+
+	mutex_lock(&fs->lock);
+	while(sz < len)
+	{
+		pos = off + sz;
+		blkno = pos >> fs->super.blkshift;
+		boff = pos & (fs->blksz - 1);
+		if(blkno >= inode.count)
+			break;
+		length = inode.size - (blkno << fs->super.blkshift);
+		if(length > fs->blksz)
+			length = fs->blksz;
+		c = lz4fs_cache_get(n->v_mount, inode.first + blkno, length);
+		if(!c)
+			break;
+		count = length - boff;
+		if(count > len - sz)
+			count = len - sz;
+		memcpy((u8_t *)buf + sz, c->buf + boff, count);
+		sz += count;
+	}
+	mutex_unlock(&fs->lock);
+
+	return sz;
+}
+
+static u64_t lz4fs_write(struct vfs_node_t * n, s64_t off, void * buf, u64_t len)
+{
+	return 0;
+}
+
+static int lz4fs_truncate(struct vfs_node_t * n, s64_t off)
+{
+	return -1;
+}
+
+static int lz4fs_sync(struct vfs_node_t * n)
+{
+	return 0;
+}
+
+static int lz4fs_readdir(struct vfs_node_t * dn, s64_t off, struct vfs_dirent_t * d)
+{
+	struct lz4fs_inode_t dir, inode;
+
+	if(lz4fs_read_inode(dn->v_mount, (u32_t)((unsigned long)dn->v_data), &dir) < 0)
+		return -1;
+	if(((dir.mode & 00170000) != 0040000) || (off < 0) || (off >= dir.count))
+		return -1;
+	if(lz4fs_read_inode(dn->v_mount, dir.first + off, &inode) < 0)
+		return -1;
+	if(lz4fs_read_name(dn->v_mount, &inode, d->d_name, sizeof(d->d_name)) < 0)
+		return -1;
+
+	if((inode.mode & 00170000) == 0140000)
+		d->d_type = VDT_SOCK;
+	else if((inode.mode & 00170000) == 0120000)
+		d->d_type = VDT_LNK;
+	else if((inode.mode & 00170000) == 0100000)
+		d->d_type = VDT_REG;
+	else if((inode.mode & 00170000) == 0060000)
+		d->d_type = VDT_BLK;
+	else if((inode.mode & 00170000) == 0040000)
+		d->d_type = VDT_DIR;
+	else if((inode.mode & 00170000) == 0020000)
+		d->d_type = VDT_CHR;
+	else if((inode.mode & 00170000) == 0010000)
+		d->d_type = VDT_FIFO;
+	else
+		d->d_type = VDT_REG;
+	d->d_off = off;
+	d->d_reclen = 1;
+
+	return 0;
+}
+
+static int lz4fs_lookup(struct vfs_node_t * dn, const char * name, struct vfs_node_t * n)
+{
+	struct lz4fs_inode_t dir, inode;
+	char buf[VFS_MAX_NAME];
+	u32_t lo, hi, mid, mode;
+	int r;
+
+	if(lz4fs_read_inode(dn->v_mount, (u32_t)((unsigned long)dn->v_data), &dir) < 0)
+		return -1;
+	if((dir.mode & 00170000) != 0040000)
+		return -1;
+
+	lo = dir.first;
+	hi = dir.first + dir.count;
+	while(lo < hi)
+	{
+		mid = lo + ((hi - lo) >> 1);
+		if(lz4fs_read_inode(dn->v_mount, mid, &inode) < 0)
+			return -1;
+		if(lz4fs_read_name(dn->v_mount, &inode, buf, sizeof(buf)) < 0)
+			return -1;
+		r = strcmp(name, buf);
+		if(r == 0)
+			break;
+		else if(r < 0)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	if(lo >= hi)
+		return -1;
+	mode = inode.mode;
+
+	n->v_atime = inode.mtime;
+	n->v_mtime = inode.mtime;
+	n->v_ctime = inode.mtime;
+	n->v_mode = 0;
+
+	if((mode & 00170000) == 0140000)
+	{
+		n->v_type = VNT_SOCK;
+		n->v_mode |= S_IFSOCK;
+	}
+	else if((mode & 00170000) == 0120000)
+	{
+		n->v_type = VNT_LNK;
+		n->v_mode |= S_IFLNK;
+	}
+	else if((mode & 00170000) == 0100000)
+	{
+		n->v_type = VNT_REG;
+		n->v_mode |= S_IFREG;
+	}
+	else if((mode & 00170000) == 0060000)
+	{
+		n->v_type = VNT_BLK;
+		n->v_mode |= S_IFBLK;
+	}
+	else if((mode & 00170000) == 0040000)
+	{
+		n->v_type = VNT_DIR;
+		n->v_mode |= S_IFDIR;
+	}
+	else if((mode & 00170000) == 0020000)
+	{
+		n->v_type = VNT_CHR;
+		n->v_mode |= S_IFCHR;
+	}
+	else if((mode & 00170000) == 0010000)
+	{
+		n->v_type = VNT_FIFO;
+		n->v_mode |= S_IFIFO;
+	}
+	else
+	{
+		n->v_type = VNT_REG;
+	}
+
+	n->v_mode |= (mode & 00400) ? S_IRUSR : 0;
+	n->v_mode |= (mode & 00200) ? S_IWUSR : 0;
+	n->v_mode |= (mode & 00100) ? S_IXUSR : 0;
+	n->v_mode |= (mode & 00040) ? S_IRGRP : 0;
+	n->v_mode |= (mode & 00020) ? S_IWGRP : 0;
+	n->v_mode |= (mode & 00010) ? S_IXGRP : 0;
+	n->v_mode |= (mode & 00004) ? S_IROTH : 0;
+	n->v_mode |= (mode & 00002) ? S_IWOTH : 0;
+	n->v_mode |= (mode & 00001) ? S_IXOTH : 0;
+	n->v_size = ((mode & 00170000) == 0040000) ? 0 : inode.size;
+	n->v_data = (void *)((unsigned long)mid);
+
+	return 0;
+}
+
+static int lz4fs_create(struct vfs_node_t * dn, const char * filename, u32_t mode)
+{
+	return -1;
+}
+
+static int lz4fs_remove(struct vfs_node_t * dn, struct vfs_node_t * n, const char * name)
+{
+	return -1;
+}
+
+static int lz4fs_rename(struct vfs_node_t * sn, const char * sname, struct vfs_node_t * n, struct vfs_node_t * dn, const char * dname)
+{
+	return -1;
+}
+
+static int lz4fs_mkdir(struct vfs_node_t * dn, const char * name, u32_t mode)
+{
+	return -1;
+}
+
+static int lz4fs_rmdir(struct vfs_node_t * dn, struct vfs_node_t * n, const char * name)
+{
+	return -1;
+}
+
+static int lz4fs_chmod(struct vfs_node_t * n, u32_t mode)
+{
+	return -1;
+}
+
+static struct filesystem_t lz4fs = {
+	.name		= "lz4fs",
+
+	.mount		= lz4fs_mount,
+	.unmount	= lz4fs_unmount,
+	.msync		= lz4fs_msync,
+	.vget		= lz4fs_vget,
+	.vput		= lz4fs_vput,
+
+	.read		= lz4fs_read,
+	.write		= lz4fs_write,
+	.truncate	= lz4fs_truncate,
+	.sync		= lz4fs_sync,
+	.readdir	= lz4fs_readdir,
+	.lookup		= lz4fs_lookup,
+	.create		= lz4fs_create,
+	.remove		= lz4fs_remove,
+	.rename		= lz4fs_rename,
+	.mkdir		= lz4fs_mkdir,
+	.rmdir		= lz4fs_rmdir,
+	.chmod		= lz4fs_chmod,
+};
+
+static __init void filesystem_lz4fs_init(void)
+{
+	register_filesystem(&lz4fs);
+}
+
+static __exit void filesystem_lz4fs_exit(void)
+{
+	unregister_filesystem(&lz4fs);
+}
+
+core_initcall(filesystem_lz4fs_init);
+core_exitcall(filesystem_lz4fs_exit);
@@ -94,83 +94,213 @@ struct tar_header_t
 	int8_t reserver[12];
 } __attribute__ ((packed));
 
-static bool_t get_next_token(const char * path, const char * perfix, char * result)
+/*
+ * Directory index of the archive, built once at mount time. Every entry is hashed
+ * by its path relative to the root of the archive, and every directory keeps
+ * its children in archive order, so lookup and readdir never scan the archive.
+ * Directories only implied by the paths of their children are added as well.
+ */
+#define TAR_HASH_SIZE		(256)
+
+struct tar_entry_t {
+	struct hlist_node node;
+	const char * path;
+	const char * name;
+	int type;
+	u32_t mode;
+	u64_t mtime;
+	u64_t size;
+	u64_t offset;
+	struct tar_entry_t ** children;
+	int nchildren;
+	int maxchildren;
+};
+
+struct tar_index_t {
+	struct hlist_head hash[TAR_HASH_SIZE];
+	struct tar_entry_t * root;
+};
+
+static u32_t tar_hash(const char * path, int len)
 {
-	char full_path[VFS_MAX_PATH];
-	char *p, *q;
-	s32_t l;
+	u32_t val = 0;
 
-	if(!path || !perfix || !result)
-		return FALSE;
+	while(len-- > 0)
+		val = ((val << 5) + val) + *path++;
+	return val & (TAR_HASH_SIZE - 1);
+}
 
-	full_path[0] = '\0';
+static struct tar_entry_t * tar_index_find(struct tar_index_t * idx, const char * path, int len)
+{
+	struct tar_entry_t * e;
+	struct hlist_node * pos;
 
-	if(path[0] != '/')
-		strcpy(full_path, (const char *)("/"));
-	strlcat(full_path, path, sizeof(full_path));
+	hlist_for_each(pos, &idx->hash[tar_hash(path, len)])
+	{
+		e = hlist_entry(pos, struct tar_entry_t, node);
+		if((strncmp(e->path, path, len) == 0) && (e->path[len] == '\0'))
+			return e;
+	}
+	return NULL;
+}
 
-	l = strlen(perfix);
-	if(memcmp(full_path, perfix, l) != 0)
-		return FALSE;
+static struct tar_entry_t * tar_index_add(struct tar_index_t * idx, const char * path, int len)
+{
+	struct tar_entry_t * e, * parent = NULL, ** children;
+	char * p;
+	int i;
 
-	p = &full_path[l];
-	if(*p == '\0')
-		return FALSE;
-	if(*p == '/')
-		p++;
-	if(*p == '\0')
-		return FALSE;
+	e = tar_index_find(idx, path, len);
+	if(e)
+		return e;
 
-	q = strchr(p, '/');
-	if(q)
+	if(len > 0)
 	{
-		if(*(q+1) != '\0')
-			return FALSE;
-		*q = 0;
+		for(i = len - 1; (i > 0) && (path[i] != '/'); i--);
+		parent = tar_index_add(idx, path, i);
+		if(!parent)
+			return NULL;
+		if(parent->nchildren >= parent->maxchildren)
+		{
+			children = realloc(parent->children, sizeof(struct tar_entry_t *) * (parent->maxchildren + 16));
+			if(!children)
+				return NULL;
+			parent->children = children;
+			parent->maxchildren += 16;
+		}
 	}
 
-	strcpy(result, p);
+	e = malloc(sizeof(struct tar_entry_t) + len + 1);
+	if(!e)
+		return NULL;
+	p = (char *)(e + 1);
+	memcpy(p, path, len);
+	p[len] = '\0';
+	e->path = p;
+	e->name = strrchr(p, '/') ? strrchr(p, '/') + 1 : p;
+	e->type = FILE_TYPE_DIRECTORY;
+	e->mode = 0755;
+	e->mtime = 0;
+	e->size = 0;
+	e->offset = 0;
+	e->children = NULL;
+	e->nchildren = 0;
+	e->maxchildren = 0;
+	hlist_add_head(&e->node, &idx->hash[tar_hash(path, len)]);
+	if(parent)
+		parent->children[parent->nchildren++] = e;
+	return e;
+}
+
+static void tar_index_free(struct tar_index_t * idx)
+{
+	struct tar_entry_t * e;
+	struct hlist_node * pos, * n;
+	int i;
 
-	return TRUE;
+	for(i = 0; i < TAR_HASH_SIZE; i++)
+	{
+		hlist_for_each_safe(pos, n, &idx->hash[i])
+		{
+			e = hlist_entry(pos, struct tar_entry_t, node);
+			hlist_del(&e->node);
+			if(e->children)
+				free(e->children);
+			free(e);
+		}
+	}
+	free(idx);
 }
 
-static bool_t check_path(const char * path, const char * perfix, const char * name)
+static struct tar_index_t * tar_index_build(void * dev)
 {
-	char path1[VFS_MAX_PATH];
-	char path2[VFS_MAX_PATH];
-	char *p;
-	s32_t l;
+	struct tar_header_t header;
+	struct tar_index_t * idx;
+	struct tar_entry_t * e;
+	char path[sizeof(header.name) + 1];
+	char buf[9];
+	u64_t off = 0, size, rd;
+	char * p;
+	int i, len;
+
+	idx = malloc(sizeof(struct tar_index_t));
+	if(!idx)
+		return NULL;
+	for(i = 0; i < TAR_HASH_SIZE; i++)
+		init_hlist_head(&idx->hash[i]);
+	idx->root = tar_index_add(idx, "", 0);
+	if(!idx->root)
+	{
+		tar_index_free(idx);
+		return NULL;
+	}
 
-	if(!path || !perfix || !name)
-		return FALSE;
+	while(1)
+	{
+		rd = block_read(dev, (u8_t *)&header, off, sizeof(struct tar_header_t));
+		if(rd != sizeof(struct tar_header_t))
+			break;
 
-	path1[0] = path2[0] = '\0';
+		if(strncmp((const char *)(header.magic), "ustar", 5) != 0)
+			break;
 
-	if(path[0] != '/')
-		strcpy(path1, (const char *)("/"));
-	strlcat(path1, path, sizeof(path1));
+		size = strtoull((const char *)(header.size), NULL, 0);
 
-	if(perfix[0] != '/')
-		strcpy(path2, (const char *)("/"));
-	strlcat(path2, perfix, sizeof(path2));
+		memcpy(path, header.name, sizeof(header.name));
+		path[sizeof(header.name)] = '\0';
+		p = path;
+		while((p[0] == '.') && (p[1] == '/'))
+			p += 2;
+		while(*p == '/')
+			p++;
+		len = strlen(p);
+		while((len > 0) && (p[len - 1] == '/'))
+			len--;
+
+		if((p[0] != '.') && (len > 0))
+		{
+			e = tar_index_add(idx, p, len);
+			if(!e)
+			{
+				tar_index_free(idx);
+				return NULL;
+			}
+			if(e->offset == 0)
+			{
+				buf[8] = '\0';
+				memcpy(buf, (const char *)(header.mode), 8);
+				e->type = header.filetype;
+				e->mode = strtoul(buf, NULL, 8);
+				e->mtime = strtoull((const char *)(header.mtime), NULL, 0);
+				e->size = size;
+				e->offset = off + sizeof(struct tar_header_t);
+			}
+		}
 
-	if(path2[strlen(path2) - 1] != '/')
-		strlcat(path2, (const char *)"/", sizeof(path2));
-	strlcat(path2, (const char *)name, sizeof(path2));
+		if(size == 0)
+			off += sizeof(struct tar_header_t);
+		else
+			off += sizeof(struct tar_header_t) + (((size + 512) >> 9) << 9);
+	}
 
-	l = strlen(path2);
-	if(memcmp(path1, path2, l) != 0)
-		return FALSE;
+	return idx;
+}
 
-	p = &path1[l];
-	if(*p == '\0')
-		return TRUE;
-	if(*p == '/')
+static struct tar_entry_t * tar_index_lookup(struct vfs_node_t * dn, const char * name)
+{
+	struct tar_index_t * idx = (struct tar_index_t *)dn->v_mount->m_data;
+	char path[VFS_MAX_PATH];
+	const char * p = dn->v_path;
+
+	while(*p == '/')
 		p++;
+	if(!name)
+		return tar_index_find(idx, p, strlen(p));
 	if(*p == '\0')
-		return TRUE;
-
-	return FALSE;
+		return tar_index_find(idx, name, strlen(name));
+	if(snprintf(path, sizeof(path), "%s/%s", p, name) >= sizeof(path))
+		return NULL;
+	return tar_index_find(idx, path, strlen(path));
 }
 
 static int tar_mount(struct vfs_mount_t * m, const char * dev, u32_t flags)
@@ -193,13 +323,17 @@ static int tar_mount(struct vfs_mount_t * m, const char * dev, u32_t flags)
 
 	m->m_flags = MOUNT_RDONLY;
 	m->m_root->v_data = NULL;
-	m->m_data = NULL;
+	m->m_data = tar_index_build(m->m_dev);
+	if(!m->m_data)
+		return -1;
 
 	return 0;
 }
 
 static int tar_unmount(struct vfs_mount_t * m)
 {
+	if(m->m_data)
+		tar_index_free((struct tar_index_t *)m->m_data);
 	m->m_data = NULL;
 	return 0;
 }
@@ -257,40 +391,14 @@ static int tar_sync(struct vfs_node_t * n)
 
 static int tar_readdir(struct vfs_node_t * dn, s64_t off, struct vfs_dirent_t * d)
 {
-	struct tar_header_t header;
-	char name[VFS_MAX_NAME];
-	u64_t toff = 0, size, rd;
-	int i = 0;
-
-	while(1)
-	{
-		rd = block_read(dn->v_mount->m_dev, (u8_t *)&header, toff, sizeof(struct tar_header_t));
-		if(rd != sizeof(struct tar_header_t))
-			return -1;
+	struct tar_entry_t * dir, * e;
 
-		if(strncmp((const char *)(header.magic), "ustar", 5) != 0)
-			return -1;
-
-		size = strtoull((const char *)(header.size), NULL, 0);
-		if(size < 0)
-			return -1;
-
-		if(size == 0)
-			toff += sizeof(struct tar_header_t);
-		else
-			toff += sizeof(struct tar_header_t) + (((size + 512) >> 9) << 9);
-
-		if(!get_next_token((const char *)header.name, dn->v_path, name))
-			continue;
-
-		if(i++ == off)
-		{
-			toff = 0;
-			break;
-		}
-	}
+	dir = tar_index_lookup(dn, NULL);
+	if(!dir || (off < 0) || (off >= dir->nchildren))
+		return -1;
+	e = dir->children[off];
 
-	switch(header.filetype)
+	switch(e->type)
 	{
 	case FILE_TYPE_NORMAL:
 		d->d_type = VDT_REG;
@@ -320,7 +428,7 @@ static int tar_readdir(struct vfs_node_t * dn, s64_t off, struct vfs_dirent_t *
 		d->d_type = VDT_REG;
 		break;
 	}
-	strlcpy(d->d_name, name, sizeof(d->d_name));
+	strlcpy(d->d_name, e->name, sizeof(d->d_name));
 	d->d_off = off;
 	d->d_reclen = 1;
 
@@ -329,41 +437,22 @@ static int tar_readdir(struct vfs_node_t * dn, s64_t off, struct vfs_dirent_t *
 
 static int tar_lookup(struct vfs_node_t * dn, const char * name, struct vfs_node_t * n)
 {
-	struct tar_header_t header;
-	u64_t off = 0, size, rd;
+	struct tar_entry_t * e;
 	u64_t mtime;
 	u32_t mode;
-	char buf[9];
-
-	while(1)
-	{
-		rd = block_read(dn->v_mount->m_dev, (u8_t *)&header, off, sizeof(struct tar_header_t));
-		if(rd != sizeof(struct tar_header_t))
-			return -1;
-
-		if(strncmp((const char *)(header.magic), "ustar", 5) != 0)
-			return -1;
 
-		size = strtoull((const char *)(header.size), NULL, 0);
-		if(size < 0)
-			return -1;
-
-		if(check_path((const char *)(header.name), dn->v_path, name))
-			break;
-
-		if(size == 0)
-			off += sizeof(struct tar_header_t);
-		else
-			off += sizeof(struct tar_header_t) + (((size + 512) >> 9) << 9);
-	}
+	e = tar_index_lookup(dn, name);
+	if(!e)
+		return -1;
+	mtime = e->mtime;
+	mode = e->mode;
 
-	mtime = strtoull((const char *)(header.mtime), NULL, 0);
 	n->v_atime = mtime;
 	n->v_mtime = mtime;
 	n->v_ctime = mtime;
 	n->v_mode = 0;
 
-	switch(header.filetype)
+	switch(e->type)
 	{
 	case FILE_TYPE_NORMAL:
 		n->v_type = VNT_REG;
@@ -403,10 +492,6 @@ static int tar_lookup(struct vfs_node_t * dn, const char * name, struct vfs_node
 		break;
 	}
 
-	buf[8] = '\0';
-	memcpy(buf, (const char *)(header.mode), 8);
-	mode = strtoul(buf, NULL, 8);
-
 	if(mode & 00400)
 		n->v_mode |= S_IRUSR;
 	if(mode & 00200)
@@ -426,8 +511,8 @@ static int tar_lookup(struct vfs_node_t * dn, const char * name, struct vfs_node
 	if(mode & 00001)
 		n->v_mode |= S_IXOTH;
 
-	n->v_size = size;
-	n->v_data = (void *)((unsigned long)(off + sizeof(struct tar_header_t)));
+	n->v_size = e->size;
+	n->v_data = (void *)((unsigned long)e->offset);
 
 	return 0;
 }
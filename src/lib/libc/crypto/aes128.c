@@ -5,6 +5,8 @@
 #include <types.h>
 #include <stdint.h>
 #include <string.h>
+#include <endian.h>
+#include <byteorder.h>
 #include <aes128.h>
 
 static const uint8_t sbox[256] = {
@@ -440,14 +442,27 @@ static inline void add_round_key(uint8_t * state, uint8_t * key)
 		state[i] ^= key[i];
 }
 
-static inline void xor_block(uint8_t * r, uint8_t * a, uint8_t * b, int len)
+typedef uint64_t __attribute__((may_alias)) aes128_word_t;
+
+static inline void xor_block(uint8_t * r, const uint8_t * a, const uint8_t * b, size_t len)
 {
-	int i;
-	for(i = 0; i < len; i++)
-		*r++ = *a++ ^ *b++;
+	size_t i = 0;
+
+	if(((uintptr_t)r | (uintptr_t)a | (uintptr_t)b) & 0x7)
+	{
+		for(; i < len; i++)
+			r[i] = a[i] ^ b[i];
+	}
+	else
+	{
+		for(; i + 8 <= len; i += 8)
+			*(aes128_word_t *)&r[i] = *(const aes128_word_t *)&a[i] ^ *(const aes128_word_t *)&b[i];
+		for(; i < len; i++)
+			r[i] = a[i] ^ b[i];
+	}
 }
 
-static void aes128_encrypt(struct aes128_ctx_t * ctx, uint8_t * in, uint8_t * out)
+static void aes128_encrypt(struct aes128_ctx_t * ctx, const uint8_t * in, uint8_t * out)
 {
 	uint8_t state[16];
 	int i;
@@ -465,7 +480,7 @@ static void aes128_encrypt(struct aes128_ctx_t * ctx, uint8_t * in, uint8_t * ou
 	memcpy(out, state, sizeof(state));
 }
 
-static void aes128_decrypt(struct aes128_ctx_t * ctx, uint8_t * in, uint8_t * out)
+static void aes128_decrypt(struct aes128_ctx_t * ctx, const uint8_t * in, uint8_t * out)
 {
 	uint8_t state[16];
 	int i;
@@ -513,119 +528,133 @@ void aes128_set_key(struct aes128_ctx_t * ctx, uint8_t * key)
 	}
 }
 
-void aes128_ecb_encrypt(struct aes128_ctx_t * ctx, uint8_t * in, uint8_t * out, int blks)
+/*
+ * Ecb on whole blocks, an arch may provide aes128_encrypt_blocks and
+ * aes128_decrypt_blocks with aes instructions and fall back to these.
+ * The modes below only go through the two of them.
+ */
+void __aes128_encrypt_blocks(struct aes128_ctx_t * ctx, const uint8_t * in, uint8_t * out, size_t blks)
 {
-	int i;
-
-	for(i = 0; i < blks; i++)
+	while(blks--)
 	{
 		aes128_encrypt(ctx, in, out);
 		in  += 16;
 		out += 16;
 	}
 }
+extern __typeof(__aes128_encrypt_blocks) aes128_encrypt_blocks __attribute__((weak, alias("__aes128_encrypt_blocks")));
 
-void aes128_ecb_decrypt(struct aes128_ctx_t * ctx, uint8_t * in, uint8_t * out, int blks)
+void __aes128_decrypt_blocks(struct aes128_ctx_t * ctx, const uint8_t * in, uint8_t * out, size_t blks)
 {
-	int i;
-
-	for(i = 0; i < blks; i++)
+	while(blks--)
 	{
 		aes128_decrypt(ctx, in, out);
 		in  += 16;
 		out += 16;
 	}
 }
+extern __typeof(__aes128_decrypt_blocks) aes128_decrypt_blocks __attribute__((weak, alias("__aes128_decrypt_blocks")));
 
-void aes128_cbc_encrypt(struct aes128_ctx_t * ctx, uint8_t * iv, uint8_t * in, uint8_t * out, int blks)
+void aes128_ecb_encrypt(struct aes128_ctx_t * ctx, uint8_t * in, uint8_t * out, size_t blks)
 {
-	uint8_t chain[16];
-	uint8_t tmp[16];
-	int i;
+	aes128_encrypt_blocks(ctx, in, out, blks);
+}
 
-	memcpy(chain, iv, 16);
-	for(i = 0; i < blks; i++)
-	{
-		xor_block(tmp, chain, in, 16);
-		aes128_encrypt(ctx, tmp, out);
-		memcpy(chain, out, 16);
-		in  += 16;
-		out += 16;
-	}
+void aes128_ecb_decrypt(struct aes128_ctx_t * ctx, uint8_t * in, uint8_t * out, size_t blks)
+{
+	aes128_decrypt_blocks(ctx, in, out, blks);
 }
 
-void aes128_cbc_decrypt(struct aes128_ctx_t * ctx, uint8_t * iv, uint8_t * in, uint8_t * out, int blks)
+void aes128_cbc_encrypt(struct aes128_ctx_t * ctx, uint8_t * iv, uint8_t * in, uint8_t * out, size_t blks)
 {
-	uint8_t chain[16];
-	uint8_t block[16];
-	uint8_t tmp[16];
-	int i;
+	const uint8_t * chain = iv;
+	uint8_t tmp[16] __attribute__((aligned(8)));
 
-	memcpy(chain, iv, 16);
-	for(i = 0; i < blks; i++)
+	while(blks--)
 	{
-		memcpy(block, in, 16);
-		aes128_decrypt(ctx, in, tmp);
-		xor_block(out, chain, tmp, 16);
-		memcpy(chain, block, 16);
+		xor_block(tmp, chain, in, 16);
+		aes128_encrypt_blocks(ctx, tmp, out, 1);
+		chain = out;
 		in  += 16;
 		out += 16;
 	}
 }
 
-static inline void add_counter(uint8_t * counter)
+/*
+ * Cbc decryption has no chaining dependency, so decrypt up to 16 blocks
+ * at a time, then xor each with the previous ciphertext from the last one
+ * backwards, which keeps in place decryption working without copies.
+ */
+void aes128_cbc_decrypt(struct aes128_ctx_t * ctx, uint8_t * iv, uint8_t * in, uint8_t * out, size_t blks)
 {
-	int i;
+	uint8_t chain[16] __attribute__((aligned(8)));
+	uint8_t last[16];
+	uint8_t tmp[16 * 16] __attribute__((aligned(8)));
+	size_t n, i;
 
-	for(i = 15; i >= 8; i--)
+	memcpy(chain, iv, 16);
+	while(blks > 0)
 	{
-		counter[i]++;
-		if( (counter[i] != 0) || (i == 8) )
-			break;
+		n = blks > 16 ? 16 : blks;
+		aes128_decrypt_blocks(ctx, in, tmp, n);
+		memcpy(last, &in[(n - 1) * 16], 16);
+		for(i = n - 1; i > 0; i--)
+			xor_block(&out[i * 16], &in[(i - 1) * 16], &tmp[i * 16], 16);
+		xor_block(out, chain, tmp, 16);
+		memcpy(chain, last, 16);
+		in  += n * 16;
+		out += n * 16;
+		blks -= n;
 	}
 }
 
-void aes128_ctr_encrypt(struct aes128_ctx_t * ctx, uint64_t offset, uint8_t * in, uint8_t * out, int bytes)
+/*
+ * The counter block is the big endian 128 bits sum of the initial counter
+ * block and the block index of the offset, as in NIST SP 800-38A. Up to 16
+ * counter blocks are encrypted at a time for the keystream.
+ */
+void aes128_ctr_encrypt(struct aes128_ctx_t * ctx, uint8_t * iv, uint64_t offset, uint8_t * in, uint8_t * out, size_t bytes)
 {
-	uint8_t counter[16];
-	uint8_t tmp[16];
+	uint8_t counter[16 * 16] __attribute__((aligned(8)));
+	uint8_t tmp[16 * 16] __attribute__((aligned(8)));
+	uint64_t hi = 0, lo = 0;
 	uint64_t o = offset / 16;
-	int pos, len;
-	int i;
+	size_t pos = (offset & 0x0f);
+	size_t n, len, i;
 
 	for(i = 0; i < 8; i++)
-		counter[i] = 0;
-	for(i = 15; i >= 8; i--)
 	{
-		counter[i] = (uint8_t)(o & 0xff);
-		o >>= 8;
+		hi = (hi << 8) | iv[i];
+		lo = (lo << 8) | iv[i + 8];
 	}
-
-	pos = (offset & 0x0f);
-	if(pos)
+	if(lo + o < lo)
+		hi++;
+	lo += o;
+	while(bytes > 0)
 	{
-		len = 16 - pos;
-		bytes -= len;
-		aes128_encrypt(ctx, counter, tmp);
+		n = (pos + bytes + 15) / 16;
+		if(n > 16)
+			n = 16;
+		for(i = 0; i < n; i++)
+		{
+			*(aes128_word_t *)&counter[i * 16 + 0] = cpu_to_be64(hi);
+			*(aes128_word_t *)&counter[i * 16 + 8] = cpu_to_be64(lo);
+			if(++lo == 0)
+				hi++;
+		}
+		aes128_encrypt_blocks(ctx, counter, tmp, n);
+		len = n * 16 - pos;
+		if(len > bytes)
+			len = bytes;
 		xor_block(out, in, &tmp[pos], len);
 		in  += len;
 		out += len;
-		add_counter(counter);
-	}
-
-	while(bytes)
-	{
-		len = bytes > 16 ? 16 : bytes;
 		bytes -= len;
-		aes128_encrypt(ctx, counter, tmp);
-		xor_block(out, in, tmp, len);
-		in  += len;
-		out += len;
-		add_counter(counter);
+		pos = 0;
 	}
 }
 
-void aes128_ctr_decrypt(struct aes128_ctx_t * ctx, uint64_t offset, uint8_t * in, uint8_t * out, int bytes)
+void aes128_ctr_decrypt(struct aes128_ctx_t * ctx, uint8_t * iv, uint64_t offset, uint8_t * in, uint8_t * out, size_t bytes)
 {
-	aes128_ctr_encrypt(ctx, offset, in, out, bytes);
+	aes128_ctr_encrypt(ctx, iv, offset, in, out, bytes);
 }
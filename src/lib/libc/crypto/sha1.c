@@ -8,59 +8,61 @@
 
 #define rol(bits, value)	(((value) << (bits)) | ((value) >> (32 - (bits))))
 
-static void sha1_transform(struct sha1_ctx_t * ctx)
+/*
+ * Transform whole 64 bytes blocks straight from the input, an arch may
+ * provide sha1_blocks with sha instructions and fall back to this one.
+ */
+void __sha1_blocks(uint32_t * state, const uint8_t * data, size_t blocks)
 {
 	uint32_t W[80];
 	uint32_t A, B, C, D, E;
-	uint8_t * p = ctx->buf;
+	const uint8_t * p = data;
 	int t;
 
-	for(t = 0; t < 16; ++t)
+	while(blocks--)
 	{
-		uint32_t tmp =  *p++ << 24;
-		tmp |= *p++ << 16;
-		tmp |= *p++ << 8;
-		tmp |= *p++;
-		W[t] = tmp;
-	}
+		for(t = 0; t < 16; t++, p += 4)
+			W[t] = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
 
-	for(; t < 80; t++)
-	{
-		W[t] = rol(1, W[t-3] ^ W[t-8] ^ W[t-14] ^ W[t-16]);
-	}
+		for(; t < 80; t++)
+		{
+			W[t] = rol(1, W[t-3] ^ W[t-8] ^ W[t-14] ^ W[t-16]);
+		}
 
-	A = ctx->state[0];
-	B = ctx->state[1];
-	C = ctx->state[2];
-	D = ctx->state[3];
-	E = ctx->state[4];
+		A = state[0];
+		B = state[1];
+		C = state[2];
+		D = state[3];
+		E = state[4];
 
-	for(t = 0; t < 80; t++)
-	{
-		uint32_t tmp = rol(5, A) + E + W[t];
-
-		if (t < 20)
-			tmp += (D ^ (B & (C ^ D))) + 0x5A827999;
-		else if ( t < 40)
-			tmp += (B ^ C ^ D) + 0x6ED9EBA1;
-		else if ( t < 60)
-			tmp += ((B & C) | (D & (B | C))) + 0x8F1BBCDC;
-		else
-			tmp += (B ^ C ^ D) + 0xCA62C1D6;
-
-		E = D;
-		D = C;
-		C = rol(30, B);
-		B = A;
-		A = tmp;
-	}
+		for(t = 0; t < 80; t++)
+		{
+			uint32_t tmp = rol(5, A) + E + W[t];
+
+			if (t < 20)
+				tmp += (D ^ (B & (C ^ D))) + 0x5A827999;
+			else if ( t < 40)
+				tmp += (B ^ C ^ D) + 0x6ED9EBA1;
+			else if ( t < 60)
+				tmp += ((B & C) | (D & (B | C))) + 0x8F1BBCDC;
+			else
+				tmp += (B ^ C ^ D) + 0xCA62C1D6;
+
+			E = D;
+			D = C;
+			C = rol(30, B);
+			B = A;
+			A = tmp;
+		}
 
-	ctx->state[0] += A;
-	ctx->state[1] += B;
-	ctx->state[2] += C;
-	ctx->state[3] += D;
-	ctx->state[4] += E;
+		state[0] += A;
+		state[1] += B;
+		state[2] += C;
+		state[3] += D;
+		state[4] += E;
+	}
 }
+extern __typeof(__sha1_blocks) sha1_blocks __attribute__((weak, alias("__sha1_blocks")));
 
 void sha1_init(struct sha1_ctx_t * ctx)
 {
@@ -72,42 +74,57 @@ void sha1_init(struct sha1_ctx_t * ctx)
 	ctx->count = 0;
 }
 
-void sha1_update(struct sha1_ctx_t * ctx, const void * data, int len)
+void sha1_update(struct sha1_ctx_t * ctx, const void * data, size_t len)
 {
-	int i = (int)(ctx->count & 63);
+	size_t i = (size_t)(ctx->count & 63);
 	const uint8_t * p = (const uint8_t *)data;
+	size_t n;
 
 	ctx->count += len;
-	while(len--)
+	if(i)
 	{
-		ctx->buf[i++] = *p++;
-		if (i == 64)
+		n = 64 - i;
+		if(len < n)
 		{
-			sha1_transform(ctx);
-			i = 0;
+			memcpy(&ctx->buf[i], p, len);
+			return;
 		}
+		memcpy(&ctx->buf[i], p, n);
+		sha1_blocks(ctx->state, ctx->buf, 1);
+		p += n;
+		len -= n;
+	}
+	if(len >= 64)
+	{
+		n = len >> 6;
+		sha1_blocks(ctx->state, p, n);
+		p += n << 6;
+		len &= 63;
 	}
+	if(len)
+		memcpy(ctx->buf, p, len);
 }
 
 const uint8_t * sha1_final(struct sha1_ctx_t * ctx)
 {
 	uint8_t * p = ctx->buf;
 	uint64_t cnt = ctx->count * 8;
-	int i;
+	int i = (int)(ctx->count & 63);
 
-	sha1_update(ctx, (uint8_t *)"\x80", 1);
-	while((ctx->count & 63) != 56)
+	ctx->buf[i++] = 0x80;
+	if(i > 56)
 	{
-		sha1_update(ctx, (uint8_t *)"\0", 1);
+		memset(&ctx->buf[i], 0, 64 - i);
+		sha1_blocks(ctx->state, ctx->buf, 1);
+		i = 0;
 	}
+	memset(&ctx->buf[i], 0, 56 - i);
 	for(i = 0; i < 8; ++i)
-	{
-		uint8_t tmp = (uint8_t)(cnt >> ((7 - i) * 8));
-		sha1_update(ctx, &tmp, 1);
-	}
+		ctx->buf[56 + i] = (uint8_t)(cnt >> ((7 - i) * 8));
+	sha1_blocks(ctx->state, ctx->buf, 1);
 
 	for(i = 0; i < 5; i++)
-		{
+	{
 		uint32_t tmp = ctx->state[i];
 		*p++ = tmp >> 24;
 		*p++ = tmp >> 16;
@@ -121,7 +138,7 @@ const uint8_t * sha1_final(struct sha1_ctx_t * ctx)
 /*
  * Compute sha1 (160-bits) message digest
  */
-const uint8_t * sha1_hash(const void * data, int len, uint8_t * digest)
+const uint8_t * sha1_hash(const void * data, size_t len, uint8_t * digest)
 {
 	struct sha1_ctx_t ctx;
 	sha1_init(&ctx);
@@ -29,66 +29,68 @@ static const uint32_t K[64] =
 	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
 };
 
-static void sha256_transform(struct sha256_ctx_t * ctx)
+/*
+ * Transform whole 64 bytes blocks straight from the input, an arch may
+ * provide sha256_blocks with sha instructions and fall back to this one.
+ */
+void __sha256_blocks(uint32_t * state, const uint8_t * data, size_t blocks)
 {
 	uint32_t W[64];
 	uint32_t A, B, C, D, E, F, G, H;
-	uint8_t * p = ctx->buf;
+	const uint8_t * p = data;
 	int t;
 
-	for(t = 0; t < 16; ++t)
+	while(blocks--)
 	{
-		uint32_t tmp =  *p++ << 24;
-		tmp |= *p++ << 16;
-		tmp |= *p++ << 8;
-		tmp |= *p++;
-		W[t] = tmp;
-	}
+		for(t = 0; t < 16; t++, p += 4)
+			W[t] = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
 
-	for(; t < 64; t++)
-	{
-		uint32_t s0 = ror(W[t-15], 7) ^ ror(W[t-15], 18) ^ shr(W[t-15], 3);
-		uint32_t s1 = ror(W[t-2], 17) ^ ror(W[t-2], 19) ^ shr(W[t-2], 10);
-		W[t] = W[t-16] + s0 + W[t-7] + s1;
-	}
+		for(; t < 64; t++)
+		{
+			uint32_t s0 = ror(W[t-15], 7) ^ ror(W[t-15], 18) ^ shr(W[t-15], 3);
+			uint32_t s1 = ror(W[t-2], 17) ^ ror(W[t-2], 19) ^ shr(W[t-2], 10);
+			W[t] = W[t-16] + s0 + W[t-7] + s1;
+		}
 
-	A = ctx->state[0];
-	B = ctx->state[1];
-	C = ctx->state[2];
-	D = ctx->state[3];
-	E = ctx->state[4];
-	F = ctx->state[5];
-	G = ctx->state[6];
-	H = ctx->state[7];
+		A = state[0];
+		B = state[1];
+		C = state[2];
+		D = state[3];
+		E = state[4];
+		F = state[5];
+		G = state[6];
+		H = state[7];
 
-	for(t = 0; t < 64; t++)
-	{
-		uint32_t s0 = ror(A, 2) ^ ror(A, 13) ^ ror(A, 22);
-		uint32_t maj = (A & B) ^ (A & C) ^ (B & C);
-		uint32_t t2 = s0 + maj;
-		uint32_t s1 = ror(E, 6) ^ ror(E, 11) ^ ror(E, 25);
-		uint32_t ch = (E & F) ^ ((~E) & G);
-		uint32_t t1 = H + s1 + ch + K[t] + W[t];
-
-		H = G;
-		G = F;
-		F = E;
-		E = D + t1;
-		D = C;
-		C = B;
-		B = A;
-		A = t1 + t2;
-	}
+		for(t = 0; t < 64; t++)
+		{
+			uint32_t s0 = ror(A, 2) ^ ror(A, 13) ^ ror(A, 22);
+			uint32_t maj = (A & B) ^ (A & C) ^ (B & C);
+			uint32_t t2 = s0 + maj;
+			uint32_t s1 = ror(E, 6) ^ ror(E, 11) ^ ror(E, 25);
+			uint32_t ch = (E & F) ^ ((~E) & G);
+			uint32_t t1 = H + s1 + ch + K[t] + W[t];
+
+			H = G;
+			G = F;
+			F = E;
+			E = D + t1;
+			D = C;
+			C = B;
+			B = A;
+			A = t1 + t2;
+		}
 
-	ctx->state[0] += A;
-	ctx->state[1] += B;
-	ctx->state[2] += C;
-	ctx->state[3] += D;
-	ctx->state[4] += E;
-	ctx->state[5] += F;
-	ctx->state[6] += G;
-	ctx->state[7] += H;
+		state[0] += A;
+		state[1] += B;
+		state[2] += C;
+		state[3] += D;
+		state[4] += E;
+		state[5] += F;
+		state[6] += G;
+		state[7] += H;
+	}
 }
+extern __typeof(__sha256_blocks) sha256_blocks __attribute__((weak, alias("__sha256_blocks")));
 
 void sha256_init(struct sha256_ctx_t * ctx)
 {
@@ -103,39 +105,54 @@ void sha256_init(struct sha256_ctx_t * ctx)
     ctx->count = 0;
 }
 
-void sha256_update(struct sha256_ctx_t * ctx, const void * data, int len)
+void sha256_update(struct sha256_ctx_t * ctx, const void * data, size_t len)
 {
-	int i = (int)(ctx->count & 63);
+	size_t i = (size_t)(ctx->count & 63);
 	const uint8_t * p = (const uint8_t *)data;
+	size_t n;
 
 	ctx->count += len;
-	while(len--)
+	if(i)
 	{
-		ctx->buf[i++] = *p++;
-		if(i == 64)
+		n = 64 - i;
+		if(len < n)
 		{
-			sha256_transform(ctx);
-			i = 0;
+			memcpy(&ctx->buf[i], p, len);
+			return;
 		}
+		memcpy(&ctx->buf[i], p, n);
+		sha256_blocks(ctx->state, ctx->buf, 1);
+		p += n;
+		len -= n;
 	}
+	if(len >= 64)
+	{
+		n = len >> 6;
+		sha256_blocks(ctx->state, p, n);
+		p += n << 6;
+		len &= 63;
+	}
+	if(len)
+		memcpy(ctx->buf, p, len);
 }
 
 const uint8_t * sha256_final(struct sha256_ctx_t * ctx)
 {
 	uint8_t * p = ctx->buf;
 	uint64_t cnt = ctx->count * 8;
-	int i;
+	int i = (int)(ctx->count & 63);
 
-	sha256_update(ctx, (uint8_t *)"\x80", 1);
-	while ((ctx->count & 63) != 56)
+	ctx->buf[i++] = 0x80;
+	if(i > 56)
 	{
-		sha256_update(ctx, (uint8_t *)"\0", 1);
+		memset(&ctx->buf[i], 0, 64 - i);
+		sha256_blocks(ctx->state, ctx->buf, 1);
+		i = 0;
 	}
+	memset(&ctx->buf[i], 0, 56 - i);
 	for(i = 0; i < 8; ++i)
-	{
-		uint8_t tmp = (uint8_t)(cnt >> ((7 - i) * 8));
-		sha256_update(ctx, &tmp, 1);
-	}
+		ctx->buf[56 + i] = (uint8_t)(cnt >> ((7 - i) * 8));
+	sha256_blocks(ctx->state, ctx->buf, 1);
 
 	for(i = 0; i < 8; i++)
 	{
@@ -152,7 +169,7 @@ const uint8_t * sha256_final(struct sha256_ctx_t * ctx)
 /*
  * Compute sha256 (256-bits) message digest
  */
-const uint8_t * sha256_hash(const void * data, int len, uint8_t * digest)
+const uint8_t * sha256_hash(const void * data, size_t len, uint8_t * digest)
 {
 	struct sha256_ctx_t ctx;
 	sha256_init(&ctx);
@@ -7,10 +7,7 @@
 #include <string.h>
 #include <xboot/module.h>
 
-/*
- * Finds the first occurrence of a byte in a buffer
- */
-void * memchr(const void * s, int c, size_t n)
+static void * __memchr(const void * s, int c, size_t n)
 {
 	const unsigned char *p = s;
 
@@ -24,4 +21,9 @@ void * memchr(const void * s, int c, size_t n)
 
 	return NULL;
 }
+
+/*
+ * Finds the first occurrence of a byte in a buffer
+ */
+extern __typeof(__memchr) memchr __attribute__((weak, alias("__memchr")));
 EXPORT_SYMBOL(memchr);
@@ -6,14 +6,16 @@
 #include <string.h>
 #include <xboot/module.h>
 
-/*
- * Calculate the length of a string
- */
-size_t strlen(const char * s)
+static size_t __strlen(const char * s)
 {
 	const char * sc;
 
 	for (sc = s; *sc != '\0'; ++sc);
 	return sc - s;
 }
+
+/*
+ * Calculate the length of a string
+ */
+extern __typeof(__strlen) strlen __attribute__((weak, alias("__strlen")));
 EXPORT_SYMBOL(strlen);
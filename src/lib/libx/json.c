@@ -27,17 +27,47 @@ enum {
 	FLAG_BLOCK_COMMENT    = 1 << 14,
 };
 
+struct json_pool_t
+{
+	struct json_pool_t * next;
+	unsigned int used;
+	unsigned int size;
+	struct json_value_t values[];
+};
+
 struct json_state_t
 {
-	unsigned long used_memory;
 	unsigned int uint_max;
-	unsigned long ulong_max;
 	int first_pass;
+	int insitu;
 	const char * ptr;
 	unsigned int cur_line;
 	unsigned int cur_col;
+
+	/*
+	 * The first pass takes its nodes from chunked pools, the second pass
+	 * copies them into a single arena together with arrays, object entries
+	 * and strings, so the whole tree is one allocation.
+	 */
+	struct json_pool_t * pool;
+	unsigned int pool_size;
+	char * mem;
+	char * arena;
+
+	/*
+	 * Sax mode only runs the first pass, nodes are recycled once they
+	 * are reported and strings are decoded into the scratch buffer.
+	 */
+	struct json_sax_t * sax;
+	void * data;
+	struct json_value_t * unused;
+	char * scratch;
+	unsigned int scratch_size;
 };
 
+#define JSON_ALIGN(x)		(((x) + 7) & ~7UL)
+#define JSON_INDEX_MIN		(8)
+
 static unsigned char hex_value(char c)
 {
 	if(isdigit(c))
@@ -68,22 +98,200 @@ static unsigned char hex_value(char c)
 	}
 }
 
-static void * json_alloc(struct json_state_t * state, unsigned long size, int zero)
+static inline unsigned int json_hash(const char * name, unsigned int length)
+{
+	unsigned char * p = (unsigned char *)name;
+	unsigned int seed = 131;
+	unsigned int hash = 0;
+
+	while(length--)
+		hash = hash * seed + (*p++);
+	return hash;
+}
+
+static inline unsigned int json_index_size(unsigned int length)
+{
+	unsigned int size = 16;
+
+	if(length < JSON_INDEX_MIN)
+		return 0;
+	while(size < length * 2)
+		size <<= 1;
+	return size;
+}
+
+static void json_object_index(struct json_value_t * value)
+{
+	struct json_object_entry_t * e;
+	unsigned int * index;
+	unsigned int size, mask;
+	unsigned int i, j;
+
+	size = json_index_size(value->u.object.length);
+	if(size == 0)
+	{
+		value->reserved.object_mem = 0;
+		return;
+	}
+	index = (unsigned int *)&value->u.object.values[value->u.object.length];
+	memset(index, 0, size * sizeof(unsigned int));
+	mask = size - 1;
+
+	for(i = 0; i < value->u.object.length; i++)
+	{
+		e = &value->u.object.values[i];
+		for(j = e->hash & mask; index[j]; j = (j + 1) & mask);
+		index[j] = i + 1;
+	}
+	value->reserved.object_mem = index;
+}
+
+static struct json_value_t * json_pool_alloc(struct json_state_t * state)
+{
+	struct json_pool_t * pool = state->pool;
+	struct json_value_t * value;
+
+	if(state->unused)
+	{
+		value = state->unused;
+		state->unused = value->parent;
+	}
+	else
+	{
+		if(!pool || (pool->used >= pool->size))
+		{
+			pool = malloc(sizeof(struct json_pool_t) + state->pool_size * sizeof(struct json_value_t));
+			if(!pool)
+				return 0;
+			pool->next = state->pool;
+			pool->used = 0;
+			pool->size = state->pool_size;
+			state->pool = pool;
+			state->pool_size <<= 1;
+		}
+		value = &pool->values[pool->used++];
+	}
+	memset(value, 0, sizeof(struct json_value_t));
+	return value;
+}
+
+static void json_pool_free(struct json_state_t * state)
+{
+	struct json_pool_t * pool;
+
+	while(state->pool)
+	{
+		pool = state->pool;
+		state->pool = pool->next;
+		free(pool);
+	}
+}
+
+static unsigned long json_arena_size(struct json_state_t * state, struct json_value_t * alloc)
+{
+	unsigned long size = 0;
+
+	for(; alloc; alloc = alloc->reserved.next_alloc)
+	{
+		size += JSON_ALIGN(sizeof(struct json_value_t));
+
+		switch(alloc->type)
+		{
+		case JSON_ARRAY:
+			size += JSON_ALIGN(alloc->u.array.length * sizeof(struct json_value_t *));
+			break;
+
+		case JSON_OBJECT:
+			size += JSON_ALIGN(alloc->u.object.length * sizeof(struct json_object_entry_t)
+				+ json_index_size(alloc->u.object.length) * sizeof(unsigned int)
+				+ (state->insitu ? 0 : (unsigned long)alloc->u.object.values));
+			break;
+
+		case JSON_STRING:
+			if(!state->insitu)
+				size += JSON_ALIGN(alloc->u.string.length + 1);
+			break;
+
+		default:
+			break;
+		}
+	}
+	return size;
+}
+
+static inline void * json_arena_alloc(struct json_state_t * state, unsigned long size)
 {
-	if((state->ulong_max - state->used_memory) < size)
+	void * p = state->arena;
+
+	state->arena += JSON_ALIGN(size);
+	return p;
+}
+
+static char * json_scratch_reserve(struct json_state_t * state, unsigned int size)
+{
+	unsigned int n = state->scratch_size;
+	char * p;
+
+	while(n < size)
+		n <<= 1;
+	if(n != state->scratch_size)
+	{
+		if(!(p = realloc(state->scratch, n)))
+			return 0;
+		state->scratch = p;
+		state->scratch_size = n;
+	}
+	return state->scratch;
+}
+
+static inline char * json_string_begin(struct json_state_t * state, char * mem)
+{
+	if(state->sax)
+		return state->scratch;
+	if(state->first_pass)
 		return 0;
-	return zero ? calloc(1, size) : malloc(size);
+	if(state->insitu)
+		return (char *)state->ptr + 1;
+	return mem;
+}
+
+static int json_sax_begin(struct json_state_t * state, enum json_type_t type)
+{
+	struct json_sax_t * sax = state->sax;
+
+	if(type == JSON_OBJECT)
+		return sax->object_begin ? sax->object_begin(state->data) : 0;
+	return sax->array_begin ? sax->array_begin(state->data) : 0;
+}
+
+static int json_sax_end(struct json_state_t * state, struct json_value_t * value)
+{
+	struct json_sax_t * sax = state->sax;
+
+	switch(value->type)
+	{
+	case JSON_OBJECT:
+		return sax->object_end ? sax->object_end(state->data) : 0;
+	case JSON_ARRAY:
+		return sax->array_end ? sax->array_end(state->data) : 0;
+	default:
+		return sax->value ? sax->value(state->data, value) : 0;
+	}
 }
 
 static int new_value(struct json_state_t * state, struct json_value_t ** top, struct json_value_t ** root, struct json_value_t ** alloc, enum json_type_t type)
 {
 	struct json_value_t * value;
-	int values_size;
+	unsigned long values_size;
 
 	if(!state->first_pass)
 	{
-		value = *top = *alloc;
+		value = json_arena_alloc(state, sizeof(struct json_value_t));
+		memcpy(value, *alloc, sizeof(struct json_value_t));
 		*alloc = (*alloc)->reserved.next_alloc;
+		value->parent = *top;
+		value->reserved.next_alloc = 0;
+		*top = value;
 
 		if(!*root)
 			*root = value;
@@ -93,25 +301,23 @@ static int new_value(struct json_state_t * state, struct json_value_t ** top, st
 		case JSON_ARRAY:
 			if(value->u.array.length == 0)
 				break;
-			if(!(value->u.array.values = (struct json_value_t **)json_alloc(state, value->u.array.length * sizeof(struct json_value_t *), 0)))
-				return 0;
+			value->u.array.values = (struct json_value_t **)json_arena_alloc(state, value->u.array.length * sizeof(struct json_value_t *));
 			value->u.array.length = 0;
 			break;
 
 		case JSON_OBJECT:
 			if(value->u.object.length == 0)
 				break;
-			values_size = sizeof(*value->u.object.values) * value->u.object.length;
+			values_size = sizeof(*value->u.object.values) * value->u.object.length + json_index_size(value->u.object.length) * sizeof(unsigned int);
 
-			if(!(value->u.object.values = (struct json_object_entry_t *)json_alloc(state, values_size + ((unsigned long)value->u.object.values), 0)))
-				return 0;
-			value->reserved.object_mem = (char *)value->u.object.values + values_size;
+			value->reserved.object_mem = json_arena_alloc(state, values_size + (state->insitu ? 0 : (unsigned long)value->u.object.values));
+			value->u.object.values = (struct json_object_entry_t *)value->reserved.object_mem;
+			value->reserved.object_mem = (char *)value->reserved.object_mem + values_size;
 			value->u.object.length = 0;
 			break;
 
 		case JSON_STRING:
-			if(!(value->u.string.ptr = (char *)json_alloc(state, (value->u.string.length + 1) * sizeof(char), 0)))
-				return 0;
+			value->u.string.ptr = state->insitu ? 0 : (char *)json_arena_alloc(state, (value->u.string.length + 1) * sizeof(char));
 			value->u.string.length = 0;
 			break;
 
@@ -121,7 +327,7 @@ static int new_value(struct json_state_t * state, struct json_value_t ** top, st
 		return 1;
 	}
 
-	if(!(value = (struct json_value_t *)json_alloc(state, sizeof(struct json_value_t), 1)))
+	if(!(value = json_pool_alloc(state)))
 		return 0;
 
 	if(!*root)
@@ -130,18 +336,21 @@ static int new_value(struct json_state_t * state, struct json_value_t ** top, st
 	value->type = type;
 	value->parent = *top;
 
-	if(*alloc)
-		(*alloc)->reserved.next_alloc = value;
-	*alloc = *top = value;
+	if(!state->sax)
+	{
+		if(*alloc)
+			(*alloc)->reserved.next_alloc = value;
+		*alloc = value;
+	}
+	*top = value;
 	return 1;
 }
 
-struct json_value_t * json_parse(const char * json, size_t length, char * errbuf)
+static int json_process(struct json_state_t * state, const char * json, size_t length, struct json_value_t ** result, char * errbuf)
 {
 	char error[256];
 	const char * end;
 	struct json_value_t * top, * root, * alloc = 0;
-	struct json_state_t state = { 0 };
 	long flags;
 	long num_digits = 0, num_e = 0;
 	int64_t num_fraction = 0;
@@ -156,12 +365,21 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 
 	error[0] = '\0';
 	end = json + length;
-	memset(&state.uint_max, 0xff, sizeof(state.uint_max));
-	memset(&state.ulong_max, 0xff, sizeof(state.ulong_max));
-	state.uint_max -= 8;
-	state.ulong_max -= 8;
+	memset(&state->uint_max, 0xff, sizeof(state->uint_max));
+	state->uint_max -= 8;
+	if(state->sax)
+	{
+		state->pool_size = 16;
+		state->scratch_size = 256;
+		if(!(state->scratch = malloc(state->scratch_size)))
+			goto e_alloc_failure;
+	}
+	else
+	{
+		state->pool_size = length / 32 + 16;
+	}
 
-   for(state.first_pass = 1; state.first_pass >= 0; --state.first_pass)
+   for(state->first_pass = 1; state->first_pass >= 0; --state->first_pass)
    {
 		unsigned int uchar;
 		unsigned char uc_b1, uc_b2, uc_b3, uc_b4;
@@ -170,23 +388,29 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 
 		top = root = 0;
 		flags = FLAG_SEEK_VALUE;
-		state.cur_line = 1;
+		state->cur_line = 1;
 
-		for(state.ptr = json;; ++state.ptr)
+		for(state->ptr = json;; ++state->ptr)
 		{
-			char b = (state.ptr == end ? 0 : *state.ptr);
+			char b = (state->ptr == end ? 0 : *state->ptr);
 
 			if(flags & FLAG_STRING)
 			{
 				if(!b)
 				{
-					sprintf(error, "Unexpected EOF in string (at %d:%d)", state.cur_line, state.cur_col);
+					sprintf(error, "Unexpected EOF in string (at %d:%d)", state->cur_line, state->cur_col);
 					goto e_failed;
 				}
 
-				if(string_length > state.uint_max)
+				if(string_length > state->uint_max)
 					goto e_overflow;
 
+				if(state->sax && (string_length + 5 > state->scratch_size))
+				{
+					if(!(string = json_scratch_reserve(state, string_length + 5)))
+						goto e_alloc_failure;
+				}
+
 				if(flags & FLAG_ESCAPED)
 				{
 					flags &= ~FLAG_ESCAPED;
@@ -194,37 +418,37 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 					switch(b)
 					{
 					case 'b':
-						if(!state.first_pass)
+						if(string)
 							string[string_length] = '\b';
 						++string_length;
 						break;
 					case 'f':
-						if(!state.first_pass)
+						if(string)
 							string[string_length] = '\f';
 						++string_length;
 						break;
 					case 'n':
-						if(!state.first_pass)
+						if(string)
 							string[string_length] = '\n';
 						++string_length;
 						break;
 					case 'r':
-						if(!state.first_pass)
+						if(string)
 							string[string_length] = '\r';
 						++string_length;
 						break;
 					case 't':
-						if(!state.first_pass)
+						if(string)
 							string[string_length] = '\t';
 						++string_length;
 						break;
 					case 'u':
-						if(end - state.ptr <= 4
-								|| (uc_b1 = hex_value(*++state.ptr)) == 0xff
-								|| (uc_b2 = hex_value(*++state.ptr)) == 0xff
-								|| (uc_b3 = hex_value(*++state.ptr)) == 0xff
-								|| (uc_b4 = hex_value(*++state.ptr)) == 0xff) {
-							sprintf(error, "Invalid character value `%c` (at %d:%d)", b, state.cur_line, state.cur_col);
+						if(end - state->ptr <= 4
+								|| (uc_b1 = hex_value(*++state->ptr)) == 0xff
+								|| (uc_b2 = hex_value(*++state->ptr)) == 0xff
+								|| (uc_b3 = hex_value(*++state->ptr)) == 0xff
+								|| (uc_b4 = hex_value(*++state->ptr)) == 0xff) {
+							sprintf(error, "Invalid character value `%c` (at %d:%d)", b, state->cur_line, state->cur_col);
 							goto e_failed;
 						}
 
@@ -236,15 +460,15 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 						{
 							unsigned int uchar2;
 
-							if(end - state.ptr <= 6
-									|| (*++state.ptr) != '\\'
-									|| (*++state.ptr) != 'u'
-									|| (uc_b1 = hex_value(*++state.ptr)) == 0xff
-									|| (uc_b2 = hex_value(*++state.ptr)) == 0xff
-									|| (uc_b3 = hex_value(*++state.ptr)) == 0xff
-									|| (uc_b4 = hex_value(*++state.ptr)) == 0xff)
+							if(end - state->ptr <= 6
+									|| (*++state->ptr) != '\\'
+									|| (*++state->ptr) != 'u'
+									|| (uc_b1 = hex_value(*++state->ptr)) == 0xff
+									|| (uc_b2 = hex_value(*++state->ptr)) == 0xff
+									|| (uc_b3 = hex_value(*++state->ptr)) == 0xff
+									|| (uc_b4 = hex_value(*++state->ptr)) == 0xff)
 							{
-								sprintf(error, "Invalid character value `%c` (at %d:%d)", b, state.cur_line, state.cur_col);
+								sprintf(error, "Invalid character value `%c` (at %d:%d)", b, state->cur_line, state->cur_col);
 								goto e_failed;
 							}
 
@@ -256,7 +480,7 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 
 						if(sizeof(char) >= sizeof(unsigned int) || (uchar <= 0x7f))
 						{
-							if(!state.first_pass)
+							if(string)
 								string[string_length] = (char )uchar;
 							++string_length;
 							break;
@@ -264,7 +488,7 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 
 						if(uchar <= 0x7ff)
 						{
-							if(state.first_pass)
+							if(!string)
 								string_length += 2;
 							else
 							{
@@ -276,7 +500,7 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 
 						if(uchar <= 0xffff)
 						{
-							if(state.first_pass)
+							if(!string)
 								string_length += 3;
 							else
 							{
@@ -287,7 +511,7 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 							break;
 						}
 
-						if(state.first_pass)
+						if(!string)
 							string_length += 4;
 						else {
 							string[string_length++] = 0xf0 | (uchar >> 18);
@@ -298,7 +522,7 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 						break;
 
 					default:
-						if(!state.first_pass)
+						if(string)
 							string[string_length] = b;
 						++string_length;
 					};
@@ -313,26 +537,36 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 
 				if(b == '"')
 				{
-					if(!state.first_pass)string[string_length] = 0;
+					if(string)
+						string[string_length] = 0;
 					flags &= ~FLAG_STRING;
-					string = 0;
 
 					switch(top->type)
 					{
 					case JSON_STRING:
+						top->u.string.ptr = string;
 						top->u.string.length = string_length;
+						string = 0;
 						flags |= FLAG_NEXT;
 						break;
 
 					case JSON_OBJECT:
-						if(state.first_pass)
+						if(state->sax)
+						{
+							if(state->sax->key && (state->sax->key(state->data, string, string_length) != 0))
+								goto e_aborted;
+						}
+						else if(state->first_pass)
 							top->u.object.values = (void *)((char *)top->u.object.values + string_length + 1);
 						else
 						{
-							top->u.object.values[top->u.object.length].name = (char *)top->reserved.object_mem;
+							top->u.object.values[top->u.object.length].name = string;
 							top->u.object.values[top->u.object.length].name_length = string_length;
-							(*(char **)&top->reserved.object_mem) += string_length + 1;
+							top->u.object.values[top->u.object.length].hash = json_hash(string, string_length);
+							if(!state->insitu)
+								(*(char **)&top->reserved.object_mem) += string_length + 1;
 						}
+						string = 0;
 						flags |= (FLAG_SEEK_VALUE | FLAG_NEED_COLON);
 						continue;
 
@@ -342,9 +576,21 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 				}
 				else
 				{
-					if(!state.first_pass)
-						string[string_length] = b;
-					++string_length;
+					const char * p = state->ptr + 1;
+					unsigned int n;
+
+					while((p < end) && (*p != '"') && (*p != '\\') && *p)
+						p++;
+					n = p - state->ptr;
+					if(state->sax && (string_length + n + 5 > state->scratch_size))
+					{
+						if(!(string = json_scratch_reserve(state, string_length + n + 5)))
+							goto e_alloc_failure;
+					}
+					if(string && (string + string_length != state->ptr))
+						memmove(string + string_length, state->ptr, n);
+					string_length += n;
+					state->ptr = p - 1;
 					continue;
 				}
 			}
@@ -356,7 +602,7 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 					if(b == '\r' || b == '\n' || !b)
 					{
 						flags &= ~FLAG_LINE_COMMENT;
-						--state.ptr;
+						--state->ptr;
 					}
 					continue;
 				}
@@ -365,13 +611,13 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 				{
 					if(!b)
 					{
-						sprintf(error, "%d:%d: Unexpected EOF in block comment", state.cur_line, state.cur_col);
+						sprintf(error, "%d:%d: Unexpected EOF in block comment", state->cur_line, state->cur_col);
 						goto e_failed;
 					}
-					if(b == '*' && state.ptr < (end - 1) && state.ptr[1] == '/')
+					if(b == '*' && state->ptr < (end - 1) && state->ptr[1] == '/')
 					{
 						flags &= ~FLAG_BLOCK_COMMENT;
-						++state.ptr;
+						++state->ptr;
 					}
 					continue;
 				}
@@ -380,17 +626,17 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 			{
 				if(!(flags & (FLAG_SEEK_VALUE | FLAG_DONE)) && top->type != JSON_OBJECT)
 				{
-					sprintf(error, "%d:%d: Comment not allowed here", state.cur_line, state.cur_col);
+					sprintf(error, "%d:%d: Comment not allowed here", state->cur_line, state->cur_col);
 					goto e_failed;
 				}
 
-				if(++state.ptr == end)
+				if(++state->ptr == end)
 				{
-					sprintf(error, "%d:%d: EOF unexpected", state.cur_line, state.cur_col);
+					sprintf(error, "%d:%d: EOF unexpected", state->cur_line, state->cur_col);
 					goto e_failed;
 				}
 
-				switch(b = *state.ptr)
+				switch(b = *state->ptr)
 				{
 				case '/':
 					flags |= FLAG_LINE_COMMENT;
@@ -401,7 +647,7 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 					continue;
 
 				default:
-					sprintf(error, "%d:%d: Unexpected `%c` in comment opening sequence", state.cur_line, state.cur_col, b);
+					sprintf(error, "%d:%d: Unexpected `%c` in comment opening sequence", state->cur_line, state->cur_col, b);
 					goto e_failed;
 				};
 			}
@@ -414,8 +660,8 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 				switch(b)
 				{
 				case '\n':
-					++state.cur_line;
-					state.cur_col = 0;
+					++state->cur_line;
+					state->cur_col = 0;
 					continue;
 				case ' ':
 				case '\t':
@@ -423,7 +669,7 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 					continue;
 
 				default:
-					sprintf(error, "%d:%d: Trailing garbage: `%c`", state.cur_line, state.cur_col, b);
+					sprintf(error, "%d:%d: Trailing garbage: `%c`", state->cur_line, state->cur_col, b);
 					goto e_failed;
 				};
 			}
@@ -433,8 +679,8 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 				switch(b)
 				{
 				case '\n':
-					++state.cur_line;
-					state.cur_col = 0;
+					++state->cur_line;
+					state->cur_col = 0;
 					continue;
 				case ' ':
 				case '\t':
@@ -446,7 +692,7 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 						flags = (flags & ~(FLAG_NEED_COMMA | FLAG_SEEK_VALUE)) | FLAG_NEXT;
 					else
 					{
-						sprintf(error, "%d:%d: Unexpected ]", state.cur_line, state.cur_col);
+						sprintf(error, "%d:%d: Unexpected ]", state->cur_line, state->cur_col);
 						goto e_failed;
 					}
 					break;
@@ -461,7 +707,7 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 						}
 						else
 						{
-							sprintf(error, "%d:%d: Expected , before %c", state.cur_line, state.cur_col, b);
+							sprintf(error, "%d:%d: Expected , before %c", state->cur_line, state->cur_col, b);
 							goto e_failed;
 						}
 					}
@@ -475,7 +721,7 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 						}
 						else
 						{
-							sprintf(error, "%d:%d: Expected : before %c", state.cur_line, state.cur_col, b);
+							sprintf(error, "%d:%d: Expected : before %c", state->cur_line, state->cur_col, b);
 							goto e_failed;
 						}
 					}
@@ -484,33 +730,37 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 					switch(b)
 					{
 					case '{':
-						if(!new_value(&state, &top, &root, &alloc, JSON_OBJECT))
+						if(!new_value(state, &top, &root, &alloc, JSON_OBJECT))
 							goto e_alloc_failure;
+						if(state->sax && (json_sax_begin(state, JSON_OBJECT) != 0))
+							goto e_aborted;
 						continue;
 
 					case '[':
-						if(!new_value(&state, &top, &root, &alloc, JSON_ARRAY))
+						if(!new_value(state, &top, &root, &alloc, JSON_ARRAY))
 							goto e_alloc_failure;
+						if(state->sax && (json_sax_begin(state, JSON_ARRAY) != 0))
+							goto e_aborted;
 						flags |= FLAG_SEEK_VALUE;
 						continue;
 
 					case '"':
-						if(!new_value(&state, &top, &root, &alloc, JSON_STRING))
+						if(!new_value(state, &top, &root, &alloc, JSON_STRING))
 							goto e_alloc_failure;
 						flags |= FLAG_STRING;
-						string = top->u.string.ptr;
+						string = json_string_begin(state, top->u.string.ptr);
 						string_length = 0;
 						continue;
 
 					case 't':
-						if((end - state.ptr) < 3
-								|| *(++state.ptr) != 'r'
-								|| *(++state.ptr) != 'u'
-								|| *(++state.ptr) != 'e')
+						if((end - state->ptr) < 4
+								|| *(++state->ptr) != 'r'
+								|| *(++state->ptr) != 'u'
+								|| *(++state->ptr) != 'e')
 						{
 							goto e_unknown_value;
 						}
-						if(!new_value(&state, &top, &root, &alloc, JSON_BOOLEAN))
+						if(!new_value(state, &top, &root, &alloc, JSON_BOOLEAN))
 							goto e_alloc_failure;
 
 						top->u.boolean = 1;
@@ -518,28 +768,28 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 						break;
 
 					case 'f':
-						if((end - state.ptr) < 4
-								|| *(++state.ptr) != 'a'
-								|| *(++state.ptr) != 'l'
-								|| *(++state.ptr) != 's'
-								|| *(++state.ptr) != 'e')
+						if((end - state->ptr) < 5
+								|| *(++state->ptr) != 'a'
+								|| *(++state->ptr) != 'l'
+								|| *(++state->ptr) != 's'
+								|| *(++state->ptr) != 'e')
 						{
 							goto e_unknown_value;
 						}
-						if(!new_value(&state, &top, &root, &alloc, JSON_BOOLEAN))
+						if(!new_value(state, &top, &root, &alloc, JSON_BOOLEAN))
 							goto e_alloc_failure;
 						flags |= FLAG_NEXT;
 						break;
 
 					case 'n':
-						if((end - state.ptr) < 3
-								|| *(++state.ptr) != 'u'
-								|| *(++state.ptr) != 'l'
-								|| *(++state.ptr) != 'l')
+						if((end - state->ptr) < 4
+								|| *(++state->ptr) != 'u'
+								|| *(++state->ptr) != 'l'
+								|| *(++state->ptr) != 'l')
 						{
 							goto e_unknown_value;
 						}
-						if(!new_value(&state, &top, &root, &alloc, JSON_NULL))
+						if(!new_value(state, &top, &root, &alloc, JSON_NULL))
 							goto e_alloc_failure;
 						flags |= FLAG_NEXT;
 						break;
@@ -547,18 +797,18 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 					default:
 						if(isdigit(b) || b == '-')
 						{
-							if(!new_value(&state, &top, &root, &alloc, JSON_INTEGER))
+							if(!new_value(state, &top, &root, &alloc, JSON_INTEGER))
 								goto e_alloc_failure;
-							if(!state.first_pass)
+							if(!state->first_pass)
 							{
 								while(isdigit(b) || b == '+' || b == '-' || b == 'e' || b == 'E' || b == '.')
 								{
-									if((++state.ptr) == end)
+									if((++state->ptr) == end)
 									{
 										b = 0;
 										break;
 									}
-									b = *state.ptr;
+									b = *state->ptr;
 								}
 								flags |= FLAG_NEXT | FLAG_REPROC;
 								break;
@@ -583,7 +833,7 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 						}
 						else
 						{
-							sprintf(error, "%d:%d: Unexpected %c when seeking value", state.cur_line, state.cur_col, b);
+							sprintf(error, "%d:%d: Unexpected %c when seeking value", state->cur_line, state->cur_col, b);
 							goto e_failed;
 						}
 					}
@@ -597,8 +847,8 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 					switch(b)
 					{
 					case '\n':
-						++state.cur_line;
-						state.cur_col = 0;
+						++state->cur_line;
+						state->cur_col = 0;
 						continue;
 					case ' ':
 					case '\t':
@@ -608,11 +858,11 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 					case '"':
 						if(flags & FLAG_NEED_COMMA)
 						{
-							sprintf(error, "%d:%d: Expected , before \"", state.cur_line, state.cur_col);
+							sprintf(error, "%d:%d: Expected , before \"", state->cur_line, state->cur_col);
 							goto e_failed;
 						}
 						flags |= FLAG_STRING;
-						string = (char *)top->reserved.object_mem;
+						string = json_string_begin(state, (char *)top->reserved.object_mem);
 						string_length = 0;
 						break;
 
@@ -623,14 +873,14 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 					case ',':
 						if(!(flags & FLAG_NEED_COMMA))
 						{
-							sprintf(error, "%d:%d: Unexpected `%c` in object", state.cur_line, state.cur_col, b);
+							sprintf(error, "%d:%d: Unexpected `%c` in object", state->cur_line, state->cur_col, b);
 							goto e_failed;
 						}
 						flags &= ~FLAG_NEED_COMMA;
 						break;
 
 					default:
-						sprintf(error, "%d:%d: Unexpected `%c` in object", state.cur_line, state.cur_col, b);
+						sprintf(error, "%d:%d: Unexpected `%c` in object", state->cur_line, state->cur_col, b);
 						goto e_failed;
 					}
 					break;
@@ -647,7 +897,7 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 							{
 								if(flags & FLAG_NUM_ZERO)
 								{
-									sprintf(error, "%d:%d: Unexpected `0` before `%c`", state.cur_line, state.cur_col, b);
+									sprintf(error, "%d:%d: Unexpected `0` before `%c`", state->cur_line, state->cur_col, b);
 									goto e_failed;
 								}
 								if (num_digits == 1 && b == '0')
@@ -680,7 +930,7 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 					{
 						if(!num_digits)
 						{
-							sprintf(error, "%d:%d: Expected digit before `.`", state.cur_line, state.cur_col);
+							sprintf(error, "%d:%d: Expected digit before `.`", state->cur_line, state->cur_col);
 							goto e_failed;
 						}
 						top->type = JSON_DOUBLE;
@@ -695,7 +945,7 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 						{
 							if(!num_digits)
 							{
-								sprintf(error, "%d:%d: Expected digit after `.`", state.cur_line, state.cur_col);
+								sprintf(error, "%d:%d: Expected digit after `.`", state->cur_line, state->cur_col);
 								goto e_failed;
 							}
 							top->u.dbl += ((double) num_fraction) / (pow(10.0, (double) num_digits));
@@ -718,7 +968,7 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 					{
 						if(!num_digits)
 						{
-							sprintf(error, "%d:%d: Expected digit after `e`", state.cur_line, state.cur_col);
+							sprintf(error, "%d:%d: Expected digit after `e`", state->cur_line, state->cur_col);
 							goto e_failed;
 						}
 						top->u.dbl *= pow(10.0, (double)(flags & FLAG_NUM_E_NEGATIVE ? -num_e : num_e));
@@ -742,13 +992,21 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 			if(flags & FLAG_REPROC)
 			{
 				flags &= ~FLAG_REPROC;
-				--state.ptr;
+				--state->ptr;
 			}
 
 			if(flags & FLAG_NEXT)
 			{
 				flags = (flags & ~FLAG_NEXT) | FLAG_NEED_COMMA;
 
+				if(state->sax)
+				{
+					if(json_sax_end(state, top) != 0)
+						goto e_aborted;
+				}
+				else if(!state->first_pass && (top->type == JSON_OBJECT))
+					json_object_index(top);
+
 				if(!top->parent)
 				{
 					flags |= FLAG_DONE;
@@ -758,7 +1016,7 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 				if(top->parent->type == JSON_ARRAY)
 					flags |= FLAG_SEEK_VALUE;
 
-				if(!state.first_pass)
+				if(!state->first_pass)
 				{
 					struct json_value_t * parent = top->parent;
 
@@ -777,18 +1035,38 @@ struct json_value_t * json_parse(const char * json, size_t length, char * errbuf
 					};
 				}
 
-				if((++top->parent->u.array.length) > state.uint_max)
+				if((++top->parent->u.array.length) > state->uint_max)
 					goto e_overflow;
+				if(state->sax)
+				{
+					alloc = top;
+					top = top->parent;
+					alloc->parent = state->unused;
+					state->unused = alloc;
+					continue;
+				}
 				top = top->parent;
 				continue;
 			}
 		}
+
+		if(state->sax)
+			break;
+		if(state->first_pass)
+		{
+			if(!(state->mem = state->arena = malloc(json_arena_size(state, root))))
+				goto e_alloc_failure;
+		}
 		alloc = root;
 	}
-	return root;
+	json_pool_free(state);
+	free(state->scratch);
+	if(result)
+		*result = state->sax ? 0 : root;
+	return 0;
 
 e_unknown_value:
-	sprintf(error, "%d:%d: Unknown value", state.cur_line, state.cur_col);
+	sprintf(error, "%d:%d: Unknown value", state->cur_line, state->cur_col);
 	goto e_failed;
 
 e_alloc_failure:
@@ -796,7 +1074,11 @@ e_alloc_failure:
 	goto e_failed;
 
 e_overflow:
-	sprintf(error, "%d:%d: Too long (caught overflow)", state.cur_line, state.cur_col);
+	sprintf(error, "%d:%d: Too long (caught overflow)", state->cur_line, state->cur_col);
+	goto e_failed;
+
+e_aborted:
+	sprintf(error, "%d:%d: Aborted by callback", state->cur_line, state->cur_col);
 	goto e_failed;
 
 e_failed:
@@ -807,59 +1089,88 @@ e_failed:
 		else
 			strcpy(errbuf, "Unknown error");
 	}
-	if(state.first_pass)
-		alloc = root;
-	while(alloc)
-	{
-		top = alloc->reserved.next_alloc;
-		free(alloc);
-		alloc = top;
-	}
-	if(!state.first_pass)
-		json_free(root);
-	return 0;
+	json_pool_free(state);
+	free(state->scratch);
+	free(state->mem);
+	if(result)
+		*result = 0;
+	return -1;
 }
 
-void json_free(struct json_value_t * value)
+struct json_value_t * json_parse(const char * json, size_t length, char * errbuf)
 {
-	struct json_value_t * v;
+	struct json_state_t state = { 0 };
+	struct json_value_t * root;
 
-	if(!value)
-		return;
+	if(json_process(&state, json, length, &root, errbuf) != 0)
+		return 0;
+	return root;
+}
 
-	value->parent = 0;
-	while(value)
-	{
-		switch(value->type)
-		{
-		case JSON_ARRAY:
-			if(!value->u.array.length)
-			{
-				free(value->u.array.values);
-				break;
-			}
-			value = value->u.array.values[--value->u.array.length];
-			continue;
+/*
+ * Keys and strings are decoded in place and point into the source buffer,
+ * which must be writable and outlive the returned tree.
+ */
+struct json_value_t * json_parse_insitu(char * json, size_t length, char * errbuf)
+{
+	struct json_state_t state = { 0 };
+	struct json_value_t * root;
 
-		case JSON_OBJECT:
-			if(!value->u.object.length)
-			{
-				free(value->u.object.values);
-				break;
-			}
-			value = value->u.object.values[--value->u.object.length].value;
-			continue;
+	state.insitu = 1;
+	if(json_process(&state, json, length, &root, errbuf) != 0)
+		return 0;
+	return root;
+}
 
-		case JSON_STRING:
-			free(value->u.string.ptr);
-			break;
+int json_parse_sax(const char * json, size_t length, struct json_sax_t * sax, void * data, char * errbuf)
+{
+	struct json_state_t state = { 0 };
 
-		default:
-			break;
-		};
+	if(!sax)
+		return -1;
+	state.sax = sax;
+	state.data = data;
+	return json_process(&state, json, length, 0, errbuf);
+}
 
-		v = value;
-		value = value->parent;
-		free(v);
+/*
+ * Find the first member called name whose value has the given type, or any type
+ * for JSON_NONE. Duplicate names are kept in document order along the probe chain.
+ */
+struct json_value_t * json_object_lookup(struct json_value_t * value, const char * name, enum json_type_t type)
+{
+	struct json_object_entry_t * e;
+	unsigned int * index;
+	unsigned int hash, length, mask;
+	unsigned int i;
+
+	if(!value || (value->type != JSON_OBJECT) || !name)
+		return 0;
+
+	length = strlen(name);
+	hash = json_hash(name, length);
+	index = (unsigned int *)value->reserved.object_mem;
+	if(index)
+	{
+		mask = json_index_size(value->u.object.length) - 1;
+		for(i = hash & mask; index[i]; i = (i + 1) & mask)
+		{
+			e = &value->u.object.values[index[i] - 1];
+			if((e->hash == hash) && (e->name_length == length) && (memcmp(e->name, name, length) == 0) && ((type == JSON_NONE) || (e->value && (e->value->type == type))))
+				return e->value;
+		}
+		return 0;
+	}
+	for(i = 0; i < value->u.object.length; i++)
+	{
+		e = &value->u.object.values[i];
+		if((e->hash == hash) && (e->name_length == length) && (memcmp(e->name, name, length) == 0) && ((type == JSON_NONE) || (e->value && (e->value->type == type))))
+			return e->value;
 	}
+	return 0;
+}
+
+void json_free(struct json_value_t * value)
+{
+	free(value);
 }
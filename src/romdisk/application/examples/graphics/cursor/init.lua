@@ -10,13 +10,14 @@ function M:init(w, h)
 		:paint())
 
 	local cursor = assets:loadDisplay("graphics/cursor/cursor.png")
-		:addEventListener(Event.MOUSE_DOWN, function(d, e) d:setPosition(e.x, e.y) end)
-		:addEventListener(Event.MOUSE_MOVE, function(d, e) d:setPosition(e.x, e.y) end)
-		:addEventListener(Event.MOUSE_UP, function(d, e) d:setPosition(e.x, e.y) end)
-		:addEventListener(Event.TOUCH_BEGIN, function(d, e) d:setPosition(e.x, e.y) end)
-		:addEventListener(Event.TOUCH_MOVE, function(d, e) d:setPosition(e.x, e.y) end)
-		:addEventListener(Event.TOUCH_END, function(d, e) d:setPosition(e.x, e.y) end)
 	self:addChild(cursor)
+
+	self:addEventListener(Event.MOUSE_DOWN, function(d, e) d:setPosition(e.x, e.y) end, cursor)
+		:addEventListener(Event.MOUSE_MOVE, function(d, e) d:setPosition(e.x, e.y) end, cursor)
+		:addEventListener(Event.MOUSE_UP, function(d, e) d:setPosition(e.x, e.y) end, cursor)
+		:addEventListener(Event.TOUCH_BEGIN, function(d, e) d:setPosition(e.x, e.y) end, cursor)
+		:addEventListener(Event.TOUCH_MOVE, function(d, e) d:setPosition(e.x, e.y) end, cursor)
+		:addEventListener(Event.TOUCH_END, function(d, e) d:setPosition(e.x, e.y) end, cursor)
 end
 
 return M
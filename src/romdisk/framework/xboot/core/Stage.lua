@@ -15,6 +15,26 @@ function M:showfps(value)
 	return self
 end
 
+function M:tiling(value, size)
+	self.display:tiling(value, size)
+	return self
+end
+
+function M:opaque(value)
+	self.display:opaque(value)
+	return self
+end
+
+function M:vsync(value)
+	self.display:vsync(value)
+	return self
+end
+
+function M:gc(budget, pause, stepmul)
+	self.display:gcBudget(budget, pause, stepmul)
+	return self
+end
+
 function M:exit()
 	self.exiting = true
 	return self
@@ -25,9 +45,13 @@ function M:loop()
 	local Event = Event
 	local display = self.display
 	local stopwatch = Stopwatch.new()
+	local frame = Event.new(Event.ENTER_FRAME, {count = 0})
 
 	timermanager:addTimer(Timer.new(1 / 60, 0, function(t, i)
-		self:render(display, Event.new(Event.ENTER_FRAME, i))
+		frame.time = frame.time + i.time * 1000000000
+		frame.count = i.count
+		frame.stop = nil
+		self:render(display, frame)
 		display:present()
 	end))
 
@@ -36,10 +60,7 @@ function M:loop()
 	end)
 
 	while not self.exiting do
-		local e = Event.pump()
-		if e ~= nil then
-			self:dispatch(e)
-		end
+		Event.pumpAll(self.dispatch, self)
 
 		local elapsed = stopwatch:elapsed()
 		if elapsed ~= 0 then
@@ -26,6 +26,7 @@ function M:setTexture(texture)
 	if texture then
 		local w, h = texture:size()
 		self.texture = texture
+		self.object:setTexture(texture)
 		self:setSize(w, h)
 	end
 	return self
@@ -41,15 +42,4 @@ function M:getTexture()
 	return self.texture
 end
 
----
--- Draw display image to the screen. (subclasses method)
---
--- @function [parent=#DisplayImage] __draw
--- @param self
--- @param display (Display) The context of the screen.
-function M:__draw(display)
-	self:updateTransformMatrix()
-	display:drawTexture(self.object, self.texture)
-end
-
 return M
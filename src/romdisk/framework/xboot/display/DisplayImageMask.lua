@@ -28,6 +28,9 @@ function M:setTexture(texture)
 	if texture then
 		local w, h = texture:size()
 		self.texture = texture
+		if self.pattern then
+			self.object:setTextureMask(texture, self.pattern)
+		end
 		self:setSize(w, h)
 	end
 	return self
@@ -52,6 +55,9 @@ end
 function M:setPattern(pattern)
 	if pattern then
 		self.pattern = pattern
+		if self.texture then
+			self.object:setTextureMask(self.texture, pattern)
+		end
 	end
 	return self
 end
@@ -66,15 +72,4 @@ function M:getPattern()
 	return self.pattern
 end
 
----
--- Draw display image with mask to the screen. (subclasses method)
---
--- @function [parent=#DisplayImageMask] __draw
--- @param self
--- @param display (Display) The context of the screen.
-function M:__draw(display)
-	self:updateTransformMatrix()
-	display:drawTextureMask(self.object, self.texture, self.pattern)
-end
-
 return M
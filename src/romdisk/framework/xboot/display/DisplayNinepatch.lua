@@ -36,6 +36,7 @@ function M:setNinepatch(ninepatch, width, height)
 	if ninepatch then
 		local w, h = ninepatch:getSize()
 		self.ninepatch = ninepatch
+		self.object:setNinepatch(ninepatch)
 		self:setSize(width or w, height or h)
 	end
 	return self
@@ -51,15 +52,4 @@ function M:getNinepatch()
 	return self.ninepatch
 end
 
----
--- Draw display ninepatch to the screen. (subclasses method)
---
--- @function [parent=#DisplayNinepatch] __draw
--- @param self
--- @param display (Display) The context of the screen.
-function M:__draw(display)
-  self:updateTransformMatrix()
-  display:drawNinepatch(self.object, self.ninepatch)
-end
-
 return M
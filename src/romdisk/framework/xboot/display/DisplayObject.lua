@@ -5,6 +5,15 @@
 -- @module DisplayObject
 local M = Class(EventDispatcher)
 
+local pointers = {
+	[Event.MOUSE_DOWN] = "begin",
+	[Event.MOUSE_MOVE] = "move",
+	[Event.MOUSE_UP] = "end",
+	[Event.TOUCH_BEGIN] = "begin",
+	[Event.TOUCH_MOVE] = "move",
+	[Event.TOUCH_END] = "end",
+}
+
 ---
 -- Creates a new display object.
 --
@@ -16,7 +25,7 @@ function M:init(width, height)
 	self.super:init()
 	self.parent = nil
 	self.children = {}
-	self.object = Object.new()
+	self.object = Object.new(self)
 	self.object:setSize(width or 0, height or 0)
 end
 
@@ -74,6 +83,8 @@ function M:addChild(child)
 	child:removeSelf()
 	table.insert(self.children, child)
 	child.parent = self
+	child.object:setDrawHook(child.__draw ~= M.__draw)
+	self.object:addChild(child.object)
 
 	return true
 end
@@ -106,6 +117,7 @@ function M:removeChild(child)
 
 	table.remove(self.children, index)
 	child.parent = nil
+	self.object:removeChild(child.object)
 
 	return true
 end
@@ -146,6 +158,7 @@ function M:toFront()
 
 	table.insert(parent.children, self)
 	self.parent = parent
+	parent.object:addChild(self.object)
 
 	return true
 end
@@ -169,6 +182,7 @@ function M:toBack()
 
 	table.insert(parent.children, 1, self)
 	self.parent = parent
+	parent.object:addChild(self.object, true)
 
 	return true
 end
@@ -541,11 +555,14 @@ function M:getBounds(target)
 end
 
 ---
--- Perform a custom animation of a set of display object properties.
+-- Perform a custom animation of a set of display object properties. Any running
+-- or queued animation is stopped first. Animations are advanced natively in one
+-- pass before each frame is rendered, and 'Event.ANIMATE_COMPLETE' is dispatched
+-- when one has finished.
 --
 -- @function [parent=#DisplayObject] animate
 -- @param self
--- @param properties (table) The properties values that the animation will move toward. ['x' 'y' 'rotation' 'scalex' 'scaley' 'alpha']
+-- @param properties (table) The properties values that the animation will move toward. ['x' 'y' 'rotation' 'scalex' 'scaley' 'alpha'], any other key animates a numeric field of the display object.
 -- @param duration (number) Determining how long the animation will run in seconds.
 -- @param easing (#Easing) The string indicating which easing function to use for transition.
 -- The following easing functions can be used:
@@ -560,56 +577,10 @@ end
 -- "inBack"		"outBack"		"inOutBack"
 -- "inElastic"	"outElastic"	"inOutElastic"
 -- "inBounce"	"outBounce"		"inOutBounce"
-function M:animate(properties, duration, easing)
-	local function __animate_listener(d, e)
-		if d.__animate ~= true then
-			d:removeEventListener(Event.ENTER_FRAME, __animate_listener, d)
-			d.__duration = nil
-			d.__tween = nil
-			d.__watch = nil
-			d.__animate = nil
-			return
-		end
-
-		local elapsed = d.__watch:elapsed()
-
-		if elapsed > d.__duration then
-			elapsed = d.__duration
-		end
-
-		for k, v in pairs(d.__tween) do
-			if k == "x" then
-				d:setX(v:easing(elapsed))
-			elseif k == "y" then
-				d:setY(v:easing(elapsed))
-			elseif k == "rotation" then
-				d:setRotation(v:easing(elapsed))
-			elseif k == "scalex" then
-				d:setScaleX(v:easing(elapsed))
-			elseif k == "scaley" then
-				d:setScaleY(v:easing(elapsed))
-			elseif k == "alpha" then
-				d:setAlpha(v:easing(elapsed))
-			end
-		end
-
-		if elapsed >= d.__duration then
-			d:removeEventListener(Event.ENTER_FRAME, __animate_listener, d)
-			self:dispatchEvent(Event.new(Event.ANIMATE_COMPLETE))
-			d.__duration = nil
-			d.__tween = nil
-			d.__watch = nil
-			d.__animate = nil
-		end
-	end
-
-	if self.__animate == true then
-		self:removeEventListener(Event.ENTER_FRAME, __animate_listener, self)
+-- @param callback (optional) The function called with the display object when the animation has finished.
+function M:animate(properties, duration, easing, callback)
+	if self.object:stopAnimate() then
 		self:dispatchEvent(Event.new(Event.ANIMATE_COMPLETE))
-		self.__duration = nil
-		self.__tween = nil
-		self.__watch = nil
-		self.__animate = nil
 	end
 
 	if not properties or type(properties) ~= "table" or not next(properties) then
@@ -620,46 +591,52 @@ function M:animate(properties, duration, easing)
 		return self
 	end
 
-	self.__duration = duration or 1
-	self.__tween = {}
-	
-	for k, v in pairs(properties) do
-		local b = nil
-
-		if k == "x" then
-			b = self:getX()
-		elseif k == "y" then
-			b = self:getY()
-		elseif k == "rotation" then
-			b = self:getRotation()
-		elseif k == "scalex" then
-			b = self:getScaleX()
-		elseif k == "scaley" then
-			b = self:getScaleY()
-		elseif k == "alpha" then
-			b = self:getAlpha()
-		end
+	return self:queueAnimate(properties, duration, easing, callback)
+end
 
-		if b ~= nil then
-			self.__tween[k] = Easing.new(b, v - b, self.__duration, easing)
+---
+-- Queue a custom animation after the running and queued animations of display
+-- object, starting at once if there is none. The properties start from the values
+-- they have when the animation starts. An empty set of properties simply waits
+-- for the duration, which can be used to delay or to synchronize a sequence.
+--
+-- @function [parent=#DisplayObject] queueAnimate
+-- @param self
+-- @param properties (table) The properties values that the animation will move toward.
+-- @param duration (number) Determining how long the animation will run in seconds.
+-- @param easing (#Easing) The string indicating which easing function to use for transition.
+-- @param callback (optional) The function called with the display object when the animation has finished.
+function M:queueAnimate(properties, duration, easing, callback)
+	self.object:animate(properties or {}, duration or 1, easing, function(d)
+		d:dispatchEvent(Event.new(Event.ANIMATE_COMPLETE))
+		if callback then
+			callback(d)
 		end
-	end
+	end)
+	return self
+end
 
-	if not next(self.__tween) then
-		self:removeEventListener(Event.ENTER_FRAME, __animate_listener, self)
-		self.__duration = nil
-		self.__tween = nil
-		self.__watch = nil
-		self.__animate = nil
-	else
-		self:addEventListener(Event.ENTER_FRAME, __animate_listener, self)
-		self.__watch = Stopwatch.new()
-		self.__animate = true
-	end
-	
+---
+-- Stop the running animation of display object and discard the queued ones,
+-- leaving the properties at their current values.
+--
+-- @function [parent=#DisplayObject] stopAnimate
+-- @param self
+function M:stopAnimate()
+	self.object:stopAnimate()
 	return self
 end
 
+---
+-- Tests whether display object has a running animation.
+--
+-- @function [parent=#DisplayObject] isAnimating
+-- @param self
+-- @return 'true' if display object is animating, 'false' otherwise.
+function M:isAnimating()
+	return self.object:isAnimating()
+end
+
 ---
 -- Layout display object and it's children to the screen.
 --
@@ -676,40 +653,159 @@ function M:layout()
 end
 
 ---
--- Draw display object to the screen. This method must be subclassing.
+-- Marks the display object as changed, so the bitmap caches of the object and
+-- all of its ancestors are rebuilt on the next render. Subclasses call it
+-- whenever their drawn content changes without a change of size.
+--
+-- @function [parent=#DisplayObject] invalidate
+-- @param self
+function M:invalidate()
+	self.object:invalidate()
+	return self
+end
+
+---
+-- Sets whether or not the display object and it's children are cached as a bitmap.
+-- A cached subtree is rasterised once into an offscreen surface and then composited
+-- with the object's transform and alpha, until one of it's descendants changes.
+-- The alpha of the object applies to the whole cached subtree.
+--
+-- @function [parent=#DisplayObject] setCacheAsBitmap
+-- @param self
+-- @param cache (bool) whether or not the display object is cached as a bitmap
+function M:setCacheAsBitmap(cache)
+	self.object:setCache(cache)
+	return self
+end
+
+---
+-- Returns whether or not the display object is cached as a bitmap.
+--
+-- @function [parent=#DisplayObject] getCacheAsBitmap
+-- @param self
+-- @return A value of 'true' if display object is cached as a bitmap; 'false' otherwise.
+function M:getCacheAsBitmap()
+	return self.object:getCache()
+end
+
+---
+-- Adds a listener function for the specified event type. Display objects
+-- listening for 'Event.ENTER_FRAME' are flagged on the native object, so the
+-- renderer only visits those when dispatching the frame event.
+--
+-- @function [parent=#DisplayObject] addEventListener
+-- @param self
+-- @param type (string) The type of event.
+-- @param listener (function) The listener function that processes the event.
+-- @param data (optional) An optional data parameter that is passed as a first argument to the listener function.
+-- @param capture (optional) Whether the listener handles pointer events in the capturing phase instead of the bubbling phase.
+function M:addEventListener(type, listener, data, capture)
+	EventDispatcher.addEventListener(self, type, listener, data, capture)
+	if type == Event.ENTER_FRAME then
+		local els = self.eventListenersMap[type]
+		self.object:setEnterFrame(els and #els > 0)
+	end
+	return self
+end
+
+---
+-- Removes a listener function for the specified event type.
+--
+-- @function [parent=#DisplayObject] removeEventListener
+-- @param self
+-- @param type (string) The type of event.
+-- @param listener (function) The listener function that processes the event.
+-- @param data (optional) An optional data parameter that is passed as a first argument to the listener function.
+function M:removeEventListener(type, listener, data)
+	EventDispatcher.removeEventListener(self, type, listener, data)
+	if type == Event.ENTER_FRAME then
+		local els = self.eventListenersMap[type]
+		self.object:setEnterFrame(els and #els > 0)
+	end
+	return self
+end
+
+---
+-- Draw display object to the screen. Subclasses which register their content
+-- with the native object, like shapes, texts and images, need not override it.
 --
 -- @function [parent=#DisplayObject] __draw
 -- @param self
 -- @param display (Display) The context of the screen.
 function M:__draw(display)
+	display:drawObject(self.object)
 end
 
 ---
--- Render display object and it's children to the screen.
+-- Render display object and it's children to the screen. The 'Event.ENTER_FRAME'
+-- event is dispatched to the listening display objects, then the whole tree is
+-- drawn by the native scene graph.
 --
 -- @function [parent=#DisplayObject] render
 -- @param self
 -- @param display (Display) The context of the screen.
 -- @param event (Event) The 'Event' object to be dispatched.
 function M:render(display, event)
-	self:dispatchEvent(event)
-
-	if self:getVisible() then
-		self:__draw(display)
-	end
-
-	for i, v in ipairs(self.children) do
-		v:render(display, event)
+	if event and event.type ~= Event.ENTER_FRAME then
+		self:dispatch(event)
+		event = nil
 	end
+	self.object:setDrawHook(self.__draw ~= M.__draw)
+	display:render(self.object, event)
 end
 
 ---
 -- Dispatches an event to display object and it's children.
 --
+-- Pointer events are routed to the topmost touchable display object under the
+-- point, travelling from this display object down to the target in the capturing
+-- phase and back up in the bubbling phase. A pressed pointer keeps the route it
+-- was pressed on until released. Other events are broadcast to the whole tree.
+--
 -- @function [parent=#DisplayObject] dispatch
 -- @param self
 -- @param event (Event) The 'Event' object to be dispatched.
 function M:dispatch(event)
+	local pointer = pointers[event.type]
+
+	if pointer and event.x and event.y then
+		local id = event.id or -1
+		local captures = self.__captures
+		if not captures then
+			captures = {}
+			self.__captures = captures
+		end
+
+		local path = captures[id]
+		if pointer == "begin" or not path then
+			local o = self.object:pick(event.x, event.y) or self
+			path = {}
+			while o and o ~= self do
+				table.insert(path, o)
+				o = o.parent
+			end
+			table.insert(path, self)
+		end
+		if pointer == "begin" then
+			captures[id] = path
+		elseif pointer == "end" then
+			captures[id] = nil
+		end
+
+		event.target = path[1]
+		event.phase = Event.CAPTURING_PHASE
+		for i = #path, 2, -1 do
+			path[i]:dispatchEvent(event)
+		end
+		event.phase = Event.AT_TARGET
+		path[1]:dispatchEvent(event)
+		event.phase = Event.BUBBLING_PHASE
+		for i = 2, #path do
+			path[i]:dispatchEvent(event)
+		end
+		return
+	end
+
 	local children = self.children
 
 	for i = #children, 1, -1 do
@@ -27,6 +27,7 @@ function M:setShape(shape)
 	if shape then
 		local w, h = shape:size()
 		self.shape = shape
+		self.object:setShape(shape)
 		self:setSize(w, h)
 	end
 	return self
@@ -184,21 +185,25 @@ end
 
 function M:stroke()
 	self.shape:stroke()
+	self:invalidate()
 	return self
 end
 
 function M:strokePreserve()
 	self.shape:strokePreserve()
+	self:invalidate()
 	return self
 end
 
 function M:fill()
 	self.shape:fill()
+	self:invalidate()
 	return self
 end
 
 function M:fillPreserve()
 	self.shape:fillPreserve()
+	self:invalidate()
 	return self
 end
 
@@ -214,18 +219,8 @@ end
 
 function M:paint(alpha)
 	self.shape:paint(alpha)
+	self:invalidate()
 	return self
 end
 
----
--- Draw display shape to the screen. (subclasses method)
---
--- @function [parent=#DisplayShape] __draw
--- @param self
--- @param display (Display) The context of the screen.
-function M:__draw(display)
-  self:updateTransformMatrix()
-  display:drawShape(self.object, self.shape)
-end
-
 return M
@@ -5,6 +5,12 @@
 -- @module DisplayText
 local M = Class(DisplayObject)
 
+local function update(self)
+	if self.font and self.text and self.pattern then
+		self.object:setText(self.font, self.text, self.pattern)
+	end
+end
+
 ---
 -- Creates a new object of display text.
 --
@@ -31,6 +37,7 @@ end
 function M:setFont(font)
 	if font then
 		self.font = font
+		update(self)
 	end
 	return self
 end
@@ -76,6 +83,7 @@ end
 function M:setPattern(pattern)
 	if pattern then
 		self.pattern = pattern
+		update(self)
 	end
 	return self
 end
@@ -100,6 +108,7 @@ function M:setText(text)
 	if text and self.font then
 		local w, h = self.font:size(text)
 		self.text = text
+		update(self)
 		self:setSize(w, h)
 	end
 	return self
@@ -115,16 +124,4 @@ function M:getText()
 	return self.text
 end
 
----
--- Draw display text to the screen. (subclasses method)
---
--- @function [parent=#DisplayText] __draw
--- @param self
--- @param display (Display) The context of the screen.
-function M:__draw(display)
-	if self.font and self.text then
-		display:drawText(self.font, self.text, self.pattern, self:getTransformMatrix())
-	end
-end
-
 return M
@@ -10,16 +10,18 @@ local M = Class()
 -- @function [parent=#Timer] new
 -- @param delay (number) The delay in seconds
 -- @param iteration (number) The number of times listener is to be invoked. pass 0 if you want it to loop forever.
--- @param listener (function) The listener to invoke after the delay.
+-- @param listener (function) The listener to invoke after the delay, with the timer and a table of the elapsed "time" and the "count" of calls. The table is reused between calls.
+-- @param catchup (optional) What to do with the periods missed when the timer is scheduled late.
+-- "skip" fires once and keeps the timer's phase, which is the default.
+-- "burst" fires once for every missed period.
+-- "delay" fires once and restarts the period from then.
 -- @return New 'Timer' object.
-function M:init(delay, iteration, listener)
+function M:init(delay, iteration, listener, catchup)
 	self.delay = delay or 1
 	self.iteration = iteration or 1
 	self.listener = listener
+	self.catchup = catchup or "skip"
 	self.running = true
-
-	self.__time = 0
-	self.__count = 0
 end
 
 ---
@@ -39,6 +41,9 @@ end
 -- @param self
 function M:resume()
 	self.running = true
+	if self.__wheel then
+		self.__wheel:resume(self)
+	end
 end
 
 ---
@@ -48,6 +53,9 @@ end
 -- @param self
 function M:pause()
 	self.running = false
+	if self.__wheel then
+		self.__wheel:pause(self)
+	end
 end
 
 return M
@@ -5,12 +5,14 @@
 local M = Class()
 
 ---
--- Creates a new 'TimerManager' object.
+-- Creates a new 'TimerManager' object. Timers are kept in a native timer wheel,
+-- so registering, removing and looking up a timer cost the same however many
+-- timers are registered, and scheduling only visits the timers that expire.
 -- 
 -- @function [parent=#TimerManager] new
 -- @return New 'TimerManager' object.
 function M:init()
-	self.timerList = {}
+	self.wheel = TimerWheel.new()
 end
 
 ---
@@ -21,23 +23,11 @@ end
 -- @param timer (Timer) The timer was registered.
 -- @return A value of 'true' if a timer is registered; 'false' otherwise.
 function M:hasTimer(timer)
-	local tl = self.timerList
-
-	if not tl or #tl == 0 then
-		return false
-	end
-
 	if not timer then
 		return false
 	end
 
-	for i, v in ipairs(tl) do
-		if v == timer then
-			return true
-		end
-	end
-
-	return false
+	return self.wheel:has(timer)
 end
 
 --- 
@@ -48,37 +38,30 @@ end
 -- @param timer (Timer) The timer will be registered.
 -- @return A value of 'true' or 'false'.
 function M:addTimer(timer)
-	if self:hasTimer(timer) then
+	if not timer or not self.wheel:add(timer) then
 		return false
 	end
 
-	table.insert(self.timerList, timer)
+	timer.__wheel = self.wheel
 	return true
 end
 
 ---
--- Removes a timer from the 'TimerManager'.
+-- Removes a timer from the 'TimerManager'. A timer may remove itself or any
+-- other timer from within it's listener.
 -- 
 -- @function [parent=#TimerManager] removeTimer
 -- @param self
 -- @param timer (Timer) The timer will be removed.
 -- @return A value of 'true' or 'false'.
 function M:removeTimer(timer)
-	local tl = self.timerList
-
-	if not tl or #tl == 0 then
+	if not timer or not self.wheel:remove(timer) then
 		return false
 	end
 
-	for i, v in ipairs(tl) do
-		if v == timer then
-			v:pause()
-			table.remove(tl, i)
-			return true
-		end
-	end
-	
-	return false
+	timer:pause()
+	timer.__wheel = nil
+	return true
 end
 
 ---
@@ -88,21 +71,7 @@ end
 -- @param self
 -- @param dt (number) The time delta in seconds.
 function M:schedule(dt)
-	for i, v in ipairs(self.timerList) do
-		if v.running then
-			v.__time = v.__time + dt
-
-			if v.__time >= v.delay then
-				v.__count = v.__count + 1
-				v.listener(v, {time = v.__time, count = v.__count})
-
-				v.__time = 0
-				if v.iteration ~= 0 and v.__count >= v.iteration then
-					self:removeTimer(v)
-				end
-			end
-		end
-	end
+	self.wheel:schedule(dt)
 end
 
 return M
@@ -0,0 +1,307 @@
+/*
+ * tools/mklz4fs/mklz4fs.c
+ *
+ * Copyright(c) 2007-2018 Jianjun Jiang <8192542@qq.com>
+ * Official site: http://xboot.org
+ * Mobile phone: +86-18665388956
+ * QQ: 8192542
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+/*
+ * Host builder for the lz4fs read only image, see kernel/vfs/lz4fs/lz4fs.c
+ * for the layout. Build with:
+ *
+ *   gcc -O2 -I tools/mklz4fs -I src/external/lz4-1.8.2 tools/mklz4fs/mklz4fs.c \
+ *       src/external/lz4-1.8.2/lz4.c src/external/lz4-1.8.2/lz4hc.c -o mklz4fs
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <lz4.h>
+#include <lz4hc.h>
+
+#define LZ4FS_MAGIC				"LZ4FS\0\0\0"
+#define LZ4FS_VERSION			(1)
+#define LZ4FS_BLOCK_RAW			(0x80000000)
+
+struct node_t {
+	char * path;
+	char * name;
+	uint32_t mode;
+	uint32_t mtime;
+	uint32_t size;
+	uint32_t first;
+	uint32_t count;
+	struct node_t ** children;
+	int nchildren;
+};
+
+static struct node_t ** nodes;
+static int nnodes, maxnodes;
+
+static void put32(FILE * fp, uint32_t v)
+{
+	uint8_t b[4] = { v & 0xff, (v >> 8) & 0xff, (v >> 16) & 0xff, (v >> 24) & 0xff };
+
+	fwrite(b, 1, 4, fp);
+}
+
+static int node_compare(const void * a, const void * b)
+{
+	return strcmp((*(struct node_t **)a)->name, (*(struct node_t **)b)->name);
+}
+
+static struct node_t * node_scan(const char * path, const char * name)
+{
+	struct node_t * n;
+	struct dirent * d;
+	struct stat st;
+	DIR * dir;
+	char * p;
+
+	if(lstat(path, &st) != 0)
+	{
+		fprintf(stderr, "mklz4fs: can't stat '%s'\n", path);
+		return NULL;
+	}
+	n = calloc(1, sizeof(struct node_t));
+	n->path = strdup(path);
+	n->name = strdup(name);
+	n->mode = st.st_mode & 0177777;
+	n->mtime = st.st_mtime;
+
+	if(S_ISDIR(st.st_mode))
+	{
+		n->mode = (st.st_mode & 07777) | 0040000;
+		if(!(dir = opendir(path)))
+			return n;
+		while((d = readdir(dir)))
+		{
+			if(!strcmp(d->d_name, ".") || !strcmp(d->d_name, ".."))
+				continue;
+			p = malloc(strlen(path) + strlen(d->d_name) + 2);
+			sprintf(p, "%s/%s", path, d->d_name);
+			n->children = realloc(n->children, sizeof(struct node_t *) * (n->nchildren + 1));
+			n->children[n->nchildren] = node_scan(p, d->d_name);
+			if(n->children[n->nchildren])
+				n->nchildren++;
+			free(p);
+		}
+		closedir(dir);
+		qsort(n->children, n->nchildren, sizeof(struct node_t *), node_compare);
+	}
+	else if(S_ISREG(st.st_mode) || S_ISLNK(st.st_mode))
+	{
+		n->size = st.st_size;
+	}
+	return n;
+}
+
+static void node_add(struct node_t * n)
+{
+	if(nnodes >= maxnodes)
+	{
+		maxnodes = maxnodes ? maxnodes * 2 : 64;
+		nodes = realloc(nodes, sizeof(struct node_t *) * maxnodes);
+	}
+	nodes[nnodes++] = n;
+}
+
+static uint8_t * node_data(struct node_t * n)
+{
+	uint8_t * buf = malloc(n->size + 1);
+	FILE * fp;
+
+	if((n->mode & 0170000) == 0120000)
+	{
+		if(readlink(n->path, (char *)buf, n->size + 1) != n->size)
+			return NULL;
+		return buf;
+	}
+	if(!(fp = fopen(n->path, "rb")))
+		return NULL;
+	if(fread(buf, 1, n->size, fp) != n->size)
+	{
+		fclose(fp);
+		return NULL;
+	}
+	fclose(fp);
+	return buf;
+}
+
+static void usage(void)
+{
+	printf("usage:\r\n");
+	printf("    mklz4fs [-b blkshift] <directory> <image>\r\n");
+}
+
+int main(int argc, char * argv[])
+{
+	struct node_t * root, * n;
+	FILE * fp;
+	uint8_t * data, * cbuf;
+	uint32_t blkshift = 14, blksz, nblocks = 0, namelen = 0;
+	uint32_t inode_offset, block_offset, name_offset, data_offset, offset, name;
+	uint32_t length, raw = 0, total = 0;
+	uint32_t * table;
+	int i, j, k, csize;
+
+	for(i = 1; i < argc; i++)
+	{
+		if(!strcmp(argv[i], "-b") && (argc > i + 1))
+			blkshift = strtoul(argv[++i], NULL, 0);
+		else
+			break;
+	}
+	if((argc - i != 2) || (blkshift < 9) || (blkshift > 20))
+	{
+		usage();
+		return -1;
+	}
+	blksz = 1 << blkshift;
+
+	root = node_scan(argv[i], "");
+	if(!root || ((root->mode & 0170000) != 0040000))
+	{
+		fprintf(stderr, "mklz4fs: '%s' is not a directory\n", argv[i]);
+		return -1;
+	}
+
+	/*
+	 * Breadth first, so the children of every directory get contiguous inodes
+	 */
+	node_add(root);
+	for(j = 0; j < nnodes; j++)
+	{
+		n = nodes[j];
+		if((n->mode & 0170000) == 0040000)
+		{
+			n->first = nnodes;
+			n->count = n->nchildren;
+			for(k = 0; k < n->nchildren; k++)
+				node_add(n->children[k]);
+		}
+		else if(n->size > 0)
+		{
+			n->first = nblocks;
+			n->count = (n->size + blksz - 1) >> blkshift;
+			nblocks += n->count;
+		}
+		namelen += strlen(n->name);
+	}
+
+	inode_offset = 64;
+	block_offset = inode_offset + nnodes * 32;
+	name_offset = block_offset + nblocks * 8;
+	data_offset = (name_offset + namelen + 3) & ~3;
+
+	if(!(fp = fopen(argv[i + 1], "wb")))
+	{
+		fprintf(stderr, "mklz4fs: can't create '%s'\n", argv[i + 1]);
+		return -1;
+	}
+
+	/*
+	 * Compress the data first, the block table and the image size follow from it
+	 */
+	table = calloc(nblocks + 1, sizeof(uint32_t) * 2);
+	cbuf = malloc(LZ4_compressBound(blksz));
+	fseek(fp, data_offset, SEEK_SET);
+	offset = data_offset;
+	for(j = 0; j < nnodes; j++)
+	{
+		n = nodes[j];
+		if(((n->mode & 0170000) == 0040000) || (n->size == 0))
+			continue;
+		if(!(data = node_data(n)))
+		{
+			fprintf(stderr, "mklz4fs: can't read '%s'\n", n->path);
+			fclose(fp);
+			return -1;
+		}
+		for(k = 0; k < n->count; k++)
+		{
+			length = n->size - (k << blkshift);
+			if(length > blksz)
+				length = blksz;
+			csize = LZ4_compress_HC((const char *)data + (k << blkshift), (char *)cbuf, length, LZ4_compressBound(blksz), LZ4HC_CLEVEL_MAX);
+			table[(n->first + k) * 2 + 0] = offset;
+			if((csize <= 0) || (csize >= length))
+			{
+				fwrite(data + (k << blkshift), 1, length, fp);
+				table[(n->first + k) * 2 + 1] = length | LZ4FS_BLOCK_RAW;
+				offset += length;
+				raw++;
+			}
+			else
+			{
+				fwrite(cbuf, 1, csize, fp);
+				table[(n->first + k) * 2 + 1] = csize;
+				offset += csize;
+			}
+		}
+		total += n->size;
+		free(data);
+	}
+
+	fseek(fp, 0, SEEK_SET);
+	fwrite(LZ4FS_MAGIC, 1, 8, fp);
+	put32(fp, LZ4FS_VERSION);
+	put32(fp, blkshift);
+	put32(fp, nnodes);
+	put32(fp, inode_offset);
+	put32(fp, nblocks);
+	put32(fp, block_offset);
+	put32(fp, name_offset);
+	put32(fp, offset);
+	for(j = 0; j < 6; j++)
+		put32(fp, 0);
+
+	for(j = 0, name = 0; j < nnodes; j++)
+	{
+		n = nodes[j];
+		put32(fp, n->mode);
+		put32(fp, n->mtime);
+		put32(fp, n->size);
+		put32(fp, name);
+		put32(fp, strlen(n->name));
+		put32(fp, n->first);
+		put32(fp, n->count);
+		put32(fp, 0);
+		name += strlen(n->name);
+	}
+	for(j = 0; j < nblocks * 2; j++)
+		put32(fp, table[j]);
+	for(j = 0; j < nnodes; j++)
+		fwrite(nodes[j]->name, 1, strlen(nodes[j]->name), fp);
+	for(j = name_offset + namelen; j < data_offset; j++)
+		fputc(0, fp);
+	fclose(fp);
+
+	printf("mklz4fs: %d inodes, %u blocks (%u stored), %u -> %u bytes\r\n", nnodes, nblocks, raw, total, offset);
+	return 0;
+}
@@ -0,0 +1,11 @@
+#ifndef __MKLZ4FS_XBOOT_H__
+#define __MKLZ4FS_XBOOT_H__
+
+/*
+ * The bundled lz4 sources include <xboot.h>, on the host the c library is all they need.
+ */
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#endif /* __MKLZ4FS_XBOOT_H__ */